@@ -22,6 +22,11 @@ class TrackingGeomtetyr;
 namespace FW {
 
 /// Create planar clusters from simulation hits.
+///
+/// By default each hit creates its own cluster. Optionally, the cells of all
+/// hits on a module are merged and clusters are formed from the connected
+/// cells. Cells are connected if they share an edge or a corner. The modules
+/// are then processed in parallel.
 class DigitizationAlgorithm : public BareAlgorithm
 {
 public:
@@ -35,6 +40,8 @@ public:
     std::shared_ptr<Acts::PlanarModuleStepper> planarModuleStepper = nullptr;
     /// Random numbers tool.
     std::shared_ptr<RandomNumbers> randomNumbers = nullptr;
+    /// Merge the cells of all hits on a module into connected clusters.
+    bool mergeHits = false;
   };
 
   /// Construct the digitization algorithm.
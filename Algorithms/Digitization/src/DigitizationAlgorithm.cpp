@@ -8,8 +8,17 @@
 
 #include "ACTFW/Digitization/DigitizationAlgorithm.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/EventData/SimHit.hpp"
@@ -47,6 +56,227 @@ FW::DigitizationAlgorithm::DigitizationAlgorithm(
   }
 }
 
+namespace {
+
+/// Digitization conditions of one surface and the range of its hits.
+struct SurfaceDigitization
+{
+  const Acts::Surface*            surface = nullptr;
+  const Acts::DigitizationModule* module  = nullptr;
+  Acts::Transform3D               invTransform;
+  double                          lorentzShift = 0.;
+  FW::SimHits::const_iterator     begin;
+  FW::SimHits::const_iterator     end;
+};
+
+/// Build the conditions table for all surfaces with hits.
+///
+/// The hits are sorted by geometry id, i.e. all hits on a surface are
+/// consecutive, and the table has one entry per consecutive range. Transform
+/// inversion and the detector element lookup are done once per surface
+/// instead of once per hit. The table depends on the geometry context and
+/// must not be reused for a different one.
+std::vector<SurfaceDigitization>
+buildSurfaceTable(const Acts::GeometryContext& gctx, const FW::SimHits& hits)
+{
+  std::vector<SurfaceDigitization> table;
+  for (auto it = hits.begin(); it != hits.end();) {
+    SurfaceDigitization entry;
+    entry.surface = it->surface;
+    entry.begin   = it;
+    while ((it != hits.end()) and (it->surface == entry.surface)) { ++it; }
+    entry.end = it;
+
+    auto detElement = dynamic_cast<const Acts::IdentifiedDetectorElement*>(
+        entry.surface->associatedDetectorElement());
+    if (detElement and detElement->digitizationModule()) {
+      entry.module = detElement->digitizationModule().get();
+      // the lorentz shift is along the local x direction
+      double lorentzShift
+          = detElement->thickness() * std::tan(entry.module->lorentzAngle());
+      entry.lorentzShift = -lorentzShift * entry.module->readoutDirection();
+      entry.invTransform = entry.surface->transform(gctx).inverse();
+    }
+    table.push_back(std::move(entry));
+  }
+  return table;
+}
+
+/// Minimal union-find over dense indices.
+struct UnionFind
+{
+  std::vector<size_t> parent;
+
+  UnionFind(size_t n) : parent(n)
+  {
+    std::iota(parent.begin(), parent.end(), 0);
+  }
+
+  size_t
+  find(size_t i)
+  {
+    while (parent[i] != i) {
+      // path halving
+      parent[i] = parent[parent[i]];
+      i         = parent[i];
+    }
+    return i;
+  }
+  void
+  unite(size_t a, size_t b)
+  {
+    a = find(a);
+    b = find(b);
+    // the smaller index is the root; labels follow the cell order
+    if (a < b) {
+      parent[b] = a;
+    } else if (b < a) {
+      parent[a] = b;
+    }
+  }
+};
+
+/// Step of a hit through a single cell.
+struct CellStep
+{
+  size_t         channel0;
+  size_t         channel1;
+  double         length;
+  Acts::Vector2D center;
+  size_t         hit;
+};
+
+/// Merge the cells of all hits on a module into connected clusters.
+std::vector<Acts::PlanarModuleCluster>
+clusterModule(const Acts::GeometryContext&     gctx,
+              const Acts::PlanarModuleStepper& stepper,
+              const SurfaceDigitization&       entry,
+              const Acts::ActsSymMatrixD<3>&   cov)
+{
+  // collect the steps of all hits in a sparse cell grid
+  std::vector<CellStep> steps;
+  for (auto hit = entry.begin; hit != entry.end; ++hit) {
+    Acts::Vector3D localIntersect3D(entry.invTransform * hit->position);
+    Acts::Vector2D localIntersection(localIntersect3D.x(),
+                                     localIntersect3D.y());
+    Acts::Vector3D localDirection(entry.invTransform.linear()
+                                  * hit->direction.normalized());
+    for (const auto& dStep : stepper.cellSteps(
+             gctx, *entry.module, localIntersection, localDirection)) {
+      steps.push_back({dStep.stepCell.channel0,
+                       dStep.stepCell.channel1,
+                       dStep.stepLength,
+                       dStep.stepCellCenter,
+                       static_cast<size_t>(hit - entry.begin)});
+    }
+  }
+  if (steps.empty()) { return {}; }
+  // steps through the same cell are consecutive after sorting
+  auto key = [](const CellStep& step) {
+    return std::make_tuple(step.channel0, step.channel1, step.hit);
+  };
+  std::sort(steps.begin(), steps.end(), [&](const auto& lhs, const auto& rhs) {
+    return key(lhs) < key(rhs);
+  });
+  // each cell is a range of steps; first step of each cell + end sentinel
+  std::vector<size_t> cells;
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if ((i == 0) or (steps[i - 1].channel0 != steps[i].channel0)
+        or (steps[i - 1].channel1 != steps[i].channel1)) {
+      cells.push_back(i);
+    }
+  }
+  size_t nCells = cells.size();
+  cells.push_back(steps.size());
+
+  // connected component labeling using the sorted cell order
+  auto findCell = [&](size_t channel0, size_t channel1) {
+    auto compare = [&](size_t is, const std::pair<size_t, size_t>& channels) {
+      return std::make_pair(steps[is].channel0, steps[is].channel1) < channels;
+    };
+    auto it = std::lower_bound(cells.begin(),
+                               cells.begin() + nCells,
+                               std::make_pair(channel0, channel1),
+                               compare);
+    size_t ic = std::distance(cells.begin(), it);
+    if ((ic < nCells) and (steps[cells[ic]].channel0 == channel0)
+        and (steps[cells[ic]].channel1 == channel1)) {
+      return ic;
+    }
+    return nCells;
+  };
+  UnionFind labels(nCells);
+  for (size_t ic = 0; ic < nCells; ++ic) {
+    size_t c0 = steps[cells[ic]].channel0;
+    size_t c1 = steps[cells[ic]].channel1;
+    // only look forward; backward neighbours have already been checked.
+    // the wrap-around of c1 - 1 for c1 = 0 never matches an existing cell.
+    std::pair<size_t, size_t> neighbours[] = {
+        {c0, c1 + 1}, {c0 + 1, c1 - 1}, {c0 + 1, c1}, {c0 + 1, c1 + 1}};
+    for (const auto& neighbour : neighbours) {
+      size_t jc = findCell(neighbour.first, neighbour.second);
+      if (jc < nCells) { labels.unite(ic, jc); }
+    }
+  }
+
+  // build one cluster per connected component in the order of the cells
+  struct Accumulator
+  {
+    std::vector<Acts::DigitizationCell>       cells;
+    std::vector<const FW::Data::SimParticle*> particles;
+    Acts::Vector2D position = Acts::Vector2D::Zero();
+    double         length   = 0.;
+    double         time     = std::numeric_limits<double>::max();
+  };
+  std::vector<size_t>      clusterIndices(nCells, nCells);
+  std::vector<Accumulator> accumulators;
+  for (size_t ic = 0; ic < nCells; ++ic) {
+    size_t root = labels.find(ic);
+    if (clusterIndices[root] == nCells) {
+      clusterIndices[root] = accumulators.size();
+      accumulators.emplace_back();
+    }
+    auto&  acc        = accumulators[clusterIndices[root]];
+    double cellLength = 0.;
+    for (size_t is = cells[ic]; is < cells[ic + 1]; ++is) {
+      const auto& step = steps[is];
+      const auto& hit  = *(entry.begin + step.hit);
+      acc.position += step.length * step.center;
+      acc.length += step.length;
+      cellLength += step.length;
+      // the earliest hit defines the cluster time
+      acc.time = std::min(acc.time, hit.time);
+      auto sameParticle = [&](const FW::Data::SimParticle* particle) {
+        return particle->barcode() == hit.particle.barcode();
+      };
+      if (std::none_of(
+              acc.particles.begin(), acc.particles.end(), sameParticle)) {
+        acc.particles.push_back(&hit.particle);
+      }
+    }
+    acc.cells.emplace_back(
+        steps[cells[ic]].channel0, steps[cells[ic]].channel1, cellLength);
+  }
+
+  std::vector<Acts::PlanarModuleCluster> clusters;
+  clusters.reserve(accumulators.size());
+  for (auto& acc : accumulators) {
+    Acts::Vector2D localPosition = acc.position / acc.length;
+    clusters.emplace_back(
+        entry.surface->getSharedPtr(),
+        Identifier(Identifier::identifier_type(entry.begin->geoId().value()),
+                   std::move(acc.particles)),
+        cov,
+        localPosition.x() + entry.lorentzShift,
+        localPosition.y(),
+        acc.time,
+        std::move(acc.cells));
+  }
+  return clusters;
+}
+
+}  // namespace
+
 FW::ProcessCode
 FW::DigitizationAlgorithm::execute(const AlgorithmContext& ctx) const
 {
@@ -54,94 +284,110 @@ FW::DigitizationAlgorithm::execute(const AlgorithmContext& ctx) const
   const auto& simHits = ctx.eventStore.get<SimHits>(m_cfg.inputSimulatedHits);
   FW::GeometryIdMultimap<Acts::PlanarModuleCluster> clusters;
 
+  // the covariance is currently set to 0.
+  Acts::ActsSymMatrixD<3> cov;
+  cov << 0.05, 0., 0., 0., 0.05, 0., 0., 0.,
+      900. * Acts::UnitConstants::ps * Acts::UnitConstants::ps;
+
+  auto table = buildSurfaceTable(ctx.geoContext, simHits);
+
+  if (m_cfg.mergeHits) {
+    // modules are independent and are clustered in parallel
+    std::vector<std::vector<Acts::PlanarModuleCluster>> moduleClusters(
+        table.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, table.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+          for (size_t i = r.begin(); i != r.end(); ++i) {
+            // only surfaces with a digitization module are digitized
+            if (not table[i].module) { continue; }
+            moduleClusters[i] = clusterModule(
+                ctx.geoContext, *m_cfg.planarModuleStepper, table[i], cov);
+          }
+        });
+    // the table follows the geometry order and so does the output
+    for (size_t i = 0; i < table.size(); ++i) {
+      for (auto& pCluster : moduleClusters[i]) {
+        clusters.emplace_hint(
+            clusters.end(), table[i].begin->geoId(), std::move(pCluster));
+      }
+    }
+    ACTS_DEBUG("Created " << clusters.size() << " clusters from "
+                          << simHits.size() << " hits");
+    ctx.eventStore.add(m_cfg.outputClusters, std::move(clusters));
+    return FW::ProcessCode::SUCCESS;
+  }
+
   // now digitise
-  for (const auto& hit : simHits) {
-    const Acts::Surface&                  hitSurface  = *hit.surface;
-    const Data::SimParticle*              hitParticle = &hit.particle;
-    std::vector<const Data::SimParticle*> hitParticles{hitParticle};
-    // get the DetectorElement
-    auto hitDetElement = dynamic_cast<const Acts::IdentifiedDetectorElement*>(
-        hitSurface.associatedDetectorElement());
-    if (hitDetElement) {
-      // get the digitization module
-      auto hitDigitizationModule = hitDetElement->digitizationModule();
-      if (hitDigitizationModule) {
-        // get the lorentz angle
-        double lorentzAngle = hitDigitizationModule->lorentzAngle();
-        double thickness    = hitDetElement->thickness();
-        double lorentzShift = thickness * tan(lorentzAngle);
-        lorentzShift *= -(hitDigitizationModule->readoutDirection());
-        // parameters
-        auto invTransfrom = hitSurface.transform(ctx.geoContext).inverse();
-        // local intersection / direction
-        Acts::Vector3D localIntersect3D(invTransfrom * hit.position);
-        Acts::Vector2D localIntersection(localIntersect3D.x(),
-                                         localIntersect3D.y());
-        Acts::Vector3D localDirection(invTransfrom.linear()
-                                      * hit.direction.normalized());
-        // now calculate the steps through the silicon
-        std::vector<Acts::DigitizationStep> dSteps
-            = m_cfg.planarModuleStepper->cellSteps(ctx.geoContext,
-                                                   *hitDigitizationModule,
-                                                   localIntersection,
-                                                   localDirection);
-        // everything under threshold or edge effects
-        if (!dSteps.size()) {
-          ACTS_VERBOSE("No steps returned from stepper.");
-          continue;
-        }
-        /// let' create a cluster - centroid method
-        double localX    = 0.;
-        double localY    = 0.;
-        double totalPath = 0.;
-        // the cells to be used
-        std::vector<Acts::DigitizationCell> usedCells;
-        usedCells.reserve(dSteps.size());
-        // loop over the steps
-        for (auto dStep : dSteps) {
-          // @todo implement smearing
-          localX += dStep.stepLength * dStep.stepCellCenter.x();
-          localY += dStep.stepLength * dStep.stepCellCenter.y();
-          totalPath += dStep.stepLength;
-          usedCells.push_back(Acts::DigitizationCell(dStep.stepCell.channel0,
-                                                     dStep.stepCell.channel1,
-                                                     dStep.stepLength));
-        }
-        // divide by the total path
-        localX /= totalPath;
-        localX += lorentzShift;
-        localY /= totalPath;
-
-        // get the segmentation & find the corresponding cell id
-        const Acts::Segmentation& segmentation
-            = hitDigitizationModule->segmentation();
-        auto           binUtility = segmentation.binUtility();
-        Acts::Vector2D localPosition(localX, localY);
-        // @todo remove unneccesary conversion
-        size_t bin0          = binUtility.bin(localPosition, 0);
-        size_t bin1          = binUtility.bin(localPosition, 1);
-        size_t binSerialized = binUtility.serialize({{bin0, bin1, 0}});
-
-        // the covariance is currently set to 0.
-        Acts::ActsSymMatrixD<3> cov;
-        cov << 0.05, 0., 0., 0., 0.05, 0., 0., 0.,
-            900. * Acts::UnitConstants::ps * Acts::UnitConstants::ps;
-
-        // create the planar cluster
-        Acts::PlanarModuleCluster pCluster(
-            hitSurface.getSharedPtr(),
-            Identifier(Identifier::identifier_type(hit.geoId().value()),
-                       hitParticles),
-            std::move(cov),
-            localX,
-            localY,
-            hit.time,
-            std::move(usedCells));
-
-        // insert into the cluster container. since the input data is already
-        // sorted by geoId, we should always be able to add at the end.
-        clusters.emplace_hint(clusters.end(), hit.geoId(), std::move(pCluster));
+  for (const auto& entry : table) {
+    // only surfaces with a digitization module are digitized
+    if (not entry.module) { continue; }
+    const Acts::Surface&      hitSurface   = *entry.surface;
+    const Acts::Transform3D&  invTransfrom = entry.invTransform;
+    const Acts::Segmentation& segmentation = entry.module->segmentation();
+    const auto&               binUtility   = segmentation.binUtility();
+
+    for (auto hit = entry.begin; hit != entry.end; ++hit) {
+      const Data::SimParticle*              hitParticle = &hit->particle;
+      std::vector<const Data::SimParticle*> hitParticles{hitParticle};
+      // local intersection / direction
+      Acts::Vector3D localIntersect3D(invTransfrom * hit->position);
+      Acts::Vector2D localIntersection(localIntersect3D.x(),
+                                       localIntersect3D.y());
+      Acts::Vector3D localDirection(invTransfrom.linear()
+                                    * hit->direction.normalized());
+      // now calculate the steps through the silicon
+      std::vector<Acts::DigitizationStep> dSteps
+          = m_cfg.planarModuleStepper->cellSteps(
+              ctx.geoContext, *entry.module, localIntersection, localDirection);
+      // everything under threshold or edge effects
+      if (!dSteps.size()) {
+        ACTS_VERBOSE("No steps returned from stepper.");
+        continue;
+      }
+      /// let' create a cluster - centroid method
+      double localX    = 0.;
+      double localY    = 0.;
+      double totalPath = 0.;
+      // the cells to be used
+      std::vector<Acts::DigitizationCell> usedCells;
+      usedCells.reserve(dSteps.size());
+      // loop over the steps
+      for (auto dStep : dSteps) {
+        // @todo implement smearing
+        localX += dStep.stepLength * dStep.stepCellCenter.x();
+        localY += dStep.stepLength * dStep.stepCellCenter.y();
+        totalPath += dStep.stepLength;
+        usedCells.push_back(Acts::DigitizationCell(dStep.stepCell.channel0,
+                                                   dStep.stepCell.channel1,
+                                                   dStep.stepLength));
       }
+      // divide by the total path
+      localX /= totalPath;
+      localX += entry.lorentzShift;
+      localY /= totalPath;
+
+      // find the corresponding cell id
+      Acts::Vector2D localPosition(localX, localY);
+      // @todo remove unneccesary conversion
+      size_t bin0          = binUtility.bin(localPosition, 0);
+      size_t bin1          = binUtility.bin(localPosition, 1);
+      size_t binSerialized = binUtility.serialize({{bin0, bin1, 0}});
+
+      // create the planar cluster
+      Acts::PlanarModuleCluster pCluster(
+          hitSurface.getSharedPtr(),
+          Identifier(Identifier::identifier_type(hit->geoId().value()),
+                     hitParticles),
+          cov,
+          localX,
+          localY,
+          hit->time,
+          std::move(usedCells));
+
+      // insert into the cluster container. since the input data is already
+      // sorted by geoId, we should always be able to add at the end.
+      clusters.emplace_hint(clusters.end(), hit->geoId(), std::move(pCluster));
     }
   }
 
@@ -11,6 +11,7 @@
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include "ACTFW/EventData/SimHit.hpp"
 #include "ACTFW/EventData/SimVertex.hpp"
@@ -22,6 +23,12 @@ namespace FW {
 
 /// Fast track simulation using the Acts propagation and navigation.
 ///
+/// By default the whole event is simulated by a single call to the
+/// simulation kernel. Optionally the primary particles are simulated in
+/// parallel, each one as a separate event with its own random number
+/// substream. The hits are collected per thread and sorted once at the end;
+/// the result does not depend on the number of threads.
+///
 /// @tparam simulator_t the Fatras simulation kernel type
 template <typename simulator_t>
 class FatrasAlgorithm : public BareAlgorithm
@@ -38,12 +45,19 @@ public:
     /// the input event collection name
     std::string inputEventCollection;
 
+    /// take the input event from the event store instead of copying it.
+    /// the input event collection is not available afterwards.
+    bool consumeInputEvent = false;
+
     /// the simulated particles output collection name
     std::string simulatedEventCollection;
 
     /// the simulated hit output collection name
     std::string simulatedHitCollection;
 
+    /// simulate the primary particles of an event in parallel
+    bool parallelParticles = false;
+
     /// @brief Config constructor with propagator type
     ///
     /// @param s the Fatras simulation kernel
@@ -64,6 +78,18 @@ public:
 
 private:
   Config m_cfg;
+
+  using SimEvent = std::vector<FW::Data::SimVertex>;
+
+  /// Simulate each primary particle separately and in parallel.
+  ///
+  /// @param ctx the algorithm context containing all event information
+  /// @param [in,out] event the event, modified in-place
+  /// @param [out] hits the sequence of all simulated hits
+  void
+  simulateParticles(const AlgorithmContext& ctx,
+                    SimEvent&               event,
+                    SimHits::sequence_type& hits) const;
 };
 
 }  // namespace FW
@@ -6,6 +6,16 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
 template <typename simulator_t>
 FW::FatrasAlgorithm<simulator_t>::FatrasAlgorithm(const Config&        cfg,
                                                   Acts::Logging::Level lvl)
@@ -28,31 +38,266 @@ namespace detail {
     }
   };
 
+  // per-thread hits that remember which primary particle created them.
+  struct ThreadSimHits : public UnorderedSimHits
+  {
+    // primary particle index and the first of its hits
+    std::vector<std::pair<size_t, size_t>> particles;
+  };
+
+  // renumber the particles created while simulating a single primary.
+  //
+  // each primary is simulated in its own event and the simulator numbers the
+  // new secondary vertices and particles only within that event. primaries
+  // from the same primary vertex would thus create the same identifiers.
+  // secondary vertices are shifted by the largest secondary vertex already
+  // used for the primary vertex; new particles at the primary vertex itself
+  // are numbered after the largest particle already used there.
+  class SecondaryBarcodes
+  {
+  public:
+    explicit SecondaryBarcodes(const std::vector<Data::SimVertex>& event)
+    {
+      for (const auto& vertex : event) {
+        for (const auto& particle : vertex.outgoing) {
+          Barcode barcode = particle.barcode();
+          auto&   maxSecondary = m_maxSecondary[barcode.vertexPrimary()];
+          maxSecondary = std::max(maxSecondary, barcode.vertexSecondary());
+          if (barcode.vertexSecondary() == 0u) {
+            auto& maxParticle = m_maxParticle[barcode.vertexPrimary()];
+            maxParticle       = std::max(maxParticle, barcode.particle());
+          }
+        }
+      }
+    }
+
+    // start renumbering the particles created by the given primary.
+    void
+    begin(Barcode primary)
+    {
+      m_primary = primary;
+      m_mapped.clear();
+      m_secondaryOffset.clear();
+      m_particles.clear();
+    }
+
+    // new identifier; the same input always gives the same output.
+    Barcode
+    operator()(Barcode barcode)
+    {
+      if (barcode == m_primary) { return barcode; }
+      auto it = m_mapped.find(barcode.value());
+      if (it != m_mapped.end()) { return Barcode(it->second); }
+
+      Barcode::Value primary = barcode.vertexPrimary();
+      Barcode        mapped  = barcode;
+      if (barcode.vertexSecondary() != 0u) {
+        auto offset
+            = m_secondaryOffset.emplace(primary, m_maxSecondary[primary])
+                  .first->second;
+        mapped.setVertexSecondary(offset + barcode.vertexSecondary());
+        m_maxSecondary[primary]
+            = std::max(m_maxSecondary[primary], mapped.vertexSecondary());
+      } else {
+        mapped.setParticle(++m_maxParticle[primary]);
+        m_particles.emplace(key(primary, barcode.particle()),
+                            mapped.particle());
+        // parents are created before their children
+        auto parent = m_particles.find(key(primary, barcode.parentParticle()));
+        if (parent != m_particles.end()) {
+          mapped.setParentParticle(parent->second);
+        }
+      }
+      m_mapped.emplace(barcode.value(), mapped.value());
+      return mapped;
+    }
+
+  private:
+    static Barcode::Value
+    key(Barcode::Value primary, Barcode::Value particle)
+    {
+      return Barcode().setVertexPrimary(primary).setParticle(particle).value();
+    }
+
+    Barcode m_primary;
+    // largest used identifiers by primary vertex
+    std::unordered_map<Barcode::Value, Barcode::Value> m_maxSecondary;
+    std::unordered_map<Barcode::Value, Barcode::Value> m_maxParticle;
+    // state for the current primary
+    std::unordered_map<Barcode::Value, Barcode::Value> m_mapped;
+    std::unordered_map<Barcode::Value, Barcode::Value> m_secondaryOffset;
+    std::unordered_map<Barcode::Value, Barcode::Value> m_particles;
+  };
+
+  // check that no particle identifier is used twice.
+  inline bool
+  hasUniqueBarcodes(const std::vector<Data::SimVertex>& event)
+  {
+    std::vector<Barcode> barcodes;
+    for (const auto& vertex : event) {
+      for (const auto& particle : vertex.outgoing) {
+        barcodes.push_back(particle.barcode());
+      }
+    }
+    std::sort(barcodes.begin(), barcodes.end());
+    return std::adjacent_find(barcodes.begin(), barcodes.end())
+        == barcodes.end();
+  }
+
 }  // namespace detail
 }  // namespace FW
 
 template <typename simulator_t>
-FW::ProcessCode
-FW::FatrasAlgorithm<simulator_t>::execute(const AlgorithmContext& ctx) const
+void
+FW::FatrasAlgorithm<simulator_t>::simulateParticles(
+    const AlgorithmContext& ctx,
+    SimEvent&               event,
+    SimHits::sequence_type& hits) const
 {
-  using SimEvent = std::vector<FW::Data::SimVertex>;
+  // the primary particles are identified by vertex and particle index
+  std::vector<std::pair<size_t, size_t>> primaries;
+  for (size_t iv = 0; iv < event.size(); ++iv) {
+    for (size_t ip = 0; ip < event[iv].outgoing.size(); ++ip) {
+      primaries.emplace_back(iv, ip);
+    }
+  }
+
+  // everything created in addition to the primary, one slot per primary
+  std::vector<std::vector<Data::SimParticle>> addedOutgoing(primaries.size());
+  std::vector<SimEvent>                       addedVertices(primaries.size());
+  tbb::enumerable_thread_specific<detail::ThreadSimHits> threadHits;
+
+  tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, primaries.size()),
+      [&](const tbb::blocked_range<size_t>& r) {
+        auto& local = threadHits.local();
+        for (size_t i = r.begin(); i != r.end(); ++i) {
+          auto& vertex   = event[primaries[i].first];
+          auto& particle = vertex.outgoing[primaries[i].second];
+          // the primary is the only particle of its own event
+          SimEvent particleEvent;
+          particleEvent.emplace_back(vertex.position,
+                                     std::vector<Data::SimParticle>{},
+                                     std::vector<Data::SimParticle>{particle},
+                                     vertex.processCode,
+                                     vertex.time);
+          local.particles.emplace_back(i, local.hits.size());
+          auto rng = m_cfg.randomNumberSvc->spawnGenerator(ctx, i);
+          m_cfg.simulator(ctx, rng, particleEvent, local);
+
+          // each primary is only written by its own task
+          auto& outgoing = particleEvent.front().outgoing;
+          particle       = std::move(outgoing.front());
+          addedOutgoing[i].assign(std::make_move_iterator(outgoing.begin() + 1),
+                                  std::make_move_iterator(outgoing.end()));
+          addedVertices[i].assign(
+              std::make_move_iterator(particleEvent.begin() + 1),
+              std::make_move_iterator(particleEvent.end()));
+        }
+      });
+
+  // collect the hits of each thread in the order of the primaries; the
+  // final sort by geometry id is stable and the result is reproducible
+  struct HitRange
+  {
+    size_t                  primary;
+    SimHits::sequence_type* hits;
+    size_t                  begin;
+    size_t                  end;
+  };
+  std::vector<HitRange> ranges;
+  ranges.reserve(primaries.size());
+  size_t numHits = 0;
+  for (auto& local : threadHits) {
+    numHits += local.hits.size();
+    for (size_t k = 0; k < local.particles.size(); ++k) {
+      size_t end = (k + 1 < local.particles.size())
+          ? local.particles[k + 1].second
+          : local.hits.size();
+      ranges.push_back({local.particles[k].first,
+                        &local.hits,
+                        local.particles[k].second,
+                        end});
+    }
+  }
+  std::sort(ranges.begin(),
+            ranges.end(),
+            [](const HitRange& lhs, const HitRange& rhs) {
+              return lhs.primary < rhs.primary;
+            });
 
-  // read input containers
-  const auto& inputEvent
-      = ctx.eventStore.get<SimEvent>(m_cfg.inputEventCollection);
+  // add the new particles, vertices, and hits in the order of the primaries
+  // with identifiers that are unique within the combined event
+  detail::SecondaryBarcodes renumber(event);
+  auto renumberParticles = [&](std::vector<Data::SimParticle>& particles) {
+    for (auto& particle : particles) {
+      particle.place(
+          particle.position(), renumber(particle.barcode()), particle.time());
+    }
+  };
+  size_t numVertices = event.size();
+  hits.reserve(numHits);
+  for (const auto& range : ranges) {
+    size_t i = range.primary;
+    renumber.begin(
+        event[primaries[i].first].outgoing[primaries[i].second].barcode());
+    renumberParticles(addedOutgoing[i]);
+    for (auto& vertex : addedVertices[i]) {
+      renumberParticles(vertex.incoming);
+      renumberParticles(vertex.outgoing);
+    }
+    for (auto hit = range.hits->begin() + range.begin;
+         hit != range.hits->begin() + range.end;
+         ++hit) {
+      hit->particle.place(hit->particle.position(),
+                          renumber(hit->particle.barcode()),
+                          hit->particle.time());
+    }
+    event[primaries[i].first].outgoing_insert(addedOutgoing[i]);
+    std::move(addedVertices[i].begin(),
+              addedVertices[i].end(),
+              std::back_inserter(event));
+    std::move(range.hits->begin() + range.begin,
+              range.hits->begin() + range.end,
+              std::back_inserter(hits));
+  }
+  assert(detail::hasUniqueBarcodes(event));
 
+  // secondary vertices are ordered by the barcode of their first particle
+  std::stable_sort(event.begin() + numVertices,
+                   event.end(),
+                   [](const Data::SimVertex& lhs, const Data::SimVertex& rhs) {
+                     if (lhs.outgoing.empty()) { return false; }
+                     if (rhs.outgoing.empty()) { return true; }
+                     return lhs.outgoing.front().barcode()
+                         < rhs.outgoing.front().barcode();
+                   });
+}
+
+template <typename simulator_t>
+FW::ProcessCode
+FW::FatrasAlgorithm<simulator_t>::execute(const AlgorithmContext& ctx) const
+{
   // prepare output containers
-  // the event is modified in-place; initialize with a copy
-  SimEvent simulatedEvent(inputEvent);
+  // the event is modified in-place; take over the input event or initialize
+  // with a copy if the input event is still needed afterwards
+  SimEvent simulatedEvent = m_cfg.consumeInputEvent
+      ? ctx.eventStore.consume<SimEvent>(m_cfg.inputEventCollection)
+      : ctx.eventStore.get<SimEvent>(m_cfg.inputEventCollection);
   // simulated hits are stored in a geometry-ordered flat container. to avoid
   // large performance impact from maintaining this order during the simulation
   // the hits are stored first in the order in which they are created.
   SimHits                  simulatedHits;
   detail::UnorderedSimHits unorderedHits;
 
-  // run the simulation w/ a local random generator
-  auto rng = m_cfg.randomNumberSvc->spawnGenerator(ctx);
-  m_cfg.simulator(ctx, rng, simulatedEvent, unorderedHits);
+  if (m_cfg.parallelParticles) {
+    // run the simulation w/ one random generator per primary particle
+    simulateParticles(ctx, simulatedEvent, unorderedHits.hits);
+  } else {
+    // run the simulation w/ a local random generator
+    auto rng = m_cfg.randomNumberSvc->spawnGenerator(ctx);
+    m_cfg.simulator(ctx, rng, simulatedEvent, unorderedHits);
+  }
 
   // restablish geometry ordering for the output hits container
   simulatedHits.adopt_sequence(std::move(unorderedHits.hits));
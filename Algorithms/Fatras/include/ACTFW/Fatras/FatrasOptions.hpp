@@ -57,6 +57,9 @@ namespace Options {
         = vars["fatras-sim-hits"].template as<std::string>();
     cfg.simulatedEventCollection
         = vars["fatras-sim-particles"].template as<std::string>();
+    cfg.parallelParticles
+        = vars["fatras-parallel-particles"].template as<bool>();
+    cfg.consumeInputEvent = vars["fatras-consume-input"].template as<bool>();
 
     return cfg;
   }
@@ -34,7 +34,30 @@ FW::Options::addFatrasOptions(FW::Options::Description& desc)
                                        "Switch on gamma conversions")(
       "fatras-had-interaction",
       value<bool>()->default_value(false),
-      "Switch on hadronic interaction")("fatras-debug-output",
-                                        value<bool>()->default_value(false),
-                                        "Switch on debug output on/off");
+      "Switch on hadronic interaction")(
+      "fatras-parallel-particles",
+      value<bool>()->default_value(false),
+      "Simulate the primary particles of an event in parallel")(
+      "fatras-consume-input",
+      value<bool>()->default_value(false),
+      "Take over the generated event instead of copying it. It can not be "
+      "written afterwards, i.e. no particle output must be enabled.")(
+      "fatras-pileup-library",
+      value<std::string>()->default_value(""),
+      "Overlay pile-up events from the library in this directory")(
+      "fatras-pileup-library-stem",
+      value<std::string>()->default_value("pileup"),
+      "The filename stem of the pile-up library")(
+      "fatras-pileup-mu",
+      value<size_t>()->default_value(0),
+      "Mean number of overlayed pile-up events")(
+      "fatras-pileup-time-sigma",
+      value<double>()->default_value(0.),
+      "Gaussian time spread of the pile-up events in ns")(
+      "fatras-pileup-library-output",
+      value<bool>()->default_value(false),
+      "Write the simulated events without overlaid pile-up as a library")(
+      "fatras-debug-output",
+      value<bool>()->default_value(false),
+      "Switch on debug output on/off");
 }
@@ -27,6 +27,7 @@
 #include <Acts/Utilities/ParameterDefinitions.hpp>
 #include <boost/program_options.hpp>
 
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
 #include "ACTFW/Plugins/BField/ScalableBField.hpp"
 
 namespace {
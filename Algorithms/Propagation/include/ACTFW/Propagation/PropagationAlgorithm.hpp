@@ -17,6 +17,9 @@
 #include "ACTFW/Framework/ProcessCode.hpp"
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Propagation/PropagationStatistics.hpp"
+#include "ACTFW/Propagation/SampledSteppingLogger.hpp"
+#include "ACTFW/Propagation/StraightLineBundlePropagator.hpp"
 #include "Acts/EventData/NeutralParameters.hpp"
 #include "Acts/EventData/TrackParameters.hpp"
 #include "Acts/Propagator/AbortList.hpp"
@@ -46,8 +49,9 @@ using RecordedMaterialTrack
     = std::pair<std::pair<Acts::Vector3D, Acts::Vector3D>, RecordedMaterial>;
 
 /// Finally the output of the propagation test
-using PropagationOutput
-    = std::pair<std::vector<Acts::detail::Step>, RecordedMaterial>;
+template <typename step_t>
+using PropagationOutputT = std::pair<std::vector<step_t>, RecordedMaterial>;
+using PropagationOutput  = PropagationOutputT<Acts::detail::Step>;
 
 /// @brief this test algorithm performs test propagation
 /// within the Acts::Propagator
@@ -55,6 +59,19 @@ using PropagationOutput
 /// If the propagator is equipped appropriately, it can
 /// also be used to test the Extrapolator within the geomtetry
 ///
+/// The tests of one event are propagated in parallel. Each test uses its own
+/// random number substream and output slot, so the output does not depend on
+/// the number of threads.
+///
+/// Optionally the steps, navigation candidates, and field cache misses are
+/// counted and stored together with the propagation time of the event.
+///
+/// If a straight line bundle propagator is configured, the tests are only
+/// generated one at a time and then propagated together through the material
+/// of the geometry. No steps are recorded in this case. Optionally, the first
+/// tests of each event are also propagated with the propagator to check the
+/// material found by the bundle propagation.
+///
 /// @tparam propagator_t Type of the Propagator to be tested
 template <typename propagator_t>
 class PropagationAlgorithm : public BareAlgorithm
@@ -110,10 +127,29 @@ public:
 
     /// The step collection to be stored
     std::string propagationStepCollection = "PropagationSteps";
+    /// Which steps are recorded
+    StepSelection stepSelection = StepSelection::All;
+    /// Record only every n-th of the selected steps
+    size_t stepSampling = 1;
+    /// Record `CompactStep`s instead of full `Acts::detail::Step`s
+    bool compactSteps = false;
 
     /// The material collection to be stored
     std::string propagationMaterialCollection = "RecordedMaterialTracks";
 
+    /// Count steps, navigation candidates, and field cache misses
+    bool recordStatistics = false;
+    /// The per-event statistics to be stored
+    std::string propagationStatisticsCollection = "PropagationStatistics";
+
+    /// Propagate all tests together as straight lines, replaces the propagator
+    std::shared_ptr<const StraightLineBundlePropagator> straightLineBundle
+        = nullptr;
+    /// Number of tests per event to check against the propagator
+    size_t straightLineBundleChecks = 0;
+    /// Relative tolerance of the checked material in X0 and L0
+    double straightLineBundleTolerance = 1e-3;
+
     /// covariance transport
     bool covarianceTransport = false;
 
@@ -151,16 +187,19 @@ private:
   /// charged and netural particles
   ///
   // @tparam parameters_t type of the parameters objects (charged/neutra;)
+  /// @tparam step_t type of the recorded steps
   ///
   /// @param [in] context The Context for this call
   /// @param [in] startParameters the start parameters
+  /// @param [out] statistics the counters of this propagation, if recorded
   /// @param [in] pathLengthe the path limit of this propagation
   ///
   /// @return collection of Propagation steps for further analysis
-  template <typename parameters_t>
-  PropagationOutput
+  template <typename parameters_t, typename step_t>
+  PropagationOutputT<step_t>
   executeTest(const AlgorithmContext& context,
               const parameters_t&     startParameters,
+              PropagationStatistics&  statistics,
               double pathLength = std::numeric_limits<double>::max()) const;
 };
 
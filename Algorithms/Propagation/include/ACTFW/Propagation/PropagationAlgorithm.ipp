@@ -6,9 +6,15 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <optional>
 #include <random>
 
 #include <Acts/Utilities/Helpers.hpp>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 template <typename propagator_t>
 std::optional<Acts::ActsSymMatrixD<Acts::BoundParsDim>>
@@ -48,32 +54,37 @@ PropagationAlgorithm<propagator_t>::PropagationAlgorithm(
 /// charged and netural particles
 /// @param [in] context is the contextual data of this event
 /// @param [in] startParameters the start parameters
+/// @param [out] statistics the counters of this propagation, if recorded
 /// @param [in] pathLength the maximal path length to go
 template <typename propagator_t>
-template <typename parameters_t>
-PropagationOutput
+template <typename parameters_t, typename step_t>
+PropagationOutputT<step_t>
 PropagationAlgorithm<propagator_t>::executeTest(
     const AlgorithmContext& context,
     const parameters_t&     startParameters,
+    PropagationStatistics&  statistics,
     double                  pathLength) const
 {
 
   ACTS_DEBUG("Test propagation/extrapolation starts");
 
-  PropagationOutput pOutput;
+  PropagationOutputT<step_t> pOutput;
 
   // This is the outside in mode
   if (m_cfg.mode == 0) {
 
     // The step length logger for testing & end of world aborter
     using MaterialInteractor = Acts::MaterialInteractor;
-    using SteppingLogger     = Acts::detail::SteppingLogger;
+    using SteppingLogger     = SampledSteppingLogger<step_t>;
     using DebugOutput        = Acts::detail::DebugOutputActor;
+    using Statistics         = PropagationStatisticsActor;
     using EndOfWorld         = Acts::detail::EndOfWorldReached;
 
     // Action list and abort list
-    using ActionList
-        = Acts::ActionList<SteppingLogger, MaterialInteractor, DebugOutput>;
+    using ActionList = Acts::ActionList<SteppingLogger,
+                                        MaterialInteractor,
+                                        DebugOutput,
+                                        Statistics>;
     using AbortList         = Acts::AbortList<EndOfWorld>;
     using PropagatorOptions = Acts::PropagatorOptions<ActionList, AbortList>;
 
@@ -87,28 +98,47 @@ PropagationAlgorithm<propagator_t>::executeTest(
            < m_cfg.ptLoopers);
 
     // Switch the material interaction on/off & eventually into logging mode
-    auto& mInteractor = options.actionList.get<MaterialInteractor>();
+    auto& mInteractor
+        = options.actionList.template get<MaterialInteractor>();
     mInteractor.multipleScattering = m_cfg.multipleScattering;
     mInteractor.energyLoss         = m_cfg.energyLoss;
     mInteractor.recordInteractions = m_cfg.recordMaterialInteractions;
 
+    // Record only the requested steps
+    auto& sLogger     = options.actionList.template get<SteppingLogger>();
+    sLogger.selection = m_cfg.stepSelection;
+    sLogger.sampling  = std::max<size_t>(m_cfg.stepSampling, 1);
+
+    // Count only if requested
+    options.actionList.template get<Statistics>().sterile
+        = not m_cfg.recordStatistics;
+
     // Set a maximum step size
     options.maxStepSize = m_cfg.maxStepSize;
 
-    // Propagate using the propagator
-    const auto& result
-        = m_cfg.propagator.propagate(startParameters, options).value();
-    auto steppingResults = result.template get<SteppingLogger::result_type>();
+    // Propagate using the propagator; owning the result allows to move the
+    // recorded steps instead of copying them
+    auto result = m_cfg.propagator.propagate(startParameters, options).value();
+    auto& steppingResults
+        = result.template get<typename SteppingLogger::result_type>();
 
     // Set the stepping result
     pOutput.first = std::move(steppingResults.steps);
-    // Also set the material recording result - if configured
-    if (m_cfg.recordMaterialInteractions) {
-      auto materialResult
+    // Also set the material recording result - if configured; the summed
+    // material is always needed to check the bundle propagation
+    if (m_cfg.recordMaterialInteractions or m_cfg.straightLineBundle) {
+      auto& materialResult
           = result.template get<MaterialInteractor::result_type>();
       pOutput.second = std::move(materialResult);
     }
 
+    // Set the counters of this propagation
+    if (m_cfg.recordStatistics) {
+      statistics = result.template get<Statistics::result_type>().statistics;
+      statistics.tracks        = 1;
+      statistics.loopProtected = options.loopProtection ? 1 : 0;
+    }
+
     // screen output if requested
     if (m_cfg.debugOutput) {
       auto& debugResult = result.template get<DebugOutput::result_type>();
@@ -123,37 +153,57 @@ ProcessCode
 PropagationAlgorithm<propagator_t>::execute(
     const AlgorithmContext& context) const
 {
-  // Create a random number generator
-  FW::RandomEngine rng = m_cfg.randomNumberSvc->spawnGenerator(context);
-
-  // Standard gaussian distribution for covarianmces
-  std::normal_distribution<double> gauss(0., 1.);
-
-  // Setup random number distributions for some quantities
-  std::uniform_real_distribution<double> phiDist(m_cfg.phiRange.first,
-                                                 m_cfg.phiRange.second);
-  std::uniform_real_distribution<double> etaDist(m_cfg.etaRange.first,
-                                                 m_cfg.etaRange.second);
-  std::uniform_real_distribution<double> ptDist(m_cfg.ptRange.first,
-                                                m_cfg.ptRange.second);
-  std::uniform_real_distribution<double> qDist(0., 1.);
-
   std::shared_ptr<const Acts::PerigeeSurface> surface
       = Acts::Surface::makeShared<Acts::PerigeeSurface>(
           Acts::Vector3D(0., 0., 0.));
 
-  // Output : the propagation steps
+  // Output : the propagation steps, one slot per test, as full or compact
+  // steps depending on the configuration
   std::vector<std::vector<Acts::detail::Step>> propagationSteps;
-  propagationSteps.reserve(m_cfg.ntests);
+  std::vector<std::vector<CompactStep>>        compactSteps;
+  if (m_cfg.compactSteps) {
+    compactSteps.resize(m_cfg.ntests);
+  } else {
+    propagationSteps.resize(m_cfg.ntests);
+  }
 
-  // Output (optional): the recorded material
+  // Output (optional): the recorded material, one slot per test
   std::vector<RecordedMaterialTrack> recordedMaterial;
   if (m_cfg.recordMaterialInteractions) {
-    recordedMaterial.reserve(m_cfg.ntests);
+    recordedMaterial.resize(m_cfg.ntests);
   }
 
-  // loop over number of particles
-  for (size_t it = 0; it < m_cfg.ntests; ++it) {
+  // Output (optional): the counters, one slot per test
+  std::vector<PropagationStatistics> statistics;
+  if (m_cfg.recordStatistics) { statistics.resize(m_cfg.ntests); }
+
+  // Input (optional): the start of all tests for the bundle propagation
+  StraightLineBundle bundle(m_cfg.straightLineBundle ? m_cfg.ntests : 0);
+  // and of the tests that are checked against the propagator
+  size_t numChecks = m_cfg.straightLineBundle
+      ? std::min(m_cfg.straightLineBundleChecks, m_cfg.ntests)
+      : 0u;
+  std::vector<std::optional<Acts::NeutralBoundParameters>> checkStarts(
+      numChecks);
+
+  // run a single test; each test draws from its own random substream
+  auto runTest = [&](size_t it) {
+    // Create a random number generator
+    FW::RandomEngine rng
+        = m_cfg.randomNumberSvc->spawnGenerator(context, it);
+
+    // Standard gaussian distribution for covarianmces
+    std::normal_distribution<double> gauss(0., 1.);
+
+    // Setup random number distributions for some quantities
+    std::uniform_real_distribution<double> phiDist(m_cfg.phiRange.first,
+                                                   m_cfg.phiRange.second);
+    std::uniform_real_distribution<double> etaDist(m_cfg.etaRange.first,
+                                                   m_cfg.etaRange.second);
+    std::uniform_real_distribution<double> ptDist(m_cfg.ptRange.first,
+                                                  m_cfg.ptRange.second);
+    std::uniform_real_distribution<double> qDist(0., 1.);
+
     /// get the d0 and z0
     double d0     = m_cfg.d0Sigma * gauss(rng);
     double z0     = m_cfg.z0Sigma * gauss(rng);
@@ -176,50 +226,172 @@ PropagationAlgorithm<propagator_t>::execute(
     // The covariance generation
     auto cov = generateCovariance(rng, gauss);
 
-    // execute the test for charged particles
-    PropagationOutput pOutput;
-    if (charge) {
-      // charged extrapolation - with hit recording
-      Acts::BoundParameters startParameters(
-          context.geoContext, std::move(cov), std::move(pars), surface);
-      sPosition = startParameters.position();
-      sMomentum = startParameters.momentum();
-      pOutput   = executeTest<Acts::TrackParameters>(context, startParameters);
-    } else {
-      // execute the test for neeutral particles
-      Acts::NeutralBoundParameters neutralParameters(
+    // only store the start of the test, all are propagated together later
+    if (m_cfg.straightLineBundle) {
+      Acts::NeutralBoundParameters startParameters(
           context.geoContext, std::move(cov), std::move(pars), surface);
-      sPosition = neutralParameters.position();
-      sMomentum = neutralParameters.momentum();
-      pOutput
-          = executeTest<Acts::NeutralParameters>(context, neutralParameters);
+      bundle.set(it, startParameters.position(), startParameters.momentum());
+      if (it < numChecks) { checkStarts[it].emplace(startParameters); }
+      if (m_cfg.recordMaterialInteractions) {
+        recordedMaterial[it].first.first  = startParameters.position();
+        recordedMaterial[it].first.second = startParameters.momentum();
+      }
+      if (m_cfg.recordStatistics) { statistics[it].tracks = 1; }
+      return;
     }
-    // Record the propagator steps
-    propagationSteps.push_back(std::move(pOutput.first));
-    if (m_cfg.recordMaterialInteractions
-        && pOutput.second.materialInteractions.size()) {
+
+    // execute the test and record the steps into the slot of this test
+    PropagationStatistics unused;
+    PropagationStatistics& testStatistics
+        = m_cfg.recordStatistics ? statistics[it] : unused;
+    auto propagate = [&](auto& stepSlots) {
+      using step_type =
+          typename std::decay_t<decltype(stepSlots)>::value_type::value_type;
+      PropagationOutputT<step_type> pOutput;
+      if (charge) {
+        // charged extrapolation - with hit recording
+        Acts::BoundParameters startParameters(
+            context.geoContext, std::move(cov), std::move(pars), surface);
+        sPosition = startParameters.position();
+        sMomentum = startParameters.momentum();
+        pOutput   = executeTest<Acts::TrackParameters, step_type>(
+            context, startParameters, testStatistics);
+      } else {
+        // execute the test for neeutral particles
+        Acts::NeutralBoundParameters neutralParameters(
+            context.geoContext, std::move(cov), std::move(pars), surface);
+        sPosition = neutralParameters.position();
+        sMomentum = neutralParameters.momentum();
+        pOutput   = executeTest<Acts::NeutralParameters, step_type>(
+            context, neutralParameters, testStatistics);
+      }
+      // Record the propagator steps
+      stepSlots[it] = std::move(pOutput.first);
+      return std::move(pOutput.second);
+    };
+    RecordedMaterial material = m_cfg.compactSteps
+        ? propagate(compactSteps)
+        : propagate(propagationSteps);
+
+    if (m_cfg.recordMaterialInteractions) {
       // Create a recorded material track
-      RecordedMaterialTrack rmTrack;
+      RecordedMaterialTrack& rmTrack = recordedMaterial[it];
       // Start position
       rmTrack.first.first = std::move(sPosition);
       // Start momentum
       rmTrack.first.second = std::move(sMomentum);
       // The material
-      rmTrack.second = std::move(pOutput.second);
-      // push it it
-      recordedMaterial.push_back(std::move(rmTrack));
+      rmTrack.second = std::move(material);
+    }
+  };
+
+  // loop over number of particles
+  auto start = std::chrono::steady_clock::now();
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, m_cfg.ntests),
+                    [&](const tbb::blocked_range<size_t>& r) {
+                      for (size_t it = r.begin(); it != r.end(); ++it) {
+                        runTest(it);
+                      }
+                    });
+  // propagate the stored tests together; each range is split into blocks
+  std::vector<RecordedMaterial> materials;
+  if (m_cfg.straightLineBundle) {
+    materials.resize(m_cfg.ntests);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_cfg.ntests),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        m_cfg.straightLineBundle->propagate(context.geoContext,
+                                                            bundle,
+                                                            r.begin(),
+                                                            r.end(),
+                                                            materials.data());
+                      });
+    if (m_cfg.recordMaterialInteractions) {
+      for (size_t it = 0; it < m_cfg.ntests; ++it) {
+        recordedMaterial[it].second = std::move(materials[it]);
+      }
     }
   }
+  auto stop = std::chrono::steady_clock::now();
+
+  // check the bundle propagation; not included in the propagation time
+  if (0 < numChecks) {
+    std::vector<RecordedMaterial> references(numChecks);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, numChecks),
+        [&](const tbb::blocked_range<size_t>& r) {
+          for (size_t it = r.begin(); it != r.end(); ++it) {
+            PropagationStatistics unused;
+            references[it]
+                = executeTest<Acts::NeutralParameters, Acts::detail::Step>(
+                      context, *checkStarts[it], unused)
+                      .second;
+          }
+        });
+    auto differs = [&](double reference, double value) {
+      return (m_cfg.straightLineBundleTolerance * std::abs(reference))
+          < std::abs(value - reference);
+    };
+    size_t numFailed = 0;
+    for (size_t it = 0; it < numChecks; ++it) {
+      const auto& reference = references[it];
+      const auto& material  = m_cfg.recordMaterialInteractions
+          ? recordedMaterial[it].second
+          : materials[it];
+      if (differs(reference.materialInX0, material.materialInX0)
+          or differs(reference.materialInL0, material.materialInL0)) {
+        ACTS_ERROR("Bundle propagation of test "
+                   << it << " finds " << material.materialInX0 << " X0 and "
+                   << material.materialInL0 << " L0 instead of "
+                   << reference.materialInX0 << " X0 and "
+                   << reference.materialInL0 << " L0");
+        ++numFailed;
+      }
+    }
+    if (0 < numFailed) {
+      ACTS_ERROR(numFailed << " of " << numChecks
+                           << " checked bundle propagations differ");
+      return ProcessCode::ABORT;
+    }
+    ACTS_DEBUG("Checked " << numChecks << " bundle propagations");
+  }
 
   // Write the propagation step data to the event store
-  context.eventStore.add(m_cfg.propagationStepCollection,
-                         std::move(propagationSteps));
+  if (m_cfg.compactSteps) {
+    context.eventStore.add(m_cfg.propagationStepCollection,
+                           std::move(compactSteps));
+  } else {
+    context.eventStore.add(m_cfg.propagationStepCollection,
+                           std::move(propagationSteps));
+  }
 
   // Write the recorded material to the event store
   if (m_cfg.recordMaterialInteractions) {
+    // only keep tracks with material, in test order
+    recordedMaterial.erase(
+        std::remove_if(recordedMaterial.begin(),
+                       recordedMaterial.end(),
+                       [](const RecordedMaterialTrack& rmTrack) {
+                         return rmTrack.second.materialInteractions.empty();
+                       }),
+        recordedMaterial.end());
     context.eventStore.add(m_cfg.propagationMaterialCollection,
                            std::move(recordedMaterial));
   }
 
+  // Write the summed counters and the propagation time to the event store
+  if (m_cfg.recordStatistics) {
+    PropagationStatistics eventStatistics;
+    for (const auto& testStatistics : statistics) {
+      eventStatistics += testStatistics;
+    }
+    eventStatistics.seconds
+        = std::chrono::duration<double>(stop - start).count();
+    ACTS_DEBUG("Propagated " << eventStatistics.tracks << " tracks with "
+                             << eventStatistics.steps << " steps in "
+                             << eventStatistics.seconds << " s");
+    context.eventStore.add(m_cfg.propagationStatisticsCollection,
+                           std::move(eventStatistics));
+  }
+
   return ProcessCode::SUCCESS;
 }
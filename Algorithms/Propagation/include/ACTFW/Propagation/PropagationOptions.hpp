@@ -9,6 +9,8 @@
 #pragma once
 
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include "ACTFW/Utilities/Options.hpp"
 #include "Acts/Utilities/Logger.hpp"
 #include "Acts/Utilities/Units.hpp"
@@ -35,6 +37,18 @@ namespace Options {
         "prop-step-collection",
         po::value<std::string>()->default_value("propagation-steps"),
         "Propgation step collection.")(
+        "prop-step-selection",
+        po::value<int>()->default_value(0),
+        "Recorded steps: 0 (all), 1 (on surfaces), 2 (with material).")(
+        "prop-step-sampling",
+        po::value<size_t>()->default_value(1),
+        "Record only every n-th of the selected steps.")(
+        "prop-step-compact",
+        po::value<bool>()->default_value(false),
+        "Record compact steps instead of the full Acts steps.")(
+        "prop-statistics",
+        po::value<bool>()->default_value(false),
+        "Count steps, navigation candidates, and field cache misses.")(
         "prop-stepper",
         po::value<int>()->default_value(1),
         "Propgation type: 0 (StraightLine), 1 (Eigen), 2 (Atlas).")(
@@ -147,6 +161,16 @@ namespace Options {
 
     pAlgConfig.propagationStepCollection
         = vm["prop-step-collection"].template as<std::string>();
+    auto stepSelection = vm["prop-step-selection"].template as<int>();
+    if ((stepSelection < static_cast<int>(FW::StepSelection::All))
+        or (static_cast<int>(FW::StepSelection::Material) < stepSelection)) {
+      throw std::invalid_argument("Unknown step selection "
+                                  + std::to_string(stepSelection));
+    }
+    pAlgConfig.stepSelection = FW::StepSelection(stepSelection);
+    pAlgConfig.stepSampling = vm["prop-step-sampling"].template as<size_t>();
+    pAlgConfig.compactSteps = vm["prop-step-compact"].template as<bool>();
+    pAlgConfig.recordStatistics = vm["prop-statistics"].template as<bool>();
     pAlgConfig.propagationMaterialCollection
         = vm["prop-material-collection"].template as<std::string>();
 
@@ -0,0 +1,259 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Acts/Geometry/TrackingVolume.hpp"
+#include "Acts/Propagator/ConstrainedStep.hpp"
+#include "Acts/Utilities/Definitions.hpp"
+
+namespace FW {
+
+/// Which step size constraint limited a step.
+enum class StepType {
+  Actor    = 0,
+  Accuracy = 1,
+  Aborter  = 2,
+  User     = 3,
+};
+
+/// Classify a step by its smallest step size constraint.
+///
+/// Ties are resolved in favour of the later constraint in the order actor,
+/// accuracy, aborter, user.
+inline StepType
+stepType(double accuracy, double actor, double aborter, double user)
+{
+  double acc2 = accuracy * accuracy;
+  double act2 = actor * actor;
+  double abo2 = aborter * aborter;
+  double usr2 = user * user;
+  if (act2 < acc2 && act2 < abo2 && act2 < usr2) {
+    return StepType::Actor;
+  } else if (acc2 < abo2 && acc2 < usr2) {
+    return StepType::Accuracy;
+  } else if (abo2 < usr2) {
+    return StepType::Aborter;
+  }
+  return StepType::User;
+}
+
+/// Counters describing the work done by the propagation.
+///
+/// Filled per track by the `PropagationStatisticsActor` and summed up per
+/// event by the propagation algorithm.
+struct PropagationStatistics
+{
+  /// number of propagated tracks
+  size_t tracks = 0;
+  /// tracks propagated with loop protection
+  size_t loopProtected = 0;
+  /// number of steps, and split by the limiting step size constraint
+  size_t steps         = 0;
+  size_t stepsActor    = 0;
+  size_t stepsAccuracy = 0;
+  size_t stepsAborter  = 0;
+  size_t stepsUser     = 0;
+  /// navigation candidates, i.e. surfaces, layers, and boundaries, listed
+  /// by the navigator whenever it resolves new candidates. Candidates that
+  /// are tested but found unreachable by the navigator are not included.
+  size_t candidatesListed = 0;
+  /// steps that ended on a surface
+  size_t surfacesReached = 0;
+  /// transitions into a different tracking volume
+  size_t volumesCrossed = 0;
+  /// steps after which the field cache holds a different field cell; a
+  /// lower bound of the field cache misses within the stepper
+  size_t fieldCacheMisses = 0;
+  /// wall clock time in seconds; only set for the event sum
+  double seconds = 0.;
+
+  PropagationStatistics&
+  operator+=(const PropagationStatistics& other)
+  {
+    tracks += other.tracks;
+    loopProtected += other.loopProtected;
+    steps += other.steps;
+    stepsActor += other.stepsActor;
+    stepsAccuracy += other.stepsAccuracy;
+    stepsAborter += other.stepsAborter;
+    stepsUser += other.stepsUser;
+    candidatesListed += other.candidatesListed;
+    surfacesReached += other.surfacesReached;
+    volumesCrossed += other.volumesCrossed;
+    fieldCacheMisses += other.fieldCacheMisses;
+    seconds += other.seconds;
+    return *this;
+  }
+};
+
+namespace detail {
+  /// The field cell lookup of a field cache that holds the last cell.
+  template <typename cache_t>
+  using FieldCellLookup = decltype(
+      std::declval<cache_t&>().initialized,
+      std::declval<cache_t&>().fieldCell->isInside(
+          std::declval<Acts::Vector3D>()));
+
+  /// Detect stepper states with a field cache that holds the last cell.
+  template <typename stepping_t, typename = void>
+  struct HasFieldCell : std::false_type
+  {
+  };
+  template <typename stepping_t>
+  struct HasFieldCell<stepping_t,
+                      std::void_t<FieldCellLookup<decltype(
+                          std::declval<stepping_t&>().fieldCache)>>>
+    : std::true_type
+  {
+  };
+}  // namespace detail
+
+/// Actor that counts steps, navigation candidates, and field cache misses.
+///
+/// All counters are observed from the propagator state after each step, so
+/// the actor does not change the propagation.
+struct PropagationStatisticsActor
+{
+  /// A navigation candidate list and the navigator position within it
+  struct CandidatesState
+  {
+    const void* data  = nullptr;
+    size_t      size  = 0;
+    size_t      index = 0;
+  };
+
+  /// The counters and the state needed to detect changes between steps
+  struct this_result
+  {
+    PropagationStatistics       statistics;
+    CandidatesState             lastSurfaces;
+    CandidatesState             lastLayers;
+    CandidatesState             lastBoundaries;
+    const Acts::TrackingVolume* lastVolume = nullptr;
+    Acts::Vector3D              lastPosition   = Acts::Vector3D::Zero();
+    bool                        hasLastCell    = false;
+  };
+
+  using result_type = this_result;
+
+  /// Do not count anything
+  bool sterile = false;
+
+  /// Count the last step
+  ///
+  /// @param state The propagator state
+  /// @param stepper The stepper in use
+  /// @param result The counters of this propagation
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  operator()(propagator_state_t& state,
+             const stepper_t&    stepper,
+             result_type&        result) const
+  {
+    if (sterile) { return; }
+
+    auto&       stats      = result.statistics;
+    const auto& navigation = state.navigation;
+    const auto& stepSize   = state.stepping.stepSize;
+
+    // the actor is called once before the first step
+    if (0 < state.stepping.pathAccumulated) {
+      ++stats.steps;
+      switch (stepType(stepSize.value(Acts::ConstrainedStep::accuracy),
+                       stepSize.value(Acts::ConstrainedStep::actor),
+                       stepSize.value(Acts::ConstrainedStep::aborter),
+                       stepSize.value(Acts::ConstrainedStep::user))) {
+      case StepType::Actor:
+        ++stats.stepsActor;
+        break;
+      case StepType::Accuracy:
+        ++stats.stepsAccuracy;
+        break;
+      case StepType::Aborter:
+        ++stats.stepsAborter;
+        break;
+      case StepType::User:
+        ++stats.stepsUser;
+        break;
+      }
+    }
+
+    countCandidates(navigation.navSurfaces,
+                    navigation.navSurfaceIter,
+                    result.lastSurfaces,
+                    stats);
+    countCandidates(
+        navigation.navLayers, navigation.navLayerIter, result.lastLayers, stats);
+    countCandidates(navigation.navBoundaries,
+                    navigation.navBoundaryIter,
+                    result.lastBoundaries,
+                    stats);
+    if (navigation.currentSurface) { ++stats.surfacesReached; }
+    if (navigation.currentVolume
+        and (navigation.currentVolume != result.lastVolume)) {
+      if (result.lastVolume) { ++stats.volumesCrossed; }
+      result.lastVolume = navigation.currentVolume;
+    }
+
+    using stepping_t = std::decay_t<decltype(state.stepping)>;
+    if constexpr (detail::HasFieldCell<stepping_t>::value) {
+      const auto& cache = state.stepping.fieldCache;
+      if (cache.initialized) {
+        // the first cell is always a miss; afterwards the cell has changed
+        // if it does not contain the previous position anymore
+        if (not result.hasLastCell
+            or not cache.fieldCell->isInside(result.lastPosition)) {
+          ++stats.fieldCacheMisses;
+        }
+        result.hasLastCell = true;
+      }
+    }
+    result.lastPosition = stepper.position(state.stepping);
+  }
+
+  /// Pure observer interface
+  /// - this does not apply to the counter
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  operator()(propagator_state_t& /*unused*/,
+             const stepper_t& /*unused*/) const
+  {
+  }
+
+private:
+  /// Count the candidates if the navigator resolved a new list.
+  ///
+  /// A new list replaces the previous candidates and the navigator restarts
+  /// at its first candidate. The allocator can reuse the previous storage,
+  /// so a list is also new if the position moved backwards.
+  template <typename candidates_t, typename iterator_t>
+  static void
+  countCandidates(const candidates_t&    candidates,
+                  const iterator_t&      position,
+                  CandidatesState&       last,
+                  PropagationStatistics& stats)
+  {
+    CandidatesState current;
+    current.data  = candidates.data();
+    current.size  = candidates.size();
+    current.index = position - candidates.begin();
+    if (not candidates.empty()
+        and ((current.data != last.data) or (current.size != last.size)
+             or (current.index < last.index))) {
+      stats.candidatesListed += current.size;
+    }
+    last = current;
+  }
+};
+
+}  // namespace FW
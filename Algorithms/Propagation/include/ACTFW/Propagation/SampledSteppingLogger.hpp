@@ -0,0 +1,158 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Acts/Geometry/GeometryID.hpp"
+#include "Acts/Geometry/TrackingVolume.hpp"
+#include "Acts/Propagator/ConstrainedStep.hpp"
+#include "Acts/Propagator/detail/SteppingLogger.hpp"
+#include "Acts/Surfaces/Surface.hpp"
+#include "Acts/Utilities/Definitions.hpp"
+
+namespace FW {
+
+/// Compact record of a single propagation step.
+///
+/// Contains the information used for stepping validation in less than half
+/// the memory of `Acts::detail::Step`: single precision kinematics, the
+/// surface identifier instead of a shared surface pointer, and the plain
+/// step size constraints instead of the `Acts::ConstrainedStep`.
+struct CompactStep
+{
+  Acts::Vector3F position;   ///< global position
+  Acts::Vector3F direction;  ///< global direction
+  /// identifier of the current surface; zero if not on a surface
+  Acts::GeometryID geoId;
+  /// volume identifier of the current volume; zero if unknown
+  Acts::GeometryID::Value volumeId = 0;
+  float                   accuracy = 0;  ///< accuracy step constraint
+  float                   actor    = 0;  ///< actor step constraint
+  float                   aborter  = 0;  ///< aborter step constraint
+  float                   user     = 0;  ///< user step constraint
+};
+
+namespace detail {
+  /// Narrow a step size constraint to single precision.
+  ///
+  /// Unset constraints are stored as the largest double value, which would
+  /// overflow to infinity, and are thus clamped to the largest float value.
+  inline float
+  narrowStepSize(double value)
+  {
+    constexpr double kMax = std::numeric_limits<float>::max();
+    return static_cast<float>(std::clamp(value, -kMax, kMax));
+  }
+}  // namespace detail
+
+/// Which propagation steps are considered for recording.
+enum class StepSelection {
+  All      = 0,  ///< all steps
+  Surfaces = 1,  ///< steps that end on a surface
+  Material = 2,  ///< steps on a surface or in a volume with material
+};
+
+/// Stepping logger that only records a sample of the steps.
+///
+/// Steps are first selected by their type and only every n-th selected step
+/// is recorded. Steps are recorded directly in the output format, i.e. either
+/// as full `Acts::detail::Step` or as `CompactStep`, so no intermediate
+/// step collection is created.
+///
+/// @tparam step_t Recorded step type
+template <typename step_t>
+struct SampledSteppingLogger
+{
+  static_assert(std::is_same_v<step_t, Acts::detail::Step>
+                    or std::is_same_v<step_t, CompactStep>,
+                "Unsupported step type");
+
+  /// Recorded steps and the number of selected steps
+  struct this_result
+  {
+    std::vector<step_t> steps;
+    size_t              selected = 0;
+  };
+
+  using result_type = this_result;
+
+  /// Do not record anything
+  bool sterile = false;
+  /// Which steps are considered
+  StepSelection selection = StepSelection::All;
+  /// Record every n-th selected step, starting with the first one
+  size_t sampling = 1;
+
+  /// Record the current step if it is selected and sampled
+  ///
+  /// @param state The propagator state
+  /// @param stepper The stepper in use
+  /// @param result The recorded steps
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  operator()(propagator_state_t& state,
+             const stepper_t&    stepper,
+             result_type&        result) const
+  {
+    // don't log if you have reached the target
+    if (sterile or state.navigation.targetReached) { return; }
+
+    const Acts::Surface*        surface = state.navigation.currentSurface;
+    const Acts::TrackingVolume* volume  = state.navigation.currentVolume;
+    if ((selection == StepSelection::Surfaces) and (surface == nullptr)) {
+      return;
+    }
+    if ((selection == StepSelection::Material)
+        and not((surface and surface->surfaceMaterial())
+                or (volume and volume->volumeMaterial()))) {
+      return;
+    }
+    if ((result.selected++ % sampling) != 0) { return; }
+
+    step_t step;
+    if constexpr (std::is_same_v<step_t, CompactStep>) {
+      step.position  = stepper.position(state.stepping).template cast<float>();
+      step.direction = stepper.direction(state.stepping).template cast<float>();
+      if (surface) { step.geoId = surface->geoID(); }
+      if (volume) { step.volumeId = volume->geoID().volume(); }
+      const auto& stepSize   = state.stepping.stepSize;
+      auto        constraint = [&](auto type) {
+        return detail::narrowStepSize(stepSize.value(type));
+      };
+      step.accuracy = constraint(Acts::ConstrainedStep::accuracy);
+      step.actor    = constraint(Acts::ConstrainedStep::actor);
+      step.aborter  = constraint(Acts::ConstrainedStep::aborter);
+      step.user     = constraint(Acts::ConstrainedStep::user);
+    } else {
+      step.stepSize = state.stepping.stepSize;
+      step.position = stepper.position(state.stepping);
+      step.momentum = stepper.momentum(state.stepping)
+          * stepper.direction(state.stepping);
+      if (surface) { step.surface = surface->getSharedPtr(); }
+      step.volume = volume;
+    }
+    result.steps.push_back(std::move(step));
+  }
+
+  /// Pure observer interface
+  /// - this does not apply to the logger
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  operator()(propagator_state_t& /*unused*/,
+             const stepper_t& /*unused*/) const
+  {
+  }
+};
+
+}  // namespace FW
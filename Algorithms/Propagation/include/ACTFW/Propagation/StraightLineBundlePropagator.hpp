@@ -0,0 +1,175 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Acts/Geometry/GeometryContext.hpp"
+#include "Acts/Geometry/Layer.hpp"
+#include "Acts/Geometry/TrackingGeometry.hpp"
+#include "Acts/Geometry/TrackingVolume.hpp"
+#include "Acts/Propagator/MaterialInteractor.hpp"
+#include "Acts/Surfaces/Surface.hpp"
+#include "Acts/Utilities/Definitions.hpp"
+
+namespace FW {
+
+/// A bundle of straight tracks in structure-of-arrays layout.
+struct StraightLineBundle
+{
+  std::vector<double> x, y, z;     ///< start positions
+  std::vector<double> dx, dy, dz;  ///< unit directions
+
+  StraightLineBundle(size_t size = 0)
+    : x(size), y(size), z(size), dx(size), dy(size), dz(size)
+  {
+  }
+
+  size_t
+  size() const
+  {
+    return x.size();
+  }
+
+  /// Set the start position and direction of one track
+  ///
+  /// @param i the track index
+  /// @param position the start position
+  /// @param direction the direction, will be normalized
+  void
+  set(size_t i, const Acts::Vector3D& position, const Acts::Vector3D& direction)
+  {
+    Acts::Vector3D unit = direction.normalized();
+    x[i]                = position.x();
+    y[i]                = position.y();
+    z[i]                = position.z();
+    dx[i]               = unit.x();
+    dy[i]               = unit.y();
+    dz[i]               = unit.z();
+  }
+};
+
+/// Propagate bundles of straight tracks through the material of a geometry.
+///
+/// All straight tracks of a bundle are intersected with the same sequence of
+/// layers and material surfaces at once. The layer and boundary surfaces of
+/// the detector are, apart from a few exceptions, cylinders and discs around
+/// the beam axis. Their intersections are computed in loops over the tracks
+/// without branches, which the compiler vectorizes. Only candidate
+/// intersections are checked against the exact surface bounds and only for
+/// layers that are hit the sensitive surfaces are looked up.
+///
+/// The result for each track is the same material record that the
+/// `Acts::MaterialInteractor` creates during a straight line propagation,
+/// without multiple scattering or energy loss. The tracks start at a free
+/// position and have no target surface. All crossed surfaces, including
+/// approach and boundary surfaces, are thus a full update in the forward
+/// direction and their material is scaled with the corresponding surface
+/// material factor. Volume material is not considered.
+///
+/// The surface placements are cached on construction, i.e. the geometry
+/// context must not change afterwards.
+class StraightLineBundlePropagator
+{
+public:
+  using RecordedMaterial = Acts::MaterialInteractor::result_type;
+
+  /// @param tGeometry the tracking geometry
+  /// @param geoContext the geometry context used to place the surfaces
+  StraightLineBundlePropagator(
+      std::shared_ptr<const Acts::TrackingGeometry> tGeometry,
+      const Acts::GeometryContext& geoContext = Acts::GeometryContext());
+
+  /// Propagate a range of tracks of a bundle
+  ///
+  /// @param geoContext the geometry context, must match the one used on
+  ///                   construction
+  /// @param bundle the start positions and directions
+  /// @param begin the first track to propagate
+  /// @param end one past the last track to propagate
+  /// @param [out] materials one record per track, indexed as the bundle
+  void
+  propagate(const Acts::GeometryContext& geoContext,
+            const StraightLineBundle&    bundle,
+            size_t                       begin,
+            size_t                       end,
+            RecordedMaterial*            materials) const;
+
+  /// Number of cylinders, discs, and other surfaces that are intersected
+  size_t
+  numCylinders() const
+  {
+    return m_cylinders.surfaces.size();
+  }
+  size_t
+  numDiscs() const
+  {
+    return m_discs.surfaces.size();
+  }
+  size_t
+  numOthers() const
+  {
+    return m_others.size();
+  }
+
+private:
+  /// Surface that is intersected for all tracks.
+  ///
+  /// Either the surface itself carries material, or it is the representing
+  /// surface of a layer whose sensitive surfaces carry material, or both.
+  struct Target
+  {
+    const Acts::Surface* surface     = nullptr;
+    const Acts::Layer*   layer       = nullptr;
+    bool                 hasMaterial = false;
+  };
+
+  /// Cylinders around the beam axis
+  struct Cylinders
+  {
+    std::vector<double> r2, zMin, zMax;
+    std::vector<Target> surfaces;
+  };
+
+  /// Discs perpendicular to the beam axis
+  struct Discs
+  {
+    std::vector<double> z, r2Min, r2Max;
+    std::vector<Target> surfaces;
+  };
+
+  /// Candidate crossing of a track with a target
+  struct Crossing
+  {
+    double        pathLength;
+    const Target* target;
+  };
+
+  /// Collect the targets from a volume and its sub-volumes
+  void
+  collect(const Acts::GeometryContext& geoContext,
+          const Acts::TrackingVolume&  volume,
+          std::vector<const Acts::Surface*>& visited);
+
+  /// Add a target to the cylinders, discs, or other surfaces
+  void
+  add(const Acts::GeometryContext& geoContext, const Target& target);
+
+  /// Keeps the surfaces alive
+  std::shared_ptr<const Acts::TrackingGeometry> m_tGeometry;
+  Cylinders                                     m_cylinders;
+  Discs                                         m_discs;
+  std::vector<Target>                           m_others;
+};
+
+}  // namespace FW
+
+#include "StraightLineBundlePropagator.ipp"
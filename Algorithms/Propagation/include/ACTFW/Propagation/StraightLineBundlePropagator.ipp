@@ -0,0 +1,311 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Acts/Surfaces/CylinderBounds.hpp"
+#include "Acts/Surfaces/RadialBounds.hpp"
+
+namespace FW {
+namespace detail {
+  /// Tolerance to identify surfaces around and along the beam axis
+  constexpr double kBeamAxisTolerance = 1e-6;
+  /// Number of tracks that are intersected at once
+  constexpr size_t kBundleBlock = 256;
+}  // namespace detail
+}  // namespace FW
+
+inline FW::StraightLineBundlePropagator::StraightLineBundlePropagator(
+    std::shared_ptr<const Acts::TrackingGeometry> tGeometry,
+    const Acts::GeometryContext&                  geoContext)
+  : m_tGeometry(std::move(tGeometry))
+{
+  if (not m_tGeometry) {
+    throw std::invalid_argument("Missing tracking geometry");
+  }
+  std::vector<const Acts::Surface*> visited;
+  collect(geoContext, *m_tGeometry->highestTrackingVolume(), visited);
+}
+
+inline void
+FW::StraightLineBundlePropagator::collect(
+    const Acts::GeometryContext&       geoContext,
+    const Acts::TrackingVolume&        volume,
+    std::vector<const Acts::Surface*>& visited)
+{
+  // surfaces are shared between volumes, e.g. glued boundaries
+  auto addSurface = [&](const Acts::Surface& surface,
+                        const Acts::Layer*   layer) {
+    bool hasMaterial = (surface.surfaceMaterial() != nullptr);
+    if ((not hasMaterial and not layer)
+        or std::find(visited.begin(), visited.end(), &surface)
+            != visited.end()) {
+      return;
+    }
+    visited.push_back(&surface);
+    add(geoContext, Target{&surface, layer, hasMaterial});
+  };
+
+  if (volume.confinedLayers()) {
+    for (const auto& layer : volume.confinedLayers()->arrayObjects()) {
+      // navigation layers neither have material nor sensitive surfaces
+      if (layer->layerType() == Acts::navigation) { continue; }
+      // the sensitive surfaces are only looked up if they have material
+      const Acts::Layer* sensitiveLayer = nullptr;
+      if (layer->surfaceArray()) {
+        for (const auto* sensitive : layer->surfaceArray()->surfaces()) {
+          if (sensitive and sensitive->surfaceMaterial()) {
+            sensitiveLayer = layer.get();
+            break;
+          }
+        }
+      }
+      addSurface(layer->surfaceRepresentation(), sensitiveLayer);
+      if (layer->approachDescriptor()) {
+        for (const auto* approach :
+             layer->approachDescriptor()->containedSurfaces()) {
+          addSurface(*approach, nullptr);
+        }
+      }
+    }
+  }
+  for (const auto& boundary : volume.boundarySurfaces()) {
+    addSurface(boundary->surfaceRepresentation(), nullptr);
+  }
+  if (volume.confinedVolumes()) {
+    for (const auto& confined : volume.confinedVolumes()->arrayObjects()) {
+      collect(geoContext, *confined, visited);
+    }
+  }
+}
+
+inline void
+FW::StraightLineBundlePropagator::add(const Acts::GeometryContext& geoContext,
+                                      const Target&                target)
+{
+  const Acts::Surface& surface   = *target.surface;
+  const auto&          transform = surface.transform(geoContext);
+  Acts::Vector3D       center    = transform.translation();
+  Acts::Vector3D       axis      = transform.rotation().col(2);
+  bool onBeamAxis = (std::abs(center.x()) < detail::kBeamAxisTolerance)
+      and (std::abs(center.y()) < detail::kBeamAxisTolerance)
+      and ((1. - std::abs(axis.z())) < detail::kBeamAxisTolerance);
+
+  if (onBeamAxis and (surface.type() == Acts::Surface::Cylinder)) {
+    const auto* bounds
+        = dynamic_cast<const Acts::CylinderBounds*>(&surface.bounds());
+    if (bounds) {
+      m_cylinders.r2.push_back(bounds->r() * bounds->r());
+      m_cylinders.zMin.push_back(center.z() - bounds->halflengthZ());
+      m_cylinders.zMax.push_back(center.z() + bounds->halflengthZ());
+      m_cylinders.surfaces.push_back(target);
+      return;
+    }
+  }
+  if (onBeamAxis and (surface.type() == Acts::Surface::Disc)) {
+    const auto* bounds
+        = dynamic_cast<const Acts::RadialBounds*>(&surface.bounds());
+    if (bounds) {
+      m_discs.z.push_back(center.z());
+      m_discs.r2Min.push_back(bounds->rMin() * bounds->rMin());
+      m_discs.r2Max.push_back(bounds->rMax() * bounds->rMax());
+      m_discs.surfaces.push_back(target);
+      return;
+    }
+  }
+  // everything else is intersected one track at a time
+  m_others.push_back(target);
+}
+
+inline void
+FW::StraightLineBundlePropagator::propagate(
+    const Acts::GeometryContext& geoContext,
+    const StraightLineBundle&    bundle,
+    size_t                       begin,
+    size_t                       end,
+    RecordedMaterial*            materials) const
+{
+  using detail::kBundleBlock;
+
+  /// Surface with material that is crossed by a track
+  struct Hit
+  {
+    double               pathLength;
+    const Acts::Surface* surface;
+  };
+
+  // candidate path lengths of all tracks in a block; negative if missed
+  double                             sNear[kBundleBlock];
+  double                             sFar[kBundleBlock];
+  std::vector<std::vector<Crossing>> crossings(kBundleBlock);
+  std::vector<Hit>                   hits;
+
+  for (size_t first = begin; first < end; first += kBundleBlock) {
+    size_t num = std::min(kBundleBlock, end - first);
+    for (size_t j = 0; j < num; ++j) { crossings[j].clear(); }
+
+    const double* x  = bundle.x.data() + first;
+    const double* y  = bundle.y.data() + first;
+    const double* z  = bundle.z.data() + first;
+    const double* dx = bundle.dx.data() + first;
+    const double* dy = bundle.dy.data() + first;
+    const double* dz = bundle.dz.data() + first;
+
+    // cylinders: up to two crossings, e.g. when starting outside
+    for (size_t ic = 0; ic < m_cylinders.surfaces.size(); ++ic) {
+      double r2   = m_cylinders.r2[ic];
+      double zMin = m_cylinders.zMin[ic];
+      double zMax = m_cylinders.zMax[ic];
+      // the discriminant is stored first, so that the square root is taken
+      // for the whole block at once without the checks of std::sqrt
+      for (size_t j = 0; j < num; ++j) {
+        double a    = dx[j] * dx[j] + dy[j] * dy[j];
+        double b    = x[j] * dx[j] + y[j] * dy[j];
+        double c    = x[j] * x[j] + y[j] * y[j] - r2;
+        double disc = b * b - a * c;
+        sNear[j]    = disc;
+        sFar[j]     = std::max(disc, 0.);
+      }
+      Eigen::Map<Eigen::ArrayXd> sqrtDisc(sFar, num);
+      sqrtDisc = sqrtDisc.sqrt();
+      // masks are combined without short-circuit to keep the loop branch-free
+      for (size_t j = 0; j < num; ++j) {
+        double a  = dx[j] * dx[j] + dy[j] * dy[j];
+        double b  = x[j] * dx[j] + y[j] * dy[j];
+        bool   ok = (0. < sNear[j]);
+        // tracks parallel to the axis give non-finite values and are missed
+        double s1 = (-b - sFar[j]) / a;
+        double s2 = (-b + sFar[j]) / a;
+        double z1 = z[j] + s1 * dz[j];
+        double z2 = z[j] + s2 * dz[j];
+        bool hit1 = ok & (0. < s1) & (zMin <= z1) & (z1 <= zMax);
+        bool hit2 = ok & (0. < s2) & (zMin <= z2) & (z2 <= zMax);
+        sNear[j]  = hit1 ? s1 : -1.;
+        sFar[j]   = hit2 ? s2 : -1.;
+      }
+      for (size_t j = 0; j < num; ++j) {
+        if (0. < sNear[j]) {
+          crossings[j].push_back({sNear[j], &m_cylinders.surfaces[ic]});
+        }
+        if (0. < sFar[j]) {
+          crossings[j].push_back({sFar[j], &m_cylinders.surfaces[ic]});
+        }
+      }
+    }
+
+    // discs: at most one crossing
+    for (size_t id = 0; id < m_discs.surfaces.size(); ++id) {
+      double zDisc = m_discs.z[id];
+      double r2Min = m_discs.r2Min[id];
+      double r2Max = m_discs.r2Max[id];
+      for (size_t j = 0; j < num; ++j) {
+        // tracks parallel to the disc give non-finite values and are missed
+        double s  = (zDisc - z[j]) / dz[j];
+        double hx = x[j] + s * dx[j];
+        double hy = y[j] + s * dy[j];
+        double r2 = hx * hx + hy * hy;
+        bool hit = (0. < s) & (r2Min <= r2) & (r2 <= r2Max);
+        sNear[j] = hit ? s : -1.;
+      }
+      for (size_t j = 0; j < num; ++j) {
+        if (0. < sNear[j]) {
+          crossings[j].push_back({sNear[j], &m_discs.surfaces[id]});
+        }
+      }
+    }
+
+    for (size_t j = 0; j < num; ++j) {
+      Acts::Vector3D origin(x[j], y[j], z[j]);
+      Acts::Vector3D direction(dx[j], dy[j], dz[j]);
+
+      // all remaining surfaces are intersected directly
+      for (const auto& target : m_others) {
+        auto intersection = target.surface->intersectionEstimate(
+            geoContext, origin, direction, true);
+        if (intersection and (0. < intersection.pathLength)) {
+          crossings[j].push_back({intersection.pathLength, &target});
+        }
+      }
+
+      // check the candidates against the full bounds and collect the
+      // surfaces with material, including the sensitive ones of a layer
+      hits.clear();
+      for (const auto& crossing : crossings[j]) {
+        const Target&  target   = *crossing.target;
+        Acts::Vector3D position = origin + crossing.pathLength * direction;
+        if (not target.surface->isOnSurface(
+                geoContext, position, direction, true)) {
+          continue;
+        }
+        if (target.hasMaterial) {
+          hits.push_back({crossing.pathLength, target.surface});
+        }
+        if (target.layer) {
+          for (const auto* sensitive :
+               target.layer->surfaceArray()->neighbors(position)) {
+            if (not sensitive or not sensitive->surfaceMaterial()) {
+              continue;
+            }
+            auto intersection = sensitive->intersectionEstimate(
+                geoContext, origin, direction, true);
+            if (intersection and (0. < intersection.pathLength)) {
+              hits.push_back({intersection.pathLength, sensitive});
+            }
+          }
+        }
+      }
+      std::sort(hits.begin(), hits.end(), [](const Hit& lhs, const Hit& rhs) {
+        return lhs.pathLength < rhs.pathLength;
+      });
+      // a layer crossed twice may find the same sensitive surface twice
+      hits.erase(std::unique(hits.begin(),
+                             hits.end(),
+                             [](const Hit& lhs, const Hit& rhs) {
+                               return lhs.surface == rhs.surface;
+                             }),
+                 hits.end());
+
+      // record the material in the same way as the material interactor.
+      // tracks start at a free position, i.e. there is neither a start nor a
+      // target surface and every crossing is a full update along the track.
+      RecordedMaterial material;
+      material.materialInteractions.reserve(hits.size());
+      for (const auto& hit : hits) {
+        Acts::Vector3D position = origin + hit.pathLength * direction;
+        // scaled by the surface material factor for this update stage
+        auto properties = hit.surface->surfaceMaterial()->materialProperties(
+            position, Acts::forward, Acts::fullUpdate);
+        if (not(0. < properties.thickness())) { continue; }
+        double pathCorrection
+            = hit.surface->pathCorrection(geoContext, position, direction);
+        const auto& mat = properties.material();
+
+        Acts::MaterialInteraction mInteraction;
+        mInteraction.position           = position;
+        mInteraction.direction          = direction;
+        mInteraction.surface            = hit.surface;
+        mInteraction.pathCorrection     = pathCorrection;
+        mInteraction.materialProperties = Acts::MaterialProperties(
+            mat.X0(),
+            mat.L0(),
+            mat.Ar(),
+            mat.Z(),
+            mat.massDensity(),
+            properties.thickness() * pathCorrection);
+        material.materialInX0
+            += mInteraction.materialProperties.thicknessInX0();
+        material.materialInL0
+            += mInteraction.materialProperties.thicknessInL0();
+        material.materialInteractions.push_back(std::move(mInteraction));
+      }
+      materials[first + j] = std::move(material);
+    }
+  }
+}
@@ -0,0 +1,100 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <Acts/Utilities/Logger.hpp>
+
+#include "ACTFW/Framework/IWriter.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+
+namespace FW {
+
+/// Write events asynchronously in a dedicated writer thread.
+///
+/// This wraps any existing writer. Instead of writing directly, the calling
+/// thread only keeps the event store alive by taking shared ownership and
+/// queues the event. The writer thread drains the queue in order and runs the
+/// wrapped writer, i.e. formatting and I/O never block the event processing
+/// unless the queue is full. The end-of-run hook waits until all queued
+/// events have been written before calling the wrapped end-of-run hook.
+///
+/// @note Event stores must be owned by a `std::shared_ptr` to be queued.
+///       Events with other event stores are written synchronously.
+/// @note Errors in the writer thread are reported on the next call.
+class AsyncWriter : public IWriter
+{
+public:
+  struct Config
+  {
+    /// The wrapped writer.
+    std::shared_ptr<IWriter> writer;
+    /// Maximum number of queued events; limits the memory of retained stores.
+    size_t queueSize = 16;
+  };
+
+  AsyncWriter(const Config&        cfg,
+              Acts::Logging::Level level = Acts::Logging::INFO);
+  /// Stops the writer thread; queued events are discarded.
+  ~AsyncWriter() override;
+
+  /// Forwards the name of the wrapped writer.
+  std::string
+  name() const final override;
+
+  /// Queue the event; blocks only if the queue is full.
+  ProcessCode
+  write(const AlgorithmContext& context) final override;
+
+  /// Wait for all queued events and run the wrapped end-of-run hook.
+  ProcessCode
+  endRun() final override;
+
+private:
+  /// A queued event with its retained event store.
+  struct Job
+  {
+    AlgorithmContext                  context;
+    std::shared_ptr<const WhiteBoard> store;
+  };
+
+  /// Write queued events until the writer is stopped.
+  void
+  work();
+  /// Report errors from the writer thread; requires the lock.
+  ProcessCode
+  status() const;
+
+  Config                              m_cfg;
+  std::mutex                          m_mutex;
+  std::condition_variable             m_queued;
+  std::condition_variable             m_written;
+  std::deque<Job>                     m_queue;
+  bool                                m_busy  = false;
+  bool                                m_stop  = false;
+  ProcessCode                         m_code  = ProcessCode::SUCCESS;
+  std::exception_ptr                  m_error = nullptr;
+  std::thread                         m_worker;
+  std::unique_ptr<const Acts::Logger> m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
@@ -0,0 +1,110 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Acts/Utilities/Logger.hpp>
+
+#include "ACTFW/Framework/IReader.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+
+namespace FW {
+
+/// Read events ahead of time in dedicated I/O threads.
+///
+/// This wraps any existing reader. Whenever an event is requested, the
+/// following events within the available range of the wrapped reader are
+/// scheduled to be read by a small pool of I/O threads into separate, detached
+/// event stores. When one of these events is requested later on, the
+/// prefetched objects are moved into the event store without blocking on the
+/// underlying storage.
+///
+/// @note Prefetched events are read with default-constructed geometry,
+///       magnetic field, and calibration contexts. Readers that depend on the
+///       event context, e.g. to convert coordinates using an aligned geometry,
+///       must not be wrapped.
+/// @note Prefetched events that are never requested, e.g. beyond the number
+///       of events selected in the sequencer, are discarded.
+class PrefetchingReader : public IReader
+{
+public:
+  struct Config
+  {
+    /// The wrapped reader; must support concurrent calls.
+    std::shared_ptr<IReader> reader;
+    /// Number of dedicated I/O threads.
+    size_t numThreads = 2;
+    /// Number of events following each requested event to read ahead.
+    size_t readAhead = 4;
+  };
+
+  PrefetchingReader(const Config&        cfg,
+                    Acts::Logging::Level level = Acts::Logging::INFO);
+  /// Stops the I/O threads; outstanding prefetches are discarded.
+  ~PrefetchingReader() override;
+
+  std::string
+  name() const final override;
+
+  /// Forwards the available events range of the wrapped reader.
+  std::pair<size_t, size_t>
+  availableEvents() const final override;
+
+  /// Hand over a prefetched event or read it directly if not available.
+  ProcessCode
+  read(const AlgorithmContext& context) final override;
+
+private:
+  /// Output of a single prefetched read.
+  struct Fragment
+  {
+    ProcessCode                 code;
+    std::unique_ptr<WhiteBoard> store;
+  };
+
+  /// Schedule the events following the given event; requires the lock.
+  void
+  schedule(size_t event);
+  /// Read a single event into a detached event store.
+  Fragment
+  prefetch(size_t event);
+  /// Run queued prefetches until the reader is stopped.
+  void
+  work();
+
+  Config                                            m_cfg;
+  std::pair<size_t, size_t>                         m_eventsRange;
+  std::mutex                                        m_mutex;
+  std::condition_variable                           m_cv;
+  std::deque<std::packaged_task<Fragment()>>        m_queue;
+  std::unordered_map<size_t, std::future<Fragment>> m_pending;
+  std::unordered_set<size_t>                        m_requested;
+  bool                                              m_stop = false;
+  std::vector<std::thread>                          m_workers;
+  std::unique_ptr<const Acts::Logger>               m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
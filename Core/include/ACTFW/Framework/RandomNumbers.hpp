@@ -57,6 +57,17 @@ public:
   RandomEngine
   spawnGenerator(const AlgorithmContext& context) const;
 
+  /// Spawn a random number generator for a substream within an event.
+  ///
+  /// Substreams, e.g. one per generated track, are seeded from the event
+  /// driven seed and the substream index. This keeps the random numbers
+  /// independent of the order and the threads used to process them.
+  ///
+  /// @param context is the AlgorithmContext of the host algorithm
+  /// @param substream is the index of the substream within the event
+  RandomEngine
+  spawnGenerator(const AlgorithmContext& context, uint64_t substream) const;
+
   /// Generate a event and algorithm specific seed value.
   ///
   /// This should only be used in special cases e.g. where a custom
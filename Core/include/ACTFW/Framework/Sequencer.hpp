@@ -44,6 +44,8 @@ public:
     int numThreads = -1;
     /// output directory for timing information, empty for working directory
     std::string outputDir;
+    /// queue size to run each writer in a dedicated thread, zero to disable
+    std::size_t writeQueue = 0;
   };
 
   Sequencer(const Config& cfg);
@@ -70,6 +72,9 @@ public:
   addAlgorithm(std::shared_ptr<IAlgorithm> algorithm);
   /// Add a writer to the set of writers.
   ///
+  /// With Config::writeQueue, the writer runs asynchronously in a dedicated
+  /// thread and the end-of-run hook waits until all events are written.
+  ///
   /// @throws std::invalid_argument if the writer is NULL.
   void
   addWriter(std::shared_ptr<IWriter> writer);
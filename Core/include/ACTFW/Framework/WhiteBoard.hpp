@@ -22,11 +22,16 @@ namespace FW {
 
 /// A container to store arbitrary objects with ownership transfer.
 ///
-/// This is an append-only container that takes ownership of the objects
-/// added to it. Once an object has been added, it can only be read but not
-/// be modified. Trying to replace an existing object is considered an error.
-/// Its lifetime is bound to the liftime of the white board.
-class WhiteBoard
+/// The container takes ownership of the objects added to it. Once an object
+/// has been added, it can be read but not be modified. Trying to replace an
+/// existing object is considered an error. Its lifetime is bound to the
+/// lifetime of the white board unless it is explicitly consumed, i.e.
+/// removed and handed back to the caller. A consumed object is no longer
+/// available to any later algorithm or writer.
+///
+/// A white board owned by a `std::shared_ptr` can be retained beyond its
+/// original scope, e.g. to write its content asynchronously.
+class WhiteBoard : public std::enable_shared_from_this<WhiteBoard>
 {
 public:
   WhiteBoard(std::unique_ptr<const Acts::Logger> logger
@@ -56,6 +61,25 @@ public:
   const T&
   get(const std::string& name) const;
 
+  /// Remove a stored object and transfer its ownership to the caller.
+  ///
+  /// This avoids a copy when the object is only read to create a modified
+  /// version of it. The object is not available to any later reader.
+  ///
+  /// @param[in] name Identifier for the object
+  /// @return the previously stored object
+  /// @throws std::out_of_range if no object is stored under the requested name
+  template <typename T>
+  T
+  consume(const std::string& name);
+
+  /// Move all objects from another white board into this one.
+  ///
+  /// @param other White board that is left empty afterwards
+  /// @throws std::invalid_argument on duplicate names; nothing is moved then
+  void
+  merge(WhiteBoard&& other);
+
 private:
   // type-erased value holder for move-constructible types
   struct IHolder
@@ -125,3 +149,37 @@ FW::WhiteBoard::get(const std::string& name) const
   ACTS_VERBOSE("Retrieved object '" << name << "'");
   return reinterpret_cast<const HolderT<T>*>(holder)->value;
 }
+
+template <typename T>
+inline T
+FW::WhiteBoard::consume(const std::string& name)
+{
+  auto it = m_store.find(name);
+  if (it == m_store.end()) {
+    throw std::out_of_range("Object '" + name + "' does not exists");
+  }
+  IHolder* holder = it->second.get();
+  if (typeid(T) != holder->type()) {
+    throw std::out_of_range("Type missmatch for object '" + name + "'");
+  }
+  T object(std::move(reinterpret_cast<HolderT<T>*>(holder)->value));
+  m_store.erase(it);
+  ACTS_VERBOSE("Consumed object '" << name << "'");
+  return object;
+}
+
+inline void
+FW::WhiteBoard::merge(WhiteBoard&& other)
+{
+  for (const auto& entry : other.m_store) {
+    if (0 < m_store.count(entry.first)) {
+      throw std::invalid_argument("Object '" + entry.first
+                                  + "' already exists");
+    }
+  }
+  for (auto& entry : other.m_store) {
+    ACTS_VERBOSE("Merged object '" << entry.first << "'");
+    m_store.emplace(entry.first, std::move(entry.second));
+  }
+  other.m_store.clear();
+}
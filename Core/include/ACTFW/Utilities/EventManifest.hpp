@@ -0,0 +1,139 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Catalog of per-event files to avoid directory scans
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FW {
+
+/// Description of a single per-event file.
+struct EventManifestEntry
+{
+  uint64_t event = 0;
+  /// File size in bytes.
+  uint64_t size = 0;
+  /// CRC-32 checksum of the file content; zero if not computed.
+  uint32_t crc32 = 0;
+};
+
+/// Catalog of per-event files `[<dir>/]event<XXXXXXXXX>-<name>`.
+///
+/// The manifest is stored next to the event files as `<name>.manifest` and
+/// lists the event number, size and checksum of each file. It allows readers
+/// to determine the available events without scanning the directory, to
+/// detect missing events, and to split the events into balanced shards.
+class EventManifest
+{
+public:
+  /// Path of the manifest for per-event files with the given name.
+  static std::string
+  path(const std::string& dir, const std::string& name);
+  /// Check whether a manifest exists for the per-event files.
+  static bool
+  exists(const std::string& dir, const std::string& name);
+  /// Read the manifest for the per-event files.
+  ///
+  /// @throws std::runtime_error if the manifest can not be read
+  static EventManifest
+  read(const std::string& dir, const std::string& name);
+  /// Create the manifest by scanning the directory for per-event files.
+  ///
+  /// @param computeChecksums Read all files to compute their checksums
+  static EventManifest
+  scan(const std::string& dir,
+       const std::string& name,
+       bool               computeChecksums = true);
+  /// Create the manifests for several names with a single directory scan.
+  ///
+  /// @param computeChecksums Read all files to compute their checksums
+  /// @return one manifest per name in the same order
+  static std::vector<EventManifest>
+  scan(const std::string&              dir,
+       const std::vector<std::string>& names,
+       bool                            computeChecksums = true);
+  /// Describe a single existing per-event file.
+  ///
+  /// @throws std::ios_base::failure if the file can not be read
+  static EventManifestEntry
+  describe(size_t event, const std::string& path, bool computeChecksum = true);
+
+  /// Append an entry without restoring the event ordering.
+  ///
+  /// `sort` must be called after the last insertion and before the manifest
+  /// is used otherwise.
+  void
+  insert(const EventManifestEntry& entry);
+  /// Restore the event ordering after insertions.
+  ///
+  /// For duplicate events only the last inserted entry is kept.
+  void
+  sort();
+  /// Add all entries from the other manifest; its entries take precedence.
+  void
+  merge(const EventManifest& other);
+  /// Write the manifest for the per-event files.
+  void
+  write(const std::string& dir, const std::string& name) const;
+
+  /// All entries sorted by event number.
+  const std::vector<EventManifestEntry>&
+  entries() const
+  {
+    return m_entries;
+  }
+  /// Whether the file for the event is listed.
+  bool
+  contains(size_t event) const;
+  /// First and last+1 listed event; {0, 0} for an empty manifest.
+  std::pair<size_t, size_t>
+  eventsRange() const;
+  /// Number of events within the events range without a listed file.
+  size_t
+  numMissingEvents() const;
+  /// Ranges [first,last+1) of consecutive events without a listed file.
+  std::vector<std::pair<size_t, size_t>>
+  missingRanges() const;
+  /// Events range of one shard when splitting into contiguous shards.
+  ///
+  /// @param shard Shard index in [0, numShards)
+  /// @param numShards Total number of shards
+  /// @throws std::invalid_argument for an invalid shard index
+  ///
+  /// Shards are balanced by the total file size, not the number of events.
+  std::pair<size_t, size_t>
+  shardRange(size_t shard, size_t numShards) const;
+  /// Events whose files are missing or have a different size or checksum.
+  ///
+  /// @param checkChecksums Read all files to compare their checksums
+  std::vector<size_t>
+  verify(const std::string& dir,
+         const std::string& name,
+         bool               checkChecksums = true) const;
+
+private:
+  std::vector<EventManifestEntry> m_entries;
+};
+
+/// Merge the entries into the existing manifest for the per-event files.
+///
+/// Entries of a previous manifest are kept unless they are replaced. This
+/// allows multiple runs to write into the same directory consecutively.
+void
+updateEventManifest(const std::string&   dir,
+                    const std::string&   name,
+                    const EventManifest& manifest);
+
+}  // namespace FW
@@ -41,8 +41,41 @@ perEventFilepath(const std::string& dir, const std::string& name, size_t event);
 /// @return first and last+1 event number
 /// @returns {0, 0} when no matching files could be found
 ///
-/// Event files must be named `[<dir>/]event<XXXXXXXXX>-<name>` to be considered
+/// Event files must be named `[<dir>/]event<XXXXXXXXX>-<name>` to be used.
+/// If an `EventManifest` exists for the files it is used instead of scanning
+/// the directory. Missing events within the range are reported as a warning.
+///
+/// @throws std::runtime_error if the manifest lists missing or invalid files
 std::pair<size_t, size_t>
 determineEventFilesRange(const std::string& dir, const std::string& name);
 
+/// Determine the first of several names with available per-event files.
+///
+/// @params dir input directory, current directory if empty
+/// @params names base filenames in order of preference
+/// @return index of the first name with files and its events range
+/// @returns names.size() and {0, 0} when no matching files could be found
+///
+/// Same as `determineEventFilesRange` for each name, but the directory is
+/// scanned at most once for all names without an `EventManifest`.
+std::pair<size_t, std::pair<size_t, size_t>>
+determineEventFilesRange(const std::string&              dir,
+                         const std::vector<std::string>& names);
+
+/// Determine the range of events for one shard of the per-event files.
+///
+/// @params dir input directory, current directory if empty
+/// @params name base filename
+/// @params shard shard index in [0, numShards)
+/// @params numShards total number of shards
+/// @return first and last+1 event number of the shard
+///
+/// Shards are contiguous and balanced by the file sizes, see `EventManifest`.
+/// @throws std::runtime_error if the manifest lists missing or invalid files
+std::pair<size_t, size_t>
+determineEventFilesShard(const std::string& dir,
+                         const std::string& name,
+                         size_t             shard,
+                         size_t             numShards);
+
 }  // namespace FW
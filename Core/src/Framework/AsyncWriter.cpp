@@ -0,0 +1,127 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Framework/AsyncWriter.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+FW::AsyncWriter::AsyncWriter(const FW::AsyncWriter::Config& cfg,
+                             Acts::Logging::Level           level)
+  : m_cfg(cfg), m_logger(Acts::getDefaultLogger("AsyncWriter", level))
+{
+  if (not m_cfg.writer) {
+    throw std::invalid_argument("Missing writer to write asynchronously");
+  }
+  if (m_cfg.queueSize == 0u) {
+    throw std::invalid_argument("Asynchronous writing requires a queue");
+  }
+  m_worker = std::thread([this] { work(); });
+  ACTS_DEBUG("Write asynchronously for writer '"
+             << m_cfg.writer->name() << "' with up to " << m_cfg.queueSize
+             << " queued events");
+}
+
+FW::AsyncWriter::~AsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_queue.clear();
+  }
+  m_queued.notify_all();
+  m_written.notify_all();
+  if (m_worker.joinable()) { m_worker.join(); }
+}
+
+std::string
+FW::AsyncWriter::name() const
+{
+  return m_cfg.writer->name();
+}
+
+FW::ProcessCode
+FW::AsyncWriter::write(const FW::AlgorithmContext& context)
+{
+  // shared ownership keeps the store alive after the event is finished
+  auto store = context.eventStore.weak_from_this().lock();
+  if (not store) {
+    ACTS_VERBOSE("Write event " << context.eventNumber << " synchronously");
+    return m_cfg.writer->write(context);
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_written.wait(lock, [this] {
+      return m_stop or (m_queue.size() < m_cfg.queueSize);
+    });
+    if (m_stop) { return ProcessCode::ABORT; }
+    ProcessCode code = status();
+    if (code != ProcessCode::SUCCESS) { return code; }
+    m_queue.push_back({context, std::move(store)});
+  }
+  m_queued.notify_one();
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::AsyncWriter::endRun()
+{
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_written.wait(lock, [this] { return m_queue.empty() and not m_busy; });
+    m_stop = true;
+  }
+  m_queued.notify_all();
+  m_worker.join();
+
+  ProcessCode code = status();
+  if (code != ProcessCode::SUCCESS) { return code; }
+  return m_cfg.writer->endRun();
+}
+
+void
+FW::AsyncWriter::work()
+{
+  while (true) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_queued.wait(lock, [this] { return m_stop or not m_queue.empty(); });
+    if (m_queue.empty()) { return; }
+    Job job = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_busy = true;
+    lock.unlock();
+
+    ProcessCode        code  = ProcessCode::SUCCESS;
+    std::exception_ptr error = nullptr;
+    try {
+      code = m_cfg.writer->write(job.context);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    // release the event store outside the lock
+    job.store.reset();
+
+    lock.lock();
+    m_busy = false;
+    if ((m_code == ProcessCode::SUCCESS) and (code != ProcessCode::SUCCESS)) {
+      ACTS_ERROR("Failed to write event " << job.context.eventNumber);
+      m_code = code;
+    }
+    if (not m_error and error) { m_error = error; }
+    lock.unlock();
+    m_written.notify_all();
+  }
+}
+
+FW::ProcessCode
+FW::AsyncWriter::status() const
+{
+  if (m_error) { std::rethrow_exception(m_error); }
+  return m_code;
+}
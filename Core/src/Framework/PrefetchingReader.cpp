@@ -0,0 +1,127 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Framework/PrefetchingReader.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+FW::PrefetchingReader::PrefetchingReader(
+    const FW::PrefetchingReader::Config& cfg,
+    Acts::Logging::Level                 level)
+  : m_cfg(cfg), m_logger(Acts::getDefaultLogger("PrefetchingReader", level))
+{
+  if (not m_cfg.reader) {
+    throw std::invalid_argument("Missing reader to prefetch from");
+  }
+  if (m_cfg.numThreads == 0u) {
+    throw std::invalid_argument("Prefetching requires at least one thread");
+  }
+  m_eventsRange = m_cfg.reader->availableEvents();
+
+  m_workers.reserve(m_cfg.numThreads);
+  for (size_t i = 0; i < m_cfg.numThreads; ++i) {
+    m_workers.emplace_back([this] { work(); });
+  }
+  ACTS_DEBUG("Prefetch " << m_cfg.readAhead << " events for reader '"
+                         << m_cfg.reader->name() << "' using "
+                         << m_cfg.numThreads << " threads");
+}
+
+FW::PrefetchingReader::~PrefetchingReader()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_queue.clear();
+  }
+  m_cv.notify_all();
+  for (auto& worker : m_workers) { worker.join(); }
+}
+
+std::string
+FW::PrefetchingReader::name() const
+{
+  return "Prefetching" + m_cfg.reader->name();
+}
+
+std::pair<size_t, size_t>
+FW::PrefetchingReader::availableEvents() const
+{
+  return m_eventsRange;
+}
+
+FW::ProcessCode
+FW::PrefetchingReader::read(const FW::AlgorithmContext& context)
+{
+  std::future<Fragment> pending;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // mark as requested so it will never be prefetched afterwards
+    m_requested.insert(context.eventNumber);
+    auto it = m_pending.find(context.eventNumber);
+    if (it != m_pending.end()) {
+      pending = std::move(it->second);
+      m_pending.erase(it);
+    }
+    schedule(context.eventNumber);
+  }
+  m_cv.notify_all();
+
+  // not yet prefetched; read directly into the event store
+  if (not pending.valid()) {
+    ACTS_VERBOSE("Read event " << context.eventNumber << " directly");
+    return m_cfg.reader->read(context);
+  }
+  // rethrows exceptions from the prefetch
+  Fragment fragment = pending.get();
+  if (fragment.code != ProcessCode::SUCCESS) { return fragment.code; }
+  context.eventStore.merge(std::move(*fragment.store));
+  ACTS_VERBOSE("Used prefetched event " << context.eventNumber);
+  return ProcessCode::SUCCESS;
+}
+
+void
+FW::PrefetchingReader::schedule(size_t event)
+{
+  size_t end = std::min(m_eventsRange.second, event + 1 + m_cfg.readAhead);
+  for (size_t next = event + 1; next < end; ++next) {
+    if ((0 < m_requested.count(next)) or (0 < m_pending.count(next))) {
+      continue;
+    }
+    m_queue.emplace_back([this, next] { return prefetch(next); });
+    m_pending.emplace(next, m_queue.back().get_future());
+  }
+}
+
+FW::PrefetchingReader::Fragment
+FW::PrefetchingReader::prefetch(size_t event)
+{
+  Fragment fragment;
+  fragment.store = std::make_unique<WhiteBoard>(Acts::getDefaultLogger(
+      "PrefetchStore#" + std::to_string(event), Acts::Logging::INFO));
+  AlgorithmContext context(0, event, *fragment.store);
+  fragment.code = m_cfg.reader->read(context);
+  return fragment;
+}
+
+void
+FW::PrefetchingReader::work()
+{
+  while (true) {
+    std::packaged_task<Fragment()> task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this] { return m_stop or not m_queue.empty(); });
+      if (m_stop) { return; }
+      task = std::move(m_queue.front());
+      m_queue.pop_front();
+    }
+    task();
+  }
+}
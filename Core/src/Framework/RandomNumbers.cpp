@@ -24,6 +24,19 @@ FW::RandomNumbers::spawnGenerator(const AlgorithmContext& context) const
   return RandomEngine(generateSeed(context));
 }
 
+FW::RandomEngine
+FW::RandomNumbers::spawnGenerator(const AlgorithmContext& context,
+                                  uint64_t                substream) const
+{
+  // mix event seed and substream so neighbouring streams are uncorrelated
+  const uint64_t seed = generateSeed(context);
+  std::seed_seq  seq{uint32_t(seed),
+                    uint32_t(seed >> 32),
+                    uint32_t(substream),
+                    uint32_t(substream >> 32)};
+  return RandomEngine(seq);
+}
+
 uint64_t
 FW::RandomNumbers::generateSeed(const AlgorithmContext& context) const
 {
@@ -18,6 +18,7 @@
 #include <dfe/dfe_namedtuple.hpp>
 #include <tbb/tbb.h>
 
+#include "ACTFW/Framework/AsyncWriter.hpp"
 #include "ACTFW/Framework/ProcessCode.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
@@ -78,6 +79,12 @@ FW::Sequencer::addWriter(std::shared_ptr<IWriter> writer)
   if (not writer) {
     throw std::invalid_argument("Can not add empty/NULL writer");
   }
+  if (0u < m_cfg.writeQueue) {
+    AsyncWriter::Config asyncCfg;
+    asyncCfg.writer    = std::move(writer);
+    asyncCfg.queueSize = m_cfg.writeQueue;
+    writer = std::make_shared<AsyncWriter>(asyncCfg, m_cfg.logLevel);
+  }
   m_writers.push_back(std::move(writer));
   ACTS_INFO("Added writer '" << m_writers.back()->name() << "'");
 }
@@ -290,12 +297,12 @@ FW::Sequencer::run()
                                                     Duration::zero());
 
         for (size_t event = r.begin(); event != r.end(); ++event) {
-          // Use per-event store
-          WhiteBoard eventStore(Acts::getDefaultLogger(
+          // Use per-event store; shared so asynchronous writers can retain it
+          auto eventStore = std::make_shared<WhiteBoard>(Acts::getDefaultLogger(
               "EventStore#" + std::to_string(event), m_cfg.logLevel));
           // If we ever wanted to run algorithms in parallel, this needs to be
           // changed to Algorithm context copies
-          AlgorithmContext context(0, event, eventStore);
+          AlgorithmContext context(0, event, *eventStore);
           size_t           ialgo = 0;
 
           // Prepare event store w/ service information
@@ -0,0 +1,335 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Utilities/EventManifest.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+
+#include <boost/filesystem.hpp>
+#include <dfe/dfe_io_dsv.hpp>
+#include <dfe/dfe_namedtuple.hpp>
+#include <zlib.h>
+
+#include "ACTFW/Utilities/Paths.hpp"
+
+namespace {
+struct ManifestRow
+{
+  uint64_t event;
+  uint64_t size;
+  uint32_t crc32;
+
+  DFE_NAMEDTUPLE(ManifestRow, event, size, crc32);
+};
+
+bool
+compareEvent(const FW::EventManifestEntry& lhs,
+             const FW::EventManifestEntry& rhs)
+{
+  return lhs.event < rhs.event;
+}
+
+/// Extract the event number from `event<number>-<name>` filenames.
+///
+/// @return false if the filename does not match
+bool
+matchEventFilename(const std::string& filename,
+                   const std::string& name,
+                   size_t&            event)
+{
+  static const std::string prefix = "event";
+  // require at least a single digit and the separator
+  if (filename.size() < (prefix.size() + 2u + name.size())) { return false; }
+  if (filename.compare(0, prefix.size(), prefix) != 0) { return false; }
+  size_t sep = filename.size() - name.size() - 1u;
+  if ((filename[sep] != '-')
+      or (filename.compare(sep + 1u, name.size(), name) != 0)) {
+    return false;
+  }
+  const char* first = filename.data() + prefix.size();
+  const char* last  = filename.data() + sep;
+  auto        ret   = std::from_chars(first, last, event);
+  return (ret.ec == std::errc()) and (ret.ptr == last);
+}
+}  // namespace
+
+std::string
+FW::EventManifest::path(const std::string& dir, const std::string& name)
+{
+  return joinPaths(dir, name + ".manifest");
+}
+
+bool
+FW::EventManifest::exists(const std::string& dir, const std::string& name)
+{
+  return boost::filesystem::is_regular_file(path(dir, name));
+}
+
+FW::EventManifest
+FW::EventManifest::read(const std::string& dir, const std::string& name)
+{
+  dfe::NamedTupleTsvReader<ManifestRow> reader(path(dir, name));
+  EventManifest                         manifest;
+  ManifestRow                           row;
+  while (reader.read(row)) {
+    manifest.m_entries.push_back({row.event, row.size, row.crc32});
+  }
+  // the manifest is written sorted, but could have been edited manually
+  if (not std::is_sorted(
+          manifest.m_entries.begin(), manifest.m_entries.end(), compareEvent)) {
+    std::sort(
+        manifest.m_entries.begin(), manifest.m_entries.end(), compareEvent);
+  }
+  return manifest;
+}
+
+FW::EventManifest
+FW::EventManifest::scan(const std::string& dir,
+                        const std::string& name,
+                        bool               computeChecksums)
+{
+  return std::move(scan(dir, std::vector<std::string>{name}, computeChecksums)
+                       .front());
+}
+
+std::vector<FW::EventManifest>
+FW::EventManifest::scan(const std::string&              dir,
+                        const std::vector<std::string>& names,
+                        bool                            computeChecksums)
+{
+  namespace fs = boost::filesystem;
+
+  // ensure directory path is valid
+  auto dir_path = dir.empty() ? fs::current_path() : fs::path(dir);
+  if (not fs::exists(dir_path)) {
+    throw std::runtime_error("'" + dir_path.native() + "' does not exists");
+  }
+  if (not fs::is_directory(dir_path)) {
+    throw std::runtime_error("'" + dir_path.native() + "' is not a directory");
+  }
+
+  std::vector<EventManifest> manifests(names.size());
+  std::string                filename;
+  size_t                     event = 0;
+  for (const auto& f : fs::directory_iterator(dir_path)) {
+    if (not fs::is_regular_file(f.status())) { continue; }
+    filename = f.path().filename().native();
+    // the separator makes the match unique for different names
+    for (size_t i = 0; i < names.size(); ++i) {
+      if (not matchEventFilename(filename, names[i], event)) { continue; }
+      manifests[i].m_entries.push_back(
+          describe(event, f.path().native(), computeChecksums));
+      break;
+    }
+  }
+  for (auto& manifest : manifests) {
+    std::sort(
+        manifest.m_entries.begin(), manifest.m_entries.end(), compareEvent);
+  }
+  return manifests;
+}
+
+FW::EventManifestEntry
+FW::EventManifest::describe(size_t             event,
+                            const std::string& path,
+                            bool               computeChecksum)
+{
+  EventManifestEntry entry;
+  entry.event = event;
+  if (not computeChecksum) {
+    entry.size = boost::filesystem::file_size(path);
+    return entry;
+  }
+  std::ifstream file(path, std::ios_base::binary);
+  if (not file.good()) {
+    throw std::ios_base::failure("Could not open '" + path + "'");
+  }
+  std::vector<char> buffer(1u << 20);
+  uLong             crc = crc32(0L, Z_NULL, 0);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    auto len = file.gcount();
+    crc      = crc32(crc, reinterpret_cast<const Bytef*>(buffer.data()), len);
+    entry.size += len;
+  }
+  if (file.bad()) {
+    throw std::ios_base::failure("Could not read '" + path + "'");
+  }
+  entry.crc32 = crc;
+  return entry;
+}
+
+void
+FW::EventManifest::insert(const EventManifestEntry& entry)
+{
+  m_entries.push_back(entry);
+}
+
+void
+FW::EventManifest::sort()
+{
+  std::stable_sort(m_entries.begin(), m_entries.end(), compareEvent);
+  // unique keeps the first of equal elements; iterate backwards to keep the
+  // last inserted entry. the remaining entries end up at the back.
+  auto last = std::unique(
+      m_entries.rbegin(),
+      m_entries.rend(),
+      [](const EventManifestEntry& lhs, const EventManifestEntry& rhs) {
+        return lhs.event == rhs.event;
+      });
+  m_entries.erase(m_entries.begin(), last.base());
+}
+
+void
+FW::EventManifest::merge(const EventManifest& other)
+{
+  std::vector<EventManifestEntry> merged;
+  merged.reserve(m_entries.size() + other.m_entries.size());
+  // std::set_union keeps the element from the first range on ties
+  std::set_union(other.m_entries.begin(),
+                 other.m_entries.end(),
+                 m_entries.begin(),
+                 m_entries.end(),
+                 std::back_inserter(merged),
+                 compareEvent);
+  m_entries = std::move(merged);
+}
+
+void
+FW::EventManifest::write(const std::string& dir, const std::string& name) const
+{
+  // write to a temporary file first so readers never see a partial manifest
+  std::string target = path(dir, name);
+  std::string temp   = target + ".tmp";
+  {
+    dfe::NamedTupleTsvWriter<ManifestRow> writer(temp);
+    for (const auto& entry : m_entries) {
+      ManifestRow row;
+      row.event = entry.event;
+      row.size  = entry.size;
+      row.crc32 = entry.crc32;
+      writer.append(row);
+    }
+  }
+  boost::filesystem::rename(temp, target);
+}
+
+bool
+FW::EventManifest::contains(size_t event) const
+{
+  EventManifestEntry key;
+  key.event = event;
+  return std::binary_search(
+      m_entries.begin(), m_entries.end(), key, compareEvent);
+}
+
+std::pair<size_t, size_t>
+FW::EventManifest::eventsRange() const
+{
+  if (m_entries.empty()) { return {0u, 0u}; }
+  return {m_entries.front().event, m_entries.back().event + 1};
+}
+
+size_t
+FW::EventManifest::numMissingEvents() const
+{
+  size_t missing = 0;
+  for (size_t i = 1; i < m_entries.size(); ++i) {
+    missing += m_entries[i].event - m_entries[i - 1].event - 1;
+  }
+  return missing;
+}
+
+std::vector<std::pair<size_t, size_t>>
+FW::EventManifest::missingRanges() const
+{
+  std::vector<std::pair<size_t, size_t>> missing;
+  for (size_t i = 1; i < m_entries.size(); ++i) {
+    if ((m_entries[i - 1].event + 1) < m_entries[i].event) {
+      missing.emplace_back(m_entries[i - 1].event + 1, m_entries[i].event);
+    }
+  }
+  return missing;
+}
+
+std::pair<size_t, size_t>
+FW::EventManifest::shardRange(size_t shard, size_t numShards) const
+{
+  if (numShards <= shard) {
+    throw std::invalid_argument("Invalid shard " + std::to_string(shard)
+                                + " for " + std::to_string(numShards)
+                                + " shards");
+  }
+  if (m_entries.empty()) { return {0u, 0u}; }
+
+  // cumulative weight; offset by one to handle empty files consistently
+  std::vector<uint64_t> cumulative(m_entries.size() + 1, 0u);
+  for (size_t i = 0; i < m_entries.size(); ++i) {
+    cumulative[i + 1] = cumulative[i] + m_entries[i].size + 1u;
+  }
+  // entry whose preceding weight is closest to the shard boundary
+  auto boundary = [&](size_t s) -> size_t {
+    if (s == numShards) { return m_entries.size(); }
+    // use floating point to avoid overflows for large totals
+    auto target = static_cast<uint64_t>(static_cast<double>(cumulative.back())
+                                        * s / numShards);
+    auto it = std::lower_bound(cumulative.begin(), cumulative.end(), target);
+    if ((it != cumulative.begin())
+        and ((target - *std::prev(it)) < (*it - target))) {
+      --it;
+    }
+    return std::min<size_t>(it - cumulative.begin(), m_entries.size());
+  };
+  size_t begin = boundary(shard);
+  size_t end   = boundary(shard + 1);
+  // shards cover all events incl. missing ones between the listed files
+  size_t last = eventsRange().second;
+  size_t lo   = (begin < m_entries.size()) ? m_entries[begin].event : last;
+  size_t hi   = (end < m_entries.size()) ? m_entries[end].event : last;
+  return {lo, std::max(lo, hi)};
+}
+
+std::vector<size_t>
+FW::EventManifest::verify(const std::string& dir,
+                          const std::string& name,
+                          bool               checkChecksums) const
+{
+  std::vector<size_t> invalid;
+  for (const auto& entry : m_entries) {
+    auto filePath = perEventFilepath(dir, name, entry.event);
+    bool checksum = checkChecksums and (entry.crc32 != 0u);
+    try {
+      auto actual = describe(entry.event, filePath, checksum);
+      if ((actual.size != entry.size)
+          or (checksum and (actual.crc32 != entry.crc32))) {
+        invalid.push_back(entry.event);
+      }
+    } catch (const std::exception&) {
+      invalid.push_back(entry.event);
+    }
+  }
+  return invalid;
+}
+
+void
+FW::updateEventManifest(const std::string&   dir,
+                        const std::string&   name,
+                        const EventManifest& manifest)
+{
+  EventManifest updated;
+  if (EventManifest::exists(dir, name)) {
+    updated = EventManifest::read(dir, name);
+  }
+  updated.merge(manifest);
+  updated.write(dir, name);
+}
@@ -8,15 +8,16 @@
 
 #include "ACTFW/Utilities/Paths.hpp"
 
-#include <charconv>
 #include <cstdio>
-#include <regex>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include <Acts/Utilities/Logger.hpp>
 #include <boost/filesystem.hpp>
 
+#include "ACTFW/Utilities/EventManifest.hpp"
+
 std::string
 FW::ensureWritableDirectory(const std::string& dir)
 {
@@ -57,57 +58,90 @@ FW::perEventFilepath(const std::string& dir,
   }
 }
 
+namespace {
+/// Read the manifest and ensure that it still matches the listed files.
+///
+/// Only the file sizes are compared to avoid reading all files; a stale
+/// manifest would otherwise silently yield wrong events ranges and shards.
+FW::EventManifest
+readValidManifest(const std::string& dir, const std::string& name)
+{
+  auto manifest = FW::EventManifest::read(dir, name);
+  auto invalid  = manifest.verify(dir, name, false);
+  if (not invalid.empty()) {
+    throw std::runtime_error(
+        std::to_string(invalid.size()) + " files listed in '"
+        + FW::EventManifest::path(dir, name)
+        + "' are missing or invalid, first is event "
+        + std::to_string(invalid.front()));
+  }
+  return manifest;
+}
+}  // namespace
+
 std::pair<size_t, size_t>
 FW::determineEventFilesRange(const std::string& dir, const std::string& name)
+{
+  return determineEventFilesRange(dir, std::vector<std::string>{name}).second;
+}
+
+std::pair<size_t, std::pair<size_t, size_t>>
+FW::determineEventFilesRange(const std::string&              dir,
+                             const std::vector<std::string>& names)
 {
   using Acts::Logger;
-  using namespace boost::filesystem;
 
   ACTS_LOCAL_LOGGER(
       Acts::getDefaultLogger("EventFilesRange", Acts::Logging::VERBOSE));
 
-  // ensure directory path is valid
-  auto dir_path = dir.empty() ? current_path() : path(dir);
-  if (not exists(dir_path)) {
-    throw std::runtime_error("'" + dir_path.native() + "' does not exists");
+  // a manifest avoids scanning large directories; all other names are
+  // collected with a single scan
+  std::vector<EventManifest> manifests(names.size());
+  std::vector<std::string>   unlisted;
+  std::vector<size_t>        unlistedIndices;
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (EventManifest::exists(dir, names[i])) {
+      ACTS_VERBOSE("Using manifest " << EventManifest::path(dir, names[i]));
+      manifests[i] = readValidManifest(dir, names[i]);
+    } else {
+      unlisted.push_back(names[i]);
+      unlistedIndices.push_back(i);
+    }
   }
-  if (not is_directory(dir_path)) {
-    throw std::runtime_error("'" + dir_path.native() + "' is not a directory");
+  if (not unlisted.empty()) {
+    auto scanned = EventManifest::scan(dir, unlisted, false);
+    for (size_t j = 0; j < scanned.size(); ++j) {
+      manifests[unlistedIndices[j]] = std::move(scanned[j]);
+    }
   }
 
-  // invalid default range that allows simple restriction later on
-  size_t eventMin = SIZE_MAX;
-  size_t eventMax = 0;
-
-  // filter matching event files from the directory listing
-  std::string filename;
-  std::regex  re("^event([0-9]+)-" + name + "$");
-  std::cmatch match;
-
-  for (const auto& f : directory_iterator(dir_path)) {
-    if ((not exists(f.status())) or (not is_regular_file(f.status()))) {
-      continue;
-    }
-    // keep a copy so the match can refer to the underlying const char*
-    filename = f.path().filename().native();
-    if (std::regex_match(filename.c_str(), match, re)) {
-      ACTS_VERBOSE("Matching file " << filename);
-
-      // first sub_match is the whole string, second should be the event number
-      size_t event = 0;
-      auto   ret   = std::from_chars(match[1].first, match[1].second, event);
-      if (ret.ptr == match[1].first) {
-        throw std::runtime_error(
-            "Could not extract event number from filename");
-      }
-      // enlarge available event range
-      eventMin = std::min(eventMin, event);
-      eventMax = std::max(eventMax, event);
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto& manifest = manifests[i];
+    if (manifest.entries().empty()) { continue; }
+    auto range = manifest.eventsRange();
+    ACTS_VERBOSE("Detected event range [" << range.first << ","
+                                          << range.second << ") of '"
+                                          << names[i] << "' files");
+    auto missing = manifest.missingRanges();
+    if (not missing.empty()) {
+      ACTS_WARNING(manifest.numMissingEvents()
+                   << " events are missing in the range [" << range.first
+                   << "," << range.second << ") of '" << names[i]
+                   << "' files, first is " << missing.front().first);
     }
+    return {i, range};
   }
-  ACTS_VERBOSE("Detected event range [" << eventMin << "," << eventMax << "]");
+  return {names.size(), {0u, 0u}};
+}
 
-  // should only occur if no files matched and the initial values persisted.
-  if (eventMax < eventMin) { return std::make_pair(0u, 0u); }
-  return std::make_pair(eventMin, eventMax + 1);
+std::pair<size_t, size_t>
+FW::determineEventFilesShard(const std::string& dir,
+                             const std::string& name,
+                             size_t             shard,
+                             size_t             numShards)
+{
+  if (EventManifest::exists(dir, name)) {
+    return readValidManifest(dir, name).shardRange(shard, numShards);
+  }
+  return EventManifest::scan(dir, name, false).shardRange(shard, numShards);
 }
@@ -6,12 +6,28 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include <boost/program_options.hpp>
-#include <boost/progress.hpp>
 
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
+#include "ACTFW/Plugins/BField/BFieldBatch.hpp"
 #include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/BFieldTypeName.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
+#include "ACTFW/Plugins/BField/ScalableBField.hpp"
 #include "ACTFW/Utilities/Options.hpp"
 #include "Acts/MagneticField/ConstantBField.hpp"
 #include "Acts/MagneticField/InterpolatedBFieldMap.hpp"
@@ -19,110 +35,327 @@
 #include "Acts/Utilities/Helpers.hpp"
 #include "Acts/Utilities/Units.hpp"
 
-#include <random>
-#include <string>
-
 /// The main executable
 ///
-/// Creates an InterpolatedBFieldMap from a txt or csv file
-/// It then tests random versus stepwise access with the
-/// direct getField access and the cell.getField access
-/// with cell caching
+/// Benchmarks the magnetic field access for any field created with the
+/// bfield options. Positions are generated either step-wise along straight
+/// tracks or uniformly random in a box. Each access pattern is evaluated
+/// directly, through the field cache, and in batches, using one up to the
+/// configured number of threads with one field cache per thread.
+///
+/// A single-threaded validation pass compares the three access modes and
+/// measures how often the cached field cell could be reused. Timing results
+/// are printed and optionally written to a csv file.
 
 namespace po = boost::program_options;
 
 using UniformDist  = std::uniform_real_distribution<double>;
 using RandomEngine = std::mt19937;
+using Clock        = std::chrono::steady_clock;
 
-template <typename field_t, typename field_context_t>
-void
-accessStepWise(field_t&         bField,
-               field_context_t& bFieldContext,
-               size_t           events,
-               size_t           theta_steps,
-               double           theta_0,
-               double           theta_step,
-               size_t           phi_steps,
-               double           phi_0,
-               double           phi_step,
-               size_t           access_steps,
-               double           access_step)
+namespace {
+
+// keeps the field lookups from being optimized away
+volatile double g_sink = 0.;
+
+/// Maximum number of pre-generated random positions.
+constexpr size_t kRandomPoolSize = 1u << 20;
+/// Maximum number of lookups for the validation pass.
+constexpr size_t kValidationSize = 1u << 20;
+
+enum class AccessMode { Direct, Cached, Batch };
+
+const char*
+accessModeName(AccessMode mode)
 {
-  std::cout << "[>>>] Start: step-wise access pattern ... " << std::endl;
-  size_t mismatched = 0;
-  // initialize the field cache
-  typename field_t::Cache bCache(bFieldContext);
-  // boost display
-  size_t totalSteps = events * theta_steps * phi_steps * access_steps;
-  boost::progress_display show_progress(totalSteps);
-  // the event loop
-  // loop over the events - @todo move to parallel for
-  for (size_t ievt = 0; ievt < events; ++ievt) {
-    for (size_t itheta = 0; itheta < theta_steps; ++itheta) {
-      double theta = theta_0 + itheta * theta_step;
-      for (size_t iphi = 0; iphi < phi_steps; ++iphi) {
-        double phi = phi_0 + iphi * phi_step;
-        // make a direction
-        Acts::Vector3D dir(
-            cos(phi) * sin(theta), sin(phi) * sin(theta), cos(theta));
-        // check for the current step
-        double currentStep = 0.;
-        // now step through the magnetic field
-        for (size_t istep = 0; istep < access_steps; ++istep) {
-          Acts::Vector3D position = currentStep * dir;
-          // access the field directly
-          auto field_direct = bField.getField(position);
-          // access the field with the cell
-          auto field_from_cache = bField.getField(position, bCache);
-          // check
-          if (!field_direct.isApprox(field_from_cache)) { ++mismatched; }
-          // increase the step
-          currentStep += access_step;
-          // show the progress bar
-          ++show_progress;
-        }
+  switch (mode) {
+  case AccessMode::Direct:
+    return "direct";
+  case AccessMode::Cached:
+    return "cached";
+  case AccessMode::Batch:
+    return "batch";
+  }
+  return "unknown";
+}
+
+/// Positions for one access pattern, addressed by a global lookup index.
+struct AccessPattern
+{
+  std::string name;
+  size_t      numLookups = 0;
+  // step-wise access along straight tracks through the origin
+  std::vector<Acts::Vector3D> directions;
+  size_t                      steps      = 1;
+  double                      stepLength = 0.;
+  // random access cycling through a pool of positions
+  std::vector<Acts::Vector3D> pool;
+
+  /// Number of lookups after which the positions repeat.
+  size_t
+  period() const
+  {
+    return pool.empty() ? (steps * directions.size()) : pool.size();
+  }
+
+  void
+  fill(size_t first, size_t num, Acts::Vector3D* positions) const
+  {
+    if (pool.empty()) {
+      for (size_t i = 0; i < num; ++i) {
+        size_t index = first + i;
+        size_t track = (index / steps) % directions.size();
+        positions[i] = ((index % steps) * stepLength) * directions[track];
+      }
+    } else {
+      for (size_t i = 0; i < num; ++i) {
+        positions[i] = pool[(first + i) % pool.size()];
       }
     }
-    std::cout << "[<<<] End result : " << mismatched << "/" << totalSteps
-              << " mismatches" << std::endl;
   }
+};
+
+AccessPattern
+makeStepWisePattern(size_t events,
+                    size_t theta_steps,
+                    double theta_0,
+                    double theta_step,
+                    size_t phi_steps,
+                    double phi_0,
+                    double phi_step,
+                    size_t access_steps,
+                    double access_step)
+{
+  AccessPattern pattern;
+  pattern.name = "stepwise";
+  for (size_t itheta = 0; itheta < theta_steps; ++itheta) {
+    double theta = theta_0 + itheta * theta_step;
+    for (size_t iphi = 0; iphi < phi_steps; ++iphi) {
+      double phi = phi_0 + iphi * phi_step;
+      pattern.directions.emplace_back(
+          cos(phi) * sin(theta), sin(phi) * sin(theta), cos(theta));
+    }
+  }
+  pattern.steps      = access_steps;
+  pattern.stepLength = access_step;
+  pattern.numLookups = events * pattern.directions.size() * access_steps;
+  return pattern;
 }
 
-template <typename field_t, typename field_context_t>
-void
-accessRandom(field_t&         bField,
-             field_context_t& bFieldContext,
-             size_t           totalSteps,
-             double           radius)
+AccessPattern
+makeRandomPattern(size_t numLookups, double radius)
 {
-  std::cout << "[>>>] Start: random access pattern ... " << std::endl;
-  size_t       mismatched = 0;
+  AccessPattern pattern;
+  pattern.name = "random";
   RandomEngine rng;
   UniformDist  xDist(-radius, radius);
   UniformDist  yDist(-radius, radius);
   UniformDist  zDist(-radius, radius);
+  pattern.pool.resize(std::min(numLookups, kRandomPoolSize));
+  for (auto& position : pattern.pool) {
+    position = Acts::Vector3D(xDist(rng), yDist(rng), zDist(rng));
+  }
+  pattern.numLookups = numLookups;
+  return pattern;
+}
+
+/// Detect field caches that hold the last interpolation cell.
+template <typename cache_t, typename = void>
+struct HasFieldCell : std::false_type
+{
+};
+template <typename cache_t>
+struct HasFieldCell<
+    cache_t,
+    std::void_t<decltype(std::declval<cache_t&>().initialized),
+                decltype(std::declval<cache_t&>().fieldCell->isInside(
+                    std::declval<Acts::Vector3D>()))>> : std::true_type
+{
+};
+
+struct Validation
+{
+  size_t lookups    = 0;
+  size_t mismatched = 0;
+  // negative if the field cache has no cell
+  double hitRate = -1.;
+};
+
+/// Compare all access modes and measure the cell reuse of the field cache.
+template <typename field_t>
+Validation
+validate(const field_t&                    bField,
+         const Acts::MagneticFieldContext& bFieldContext,
+         const AccessPattern&              pattern,
+         size_t                            batchSize)
+{
+  using Cache = typename field_t::Cache;
+
+  Validation result;
+  result.lookups = std::min(pattern.numLookups, kValidationSize);
 
-  // initialize the field cache
-  typename field_t::Cache bCache(bFieldContext);
-  boost::progress_display show_progress(totalSteps);
-
-  // the event loop
-  // loop over the events - @todo move to parallel for
-  for (size_t istep = 0; istep < totalSteps; ++istep) {
-    Acts::Vector3D position(xDist(rng), yDist(rng), zDist(rng));
-    // access the field directly
-    auto field_direct = bField.getField(position);
-    // access the field with the cell
-    auto field_from_cache = bField.getField(position, bCache);
-    // check
-    if (!field_direct.isApprox(field_from_cache)) { ++mismatched; }
-    // show the progress bar
-    ++show_progress;
+  Cache                       bCache(bFieldContext);
+  Cache                       bBatchCache(bFieldContext);
+  std::vector<Acts::Vector3D> positions(batchSize);
+  std::vector<Acts::Vector3D> fields(batchSize);
+  size_t                      hits = 0;
+  for (size_t first = 0; first < result.lookups; first += batchSize) {
+    size_t num = std::min(batchSize, result.lookups - first);
+    pattern.fill(first, num, positions.data());
+    FW::BField::getFieldBatch(
+        bField, positions.data(), fields.data(), num, bBatchCache);
+    for (size_t i = 0; i < num; ++i) {
+      if constexpr (HasFieldCell<Cache>::value) {
+        if (bCache.initialized and bCache.fieldCell->isInside(positions[i])) {
+          ++hits;
+        }
+      }
+      auto field_direct     = bField.getField(positions[i]);
+      auto field_from_cache = bField.getField(positions[i], bCache);
+      if (!field_direct.isApprox(field_from_cache)
+          or !field_direct.isApprox(fields[i])) {
+        ++result.mismatched;
+      }
+    }
+  }
+  if (HasFieldCell<Cache>::value and (0 < result.lookups)) {
+    result.hitRate = static_cast<double>(hits) / result.lookups;
   }
-  std::cout << "[<<<] End result : " << mismatched << "/" << totalSteps
-            << " mismatches" << std::endl;
+  return result;
 }
 
+/// Time all lookups of the pattern split evenly over the threads.
+///
+/// @param positions All positions of one pattern period, generated before
+///                  the measurement so only the field lookups are timed
+/// @return wall clock time in seconds
+template <typename field_t>
+double
+measure(const field_t&                     bField,
+        const Acts::MagneticFieldContext&  bFieldContext,
+        const AccessPattern&               pattern,
+        const std::vector<Acts::Vector3D>& positions,
+        AccessMode                         mode,
+        size_t                             numThreads,
+        size_t                             batchSize)
+{
+  std::vector<double> sinks(numThreads, 0.);
+
+  auto work = [&](size_t ithread) {
+    size_t first = pattern.numLookups * ithread / numThreads;
+    size_t last  = pattern.numLookups * (ithread + 1) / numThreads;
+    // each thread owns its cache, as each propagation would
+    typename field_t::Cache     bCache(bFieldContext);
+    std::vector<Acts::Vector3D> fields(batchSize);
+    double                      sink = 0.;
+    size_t                      num  = 0;
+    for (size_t chunk = first; chunk < last; chunk += num) {
+      // chunks must not wrap around the end of the period
+      size_t                offset = chunk % positions.size();
+      const Acts::Vector3D* chunkPositions = positions.data() + offset;
+      num = std::min({batchSize, last - chunk, positions.size() - offset});
+      switch (mode) {
+      case AccessMode::Direct:
+        for (size_t i = 0; i < num; ++i) {
+          fields[i] = bField.getField(chunkPositions[i]);
+        }
+        break;
+      case AccessMode::Cached:
+        for (size_t i = 0; i < num; ++i) {
+          fields[i] = bField.getField(chunkPositions[i], bCache);
+        }
+        break;
+      case AccessMode::Batch:
+        FW::BField::getFieldBatch(
+            bField, chunkPositions, fields.data(), num, bCache);
+        break;
+      }
+      sink += fields[num - 1].x();
+    }
+    sinks[ithread] = sink;
+  };
+
+  auto                     start = Clock::now();
+  std::vector<std::thread> threads;
+  for (size_t ithread = 1; ithread < numThreads; ++ithread) {
+    threads.emplace_back(work, ithread);
+  }
+  work(0);
+  for (auto& thread : threads) { thread.join(); }
+  auto stop = Clock::now();
+
+  for (double sink : sinks) { g_sink = g_sink + sink; }
+  return std::chrono::duration<double>(stop - start).count();
+}
+
+/// Thread counts 1, 2, 4, ... up to and including the maximum.
+std::vector<size_t>
+threadCounts(size_t maxThreads)
+{
+  std::vector<size_t> counts;
+  for (size_t n = 1; n < maxThreads; n *= 2) { counts.push_back(n); }
+  counts.push_back(maxThreads);
+  return counts;
+}
+
+template <typename field_t>
+void
+runBenchmark(const field_t&                    bField,
+             const Acts::MagneticFieldContext& bFieldContext,
+             const std::vector<AccessPattern>& patterns,
+             size_t                            maxThreads,
+             size_t                            batchSize,
+             std::ostream*                     csv)
+{
+  std::string field = FW::BField::fieldTypeName<field_t>();
+
+  std::cout << "[>>>] Benchmark field access for '" << field << "' with up to "
+            << maxThreads << " threads" << std::endl;
+  for (const auto& pattern : patterns) {
+    auto check = validate(bField, bFieldContext, pattern, batchSize);
+    std::cout << "[---] " << pattern.name << ": " << check.mismatched << "/"
+              << check.lookups << " mismatches, cache cell hit rate ";
+    if (check.hitRate < 0) {
+      std::cout << "n/a" << std::endl;
+    } else {
+      std::cout << check.hitRate << std::endl;
+    }
+
+    std::vector<Acts::Vector3D> positions(pattern.period());
+    pattern.fill(0, positions.size(), positions.data());
+    for (auto mode :
+         {AccessMode::Direct, AccessMode::Cached, AccessMode::Batch}) {
+      double reference = 0.;
+      for (size_t numThreads : threadCounts(maxThreads)) {
+        double seconds = measure(bField,
+                                 bFieldContext,
+                                 pattern,
+                                 positions,
+                                 mode,
+                                 numThreads,
+                                 batchSize);
+        if (numThreads == 1) { reference = seconds; }
+        double nsPerLookup = 1e9 * seconds / pattern.numLookups;
+        double speedup     = (0 < seconds) ? (reference / seconds) : 0.;
+        std::cout << "[<<<] " << std::setw(8) << pattern.name << " "
+                  << std::setw(6) << accessModeName(mode) << " "
+                  << std::setw(3) << numThreads << " threads: "
+                  << nsPerLookup << " ns/lookup, speedup " << speedup
+                  << std::endl;
+        if (csv) {
+          (*csv) << field << "," << pattern.name << ","
+                 << accessModeName(mode) << "," << numThreads << ","
+                 << pattern.numLookups << "," << seconds << ","
+                 << nsPerLookup << "," << speedup << "," << check.hitRate
+                 << "," << check.mismatched << '\n';
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 /// @brief main executable
 ///
 /// @param argc The argument count
@@ -151,18 +384,27 @@ main(int argc, char* argv[])
       "number of steps for magnetic field access.")(
       "bf-tracklength",
       po::value<double>()->default_value(100.),
-      "track length in [mm] magnetic field access.");
+      "track length in [mm] magnetic field access.")(
+      "bf-batchsize",
+      po::value<size_t>()->default_value(1024),
+      "number of positions per batch for the batch field access.")(
+      "bf-benchmark-csv",
+      po::value<std::string>()->default_value(""),
+      "Write the benchmark results to this csv file. Omit to only print.");
   auto vm = FW::Options::parse(desc, argc, argv);
   if (vm.empty()) { return EXIT_FAILURE; }
 
-  // A test magnetic field context
-  Acts::MagneticFieldContext magFieldContext = Acts::MagneticFieldContext();
+  // The scalable field requires its context, all others ignore it
+  Acts::MagneticFieldContext magFieldContext
+      = FW::BField::ScalableBFieldContext();
 
-  // TODO
-  // Why does this need number-of-events? If it really does emulate
-  // per-event access patterns this should be switched to a proper
-  // Sequencer-based tool. Otherwise it should be removed.
-  auto nEvents   = FW::Options::readSequencerConfig(vm).events;
+  // the events repeat the step-wise access pattern
+  auto seqCfg  = FW::Options::readSequencerConfig(vm);
+  auto nEvents = (seqCfg.events == SIZE_MAX) ? size_t(1) : seqCfg.events;
+  auto nThreads
+      = (seqCfg.numThreads < 0)
+      ? std::max<size_t>(std::thread::hardware_concurrency(), 1)
+      : std::max<size_t>(seqCfg.numThreads, 1);
   auto bFieldVar = FW::Options::readBField(vm);
 
   // Get the phi and eta range
@@ -182,38 +424,42 @@ main(int argc, char* argv[])
   double theta_span  = std::abs(thetar[1] - thetar[0]);
   double theta_step  = theta_span / theta_steps;
   double access_step = track_length / access_steps;
+  size_t batch_size  = std::max<size_t>(vm["bf-batchsize"].as<size_t>(), 1);
+
+  std::vector<AccessPattern> patterns;
+  patterns.push_back(makeStepWisePattern(nEvents,
+                                         theta_steps,
+                                         thetar[0],
+                                         theta_step,
+                                         phi_steps,
+                                         phir[0],
+                                         phi_step,
+                                         access_steps,
+                                         access_step));
+  patterns.push_back(
+      makeRandomPattern(patterns.front().numLookups, track_length));
+
+  std::ofstream csv;
+  auto          csvPath = vm["bf-benchmark-csv"].as<std::string>();
+  if (not csvPath.empty()) {
+    csv.open(csvPath);
+    if (not csv.good()) {
+      std::cerr << "Could not open '" << csvPath << "'" << std::endl;
+      return EXIT_FAILURE;
+    }
+    csv << "field,pattern,mode,threads,lookups,seconds,ns_per_lookup,speedup,"
+           "hit_rate,mismatches\n";
+  }
 
   return std::visit(
       [&](auto& bField) -> int {
-        using field_type =
-            typename std::decay_t<decltype(bField)>::element_type;
-        if constexpr (
-            !std::is_same_v<
-                field_type,
-                InterpolatedBFieldMap2D> && !std::is_same_v<field_type, InterpolatedBFieldMap3D>) {
-          std::cout << "Bfield map could not be read. Exiting." << std::endl;
-          return EXIT_FAILURE;
-        } else {
-
-          // Step-wise access pattern
-          accessStepWise(*bField,
-                         magFieldContext,
-                         nEvents,
-                         theta_steps,
-                         thetar[0],
-                         theta_step,
-                         phi_steps,
-                         phir[0],
-                         phi_step,
-                         access_steps,
-                         access_step);
-          // Random access pattern
-          accessRandom(*bField,
-                       magFieldContext,
-                       nEvents * theta_steps * phi_steps * access_steps,
-                       track_length);
-          return EXIT_SUCCESS;
-        }
+        runBenchmark(*bField,
+                     magFieldContext,
+                     patterns,
+                     nThreads,
+                     batch_size,
+                     csvPath.empty() ? nullptr : &csv);
+        return EXIT_SUCCESS;
       },
       bFieldVar);
 }
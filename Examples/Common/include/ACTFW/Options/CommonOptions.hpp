@@ -64,6 +64,9 @@ namespace Options {
   readLogLevel(const boost::program_options::variables_map& vm);
 
   /// Read the sequencer config.
+  ///
+  /// This also enables ROOT's implicit multi-threading if requested. It must
+  /// thus be called before any ROOT reader or writer is created.
   Sequencer::Config
   readSequencerConfig(const boost::program_options::variables_map& vm);
 
@@ -0,0 +1,25 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace FW {
+class IBaseDetector;
+}
+
+/// The Propagation benchmark
+///
+/// Builds the geometry and the magnetic field once and then times the
+/// propagation for the full matrix of steppers, pT and eta bins, step size
+/// limits and material interaction settings.
+///
+/// @param argc the number of argumetns of the call
+/// @param argv the argument list
+/// @param detector The detector descriptor instance
+int
+propagationBenchmark(int argc, char* argv[], FW::IBaseDetector& detector);
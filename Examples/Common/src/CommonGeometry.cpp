@@ -16,6 +16,7 @@
 
 #include "ACTFW/Detector/IBaseDetector.hpp"
 #include "ACTFW/Geometry/MaterialWiper.hpp"
+#include "ACTFW/Io/Binary/BinaryMaterialDecorator.hpp"
 #include "ACTFW/Io/Root/RootMaterialDecorator.hpp"
 
 namespace FW {
@@ -44,7 +45,7 @@ namespace Geometry {
     } else if (matType == "file") {
       // Retrieve the filename
       auto fileName = vm["mat-input-file"].template as<std::string>();
-      // json or root based decorator
+      // json, root, or binary based decorator
       if (fileName.find(".json") != std::string::npos) {
         // Set up the converter first
         Acts::JsonGeometryConverter::Config jsonGeoConvConfig;
@@ -57,6 +58,12 @@ namespace Geometry {
         rootMatDecConfig.fileName = fileName;
         matDeco = std::make_shared<const FW::RootMaterialDecorator>(
             rootMatDecConfig);
+      } else if (fileName.find(".bmat") != std::string::npos) {
+        // Set up the lazily decoding binary decorator
+        FW::BinaryMaterialDecorator::Config binMatDecConfig;
+        binMatDecConfig.fileName = fileName;
+        matDeco = std::make_shared<const FW::BinaryMaterialDecorator>(
+            binMatDecConfig);
       }
     }
 
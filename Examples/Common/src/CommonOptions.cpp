@@ -8,6 +8,7 @@
 
 #include "ACTFW/Options/CommonOptions.hpp"
 
+#include "ACTFW/Io/Root/RootImplicitMT.hpp"
 #include "ACTFW/Utilities/Options.hpp"
 
 using namespace boost::program_options;
@@ -41,7 +42,15 @@ FW::Options::addSequencerOptions(
       "The number of events to skip")(
       "jobs,j",
       value<int>()->default_value(-1),
-      "Number of parallel jobs, negative for automatic.");
+      "Number of parallel jobs, negative for automatic.")(
+      "write-queue",
+      value<size_t>()->default_value(0),
+      "Run each writer in a dedicated thread with up to this many queued "
+      "events. Zero to write synchronously.")(
+      "root-implicit-mt",
+      bool_switch(),
+      "Enable ROOT's implicit multi-threading for all ROOT input and output, "
+      "e.g. to (de)compress branches or ntuple pages in parallel.");
 }
 
 void
@@ -81,7 +90,8 @@ FW::Options::addMaterialOptions(
       "The way material is loaded: 'none', 'build', 'proto', 'file'.")(
       "mat-input-file",
       value<std::string>()->default_value(""),
-      "Name of the material map input file, supported: '.json' or '.root'.")(
+      "Name of the material map input file, supported: '.json', '.root', or "
+      "'.bmat'.")(
       "mat-output-file",
       value<std::string>()->default_value(""),
       "Name of the material map output file (without extension).")(
@@ -115,9 +125,20 @@ FW::Options::addOutputOptions(boost::program_options::options_description& opt)
       "output-root",
       value<bool>()->default_value(false),
       "Switch on to write '.root' output file(s).")(
+      "output-root-parallel",
+      value<bool>()->default_value(false),
+      "Fill '.root' output trees in parallel and merge in the background.")(
+      "output-root-ntuple",
+      value<bool>()->default_value(false),
+      "Write RNTuples instead of trees for '.root' step and track output. "
+      "Pages are only compressed in parallel with --root-implicit-mt.")(
       "output-csv",
       value<bool>()->default_value(false),
       "Switch on to write '.csv' output file(s).")(
+      "output-binary",
+      value<bool>()->default_value(false),
+      "Switch on to write binary '.evc' event and '.bmat' material map "
+      "output file(s).")(
       "output-obj",
       value<bool>()->default_value(false),
       "Switch on to write '.obj' ouput file(s).")(
@@ -148,7 +169,16 @@ FW::Options::addInputOptions(boost::program_options::options_description& opt)
                                            "Switch on to read '.obj' file(s).")(
       "input-json",
       value<bool>()->default_value(false),
-      "Switch on to read '.json' file(s).");
+      "Switch on to read '.json' file(s).")(
+      "input-prefetch",
+      value<size_t>()->default_value(0),
+      "Number of events to read ahead in background I/O threads, 0 to "
+      "disable prefetching.")("input-shard",
+                              value<size_t>()->default_value(0),
+                              "Only read events from this input shard.")(
+      "input-num-shards",
+      value<size_t>()->default_value(1),
+      "Split the available input events into this many shards.");
 }
 
 boost::program_options::variables_map
@@ -182,6 +212,11 @@ FW::Options::readSequencerConfig(
   if (not vm["events"].empty()) { cfg.events = vm["events"].as<size_t>(); }
   cfg.logLevel   = readLogLevel(vm);
   cfg.numThreads = vm["jobs"].as<int>();
+  cfg.writeQueue = vm["write-queue"].as<size_t>();
+  // must be enabled before any ROOT reader or writer is created
+  if (vm["root-implicit-mt"].as<bool>()) {
+    enableRootImplicitMT(cfg.numThreads);
+  }
   if (not vm["output-dir"].empty()) {
     cfg.outputDir = vm["output-dir"].as<std::string>();
   }
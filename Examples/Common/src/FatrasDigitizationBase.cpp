@@ -14,6 +14,8 @@
 #include "ACTFW/Digitization/DigitizationAlgorithm.hpp"
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
+#include "ACTFW/Io/Binary/BinaryPlanarClusterWriter.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Io/Csv/CsvPlanarClusterWriter.hpp"
 #include "ACTFW/Io/Root/RootPlanarClusterWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
@@ -38,6 +40,7 @@ setupDigitization(boost::program_options::variables_map& vars,
   digiConfig.outputClusters      = "clusters";
   digiConfig.planarModuleStepper = pmStepper;
   digiConfig.randomNumbers       = randomNumbers;
+  digiConfig.mergeHits = vars["digi-merge-hits"].template as<bool>();
 
   // Create the algorithm and add it to the sequencer
   sequencer.addAlgorithm(
@@ -49,15 +52,24 @@ setupDigitization(boost::program_options::variables_map& vars,
   // Write digitisation output as Csv files
   if (vars["output-csv"].template as<bool>()) {
     // clusters as root
-    FW::CsvPlanarClusterWriter::Config clusterWriterCsvConfig;
+    auto clusterWriterCsvConfig
+        = FW::Options::readCsvPlanarClusterWriterConfig(vars);
     clusterWriterCsvConfig.inputClusters = digiConfig.outputClusters;
-    clusterWriterCsvConfig.outputDir     = outputDir;
     auto clusteWriterCsv
         = std::make_shared<FW::CsvPlanarClusterWriter>(clusterWriterCsvConfig);
     // Add to the sequencer
     sequencer.addWriter(clusteWriterCsv);
   }
 
+  // Write digitisation output as binary files
+  if (vars["output-binary"].template as<bool>()) {
+    FW::BinaryPlanarClusterWriter::Config clusterWriterBinaryConfig;
+    clusterWriterBinaryConfig.inputClusters = digiConfig.outputClusters;
+    clusterWriterBinaryConfig.outputDir     = outputDir;
+    sequencer.addWriter(std::make_shared<FW::BinaryPlanarClusterWriter>(
+        clusterWriterBinaryConfig));
+  }
+
   // Write digitsation output as ROOT files
   if (vars["output-root"].template as<bool>()) {
     // clusters as root
@@ -66,6 +78,8 @@ setupDigitization(boost::program_options::variables_map& vars,
     clusterWriterRootConfig.filePath
         = FW::joinPaths(outputDir, digiConfig.outputClusters + ".root");
     clusterWriterRootConfig.treeName = digiConfig.outputClusters;
+    clusterWriterRootConfig.parallelOutput
+        = vars["output-root-parallel"].template as<bool>();
     auto clusteWriterRoot = std::make_shared<FW::RootPlanarClusterWriter>(
         clusterWriterRootConfig);
     // Add to the sequencer
@@ -11,6 +11,8 @@
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Generators/EventGenerator.hpp"
+#include "ACTFW/Io/Binary/BinaryParticleWriter.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Io/Csv/CsvParticleWriter.hpp"
 #include "ACTFW/Io/Root/RootParticleWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
@@ -49,14 +51,23 @@ setupEvgenInput(boost::program_options::variables_map& vm,
 
   // Write particles as CSV files
   if (vm["output-csv"].template as<bool>()) {
-    FW::CsvParticleWriter::Config pWriterCsvConfig;
+    auto pWriterCsvConfig       = FW::Options::readCsvParticleWriterConfig(vm);
     pWriterCsvConfig.inputEvent = "particles";
-    pWriterCsvConfig.outputDir  = outputDir;
     pWriterCsvConfig.outputStem = "particles";
     sequencer.addWriter(
         std::make_shared<FW::CsvParticleWriter>(pWriterCsvConfig));
   }
 
+  // Write particles as binary file
+  if (vm["output-binary"].template as<bool>()) {
+    FW::BinaryParticleWriter::Config pWriterBinaryConfig;
+    pWriterBinaryConfig.inputEvent = "particles";
+    pWriterBinaryConfig.outputDir  = outputDir;
+    pWriterBinaryConfig.outputStem = "particles";
+    sequencer.addWriter(
+        std::make_shared<FW::BinaryParticleWriter>(pWriterBinaryConfig));
+  }
+
   // Write particles as ROOT file
   if (vm["output-root"].template as<bool>()) {
     // Write particles as ROOT TTree
@@ -64,6 +75,8 @@ setupEvgenInput(boost::program_options::variables_map& vm,
     pWriterRootConfig.collection = "particles";
     pWriterRootConfig.filePath   = FW::joinPaths(outputDir, "particles.root");
     pWriterRootConfig.treeName   = "particles";
+    pWriterRootConfig.parallelOutput
+        = vm["output-root-parallel"].template as<bool>();
     sequencer.addWriter(
         std::make_shared<FW::RootParticleWriter>(pWriterRootConfig));
   }
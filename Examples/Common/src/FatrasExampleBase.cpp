@@ -15,7 +15,7 @@
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Geometry/CommonGeometry.hpp"
-#include "ACTFW/Io/Csv/CsvParticleWriter.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
 #include "ACTFW/Options/ParticleGunOptions.hpp"
 #include "ACTFW/Options/Pythia8Options.hpp"
@@ -43,9 +43,13 @@ fatrasExample(int argc, char* argv[], FW::IBaseDetector& detector)
   FW::Options::addBFieldOptions(desc);
   FW::Options::addFatrasOptions(desc);
   FW::Options::addOutputOptions(desc);
+  FW::Options::addCsvWriterOptions(desc);
   desc.add_options()("evg-input-type",
                      value<std::string>()->default_value("pythia8"),
-                     "Type of evgen input 'gun', 'pythia8'");
+                     "Type of evgen input 'gun', 'pythia8'")(
+      "digi-merge-hits",
+      value<bool>()->default_value(false),
+      "Merge the cells of all hits on a module into connected clusters");
   // Add specific options for this geometry
   detector.addOptions(desc);
   auto vm = FW::Options::parse(desc, argc, argv);
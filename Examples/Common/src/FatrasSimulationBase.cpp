@@ -8,6 +8,8 @@
 
 #include "detail/FatrasSimulationBase.hpp"
 
+#include <stdexcept>
+
 #include <boost/program_options.hpp>
 
 #include "ACTFW/EventData/SimHit.hpp"
@@ -17,11 +19,17 @@
 #include "ACTFW/Fatras/FatrasOptions.hpp"
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
+#include "ACTFW/Generators/MultiplicityGenerators.hpp"
+#include "ACTFW/Io/Binary/BinaryPileupLibrary.hpp"
+#include "ACTFW/Io/Binary/BinaryPileupLibraryWriter.hpp"
+#include "ACTFW/Io/Binary/BinaryPileupOverlay.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Io/Csv/CsvParticleWriter.hpp"
 #include "ACTFW/Io/Root/RootParticleWriter.hpp"
 #include "ACTFW/Io/Root/RootSimHitWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
 #include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
 #include "ACTFW/Plugins/BField/ScalableBField.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
 #include "Acts/Geometry/GeometryID.hpp"
@@ -35,6 +43,7 @@
 #include "Acts/Propagator/StraightLineStepper.hpp"
 #include "Acts/Propagator/detail/DebugOutputActor.hpp"
 #include "Acts/Surfaces/Surface.hpp"
+#include "Acts/Utilities/Units.hpp"
 #include "ActsFatras/Kernel/Interactor.hpp"
 #include "ActsFatras/Kernel/Process.hpp"
 #include "ActsFatras/Kernel/SelectorList.hpp"
@@ -216,21 +225,80 @@ setupSimulationAlgorithm(
   auto fatrasConfig = FW::Options::readFatrasConfig(vm, std::move(simulator));
   fatrasConfig.randomNumberSvc      = randomNumberSvc;
   fatrasConfig.inputEventCollection = evgenCollection;
+  // the evgen writers run after the algorithms and need the generated event
+  if (fatrasConfig.consumeInputEvent
+      and (vm["output-csv"].template as<bool>()
+           or vm["output-binary"].template as<bool>()
+           or vm["output-root"].template as<bool>())) {
+    throw std::invalid_argument(
+        "The generated event can not be consumed by the simulation when it "
+        "is also written as particle output");
+  }
+
+  // the final simulation output, possibly including pile-up
+  std::string simulatedEvent = fatrasConfig.simulatedEventCollection;
+  std::string simulatedHits  = fatrasConfig.simulatedHitCollection;
+  std::string pileupLibrary
+      = vm["fatras-pileup-library"].template as<std::string>();
+  if (not pileupLibrary.empty()) {
+    fatrasConfig.simulatedEventCollection += "-hardscatter";
+    fatrasConfig.simulatedHitCollection += "-hardscatter";
+  }
 
   // Finally the fatras algorithm
   sequencer.addAlgorithm(
       std::make_shared<SimulationAlgorithm>(fatrasConfig, logLevel));
 
+  // Overlay pre-simulated pile-up events
+  if (not pileupLibrary.empty()) {
+    FW::BinaryPileupLibrary::Config libraryConfig;
+    libraryConfig.inputDir = pileupLibrary;
+    libraryConfig.inputStem
+        = vm["fatras-pileup-library-stem"].template as<std::string>();
+    libraryConfig.trackingGeometry = trackingGeometry;
+
+    FW::BinaryPileupOverlay::Config overlayConfig;
+    overlayConfig.inputEvent  = fatrasConfig.simulatedEventCollection;
+    overlayConfig.inputHits   = fatrasConfig.simulatedHitCollection;
+    overlayConfig.outputEvent = simulatedEvent;
+    overlayConfig.outputHits  = simulatedHits;
+    // the hard-scatter collections are only needed afterwards to write the
+    // pile-up library; never write a library of already stacked events
+    overlayConfig.consumeInput
+        = not vm["fatras-pileup-library-output"].template as<bool>();
+    overlayConfig.library
+        = std::make_shared<FW::BinaryPileupLibrary>(libraryConfig);
+    overlayConfig.randomNumbers = randomNumberSvc;
+    overlayConfig.multiplicity  = FW::PoissonMultiplicityGenerator{
+        vm["fatras-pileup-mu"].template as<size_t>()};
+    overlayConfig.timeStddev
+        = vm["fatras-pileup-time-sigma"].template as<double>()
+        * Acts::UnitConstants::ns;
+    sequencer.addAlgorithm(
+        std::make_shared<FW::BinaryPileupOverlay>(overlayConfig, logLevel));
+  }
+
   // Output directory
   std::string outputDir = vm["output-dir"].template as<std::string>();
 
+  // Write the simulated events w/o pile-up as a pile-up library
+  if (vm["fatras-pileup-library-output"].template as<bool>()) {
+    FW::BinaryPileupLibraryWriter::Config libraryWriterConfig;
+    libraryWriterConfig.inputEvent = fatrasConfig.simulatedEventCollection;
+    libraryWriterConfig.inputHits  = fatrasConfig.simulatedHitCollection;
+    libraryWriterConfig.outputDir  = outputDir;
+    libraryWriterConfig.outputStem
+        = vm["fatras-pileup-library-stem"].template as<std::string>();
+    sequencer.addWriter(
+        std::make_shared<FW::BinaryPileupLibraryWriter>(libraryWriterConfig));
+  }
+
   // Write simulation information as CSV files
   std::shared_ptr<FW::CsvParticleWriter> pWriterCsv = nullptr;
   if (vm["output-csv"].template as<bool>()) {
-    FW::CsvParticleWriter::Config pWriterCsvConfig;
-    pWriterCsvConfig.inputEvent = fatrasConfig.simulatedEventCollection;
-    pWriterCsvConfig.outputDir  = outputDir;
-    pWriterCsvConfig.outputStem = fatrasConfig.simulatedEventCollection;
+    auto pWriterCsvConfig       = FW::Options::readCsvParticleWriterConfig(vm);
+    pWriterCsvConfig.inputEvent = simulatedEvent;
+    pWriterCsvConfig.outputStem = simulatedEvent;
     sequencer.addWriter(
         std::make_shared<FW::CsvParticleWriter>(pWriterCsvConfig));
   }
@@ -240,19 +308,23 @@ setupSimulationAlgorithm(
   if (vm["output-root"].template as<bool>()) {
     // Write particles as ROOT TTree
     FW::RootParticleWriter::Config pWriterRootConfig;
-    pWriterRootConfig.collection = fatrasConfig.simulatedEventCollection;
-    pWriterRootConfig.filePath   = FW::joinPaths(
-        outputDir, fatrasConfig.simulatedEventCollection + ".root");
-    pWriterRootConfig.treeName = fatrasConfig.simulatedEventCollection;
+    pWriterRootConfig.collection = simulatedEvent;
+    pWriterRootConfig.filePath
+        = FW::joinPaths(outputDir, simulatedEvent + ".root");
+    pWriterRootConfig.treeName = simulatedEvent;
+    pWriterRootConfig.parallelOutput
+        = vm["output-root-parallel"].template as<bool>();
     sequencer.addWriter(
         std::make_shared<FW::RootParticleWriter>(pWriterRootConfig));
 
     // Write simulated hits as ROOT TTree
     FW::RootSimHitWriter::Config fhitWriterRootConfig;
-    fhitWriterRootConfig.collection = fatrasConfig.simulatedHitCollection;
-    fhitWriterRootConfig.filePath   = FW::joinPaths(
-        outputDir, fatrasConfig.simulatedHitCollection + ".root");
-    fhitWriterRootConfig.treeName = fatrasConfig.simulatedHitCollection;
+    fhitWriterRootConfig.collection = simulatedHits;
+    fhitWriterRootConfig.filePath
+        = FW::joinPaths(outputDir, simulatedHits + ".root");
+    fhitWriterRootConfig.treeName = simulatedHits;
+    fhitWriterRootConfig.parallelOutput
+        = vm["output-root-parallel"].template as<bool>();
     sequencer.addWriter(
         std::make_shared<FW::RootSimHitWriter>(fhitWriterRootConfig));
   }
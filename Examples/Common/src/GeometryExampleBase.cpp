@@ -18,6 +18,7 @@
 #include "ACTFW/Framework/IContextDecorator.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Geometry/CommonGeometry.hpp"
+#include "ACTFW/Io/Binary/BinaryMaterialWriter.hpp"
 #include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Io/Csv/CsvTrackingGeometryWriter.hpp"
 #include "ACTFW/Io/Root/RootMaterialWriter.hpp"
@@ -184,6 +185,22 @@ processGeometry(int argc, char* argv[], FW::IBaseDetector& detector)
 
       jmwImpl.write(*tGeometry);
     }
+
+    if (!materialFileName.empty() and vm["output-binary"].template as<bool>()) {
+      // The writer of the lazily decoded binary material
+      FW::BinaryMaterialWriter::Config bmwConfig;
+      bmwConfig.fileName = materialFileName + ".bmat";
+      bmwConfig.processSensitives
+          = vm["mat-output-sensitives"].template as<bool>();
+      bmwConfig.processApproaches
+          = vm["mat-output-approaches"].template as<bool>();
+      bmwConfig.processRepresenting
+          = vm["mat-output-representing"].template as<bool>();
+      bmwConfig.processBoundaries
+          = vm["mat-output-boundaries"].template as<bool>();
+      FW::BinaryMaterialWriter bmwImpl(bmwConfig);
+      bmwImpl.write(*tGeometry);
+    }
   }
 
   return 0;
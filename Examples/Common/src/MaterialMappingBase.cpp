@@ -21,6 +21,7 @@
 #include "ACTFW/Detector/IBaseDetector.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Geometry/CommonGeometry.hpp"
+#include "ACTFW/Io/Binary/BinaryMaterialWriter.hpp"
 #include "ACTFW/Io/Root/RootMaterialTrackReader.hpp"
 #include "ACTFW/Io/Root/RootMaterialTrackWriter.hpp"
 #include "ACTFW/Io/Root/RootMaterialWriter.hpp"
@@ -125,6 +126,8 @@ materialMappingExample(int argc, char* argv[], FW::IBaseDetector& detector)
     matTrackWriterRootConfig.filePath   = materialFileName + "_tracks.root";
     matTrackWriterRootConfig.collection = mmAlgConfig.mappingMaterialCollection;
     matTrackWriterRootConfig.storesurface = true;
+    matTrackWriterRootConfig.ntupleOutput
+        = vm["output-root-ntuple"].template as<bool>();
     auto matTrackWriterRoot = std::make_shared<FW::RootMaterialTrackWriter>(
         matTrackWriterRootConfig, logLevel);
 
@@ -157,6 +160,17 @@ materialMappingExample(int argc, char* argv[], FW::IBaseDetector& detector)
         std::make_shared<JsonWriter>(std::move(jmwImpl)));
   }
 
+  if (!materialFileName.empty() and vm["output-binary"].template as<bool>()) {
+    // The writer of the lazily decoded binary material
+    FW::BinaryMaterialWriter::Config bmwConfig;
+    bmwConfig.fileName = materialFileName + ".bmat";
+    FW::BinaryMaterialWriter bmwImpl(bmwConfig);
+    // Fullfill the IMaterialWriter interface
+    using BinaryWriter = FW::MaterialWriterT<FW::BinaryMaterialWriter>;
+    mmAlgConfig.materialWriters.push_back(
+        std::make_shared<BinaryWriter>(std::move(bmwImpl)));
+  }
+
   // Create the material mapping
   auto mmAlg = std::make_shared<FW::MaterialMapping>(mmAlgConfig);
 
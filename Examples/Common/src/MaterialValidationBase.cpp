@@ -25,9 +25,11 @@
 #include "ACTFW/Io/Root/RootMaterialTrackWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
 #include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
 #include "ACTFW/Plugins/BField/ScalableBField.hpp"
 #include "ACTFW/Propagation/PropagationAlgorithm.hpp"
 #include "ACTFW/Propagation/PropagationOptions.hpp"
+#include "ACTFW/Propagation/StraightLineBundlePropagator.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
 
 namespace po = boost::program_options;
@@ -107,6 +109,13 @@ setupStraightLinePropagation(
   // Read the propagation config and create the algorithms
   auto pAlgConfig = FW::Options::readPropagationConfig(vm, propagator);
   pAlgConfig.randomNumberSvc = randomNumberSvc;
+  // Optionally propagate all tracks of an event together
+  if (vm["prop-bundle"].template as<bool>()) {
+    pAlgConfig.straightLineBundle
+        = std::make_shared<FW::StraightLineBundlePropagator>(tGeometry);
+    pAlgConfig.straightLineBundleChecks
+        = vm["prop-bundle-checks"].template as<size_t>();
+  }
   auto propagationAlg = std::make_shared<FW::PropagationAlgorithm<Propagator>>(
       pAlgConfig, logLevel);
 
@@ -131,6 +140,14 @@ materialValidationExample(int argc, char* argv[], FW::IBaseDetector& detector)
   FW::Options::addRandomNumbersOptions(desc);
   FW::Options::addPropagationOptions(desc);
   FW::Options::addOutputOptions(desc);
+  desc.add_options()(
+      "prop-bundle",
+      po::value<bool>()->default_value(false),
+      "Propagate all straight line tracks of an event together.")(
+      "prop-bundle-checks",
+      po::value<size_t>()->default_value(0),
+      "Number of bundle propagated tracks per event that are checked "
+      "against the propagator.");
 
   // Add specific options for this geometry
   detector.addOptions(desc);
@@ -181,6 +198,8 @@ materialValidationExample(int argc, char* argv[], FW::IBaseDetector& detector)
     matTrackWriterRootConfig.filePath
         = FW::joinPaths(outputDir, matCollection + ".root");
     matTrackWriterRootConfig.storesurface = true;
+    matTrackWriterRootConfig.ntupleOutput
+        = vm["output-root-ntuple"].template as<bool>();
     auto matTrackWriterRoot = std::make_shared<FW::RootMaterialTrackWriter>(
         matTrackWriterRootConfig, logLevel);
     sequencer.addWriter(matTrackWriterRoot);
@@ -0,0 +1,453 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Propagation/PropagationBenchmarkBase.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <Acts/EventData/TrackParameters.hpp>
+#include <Acts/Geometry/GeometryContext.hpp>
+#include <Acts/Geometry/TrackingGeometry.hpp>
+#include <Acts/MagneticField/ConstantBField.hpp>
+#include <Acts/MagneticField/InterpolatedBFieldMap.hpp>
+#include <Acts/MagneticField/MagneticFieldContext.hpp>
+#include <Acts/MagneticField/SharedBField.hpp>
+#include <Acts/Propagator/AbortList.hpp>
+#include <Acts/Propagator/ActionList.hpp>
+#include <Acts/Propagator/AtlasStepper.hpp>
+#include <Acts/Propagator/EigenStepper.hpp>
+#include <Acts/Propagator/MaterialInteractor.hpp>
+#include <Acts/Propagator/Navigator.hpp>
+#include <Acts/Propagator/Propagator.hpp>
+#include <Acts/Propagator/StraightLineStepper.hpp>
+#include <Acts/Propagator/detail/StandardAborters.hpp>
+#include <Acts/Surfaces/PerigeeSurface.hpp>
+#include <Acts/Utilities/Units.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/program_options.hpp>
+#include <dfe/dfe_io_dsv.hpp>
+#include <dfe/dfe_namedtuple.hpp>
+
+#include "ACTFW/Detector/IBaseDetector.hpp"
+#include "ACTFW/Geometry/CommonGeometry.hpp"
+#include "ACTFW/Options/CommonOptions.hpp"
+#include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/BFieldTypeName.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
+#include "ACTFW/Plugins/BField/ScalableBField.hpp"
+#include "ACTFW/Utilities/Options.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+
+using namespace Acts::UnitLiterals;
+
+namespace po = boost::program_options;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/// Loop protection is activated below this transverse momentum, as in the
+/// propagation algorithm.
+constexpr double kPtLoopers = 300_MeV;
+
+const char*
+stepperName(int stepper)
+{
+  switch (stepper) {
+  case 0:
+    return "straightline";
+  case 1:
+    return "eigen";
+  case 2:
+    return "atlas";
+  }
+  return "unknown";
+}
+
+/// Navigator that counts how often the propagator calls it.
+///
+/// The counter is shared by all copies of the navigator, i.e. the one that
+/// is copied into the propagator and the one owned by the benchmark.
+class CountingNavigator
+{
+public:
+  using State      = Acts::Navigator::State;
+  using state_type = State;
+
+  CountingNavigator(Acts::Navigator navigator)
+    : m_navigator(std::move(navigator)), m_calls(std::make_shared<size_t>(0))
+  {
+  }
+
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  status(propagator_state_t& state, const stepper_t& stepper) const
+  {
+    ++(*m_calls);
+    m_navigator.status(state, stepper);
+  }
+
+  template <typename propagator_state_t, typename stepper_t>
+  void
+  target(propagator_state_t& state, const stepper_t& stepper) const
+  {
+    ++(*m_calls);
+    m_navigator.target(state, stepper);
+  }
+
+  /// Number of calls since the last reset
+  size_t
+  calls() const
+  {
+    return *m_calls;
+  }
+
+  void
+  reset() const
+  {
+    *m_calls = 0;
+  }
+
+private:
+  Acts::Navigator         m_navigator;
+  std::shared_ptr<size_t> m_calls;
+};
+
+/// One point of the benchmark matrix besides the stepper.
+struct Configuration
+{
+  double pt       = 1_GeV;
+  double etaMin   = 0.;
+  double etaMax   = 0.;
+  double maxStep  = 3_m;
+  bool   material = false;
+};
+
+/// One row of the output table.
+struct BenchmarkRow
+{
+  std::string field;
+  std::string stepper;
+  double      pt_GeV;
+  double      eta_min;
+  double      eta_max;
+  double      max_step_mm;
+  bool        material;
+  size_t      tracks;
+  size_t      failures;
+  double      time_per_track_us;
+  double      steps_per_track;
+  double      navigation_calls_per_track;
+
+  DFE_NAMEDTUPLE(BenchmarkRow,
+                 field,
+                 stepper,
+                 pt_GeV,
+                 eta_min,
+                 eta_max,
+                 max_step_mm,
+                 material,
+                 tracks,
+                 failures,
+                 time_per_track_us,
+                 steps_per_track,
+                 navigation_calls_per_track);
+};
+
+/// Start parameters for a configuration.
+///
+/// The same seed is used for all configurations so that all steppers and
+/// settings see identical tracks for a given pT and eta bin.
+std::vector<Acts::BoundParameters>
+generateTracks(const Acts::GeometryContext& geoContext,
+               const Configuration&         cfg,
+               size_t                       ntracks,
+               uint64_t                     seed)
+{
+  auto perigee = Acts::Surface::makeShared<Acts::PerigeeSurface>(
+      Acts::Vector3D(0., 0., 0.));
+
+  std::mt19937                           rng(seed);
+  std::uniform_real_distribution<double> phiDist(-M_PI, M_PI);
+  std::uniform_real_distribution<double> etaDist(cfg.etaMin, cfg.etaMax);
+  std::uniform_real_distribution<double> qDist(0., 1.);
+
+  std::vector<Acts::BoundParameters> tracks;
+  tracks.reserve(ntracks);
+  for (size_t it = 0; it < ntracks; ++it) {
+    double phi    = phiDist(rng);
+    double theta  = 2 * std::atan(std::exp(-etaDist(rng)));
+    double charge = qDist(rng) > 0.5 ? 1. : -1.;
+    double p      = cfg.pt / std::sin(theta);
+    // parameters
+    Acts::BoundVector pars;
+    pars << 0., 0., phi, theta, charge / p, 0.;
+    tracks.emplace_back(geoContext, std::nullopt, std::move(pars), perigee);
+  }
+  return tracks;
+}
+
+/// Time the propagation of all tracks for one configuration.
+template <typename propagator_t>
+BenchmarkRow
+runConfiguration(const propagator_t&                       propagator,
+                 const CountingNavigator&                  navigator,
+                 const Acts::GeometryContext&              geoContext,
+                 const Acts::MagneticFieldContext&         magFieldContext,
+                 const Configuration&                      cfg,
+                 const std::vector<Acts::BoundParameters>& tracks)
+{
+  using MaterialInteractor = Acts::MaterialInteractor;
+  using EndOfWorld         = Acts::detail::EndOfWorldReached;
+  using ActionList         = Acts::ActionList<MaterialInteractor>;
+  using AbortList          = Acts::AbortList<EndOfWorld>;
+  using PropagatorOptions  = Acts::PropagatorOptions<ActionList, AbortList>;
+
+  PropagatorOptions options(geoContext, magFieldContext);
+  options.maxStepSize    = cfg.maxStep;
+  options.loopProtection = (cfg.pt < kPtLoopers);
+  // Switch the material interaction on/off
+  auto& mInteractor              = options.actionList.get<MaterialInteractor>();
+  mInteractor.multipleScattering = cfg.material;
+  mInteractor.energyLoss         = cfg.material;
+  mInteractor.recordInteractions = false;
+
+  BenchmarkRow row;
+  row.pt_GeV      = cfg.pt / 1_GeV;
+  row.eta_min     = cfg.etaMin;
+  row.eta_max     = cfg.etaMax;
+  row.max_step_mm = cfg.maxStep / 1_mm;
+  row.material    = cfg.material;
+  row.tracks      = tracks.size();
+  row.failures    = 0;
+
+  size_t steps = 0;
+  navigator.reset();
+  auto start = Clock::now();
+  for (const auto& track : tracks) {
+    auto result = propagator.propagate(track, options);
+    if (result.ok()) {
+      steps += result.value().steps;
+    } else {
+      ++row.failures;
+    }
+  }
+  auto stop = Clock::now();
+
+  double ntracks = std::max<size_t>(tracks.size(), 1);
+  row.time_per_track_us
+      = std::chrono::duration<double, std::micro>(stop - start).count()
+      / ntracks;
+  row.steps_per_track            = steps / ntracks;
+  row.navigation_calls_per_track = navigator.calls() / ntracks;
+  return row;
+}
+
+/// Write the table as a json array with one object per row.
+void
+writeJson(const std::string& path, const std::vector<BenchmarkRow>& rows)
+{
+  std::ofstream os(path);
+  if (not os.good()) {
+    throw std::ios_base::failure("Could not open '" + path + "'");
+  }
+  os << "[\n";
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const auto& row = rows[i];
+    os << "  {\"field\": \"" << row.field << "\", \"stepper\": \""
+       << row.stepper << "\", \"pt_GeV\": " << row.pt_GeV
+       << ", \"eta_min\": " << row.eta_min << ", \"eta_max\": " << row.eta_max
+       << ", \"max_step_mm\": " << row.max_step_mm
+       << ", \"material\": " << (row.material ? "true" : "false")
+       << ", \"tracks\": " << row.tracks << ", \"failures\": " << row.failures
+       << ", \"time_per_track_us\": " << row.time_per_track_us
+       << ", \"steps_per_track\": " << row.steps_per_track
+       << ", \"navigation_calls_per_track\": "
+       << row.navigation_calls_per_track << "}"
+       << ((i + 1) < rows.size() ? ",\n" : "\n");
+  }
+  os << "]\n";
+  if (not os.good()) {
+    throw std::ios_base::failure("Could not write to '" + path + "'");
+  }
+}
+
+}  // namespace
+
+int
+propagationBenchmark(int argc, char* argv[], FW::IBaseDetector& detector)
+{
+  // Setup and parse options
+  auto desc = FW::Options::makeDefaultOptions();
+  FW::Options::addGeometryOptions(desc);
+  FW::Options::addMaterialOptions(desc);
+  FW::Options::addBFieldOptions(desc);
+  FW::Options::addRandomNumbersOptions(desc);
+  FW::Options::addOutputOptions(desc);
+  desc.add_options()("bench-tracks",
+                     po::value<size_t>()->default_value(1000),
+                     "Number of propagated tracks per configuration.")(
+      "bench-steppers",
+      po::value<read_series>()->multitoken()->default_value({0, 1, 2}),
+      "Steppers: 0 (StraightLine), 1 (Eigen), 2 (Atlas).")(
+      "bench-pt",
+      po::value<read_range>()->multitoken()->default_value(
+          {0.1, 0.5, 1., 2., 5., 10., 100.}),
+      "Transverse momentum values in [GeV].")(
+      "bench-eta-bins",
+      po::value<read_range>()->multitoken()->default_value(
+          {0., 1., 2., 3., 4.}),
+      "Edges of the eta bins; tracks are uniform in eta within each bin.")(
+      "bench-max-step",
+      po::value<read_range>()->multitoken()->default_value({3000.}),
+      "Step size limits in [mm].")(
+      "bench-material",
+      po::value<read_series>()->multitoken()->default_value({0, 1}),
+      "Material interactions: 0 (off), 1 (on).")(
+      "bench-output",
+      po::value<std::string>()->default_value("propagation_benchmark.tsv"),
+      "Output table in the output directory; written as json if the name "
+      "ends with '.json', as tsv otherwise.");
+
+  // Add specific options for this geometry
+  detector.addOptions(desc);
+  auto vm = FW::Options::parse(desc, argc, argv);
+  if (vm.empty()) { return EXIT_FAILURE; }
+
+  // The benchmark matrix besides the steppers
+  auto ntracks  = vm["bench-tracks"].template as<size_t>();
+  auto seed     = vm["rnd-seed"].template as<uint64_t>();
+  auto steppers = vm["bench-steppers"].template as<read_series>();
+  auto pts      = vm["bench-pt"].template as<read_range>();
+  auto etaBins  = vm["bench-eta-bins"].template as<read_range>();
+  auto maxSteps = vm["bench-max-step"].template as<read_range>();
+  auto material = vm["bench-material"].template as<read_series>();
+  if (etaBins.size() < 2) {
+    std::cerr << "At least two eta bin edges are required" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<Configuration> configurations;
+  for (double pt : pts) {
+    for (size_t ieta = 0; (ieta + 1) < etaBins.size(); ++ieta) {
+      for (double maxStep : maxSteps) {
+        for (int withMaterial : material) {
+          Configuration cfg;
+          cfg.pt       = pt * 1_GeV;
+          cfg.etaMin   = etaBins[ieta];
+          cfg.etaMax   = etaBins[ieta + 1];
+          cfg.maxStep  = maxStep * 1_mm;
+          cfg.material = (withMaterial != 0);
+          configurations.push_back(cfg);
+        }
+      }
+    }
+  }
+
+  // The geometry, material and field are only built once; alignment
+  // decorators are not applied, the nominal geometry is used throughout
+  auto geometry  = FW::Geometry::build(vm, detector);
+  auto tGeometry = geometry.first;
+  auto bFieldVar = FW::Options::readBField(vm);
+
+  // The scalable field requires its context, all others ignore it
+  Acts::GeometryContext      geoContext;
+  Acts::MagneticFieldContext magFieldContext
+      = FW::BField::ScalableBFieldContext();
+
+  std::vector<BenchmarkRow> rows;
+  std::visit(
+      [&](auto& bField) {
+        using field_type =
+            typename std::decay_t<decltype(bField)>::element_type;
+        using field_map_type = Acts::SharedBField<field_type>;
+        using StepperVariant
+            = std::variant<Acts::EigenStepper<field_map_type>,
+                           Acts::AtlasStepper<field_map_type>,
+                           Acts::StraightLineStepper>;
+
+        for (int istepper : steppers) {
+          // translate option to variant
+          field_map_type                fieldMap(bField);
+          std::optional<StepperVariant> var_stepper;
+          if (istepper == 0) {
+            var_stepper = Acts::StraightLineStepper{};
+          } else if (istepper == 1) {
+            var_stepper = Acts::EigenStepper<field_map_type>{fieldMap};
+          } else if (istepper == 2) {
+            var_stepper = Acts::AtlasStepper<field_map_type>{fieldMap};
+          } else {
+            std::cerr << "Unknown stepper " << istepper << ", skipped"
+                      << std::endl;
+            continue;
+          }
+
+          // resolve stepper, setup propagator and run the matrix
+          std::visit(
+              [&](auto& stepper) {
+                using Stepper = std::decay_t<decltype(stepper)>;
+                using Propagator
+                    = Acts::Propagator<Stepper, CountingNavigator>;
+                CountingNavigator navigator(Acts::Navigator(tGeometry));
+                Propagator propagator(std::move(stepper), navigator);
+
+                for (const auto& cfg : configurations) {
+                  auto tracks
+                      = generateTracks(geoContext, cfg, ntracks, seed);
+                  auto row = runConfiguration(propagator,
+                                              navigator,
+                                              geoContext,
+                                              magFieldContext,
+                                              cfg,
+                                              tracks);
+                  row.field   = FW::BField::fieldTypeName<field_type>();
+                  row.stepper = stepperName(istepper);
+                  std::cout << "[<<<] " << row.stepper << " pT "
+                            << row.pt_GeV << " GeV, eta [" << row.eta_min
+                            << ", " << row.eta_max << "), max step "
+                            << row.max_step_mm << " mm, material "
+                            << (row.material ? "on" : "off") << ": "
+                            << row.time_per_track_us << " us/track, "
+                            << row.steps_per_track << " steps/track, "
+                            << row.navigation_calls_per_track
+                            << " navigation calls/track" << std::endl;
+                  rows.push_back(std::move(row));
+                }
+              },
+              *var_stepper);
+        }
+      },
+      bFieldVar);
+
+  // Write the table
+  auto outputDir  = vm["output-dir"].template as<std::string>();
+  auto outputName = vm["bench-output"].template as<std::string>();
+  auto outputPath = FW::joinPaths(outputDir, outputName);
+  if (boost::algorithm::ends_with(outputName, ".json")) {
+    writeJson(outputPath, rows);
+  } else {
+    dfe::NamedTupleTsvWriter<BenchmarkRow> writer(outputPath, 6);
+    for (const auto& row : rows) { writer.append(row); }
+  }
+  std::cout << "[>>>] Benchmark results written to: " << outputPath
+            << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -23,9 +23,11 @@
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Geometry/CommonGeometry.hpp"
+#include "ACTFW/Io/Csv/CsvPropagationStatisticsWriter.hpp"
 #include "ACTFW/Io/Root/RootPropagationStepsWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
 #include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
 #include "ACTFW/Plugins/BField/ScalableBField.hpp"
 #include "ACTFW/Plugins/Obj/ObjPropagationStepsWriter.hpp"
 #include "ACTFW/Propagation/PropagationAlgorithm.hpp"
@@ -74,6 +76,9 @@ propagationExample(int argc, char* argv[], FW::IBaseDetector& detector)
   // Get a Navigator
   Acts::Navigator navigator(tGeometry);
 
+  // The per-event statistics written by the algorithm, if any
+  std::string statisticsCollection;
+
   std::visit(
       [&](auto& bField) {
         // Resolve the bfield map and create the propgator
@@ -108,6 +113,8 @@ propagationExample(int argc, char* argv[], FW::IBaseDetector& detector)
               auto pAlgConfig
                   = FW::Options::readPropagationConfig(vm, propagator);
               pAlgConfig.randomNumberSvc = randomNumberSvc;
+              statisticsCollection
+                  = pAlgConfig.propagationStatisticsCollection;
               sequencer.addAlgorithm(
                   std::make_shared<FW::PropagationAlgorithm<Propagator>>(
                       pAlgConfig, logLevel));
@@ -121,27 +128,49 @@ propagationExample(int argc, char* argv[], FW::IBaseDetector& detector)
   std::string outputDir    = vm["output-dir"].template as<std::string>();
   auto        psCollection = vm["prop-step-collection"].as<std::string>();
 
-  if (vm["output-root"].template as<bool>()) {
-    // Write the propagation steps as ROOT TTree
-    FW::RootPropagationStepsWriter::Config pstepWriterRootConfig;
-    pstepWriterRootConfig.collection = psCollection;
-    pstepWriterRootConfig.filePath
-        = FW::joinPaths(outputDir, psCollection + ".root");
-    sequencer.addWriter(std::make_shared<FW::RootPropagationStepsWriter>(
-        pstepWriterRootConfig));
+  // Full or compact steps are recorded and written
+  auto addStepWriters = [&](auto stepType) {
+    using step_t = decltype(stepType);
+
+    if (vm["output-root"].template as<bool>()) {
+      // Write the propagation steps as ROOT TTree
+      using RootWriter = FW::RootPropagationStepsWriterT<step_t>;
+      typename RootWriter::Config pstepWriterRootConfig;
+      pstepWriterRootConfig.collection = psCollection;
+      pstepWriterRootConfig.filePath
+          = FW::joinPaths(outputDir, psCollection + ".root");
+      pstepWriterRootConfig.parallelOutput
+          = vm["output-root-parallel"].template as<bool>();
+      pstepWriterRootConfig.ntupleOutput
+          = vm["output-root-ntuple"].template as<bool>();
+      sequencer.addWriter(std::make_shared<RootWriter>(pstepWriterRootConfig));
+    }
+
+    if (vm["output-obj"].template as<bool>()) {
+      using ObjPropagationStepsWriter
+          = FW::Obj::ObjPropagationStepsWriter<step_t>;
+
+      // Write the propagation steps as Obj TTree
+      typename ObjPropagationStepsWriter::Config pstepWriterObjConfig;
+      pstepWriterObjConfig.collection = psCollection;
+      pstepWriterObjConfig.outputDir  = outputDir;
+      sequencer.addWriter(
+          std::make_shared<ObjPropagationStepsWriter>(pstepWriterObjConfig));
+    }
+  };
+  if (vm["prop-step-compact"].template as<bool>()) {
+    addStepWriters(FW::CompactStep());
+  } else {
+    addStepWriters(Acts::detail::Step());
   }
 
-  if (vm["output-obj"].template as<bool>()) {
-    using PropagationSteps = Acts::detail::Step;
-    using ObjPropagationStepsWriter
-        = FW::Obj::ObjPropagationStepsWriter<PropagationSteps>;
-
-    // Write the propagation steps as Obj TTree
-    ObjPropagationStepsWriter::Config pstepWriterObjConfig;
-    pstepWriterObjConfig.collection = psCollection;
-    pstepWriterObjConfig.outputDir  = outputDir;
-    sequencer.addWriter(
-        std::make_shared<ObjPropagationStepsWriter>(pstepWriterObjConfig));
+  if (vm["prop-statistics"].template as<bool>()) {
+    // Write the per-event statistics next to the timing output
+    FW::CsvPropagationStatisticsWriter::Config statisticsWriterConfig;
+    statisticsWriterConfig.inputStatistics = statisticsCollection;
+    statisticsWriterConfig.outputDir       = outputDir;
+    sequencer.addWriter(std::make_shared<FW::CsvPropagationStatisticsWriter>(
+        statisticsWriterConfig));
   }
 
   return sequencer.run();
@@ -13,6 +13,7 @@
 
 #include "ACTFW/Framework/RandomNumbers.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 #include "ACTFW/Io/Csv/CsvParticleWriter.hpp"
 #include "ACTFW/Io/Root/RootParticleWriter.hpp"
 #include "ACTFW/Options/CommonOptions.hpp"
@@ -32,6 +33,7 @@ main(int argc, char* argv[])
   Options::addRandomNumbersOptions(desc);
   Options::addParticleGunOptions(desc);
   Options::addOutputOptions(desc);
+  Options::addCsvWriterOptions(desc);
   auto vm = Options::parse(desc, argc, argv);
   if (vm.empty()) { return EXIT_FAILURE; }
 
@@ -57,17 +59,17 @@ main(int argc, char* argv[])
   // different output modes
   std::string outputDir = vm["output-dir"].as<std::string>();
   if (vm["output-csv"].as<bool>()) {
-    CsvParticleWriter::Config csvWriterCfg;
+    auto csvWriterCfg       = Options::readCsvParticleWriterConfig(vm);
     csvWriterCfg.inputEvent = evgenCfg.output;
-    csvWriterCfg.outputDir  = outputDir;
     csvWriterCfg.outputStem = "particles";
     sequencer.addWriter(
         std::make_shared<CsvParticleWriter>(csvWriterCfg, logLevel));
   }
   if (vm["output-root"].as<bool>()) {
     RootParticleWriter::Config rootWriterCfg;
-    rootWriterCfg.collection = evgenCfg.output;
-    rootWriterCfg.filePath   = joinPaths(outputDir, "particles.root");
+    rootWriterCfg.collection     = evgenCfg.output;
+    rootWriterCfg.filePath       = joinPaths(outputDir, "particles.root");
+    rootWriterCfg.parallelOutput = vm["output-root-parallel"].as<bool>();
     sequencer.addWriter(
         std::make_shared<RootParticleWriter>(rootWriterCfg, logLevel));
   }
@@ -90,6 +90,8 @@ main(int argc, char* argv[])
     matTrackWriterRootConfig.collection        = matCollection;
     matTrackWriterRootConfig.filePath
         = FW::joinPaths(outputDir, matCollection + ".root");
+    matTrackWriterRootConfig.ntupleOutput
+        = vm["output-root-ntuple"].template as<bool>();
     auto matTrackWriterRoot = std::make_shared<FW::RootMaterialTrackWriter>(
         matTrackWriterRootConfig);
     g4sequencer.addWriter(matTrackWriterRoot);
@@ -0,0 +1,76 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <Acts/Plugins/Json/JsonGeometryConverter.hpp>
+#include <Acts/Utilities/Logger.hpp>
+#include <boost/program_options.hpp>
+
+#include "ACTFW/Io/Binary/BinaryMaterialWriter.hpp"
+#include "ACTFW/Io/Root/RootMaterialDecorator.hpp"
+#include "ACTFW/Options/CommonOptions.hpp"
+
+/// The main executable
+///
+/// Converts existing '.json' or '.root' surface material maps into the binary
+/// material format that is memory-mapped and decoded lazily per surface.
+int
+main(int argc, char* argv[])
+{
+  // setup and parse options
+  auto desc = FW::Options::makeDefaultOptions();
+  FW::Options::addMaterialOptions(desc);
+  auto vm = FW::Options::parse(desc, argc, argv);
+  if (vm.empty()) { return EXIT_FAILURE; }
+
+  auto logLevel   = FW::Options::readLogLevel(vm);
+  auto inputFile  = vm["mat-input-file"].as<std::string>();
+  auto outputFile = vm["mat-output-file"].as<std::string>();
+  if (inputFile.empty() or outputFile.empty()) {
+    std::cerr << "Material input and output file are required" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Acts::DetectorMaterialMaps detMaterial;
+  if (inputFile.find(".json") != std::string::npos) {
+    Acts::JsonGeometryConverter::Config jsonGeoConvConfig(
+        "JsonGeometryConverter", logLevel);
+    Acts::JsonGeometryConverter jmConverter(jsonGeoConvConfig);
+    std::ifstream               ifj(inputFile);
+    if (not ifj.good()) {
+      std::cerr << "Could not open '" << inputFile << "'" << std::endl;
+      return EXIT_FAILURE;
+    }
+    nlohmann::json jin;
+    ifj >> jin;
+    detMaterial = jmConverter.jsonToMaterialMaps(jin);
+  } else if (inputFile.find(".root") != std::string::npos) {
+    FW::RootMaterialDecorator::Config rootMatDecConfig("MaterialReader",
+                                                       logLevel);
+    rootMatDecConfig.fileName = inputFile;
+    FW::RootMaterialDecorator rootMatDeco(rootMatDecConfig);
+    detMaterial.first = rootMatDeco.surfaceMaterialMap();
+  } else {
+    std::cerr << "Unsupported material input file '" << inputFile << "'"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  FW::BinaryMaterialWriter::Config bmwConfig;
+  bmwConfig.fileName = outputFile + ".bmat";
+  // read the written file back and compare it to the converted input
+  bmwConfig.verify = true;
+  FW::BinaryMaterialWriter bmwImpl(bmwConfig, logLevel);
+  bmwImpl.write(detMaterial);
+
+  return EXIT_SUCCESS;
+}
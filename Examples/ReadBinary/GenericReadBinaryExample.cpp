@@ -0,0 +1,112 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <memory>
+
+#include "ACTFW/Framework/PrefetchingReader.hpp"
+#include "ACTFW/Framework/Sequencer.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/GenericDetector/GenericDetector.hpp"
+#include "ACTFW/Geometry/CommonGeometry.hpp"
+#include "ACTFW/Io/Binary/BinaryParticleReader.hpp"
+#include "ACTFW/Io/Binary/BinaryPlanarClusterReader.hpp"
+#include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
+#include "ACTFW/Io/Csv/CsvPlanarClusterWriter.hpp"
+#include "ACTFW/Options/CommonOptions.hpp"
+#include "ACTFW/Printers/PrintHits.hpp"
+#include "ACTFW/Utilities/Options.hpp"
+
+/// Read back the binary particle and cluster files written by Fatras.
+///
+/// With `--output-csv` the clusters are written again as csv files. Compared
+/// to the csv output of the same Fatras run, this checks the full round trip
+/// through the binary columnar event format.
+int
+main(int argc, char* argv[])
+{
+  GenericDetector detector;
+
+  // setup and parse options
+  auto desc = FW::Options::makeDefaultOptions();
+  FW::Options::addSequencerOptions(desc);
+  FW::Options::addGeometryOptions(desc);
+  FW::Options::addMaterialOptions(desc);
+  FW::Options::addInputOptions(desc);
+  FW::Options::addOutputOptions(desc);
+  FW::Options::addCsvWriterOptions(desc);
+  detector.addOptions(desc);
+
+  auto vm = FW::Options::parse(desc, argc, argv);
+  if (vm.empty()) { return EXIT_FAILURE; }
+
+  FW::Sequencer sequencer(FW::Options::readSequencerConfig(vm));
+
+  // Read some standard options
+  auto logLevel = FW::Options::readLogLevel(vm);
+  auto inputDir = vm["input-dir"].as<std::string>();
+  auto prefetch = vm["input-prefetch"].as<size_t>();
+
+  // Optionally read ahead in dedicated I/O threads
+  auto addReader = [&](std::shared_ptr<FW::IReader> reader) {
+    if (0 < prefetch) {
+      FW::PrefetchingReader::Config prefetchCfg;
+      prefetchCfg.reader    = std::move(reader);
+      prefetchCfg.readAhead = prefetch;
+      reader = std::make_shared<FW::PrefetchingReader>(prefetchCfg, logLevel);
+    }
+    sequencer.addReader(std::move(reader));
+  };
+
+  // Setup detector geometry
+  auto geometry         = FW::Geometry::build(vm, detector);
+  auto trackingGeometry = geometry.first;
+  // Add context decorators
+  for (auto cdr : geometry.second) { sequencer.addContextDecorator(cdr); }
+
+  // Read particles from the binary file
+  FW::BinaryParticleReader::Config particleReaderCfg;
+  particleReaderCfg.inputDir        = inputDir;
+  particleReaderCfg.outputParticles = "particles";
+  addReader(
+      std::make_shared<FW::BinaryParticleReader>(particleReaderCfg, logLevel));
+
+  // Read clusters from the binary files
+  FW::BinaryPlanarClusterReader::Config clusterReaderCfg;
+  clusterReaderCfg.trackingGeometry      = trackingGeometry;
+  clusterReaderCfg.inputDir              = inputDir;
+  clusterReaderCfg.outputClusters        = "clusters";
+  clusterReaderCfg.outputHitParticlesMap = "hit_particle_map";
+  clusterReaderCfg.outputHitIds          = "hit_ids";
+  clusterReaderCfg.outputSimulatedHits   = "hits";
+  addReader(std::make_shared<FW::BinaryPlanarClusterReader>(clusterReaderCfg,
+                                                            logLevel));
+
+  // Print some information as crosscheck
+  FW::PrintHits::Config printCfg;
+  printCfg.inputClusters        = clusterReaderCfg.outputClusters;
+  printCfg.inputHitParticlesMap = clusterReaderCfg.outputHitParticlesMap;
+  printCfg.inputHitIds          = clusterReaderCfg.outputHitIds;
+  // the following print selections work for the original author.
+  // you probably need to adapt them to your data.
+  printCfg.hitIdStart  = 10224;
+  printCfg.hitIdLength = 8;
+  printCfg.volumeId    = 13;
+  printCfg.layerId     = 4;
+  printCfg.moduleId    = 116;
+  sequencer.addAlgorithm(std::make_shared<FW::PrintHits>(printCfg, logLevel));
+
+  // Write the clusters again for comparison with the original csv files
+  if (vm["output-csv"].as<bool>()) {
+    auto clusterWriterCfg = FW::Options::readCsvPlanarClusterWriterConfig(vm);
+    clusterWriterCfg.inputClusters = clusterReaderCfg.outputClusters;
+    sequencer.addWriter(std::make_shared<FW::CsvPlanarClusterWriter>(
+        clusterWriterCfg, logLevel));
+  }
+
+  return sequencer.run();
+}
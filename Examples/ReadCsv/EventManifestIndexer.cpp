@@ -0,0 +1,96 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include "ACTFW/Options/CommonOptions.hpp"
+#include "ACTFW/Utilities/EventManifest.hpp"
+#include "ACTFW/Utilities/Options.hpp"
+
+/// Create, verify, or shard the event manifests of existing per-event files.
+int
+main(int argc, char* argv[])
+{
+  using namespace boost::program_options;
+  using Names = std::vector<std::string>;
+
+  auto desc = FW::Options::makeDefaultOptions(
+      "Usage: ACTFWEventManifestIndexer [options]");
+  desc.add_options()("input-dir",
+                     value<std::string>()->default_value(""),
+                     "Directory with the per-event files.")(
+      "names",
+      value<Names>()->multitoken()->default_value(
+          {"particles.csv", "hits.csv", "cells.csv", "truth.csv"},
+          "particles.csv hits.csv cells.csv truth.csv"),
+      "Per-event filenames w/o the event prefix, space separated.")(
+      "no-checksums",
+      bool_switch(),
+      "Only store the file sizes and skip reading the files.")(
+      "verify",
+      bool_switch(),
+      "Verify the files against the existing manifests instead.")(
+      "shards",
+      value<size_t>()->default_value(0),
+      "Print the events range for this many shards. Shards are computed from "
+      "the first name only and apply to all files.");
+
+  auto vm = FW::Options::parse(desc, argc, argv);
+  if (vm.empty()) { return EXIT_FAILURE; }
+
+  auto dir       = vm["input-dir"].as<std::string>();
+  auto checksums = not vm["no-checksums"].as<bool>();
+  auto verify    = vm["verify"].as<bool>();
+  auto numShards = vm["shards"].as<size_t>();
+
+  int  ret         = EXIT_SUCCESS;
+  bool printShards = (0u < numShards);
+  for (const auto& name : vm["names"].as<Names>()) {
+    FW::EventManifest manifest;
+    if (verify) {
+      if (not FW::EventManifest::exists(dir, name)) {
+        std::cerr << "Missing manifest for '" << name << "' files\n";
+        ret = EXIT_FAILURE;
+        continue;
+      }
+      manifest     = FW::EventManifest::read(dir, name);
+      auto invalid = manifest.verify(dir, name);
+      for (auto event : invalid) {
+        std::cerr << "Invalid '" << name << "' file for event " << event
+                  << '\n';
+      }
+      if (not invalid.empty()) { ret = EXIT_FAILURE; }
+    } else {
+      manifest = FW::EventManifest::scan(dir, name, checksums);
+      // skip names without any files, e.g. optional outputs
+      if (manifest.entries().empty()) { continue; }
+      manifest.write(dir, name);
+    }
+
+    auto range   = manifest.eventsRange();
+    auto missing = manifest.numMissingEvents();
+    std::cout << FW::EventManifest::path(dir, name) << ": "
+              << manifest.entries().size() << " events in [" << range.first
+              << "," << range.second << "), " << missing << " missing\n";
+    // readers must use the same shard ranges for all files
+    if (printShards and not manifest.entries().empty()) {
+      for (size_t shard = 0; shard < numShards; ++shard) {
+        auto shardRange = manifest.shardRange(shard, numShards);
+        std::cout << "  shard " << shard << ": [" << shardRange.first << ","
+                  << shardRange.second << ")\n";
+      }
+      printShards = false;
+    }
+  }
+  return ret;
+}
@@ -8,6 +8,7 @@
 
 #include <memory>
 
+#include "ACTFW/Framework/PrefetchingReader.hpp"
 #include "ACTFW/Framework/Sequencer.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/GenericDetector/GenericDetector.hpp"
@@ -41,6 +42,18 @@ main(int argc, char* argv[])
   // Read some standard options
   auto logLevel = FW::Options::readLogLevel(vm);
   auto inputDir = vm["input-dir"].as<std::string>();
+  auto prefetch = vm["input-prefetch"].as<size_t>();
+
+  // Optionally read ahead in dedicated I/O threads
+  auto addReader = [&](std::shared_ptr<FW::IReader> reader) {
+    if (0 < prefetch) {
+      FW::PrefetchingReader::Config prefetchCfg;
+      prefetchCfg.reader    = std::move(reader);
+      prefetchCfg.readAhead = prefetch;
+      reader = std::make_shared<FW::PrefetchingReader>(prefetchCfg, logLevel);
+    }
+    sequencer.addReader(std::move(reader));
+  };
 
   // Setup detector geometry
   auto geometry         = FW::Geometry::build(vm, detector);
@@ -51,7 +64,7 @@ main(int argc, char* argv[])
   // Read particles from CSV files
   auto particleReaderCfg = FW::Options::readCsvParticleReaderConfig(vm);
   particleReaderCfg.outputParticles = "particles";
-  sequencer.addReader(
+  addReader(
       std::make_shared<FW::CsvParticleReader>(particleReaderCfg, logLevel));
 
   // Read clusters from CSV files
@@ -60,7 +73,7 @@ main(int argc, char* argv[])
   clusterReaderCfg.outputClusters        = "clusters";
   clusterReaderCfg.outputHitParticlesMap = "hit_particle_map";
   clusterReaderCfg.outputHitIds          = "hit_ids";
-  sequencer.addReader(
+  addReader(
       std::make_shared<FW::CsvPlanarClusterReader>(clusterReaderCfg, logLevel));
 
   // Print some information as crosscheck
@@ -144,6 +144,8 @@ main(int argc, char* argv[])
   trackWriterCfg.outputDir         = outputDir;
   trackWriterCfg.outputFilename    = "tracks.root";
   trackWriterCfg.outputTreename    = "tracks";
+  trackWriterCfg.parallelOutput    = vm["output-root-parallel"].as<bool>();
+  trackWriterCfg.ntupleOutput      = vm["output-root-ntuple"].as<bool>();
   sequencer.addWriter(
       std::make_shared<RootTrajectoryWriter>(trackWriterCfg, logLevel));
   // write reconstruction performance data
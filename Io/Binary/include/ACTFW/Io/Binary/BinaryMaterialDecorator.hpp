@@ -0,0 +1,105 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Acts/Geometry/GeometryID.hpp>
+#include <Acts/Material/IMaterialDecorator.hpp>
+#include <Acts/Material/ISurfaceMaterial.hpp>
+#include <Acts/Utilities/Logger.hpp>
+
+namespace FW {
+
+/// Decorate surfaces with material from the binary material format.
+///
+/// The file written by the `BinaryMaterialWriter` is memory-mapped and only
+/// the surface index is read on construction. The material of each surface is
+/// decoded on first access and shared by all subsequent decorations, e.g.
+/// when the same geometry is built multiple times. Surfaces that are never
+/// decorated are never decoded.
+///
+/// All access is const and can be used concurrently.
+class BinaryMaterialDecorator : public Acts::IMaterialDecorator
+{
+public:
+  struct Config
+  {
+    /// Input file path.
+    std::string fileName = "material-maps.bmat";
+    /// Remove existing material from surfaces without stored material.
+    bool clearSurfaceMaterial = true;
+    /// Remove existing material from volumes; volume material is not stored.
+    bool clearVolumeMaterial = true;
+  };
+
+  /// @throws std::runtime_error if the file is not readable or corrupt
+  BinaryMaterialDecorator(const Config&        cfg,
+                          Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryMaterialDecorator();
+
+  /// Decorate a surface
+  ///
+  /// @param surface the non-const surface that is decorated
+  void
+  decorate(Acts::Surface& surface) const final;
+
+  /// Decorate a TrackingVolume
+  ///
+  /// @param volume the non-const volume that is decorated
+  void
+  decorate(Acts::TrackingVolume& volume) const final;
+
+  /// Number of surfaces with stored material.
+  size_t
+  size() const
+  {
+    return m_index.size();
+  }
+
+  /// Material for a surface; decoded on first access.
+  ///
+  /// @return Surface material or nullptr if none is stored
+  std::shared_ptr<const Acts::ISurfaceMaterial>
+  surfaceMaterial(Acts::GeometryID geoId) const;
+
+private:
+  struct Entry
+  {
+    uint64_t geoId;
+    uint64_t offset;
+    uint64_t size;
+  };
+  struct Mapping;
+
+  std::shared_ptr<const Acts::ISurfaceMaterial>
+  decode(const Entry& entry) const;
+
+  Config                   m_cfg;
+  std::unique_ptr<Mapping> m_mapping;
+  const uint8_t*           m_base = nullptr;
+  size_t                   m_size = 0;
+  std::vector<Entry>       m_index;
+  // decoded material; written once per entry under its flag
+  mutable std::vector<std::once_flag>                                m_once;
+  mutable std::vector<std::shared_ptr<const Acts::ISurfaceMaterial>> m_decoded;
+  std::unique_ptr<const Acts::Logger>                                m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
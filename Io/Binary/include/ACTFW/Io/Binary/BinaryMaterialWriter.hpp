@@ -0,0 +1,106 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <Acts/Geometry/GeometryID.hpp>
+#include <Acts/Material/ISurfaceMaterial.hpp>
+#include <Acts/Material/IVolumeMaterial.hpp>
+#include <Acts/Utilities/Logger.hpp>
+
+namespace Acts {
+class Layer;
+class TrackingGeometry;
+class TrackingVolume;
+using SurfaceMaterialMap
+    = std::map<GeometryID, std::shared_ptr<const ISurfaceMaterial>>;
+using VolumeMaterialMap
+    = std::map<GeometryID, std::shared_ptr<const IVolumeMaterial>>;
+using DetectorMaterialMaps = std::pair<SurfaceMaterialMap, VolumeMaterialMap>;
+}  // namespace Acts
+
+namespace FW {
+
+/// Write surface material maps in the binary material format.
+///
+/// All surfaces are stored in a single file with an index sorted by geometry
+/// identifier followed by the packed single-precision material slabs of each
+/// surface. The file can be memory-mapped and decoded lazily per surface by
+/// the `BinaryMaterialDecorator`.
+///
+/// @note Only binned and homogeneous surface material is supported. Other
+///       surface material, e.g. proto material, and volume material is
+///       skipped with a warning. Binnings with sub-binning are rejected.
+class BinaryMaterialWriter
+{
+public:
+  struct Config
+  {
+    /// Output file path; an existing file is overwritten.
+    std::string fileName = "material-maps.bmat";
+    /// Steering to handle sensitive data
+    bool processSensitives = true;
+    /// Steering to handle approach data
+    bool processApproaches = true;
+    /// Steering to handle representing data
+    bool processRepresenting = true;
+    /// Steering to handle boundary data
+    bool processBoundaries = true;
+    /// Read the file back after writing and compare all material and the
+    /// bin lookup with the input.
+    bool verify = false;
+  };
+
+  BinaryMaterialWriter(const Config&        cfg,
+                       Acts::Logging::Level level = Acts::Logging::INFO);
+
+  /// Write out the material map
+  ///
+  /// @param detMaterial is the SurfaceMaterial and VolumeMaterial maps
+  /// @throws std::invalid_argument for binnings that can not be represented
+  /// @throws std::runtime_error if the verification fails
+  void
+  write(const Acts::DetectorMaterialMaps& detMaterial);
+
+  /// Write out the material map from Geometry
+  ///
+  /// @param tGeometry is the TrackingGeometry
+  void
+  write(const Acts::TrackingGeometry& tGeometry);
+
+private:
+  /// Compare the written file with the input material.
+  void
+  verify(const Acts::DetectorMaterialMaps& detMaterial,
+         size_t                            numSurfaces) const;
+
+  /// Collect the surface material of a volume and its sub volumes.
+  void
+  collectMaterial(const Acts::TrackingVolume& tVolume,
+                  Acts::SurfaceMaterialMap&   surfaceMaterial) const;
+  /// Collect the surface material of a layer.
+  void
+  collectMaterial(const Acts::Layer&        tLayer,
+                  Acts::SurfaceMaterialMap& surfaceMaterial) const;
+
+  Config                              m_cfg;
+  std::unique_ptr<const Acts::Logger> m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
@@ -0,0 +1,67 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <Acts/Utilities/Logger.hpp>
+
+#include "ACTFW/Framework/IReader.hpp"
+
+namespace FW {
+
+class ColumnarEventFileReader;
+
+/// Read particles in the binary columnar event format.
+///
+/// This reads the `<stem>.evc` file in the configured input directory as
+/// written by the `BinaryParticleWriter`. The file is memory-mapped and any
+/// event can be accessed directly without parsing.
+class BinaryParticleReader : public IReader
+{
+public:
+  struct Config
+  {
+    /// Which particle collection to read into.
+    std::string outputParticles;
+    /// Where to read the input file from.
+    std::string inputDir;
+    /// Input filename stem.
+    std::string inputStem = "particles";
+  };
+
+  BinaryParticleReader(const Config&        cfg,
+                       Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryParticleReader() override;
+
+  std::string
+  name() const final override;
+
+  /// Return the available events range.
+  std::pair<size_t, size_t>
+  availableEvents() const final override;
+
+  /// Read out data from the input file.
+  ProcessCode
+  read(const FW::AlgorithmContext& ctx) final override;
+
+private:
+  Config                                   m_cfg;
+  std::unique_ptr<ColumnarEventFileReader> m_file;
+  std::unique_ptr<const Acts::Logger>      m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
@@ -0,0 +1,74 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ACTFW/EventData/SimParticle.hpp"
+#include "ACTFW/EventData/SimVertex.hpp"
+#include "ACTFW/Framework/WriterT.hpp"
+
+namespace FW {
+
+class ColumnarEventFileWriter;
+
+/// Write out particles in the binary columnar event format.
+///
+/// This is the binary counterpart of the `CsvParticleWriter` and stores the
+/// same columns. All events are written into a single file
+///
+///     <stem>.evc
+///
+/// in the configured output directory. Rows are particles and each event can
+/// be accessed directly through the per-event index stored in the file.
+///
+/// Safe to use from multiple writer threads.
+class BinaryParticleWriter : public WriterT<std::vector<Data::SimVertex>>
+{
+public:
+  struct Config
+  {
+    /// Input event (vector of simulation vertices) collection to write.
+    std::string inputEvent;
+    /// Input collection to map particle ids to number of hits (optional).
+    std::string inputHitsPerParticle;
+    /// Where to place the output file.
+    std::string outputDir;
+    /// Output filename stem.
+    std::string outputStem = "particles";
+    /// Compress the floating point columns.
+    bool compress = false;
+  };
+
+  /// @param cfg is the configuration object
+  /// @param level is the output logging level
+  BinaryParticleWriter(const Config&        cfg,
+                       Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryParticleWriter() override;
+
+  /// Write the event index and close the output file.
+  ProcessCode
+  endRun() final override;
+
+protected:
+  /// @param [in] context is the algorithm context for consistency
+  /// @param [in] vertices is the process vertex collection for the
+  /// particles to be attached
+  ProcessCode
+  writeT(const FW::AlgorithmContext&         context,
+         const std::vector<Data::SimVertex>& vertices) final override;
+
+private:
+  Config                                   m_cfg;
+  std::unique_ptr<ColumnarEventFileWriter> m_file;
+};
+
+}  // namespace FW
@@ -0,0 +1,95 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Acts/Geometry/GeometryID.hpp>
+#include <Acts/Geometry/TrackingGeometry.hpp>
+
+#include "ACTFW/EventData/Barcode.hpp"
+#include "ACTFW/EventData/SimHit.hpp"
+#include "ACTFW/EventData/SimVertex.hpp"
+
+namespace Acts {
+class Surface;
+}
+
+namespace FW {
+
+class ColumnarEventFileReader;
+
+/// Library of pre-simulated events, e.g. minimum-bias events for pile-up.
+///
+/// This reads the files written by the `BinaryPileupLibraryWriter` from the
+/// configured input directory. The files are memory-mapped, i.e. library
+/// events are only loaded on access and are kept in the page cache of the
+/// operating system. Library events are accessed by their index, not by
+/// their original event number. All access is const and can be used
+/// concurrently.
+class BinaryPileupLibrary
+{
+public:
+  struct Config
+  {
+    /// Where to read the input files from.
+    std::string inputDir;
+    /// Input filename stem.
+    std::string inputStem = "pileup";
+    /// Tracking geometry required to restore the hit surfaces.
+    std::shared_ptr<const Acts::TrackingGeometry> trackingGeometry;
+  };
+
+  /// @throws std::invalid_argument on missing configuration
+  /// @throws std::runtime_error if the files are not readable or consistent
+  BinaryPileupLibrary(const Config& cfg);
+  ~BinaryPileupLibrary();
+
+  /// Number of stored events.
+  size_t
+  size() const
+  {
+    return m_events.size();
+  }
+
+  /// Append a stored event to an existing event.
+  ///
+  /// The primary vertex identifier of all barcodes is shifted to keep them
+  /// unique within the combined event and all times are shifted by the same
+  /// amount.
+  ///
+  /// @param index the library event index in [0, size())
+  /// @param primaryOffset is added to the primary vertex identifiers
+  /// @param timeShift is added to all vertex, particle, and hit times
+  /// @param [in,out] vertices the event vertices to append to
+  /// @param [in,out] hits the unordered hits to append to
+  /// @return the largest shifted primary vertex identifier
+  ///
+  /// @throws std::out_of_range for an invalid index
+  /// @throws std::runtime_error for hits on unknown surfaces
+  Barcode::Value
+  append(size_t                        index,
+         Barcode::Value                primaryOffset,
+         double                        timeShift,
+         std::vector<Data::SimVertex>& vertices,
+         SimHits::sequence_type&       hits) const;
+
+private:
+  Config                                           m_cfg;
+  std::unique_ptr<ColumnarEventFileReader>         m_vertices;
+  std::unique_ptr<ColumnarEventFileReader>         m_particles;
+  std::unique_ptr<ColumnarEventFileReader>         m_hits;
+  std::vector<size_t>                              m_events;
+  std::map<Acts::GeometryID, const Acts::Surface*> m_surfaces;
+};
+
+}  // namespace FW
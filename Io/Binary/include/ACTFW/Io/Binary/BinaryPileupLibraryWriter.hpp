@@ -0,0 +1,77 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ACTFW/EventData/SimVertex.hpp"
+#include "ACTFW/Framework/WriterT.hpp"
+
+namespace FW {
+
+class ColumnarEventFileWriter;
+
+/// Write simulated events into a pile-up library.
+///
+/// The library consists of the three files
+///
+///     <stem>-vertices.evc
+///     <stem>-particles.evc
+///     <stem>-hits.evc
+///
+/// in the binary columnar event format in the configured output directory.
+/// It contains the simulated vertices and particles, and the simulated hits
+/// identified by their geometry id. The library is read back by the
+/// `BinaryPileupLibrary` to overlay the stored events onto other events.
+///
+/// Safe to use from multiple writer threads.
+class BinaryPileupLibraryWriter : public WriterT<std::vector<Data::SimVertex>>
+{
+public:
+  struct Config
+  {
+    /// Input simulated event (vector of simulation vertices) collection.
+    std::string inputEvent;
+    /// Input simulated hits collection.
+    std::string inputHits;
+    /// Where to place the output files.
+    std::string outputDir;
+    /// Output filename stem.
+    std::string outputStem = "pileup";
+    /// Compress the floating point columns.
+    bool compress = false;
+  };
+
+  /// @param cfg is the configuration object
+  /// @param level is the output logging level
+  BinaryPileupLibraryWriter(const Config&        cfg,
+                            Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryPileupLibraryWriter() override;
+
+  /// Write the event indices and close the output files.
+  ProcessCode
+  endRun() final override;
+
+protected:
+  /// @param [in] context is the algorithm context for consistency
+  /// @param [in] vertices is the simulated event
+  ProcessCode
+  writeT(const FW::AlgorithmContext&         context,
+         const std::vector<Data::SimVertex>& vertices) final override;
+
+private:
+  Config                                   m_cfg;
+  std::unique_ptr<ColumnarEventFileWriter> m_vertices;
+  std::unique_ptr<ColumnarEventFileWriter> m_particles;
+  std::unique_ptr<ColumnarEventFileWriter> m_hits;
+};
+
+}  // namespace FW
@@ -0,0 +1,67 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "ACTFW/Framework/BareAlgorithm.hpp"
+#include "ACTFW/Framework/RandomNumbers.hpp"
+
+namespace FW {
+
+class BinaryPileupLibrary;
+
+/// Overlay pile-up events from a library onto a simulated event.
+///
+/// For each event, the number of pile-up events is drawn from the
+/// multiplicity generator and the pile-up events are picked uniformly from
+/// the library. The vertices, particles, and hits of each pile-up event are
+/// added to the input event with shifted primary vertex identifiers and a
+/// random time offset. The hits are not shifted in space, since they are
+/// bound to their surfaces; the pile-up vertex spread is the one of the
+/// simulated library events.
+class BinaryPileupOverlay : public BareAlgorithm
+{
+public:
+  struct Config
+  {
+    /// Input simulated event (vector of simulation vertices) collection.
+    std::string inputEvent;
+    /// Input simulated hits collection.
+    std::string inputHits;
+    /// Output combined event collection.
+    std::string outputEvent;
+    /// Output combined hits collection.
+    std::string outputHits;
+    /// Take the input event and hits from the event store instead of copying
+    /// them. The input collections are not available afterwards.
+    bool consumeInput = false;
+    /// The library of pre-simulated pile-up events.
+    std::shared_ptr<const BinaryPileupLibrary> library;
+    /// The random number service.
+    std::shared_ptr<RandomNumbers> randomNumbers;
+    /// Number of pile-up events per event.
+    std::function<size_t(RandomEngine&)> multiplicity;
+    /// Standard deviation of the Gaussian pile-up time offset.
+    double timeStddev = 0.;
+  };
+
+  BinaryPileupOverlay(const Config&        cfg,
+                      Acts::Logging::Level level = Acts::Logging::INFO);
+
+  ProcessCode
+  execute(const AlgorithmContext& ctx) const final override;
+
+private:
+  Config m_cfg;
+};
+
+}  // namespace FW
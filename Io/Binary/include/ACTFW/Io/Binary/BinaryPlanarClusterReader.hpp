@@ -0,0 +1,84 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <Acts/Geometry/GeometryID.hpp>
+#include <Acts/Geometry/TrackingGeometry.hpp>
+#include <Acts/Utilities/Logger.hpp>
+
+#include "ACTFW/Framework/IReader.hpp"
+
+namespace Acts {
+class Surface;
+}
+
+namespace FW {
+
+class ColumnarEventFileReader;
+
+/// Read in a planar cluster collection in the binary columnar event format.
+///
+/// This reads the `cells.evc`, `hits.evc`, and `truth.evc` files in the
+/// configured input directory as written by the `BinaryPlanarClusterWriter`
+/// and provides the same output collections as the `CsvPlanarClusterReader`.
+/// The files are memory-mapped and any event can be accessed directly.
+class BinaryPlanarClusterReader : public IReader
+{
+public:
+  struct Config
+  {
+    /// Tracking geometry required to access global-to-local transforms.
+    std::shared_ptr<const Acts::TrackingGeometry> trackingGeometry;
+    /// Where to read input files from.
+    std::string inputDir;
+    /// Output cluster collection.
+    std::string outputClusters;
+    /// For each cluster/ hit index the original hit id stored on file.
+    std::string outputHitIds;
+    /// Output hit-particles mapping collection.
+    std::string outputHitParticlesMap;
+    /// Output simulated (truth) hits collection.
+    std::string outputSimulatedHits;
+  };
+
+  BinaryPlanarClusterReader(const Config&        cfg,
+                            Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryPlanarClusterReader() override;
+
+  std::string
+  name() const final override;
+
+  /// Return the available events range.
+  std::pair<size_t, size_t>
+  availableEvents() const final override;
+
+  /// Read out data from the input files.
+  ProcessCode
+  read(const FW::AlgorithmContext& ctx) final override;
+
+private:
+  Config                                           m_cfg;
+  std::map<Acts::GeometryID, const Acts::Surface*> m_surfaces;
+  std::unique_ptr<ColumnarEventFileReader>         m_hits;
+  std::unique_ptr<ColumnarEventFileReader>         m_cells;
+  std::unique_ptr<ColumnarEventFileReader>         m_truth;
+  std::unique_ptr<const Acts::Logger>              m_logger;
+
+  const Acts::Logger&
+  logger() const
+  {
+    return *m_logger;
+  }
+};
+
+}  // namespace FW
@@ -0,0 +1,77 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
+
+#include "ACTFW/EventData/DataContainers.hpp"
+#include "ACTFW/Framework/WriterT.hpp"
+
+namespace FW {
+
+class ColumnarEventFileWriter;
+
+/// Write out a planar cluster collection in the binary columnar event format.
+///
+/// This is the binary counterpart of the `CsvPlanarClusterWriter` and stores
+/// the same information. Instead of multiple files per event, all events are
+/// written into three files in the configured output directory
+///
+///     cells.evc
+///     hits.evc
+///     truth.evc
+///
+/// Hits are stored ordered by geometry id with the hit id corresponding to
+/// the index within the event. Cells and truth entries are ordered by hit id.
+///
+/// Safe to use from multiple writer threads.
+class BinaryPlanarClusterWriter
+  : public WriterT<GeometryIdMultimap<Acts::PlanarModuleCluster>>
+{
+public:
+  struct Config
+  {
+    /// Which cluster collection to write.
+    std::string inputClusters;
+    /// Where to place output files.
+    std::string outputDir;
+    /// Compress the non-identifier columns.
+    bool compress = false;
+  };
+
+  /// Constructor with
+  /// @param cfg configuration struct
+  /// @param output logging level
+  BinaryPlanarClusterWriter(const Config&        cfg,
+                            Acts::Logging::Level level = Acts::Logging::INFO);
+  ~BinaryPlanarClusterWriter() override;
+
+  /// Write the event indices and close the output files.
+  ProcessCode
+  endRun() final override;
+
+protected:
+  /// This implementation holds the actual writing method
+  /// and is called by the WriterT<>::write interface
+  ProcessCode
+  writeT(const AlgorithmContext&                              context,
+         const GeometryIdMultimap<Acts::PlanarModuleCluster>& clusters)
+      final override;
+
+private:
+  Config                                   m_cfg;
+  std::unique_ptr<ColumnarEventFileWriter> m_hits;
+  std::unique_ptr<ColumnarEventFileWriter> m_cells;
+  std::unique_ptr<ColumnarEventFileWriter> m_truth;
+};
+
+}  // namespace FW
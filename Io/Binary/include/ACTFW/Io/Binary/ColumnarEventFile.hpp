@@ -0,0 +1,283 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Binary container for typed, per-event columns
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "ACTFW/Utilities/Range.hpp"
+
+namespace FW {
+
+/// Element type of a stored column.
+enum class ColumnType : uint8_t {
+  Int32   = 1,
+  UInt32  = 2,
+  UInt64  = 3,
+  Float32 = 4,
+};
+
+template <typename T>
+struct ColumnTypeOf;
+template <>
+struct ColumnTypeOf<int32_t>
+{
+  static constexpr ColumnType value = ColumnType::Int32;
+};
+template <>
+struct ColumnTypeOf<uint32_t>
+{
+  static constexpr ColumnType value = ColumnType::UInt32;
+};
+template <>
+struct ColumnTypeOf<uint64_t>
+{
+  static constexpr ColumnType value = ColumnType::UInt64;
+};
+template <>
+struct ColumnTypeOf<float>
+{
+  static constexpr ColumnType value = ColumnType::Float32;
+};
+
+/// Size in bytes of a single column element.
+size_t
+columnElementSize(ColumnType type);
+
+/// Definition of a single column.
+struct ColumnSpec
+{
+  /// Column name, must be unique within a file.
+  std::string name;
+  /// Element type.
+  ColumnType type;
+  /// Store the column chunks zlib-compressed.
+  bool compress = false;
+};
+
+/// Column data of a single event, filled in the column order of the file.
+class ColumnarEventData
+{
+public:
+  /// Add the next column.
+  ///
+  /// @throws std::invalid_argument on inconsistent number of rows
+  template <typename T>
+  void
+  add(const std::vector<T>& values);
+
+  /// Number of rows; zero if no column was added yet.
+  size_t
+  numRows() const
+  {
+    return m_types.empty() ? 0u : m_numRows;
+  }
+
+private:
+  std::vector<ColumnType>           m_types;
+  std::vector<std::vector<uint8_t>> m_chunks;
+  size_t                            m_numRows = 0;
+
+  friend class ColumnarEventFileWriter;
+};
+
+/// Write events with typed columns into a single binary file.
+///
+/// The file layout is
+///
+///     header | column definitions | event chunks ... | event index
+///
+/// where each event stores one contiguous chunk per column. Chunks are
+/// aligned to 8 bytes so uncompressed columns can be used directly from a
+/// memory-mapped file. The event index is sorted by event number and written
+/// when the file is closed. All numbers are stored in native byte order.
+///
+/// Appending events is thread-safe. Packing and compression happen before the
+/// internal lock is taken; only the actual file write is serialized.
+class ColumnarEventFileWriter
+{
+public:
+  /// @param path Output file path; an existing file is overwritten
+  /// @param columns Column definitions
+  /// @param compressionLevel zlib level used for compressed columns
+  ColumnarEventFileWriter(const std::string&      path,
+                          std::vector<ColumnSpec> columns,
+                          int                     compressionLevel = 1);
+  ColumnarEventFileWriter(const ColumnarEventFileWriter&) = delete;
+  ColumnarEventFileWriter&
+  operator=(const ColumnarEventFileWriter&)
+      = delete;
+  /// Closes the file if this has not been done explicitely.
+  ~ColumnarEventFileWriter();
+
+  /// Append the data for one event.
+  ///
+  /// @throws std::invalid_argument on columns inconsistent with the file
+  /// @throws std::invalid_argument if the event was already written
+  void
+  append(size_t event, ColumnarEventData&& data);
+
+  /// Write the event index and close the file.
+  void
+  close();
+
+private:
+  struct ChunkEntry
+  {
+    uint64_t offset;
+    uint64_t storedSize;
+  };
+  struct EventEntry
+  {
+    uint64_t                event;
+    uint64_t                numRows;
+    std::vector<ChunkEntry> chunks;
+  };
+
+  std::string                  m_path;
+  std::vector<ColumnSpec>      m_columns;
+  int                          m_compressionLevel;
+  std::mutex                   m_mutex;
+  std::ofstream                m_file;
+  uint64_t                     m_offset = 0;
+  std::vector<EventEntry>      m_index;
+  std::unordered_set<uint64_t> m_events;
+};
+
+/// Read events written by the `ColumnarEventFileWriter`.
+///
+/// The file is memory-mapped. Uncompressed columns are accessed in-place
+/// without any copy; compressed columns are inflated into per-event buffers.
+/// All read access is const and can be used concurrently.
+class ColumnarEventFileReader
+{
+public:
+  /// Column data for a single event.
+  class Event
+  {
+  public:
+    Event() = default;
+    // column data can point into the own buffers, which stay in place when
+    // the buffers are moved but not when they are copied
+    Event(const Event&) = delete;
+    Event(Event&&)      = default;
+    Event&
+    operator=(const Event&)
+        = delete;
+    Event&
+    operator=(Event&&)
+        = default;
+
+    /// Number of rows in this event.
+    size_t
+    numRows() const
+    {
+      return m_numRows;
+    }
+    /// Typed access to a column.
+    ///
+    /// @throws std::invalid_argument for unknown columns or type mismatches
+    template <typename T>
+    Range<const T*>
+    column(const std::string& name) const;
+
+  private:
+    const std::vector<ColumnSpec>*     m_columns = nullptr;
+    size_t                             m_numRows = 0;
+    std::vector<const uint8_t*>        m_data;
+    std::vector<std::vector<uint64_t>> m_buffers;
+
+    friend class ColumnarEventFileReader;
+  };
+
+  /// @throws std::runtime_error if the file is not readable or corrupt
+  explicit ColumnarEventFileReader(const std::string& path);
+  ~ColumnarEventFileReader();
+
+  /// Column definitions stored in the file.
+  const std::vector<ColumnSpec>&
+  columns() const
+  {
+    return m_columns;
+  }
+  /// First and last+1 stored event number; {0, 0} for an empty file.
+  std::pair<size_t, size_t>
+  availableEvents() const;
+  /// Whether the event is stored in the file.
+  bool
+  hasEvent(size_t event) const;
+  /// All stored event numbers in increasing order.
+  std::vector<size_t>
+  events() const;
+  /// Access the columns for a single event.
+  ///
+  /// @throws std::out_of_range if the event is not stored in the file
+  Event
+  read(size_t event) const;
+
+private:
+  struct EventEntry
+  {
+    uint64_t event;
+    uint64_t numRows;
+    // position of the chunk entries in the mapped index
+    const uint64_t* chunks;
+  };
+  struct Mapping;
+
+  std::string              m_path;
+  std::unique_ptr<Mapping> m_mapping;
+  const uint8_t*           m_base = nullptr;
+  size_t                   m_size = 0;
+  std::vector<ColumnSpec>  m_columns;
+  std::vector<EventEntry>  m_index;
+};
+
+}  // namespace FW
+
+template <typename T>
+inline void
+FW::ColumnarEventData::add(const std::vector<T>& values)
+{
+  if (not m_types.empty() and (values.size() != m_numRows)) {
+    throw std::invalid_argument("Inconsistent number of rows in column "
+                                + std::to_string(m_types.size()));
+  }
+  const auto* first = reinterpret_cast<const uint8_t*>(values.data());
+  m_types.push_back(ColumnTypeOf<T>::value);
+  m_chunks.emplace_back(first, first + values.size() * sizeof(T));
+  m_numRows = values.size();
+}
+
+template <typename T>
+inline FW::Range<const T*>
+FW::ColumnarEventFileReader::Event::column(const std::string& name) const
+{
+  for (size_t i = 0; i < m_columns->size(); ++i) {
+    const ColumnSpec& spec = (*m_columns)[i];
+    if (spec.name != name) { continue; }
+    if (spec.type != ColumnTypeOf<T>::value) {
+      throw std::invalid_argument("Type mismatch for column '" + name + "'");
+    }
+    const T* first = reinterpret_cast<const T*>(m_data[i]);
+    return makeRange(first, first + m_numRows);
+  }
+  throw std::invalid_argument("Unknown column '" + name + "'");
+}
@@ -0,0 +1,139 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Column definitions shared by the binary readers and writers
+
+#pragma once
+
+#include <vector>
+
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+
+namespace FW {
+
+/// Columns are named and typed as in the TrackML csv files. Identifier
+/// columns are never compressed to keep them directly accessible.
+
+inline std::vector<ColumnSpec>
+particleColumns(bool compress)
+{
+  return {
+      {"particle_id", ColumnType::UInt64, false},
+      {"particle_type", ColumnType::Int32, false},
+      {"vx", ColumnType::Float32, compress},
+      {"vy", ColumnType::Float32, compress},
+      {"vz", ColumnType::Float32, compress},
+      {"vt", ColumnType::Float32, compress},
+      {"px", ColumnType::Float32, compress},
+      {"py", ColumnType::Float32, compress},
+      {"pz", ColumnType::Float32, compress},
+      {"q", ColumnType::Float32, compress},
+      {"nhits", ColumnType::Int32, compress},
+  };
+}
+
+inline std::vector<ColumnSpec>
+hitColumns(bool compress)
+{
+  return {
+      {"hit_id", ColumnType::UInt64, false},
+      {"x", ColumnType::Float32, compress},
+      {"y", ColumnType::Float32, compress},
+      {"z", ColumnType::Float32, compress},
+      {"t", ColumnType::Float32, compress},
+      {"volume_id", ColumnType::UInt32, false},
+      {"layer_id", ColumnType::UInt32, false},
+      {"module_id", ColumnType::UInt32, false},
+  };
+}
+
+inline std::vector<ColumnSpec>
+cellColumns(bool compress)
+{
+  return {
+      {"hit_id", ColumnType::UInt64, false},
+      {"ch0", ColumnType::Int32, compress},
+      {"ch1", ColumnType::Int32, compress},
+      {"timestamp", ColumnType::Int32, compress},
+      {"value", ColumnType::Int32, compress},
+  };
+}
+
+inline std::vector<ColumnSpec>
+truthColumns(bool compress)
+{
+  return {
+      {"hit_id", ColumnType::UInt64, false},
+      {"particle_id", ColumnType::UInt64, false},
+      {"tx", ColumnType::Float32, compress},
+      {"ty", ColumnType::Float32, compress},
+      {"tz", ColumnType::Float32, compress},
+      {"tt", ColumnType::Float32, compress},
+      {"tpx", ColumnType::Float32, compress},
+      {"tpy", ColumnType::Float32, compress},
+      {"tpz", ColumnType::Float32, compress},
+  };
+}
+
+/// Columns of the pile-up library. Vertices are stored in event order and
+/// particles refer to them by their index within the event.
+
+inline std::vector<ColumnSpec>
+pileupVertexColumns(bool compress)
+{
+  return {
+      {"vx", ColumnType::Float32, compress},
+      {"vy", ColumnType::Float32, compress},
+      {"vz", ColumnType::Float32, compress},
+      {"vt", ColumnType::Float32, compress},
+      {"process", ColumnType::UInt32, compress},
+  };
+}
+
+inline std::vector<ColumnSpec>
+pileupParticleColumns(bool compress)
+{
+  return {
+      {"vertex", ColumnType::UInt32, false},
+      {"incoming", ColumnType::Int32, false},
+      {"particle_id", ColumnType::UInt64, false},
+      {"particle_type", ColumnType::Int32, false},
+      {"x", ColumnType::Float32, compress},
+      {"y", ColumnType::Float32, compress},
+      {"z", ColumnType::Float32, compress},
+      {"t", ColumnType::Float32, compress},
+      {"px", ColumnType::Float32, compress},
+      {"py", ColumnType::Float32, compress},
+      {"pz", ColumnType::Float32, compress},
+      {"m", ColumnType::Float32, compress},
+      {"q", ColumnType::Float32, compress},
+  };
+}
+
+inline std::vector<ColumnSpec>
+pileupHitColumns(bool compress)
+{
+  return {
+      {"geometry_id", ColumnType::UInt64, false},
+      {"particle_id", ColumnType::UInt64, false},
+      {"x", ColumnType::Float32, compress},
+      {"y", ColumnType::Float32, compress},
+      {"z", ColumnType::Float32, compress},
+      {"t", ColumnType::Float32, compress},
+      {"dx", ColumnType::Float32, compress},
+      {"dy", ColumnType::Float32, compress},
+      {"dz", ColumnType::Float32, compress},
+      {"tpx", ColumnType::Float32, compress},
+      {"tpy", ColumnType::Float32, compress},
+      {"tpz", ColumnType::Float32, compress},
+      {"value", ColumnType::Float32, compress},
+  };
+}
+
+}  // namespace FW
@@ -0,0 +1,243 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryMaterialDecorator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Acts/Geometry/TrackingVolume.hpp>
+#include <Acts/Material/BinnedSurfaceMaterial.hpp>
+#include <Acts/Material/HomogeneousSurfaceMaterial.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <Acts/Utilities/BinUtility.hpp>
+#include <Acts/Utilities/BinningType.hpp>
+#include <Acts/Utilities/Definitions.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "BinaryMaterialFormat.hpp"
+
+namespace {
+using namespace FW::BinaryMaterial;
+
+template <typename T>
+inline T
+readValue(const uint8_t* ptr)
+{
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+inline Acts::MaterialProperties
+readSlab(const uint8_t* ptr)
+{
+  float slab[kSlabValues];
+  std::memcpy(slab, ptr, sizeof(slab));
+  // empty bins are stored with zero thickness
+  if (not(0 < slab[0])) { return Acts::MaterialProperties(); }
+  return Acts::MaterialProperties(
+      slab[1], slab[2], slab[3], slab[4], slab[5], slab[0]);
+}
+}  // namespace
+
+struct FW::BinaryMaterialDecorator::Mapping
+{
+  boost::interprocess::file_mapping  file;
+  boost::interprocess::mapped_region region;
+
+  Mapping(const std::string& path)
+    : file(path.c_str(), boost::interprocess::read_only)
+    , region(file, boost::interprocess::read_only)
+  {
+  }
+};
+
+FW::BinaryMaterialDecorator::BinaryMaterialDecorator(
+    const FW::BinaryMaterialDecorator::Config& cfg,
+    Acts::Logging::Level                       level)
+  : m_cfg(cfg)
+  , m_logger(Acts::getDefaultLogger("BinaryMaterialDecorator", level))
+{
+  if (m_cfg.fileName.empty()) {
+    throw std::invalid_argument("Missing file name");
+  }
+  try {
+    m_mapping = std::make_unique<Mapping>(m_cfg.fileName);
+  } catch (const boost::interprocess::interprocess_exception& e) {
+    throw std::runtime_error("Could not map '" + m_cfg.fileName
+                             + "': " + e.what());
+  }
+  m_base = static_cast<const uint8_t*>(m_mapping->region.get_address());
+  m_size = m_mapping->region.get_size();
+
+  auto corrupt = [&](const std::string& what) {
+    return std::runtime_error("'" + m_cfg.fileName + "' is corrupt: " + what);
+  };
+
+  // header
+  if ((m_size < kHeaderSize)
+      or (std::memcmp(m_base, kMagic, sizeof(kMagic)) != 0)) {
+    throw corrupt("invalid header");
+  }
+  if (readValue<uint32_t>(m_base + kOffsetVersion) != kVersion) {
+    throw corrupt("unsupported version");
+  }
+  auto numSurfaces = readValue<uint64_t>(m_base + kOffsetNumSurfaces);
+
+  // surface index; records are only checked to be inside the file
+  if (m_size < (kHeaderSize + numSurfaces * kEntrySize)) {
+    throw corrupt("truncated index");
+  }
+  m_index.reserve(numSurfaces);
+  for (uint64_t i = 0; i < numSurfaces; ++i) {
+    const uint8_t* entry = m_base + kHeaderSize + i * kEntrySize;
+    m_index.push_back({readValue<uint64_t>(entry),
+                       readValue<uint64_t>(entry + 8u),
+                       readValue<uint64_t>(entry + 16u)});
+    const Entry& last = m_index.back();
+    if ((last.size < recordSize(false, 0u, 0u, 1u))
+        or (m_size < (last.offset + last.size))) {
+      throw corrupt("surface record outside of the file");
+    }
+    if ((0 < i) and not(m_index[i - 1].geoId < last.geoId)) {
+      throw corrupt("unsorted surface index");
+    }
+  }
+  m_once    = std::vector<std::once_flag>(m_index.size());
+  m_decoded = std::vector<std::shared_ptr<const Acts::ISurfaceMaterial>>(
+      m_index.size());
+
+  ACTS_DEBUG("Mapped material for " << m_index.size() << " surfaces from '"
+                                    << m_cfg.fileName << "'");
+}
+
+FW::BinaryMaterialDecorator::~BinaryMaterialDecorator() = default;
+
+void
+FW::BinaryMaterialDecorator::decorate(Acts::Surface& surface) const
+{
+  auto sMaterial = surfaceMaterial(surface.geoID());
+  if (sMaterial or m_cfg.clearSurfaceMaterial) {
+    surface.assignSurfaceMaterial(std::move(sMaterial));
+  }
+}
+
+void
+FW::BinaryMaterialDecorator::decorate(Acts::TrackingVolume& volume) const
+{
+  if (m_cfg.clearVolumeMaterial) { volume.assignVolumeMaterial(nullptr); }
+}
+
+std::shared_ptr<const Acts::ISurfaceMaterial>
+FW::BinaryMaterialDecorator::surfaceMaterial(Acts::GeometryID geoId) const
+{
+  auto it = std::lower_bound(
+      m_index.begin(),
+      m_index.end(),
+      geoId.value(),
+      [](const Entry& entry, uint64_t value) { return entry.geoId < value; });
+  if ((it == m_index.end()) or (it->geoId != geoId.value())) {
+    return nullptr;
+  }
+  size_t i = std::distance(m_index.begin(), it);
+  std::call_once(m_once[i], [&] { m_decoded[i] = decode(*it); });
+  return m_decoded[i];
+}
+
+std::shared_ptr<const Acts::ISurfaceMaterial>
+FW::BinaryMaterialDecorator::decode(const Entry& entry) const
+{
+  const uint8_t* record       = m_base + entry.offset;
+  auto           numBinning   = readValue<uint32_t>(record);
+  auto           flags        = readValue<uint32_t>(record + 4u);
+  bool           hasTransform = (flags & kHasTransform);
+
+  auto corrupt = [&](const std::string& what) {
+    return std::runtime_error("'" + m_cfg.fileName + "' is corrupt: " + what);
+  };
+
+  // homogeneous material is stored w/o binning as a single slab
+  if (numBinning == 0u) {
+    if (entry.size != recordSize(false, 0u, 0u, 1u)) {
+      throw corrupt("inconsistent surface record");
+    }
+    ACTS_VERBOSE("Decode homogeneous material for "
+                 << Acts::GeometryID(entry.geoId));
+    return std::make_shared<const Acts::HomogeneousSurfaceMaterial>(
+        readSlab(record + kRecordHead));
+  }
+
+  if (entry.size < recordSize(hasTransform, numBinning, 0u, 0u)) {
+    throw corrupt("truncated surface record");
+  }
+  const uint8_t* content = record + kRecordHead;
+  std::shared_ptr<const Acts::Transform3D> transform;
+  if (hasTransform) {
+    Acts::Transform3D matrix = Acts::Transform3D::Identity();
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        matrix(row, col) = readValue<double>(content);
+        content += sizeof(double);
+      }
+    }
+    transform = std::make_shared<const Acts::Transform3D>(matrix);
+  }
+  const uint8_t*   binnings      = content;
+  const uint8_t*   boundaries    = binnings + numBinning * kBinningSize;
+  uint64_t         numBoundaries = 0;
+  Acts::BinUtility bUtility(transform);
+  for (uint32_t ib = 0; ib < numBinning; ++ib) {
+    const uint8_t* binning = binnings + ib * kBinningSize;
+    auto           bins    = readValue<uint32_t>(binning);
+    auto           val     = Acts::BinningValue(binning[4]);
+    auto           opt     = Acts::BinningOption(binning[5]);
+    auto           type    = Acts::BinningType(binning[6]);
+    auto           rmin    = readValue<float>(binning + 8u);
+    auto           rmax    = readValue<float>(binning + 12u);
+    if (type == Acts::arbitrary) {
+      uint64_t first = numBoundaries;
+      numBoundaries += bins + 1u;
+      if (entry.size
+          < recordSize(hasTransform, numBinning, numBoundaries, 0u)) {
+        throw corrupt("truncated surface record");
+      }
+      std::vector<float> values(bins + 1u);
+      std::memcpy(values.data(),
+                  boundaries + first * sizeof(float),
+                  values.size() * sizeof(float));
+      bUtility += Acts::BinUtility(values, opt, val);
+    } else {
+      bUtility += Acts::BinUtility(bins, rmin, rmax, opt, val);
+    }
+  }
+  size_t bins0 = bUtility.bins(0);
+  size_t bins1 = bUtility.bins(1);
+  if (entry.size
+      != recordSize(hasTransform, numBinning, numBoundaries, bins0 * bins1)) {
+    throw corrupt("inconsistent surface record");
+  }
+
+  const uint8_t* slabs = boundaries + numBoundaries * sizeof(float);
+  Acts::MaterialPropertiesMatrix materialMatrix(
+      bins1, Acts::MaterialPropertiesVector(bins0, Acts::MaterialProperties()));
+  for (size_t b1 = 0; b1 < bins1; ++b1) {
+    for (size_t b0 = 0; b0 < bins0; ++b0) {
+      materialMatrix[b1][b0] = readSlab(slabs);
+      slabs += kSlabValues * sizeof(float);
+    }
+  }
+  ACTS_VERBOSE("Decode binned material for " << Acts::GeometryID(entry.geoId)
+                                             << " with " << bUtility);
+  return std::make_shared<const Acts::BinnedSurfaceMaterial>(
+      bUtility, std::move(materialMatrix));
+}
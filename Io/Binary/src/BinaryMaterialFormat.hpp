@@ -0,0 +1,96 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief On-disk layout of the binary material maps
+///
+/// The file layout is
+///
+///     header | surface index | surface records ...
+///
+/// with a fixed-size header
+///
+///     magic[8] | version u32 | reserved u32 | numSurfaces u64 | reserved u64
+///
+/// and one index entry per surface, sorted by geometry identifier,
+///
+///     geoId u64 | offset u64 | size u64
+///
+/// Each surface record is aligned to 8 bytes and contains
+///
+///     numBinning u32 | flags u32 | [transform] | binning[numBinning] |
+///     boundaries | slabs
+///
+/// where the optional transform of the bin utility is stored as the 3x4
+/// affine matrix in row-major order with 12 f64 values if the `kHasTransform`
+/// flag is set, and a binning entry is
+///
+///     bins u32 | value u8 | option u8 | type u8 | reserved u8 |
+///     min f32 | max f32
+///
+/// The boundaries contain `bins + 1` f32 values for each binning entry with
+/// arbitrary binning type in the order of the binning entries. The slabs are
+/// the material properties of all bins in the row-major order of
+/// `Acts::MaterialPropertiesMatrix`, i.e. bin1 is the slow index, with
+/// `kSlabValues` floats each. Surfaces without binning store a single slab of
+/// homogeneous material. Empty bins have zero thickness. All numbers are
+/// stored in native byte order.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace FW {
+namespace BinaryMaterial {
+
+  constexpr char     kMagic[8]    = {'A', 'C', 'T', 'F', 'W', 'M', 'A', 'T'};
+  constexpr uint32_t kVersion     = 2u;
+  constexpr size_t   kHeaderSize  = 32u;
+  constexpr size_t   kEntrySize   = 3u * sizeof(uint64_t);
+  constexpr size_t   kRecordHead  = 8u;
+  constexpr size_t   kBinningSize = 16u;
+  constexpr size_t   kAlignment   = 8u;
+
+  /// Record flag for a bin utility with a transform.
+  constexpr uint32_t kHasTransform = 1u;
+  /// Transform values: the 3x4 affine matrix.
+  constexpr size_t kTransformValues = 12u;
+
+  // header field offsets
+  constexpr size_t kOffsetVersion     = 8u;
+  constexpr size_t kOffsetNumSurfaces = 16u;
+
+  /// Slab values: thickness, X0, L0, Ar, Z, mass density.
+  constexpr size_t kSlabValues = 6u;
+
+  inline uint64_t
+  alignUp(uint64_t offset)
+  {
+    return (offset + kAlignment - 1) & ~uint64_t(kAlignment - 1);
+  }
+
+  /// Record size for the given record content.
+  ///
+  /// @param hasTransform whether the bin utility transform is stored
+  /// @param numBinning number of binning entries
+  /// @param numBoundaries total number of arbitrary bin boundaries
+  /// @param numSlabs number of material slabs
+  inline uint64_t
+  recordSize(bool     hasTransform,
+             uint64_t numBinning,
+             uint64_t numBoundaries,
+             uint64_t numSlabs)
+  {
+    return kRecordHead + (hasTransform ? kTransformValues * sizeof(double) : 0u)
+        + numBinning * kBinningSize + numBoundaries * sizeof(float)
+        + numSlabs * kSlabValues * sizeof(float);
+  }
+
+}  // namespace BinaryMaterial
+}  // namespace FW
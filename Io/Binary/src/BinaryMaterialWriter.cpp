@@ -0,0 +1,374 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryMaterialWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Acts/Geometry/Layer.hpp>
+#include <Acts/Geometry/TrackingGeometry.hpp>
+#include <Acts/Geometry/TrackingVolume.hpp>
+#include <Acts/Material/BinnedSurfaceMaterial.hpp>
+#include <Acts/Material/HomogeneousSurfaceMaterial.hpp>
+#include <Acts/Surfaces/Surface.hpp>
+#include <Acts/Utilities/BinUtility.hpp>
+#include <Acts/Utilities/BinningType.hpp>
+
+#include "ACTFW/Io/Binary/BinaryMaterialDecorator.hpp"
+#include "BinaryMaterialFormat.hpp"
+
+namespace {
+using namespace FW::BinaryMaterial;
+
+template <typename T>
+inline void
+writeValue(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// A surface prepared for writing.
+struct Record
+{
+  uint64_t                           geoId;
+  const Acts::BinnedSurfaceMaterial* binned;
+  const Acts::ISurfaceMaterial*      material;
+  bool                               hasTransform;
+  uint64_t                           numBoundaries;
+  uint64_t                           bins0;
+  uint64_t                           bins1;
+  uint64_t                           size;
+};
+
+void
+writeRecord(std::ostream& os, const Record& record)
+{
+  uint32_t numBinning
+      = record.binned ? record.binned->binUtility().dimensions() : 0u;
+  writeValue(os, numBinning);
+  writeValue(os, record.hasTransform ? kHasTransform : uint32_t(0));
+  if (record.hasTransform) {
+    const auto& matrix = record.binned->binUtility().transform()->matrix();
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        writeValue(os, static_cast<double>(matrix(row, col)));
+      }
+    }
+  }
+  for (uint32_t ib = 0; ib < numBinning; ++ib) {
+    const auto& bData = record.binned->binUtility().binningData()[ib];
+    writeValue(os, static_cast<uint32_t>(bData.bins()));
+    writeValue(os, static_cast<uint8_t>(bData.binvalue));
+    writeValue(os, static_cast<uint8_t>(bData.option));
+    writeValue(os, static_cast<uint8_t>(bData.type));
+    writeValue(os, uint8_t(0));
+    writeValue(os, static_cast<float>(bData.min));
+    writeValue(os, static_cast<float>(bData.max));
+  }
+  for (uint32_t ib = 0; ib < numBinning; ++ib) {
+    const auto& bData = record.binned->binUtility().binningData()[ib];
+    if (bData.type == Acts::arbitrary) {
+      for (float boundary : bData.boundaries()) { writeValue(os, boundary); }
+    }
+  }
+  // same ordering as the material properties matrix
+  float slab[kSlabValues];
+  for (size_t b1 = 0; b1 < record.bins1; ++b1) {
+    for (size_t b0 = 0; b0 < record.bins0; ++b0) {
+      const auto& mat = record.material->materialProperties(b0, b1);
+      std::fill(slab, slab + kSlabValues, 0.0f);
+      if (mat) {
+        slab[0] = mat.thickness();
+        slab[1] = mat.material().X0();
+        slab[2] = mat.material().L0();
+        slab[3] = mat.material().Ar();
+        slab[4] = mat.material().Z();
+        slab[5] = mat.material().massDensity();
+      }
+      os.write(reinterpret_cast<const char*>(slab), sizeof(slab));
+    }
+  }
+}
+}  // namespace
+
+FW::BinaryMaterialWriter::BinaryMaterialWriter(
+    const FW::BinaryMaterialWriter::Config& cfg,
+    Acts::Logging::Level                    level)
+  : m_cfg(cfg), m_logger(Acts::getDefaultLogger("BinaryMaterialWriter", level))
+{
+  if (m_cfg.fileName.empty()) {
+    throw std::invalid_argument("Missing file name");
+  }
+}
+
+void
+FW::BinaryMaterialWriter::write(const Acts::DetectorMaterialMaps& detMaterial)
+{
+  if (not detMaterial.second.empty()) {
+    ACTS_WARNING("Volume material is not supported and will not be written");
+  }
+
+  // prepare the records in index order
+  std::vector<Record> records;
+  records.reserve(detMaterial.first.size());
+  for (const auto& [geoId, sMaterial] : detMaterial.first) {
+    if (not sMaterial) { continue; }
+    Record record;
+    record.geoId    = geoId.value();
+    record.binned   = dynamic_cast<const Acts::BinnedSurfaceMaterial*>(
+        sMaterial.get());
+    record.material = sMaterial.get();
+    record.hasTransform  = false;
+    record.numBoundaries = 0;
+    record.bins0         = 1;
+    record.bins1         = 1;
+    record.size          = recordSize(false, 0u, 0u, 1u);
+    if (record.binned) {
+      const auto& bUtility = record.binned->binUtility();
+      for (const auto& bData : bUtility.binningData()) {
+        // sub-binning can not be represented; fail instead of writing a
+        // binning that would put the material into the wrong bins
+        if (bData.subBinningData) {
+          throw std::invalid_argument("Unsupported sub-binning in the material "
+                                      "of surface "
+                                      + std::to_string(record.geoId));
+        }
+        if (bData.type == Acts::arbitrary) {
+          record.numBoundaries += bData.boundaries().size();
+        }
+      }
+      record.hasTransform = (bUtility.transform() != nullptr);
+      record.bins0        = bUtility.bins(0);
+      record.bins1        = bUtility.bins(1);
+      record.size         = recordSize(record.hasTransform,
+                                       bUtility.dimensions(),
+                                       record.numBoundaries,
+                                       record.bins0 * record.bins1);
+    } else if (not dynamic_cast<const Acts::HomogeneousSurfaceMaterial*>(
+                   sMaterial.get())) {
+      ACTS_WARNING("Skip unsupported surface material for " << geoId);
+      continue;
+    }
+    records.push_back(record);
+  }
+  std::sort(records.begin(),
+            records.end(),
+            [](const Record& lhs, const Record& rhs) {
+              return lhs.geoId < rhs.geoId;
+            });
+
+  std::ofstream os(m_cfg.fileName,
+                   std::ios_base::binary | std::ios_base::trunc);
+  if (not os.good()) {
+    throw std::ios_base::failure("Could not open '" + m_cfg.fileName + "'");
+  }
+
+  // header
+  os.write(kMagic, sizeof(kMagic));
+  writeValue(os, kVersion);
+  writeValue(os, uint32_t(0));
+  writeValue(os, static_cast<uint64_t>(records.size()));
+  writeValue(os, uint64_t(0));
+  // index; the record sizes are known upfront
+  uint64_t offset = kHeaderSize + records.size() * kEntrySize;
+  for (const auto& record : records) {
+    writeValue(os, record.geoId);
+    writeValue(os, offset);
+    writeValue(os, record.size);
+    offset = alignUp(offset + record.size);
+  }
+  // records; the index is a multiple of the alignment
+  static const char zeros[kAlignment] = {};
+  for (const auto& record : records) {
+    writeRecord(os, record);
+    os.write(zeros, alignUp(record.size) - record.size);
+  }
+  if (not os.good()) {
+    throw std::ios_base::failure("Could not write to '" + m_cfg.fileName
+                                 + "'");
+  }
+  os.close();
+  ACTS_INFO("Wrote material for " << records.size() << " surfaces to '"
+                                  << m_cfg.fileName << "'");
+
+  if (m_cfg.verify) { verify(detMaterial, records.size()); }
+}
+
+void
+FW::BinaryMaterialWriter::verify(const Acts::DetectorMaterialMaps& detMaterial,
+                                 size_t numSurfaces) const
+{
+  BinaryMaterialDecorator::Config decoratorConfig;
+  decoratorConfig.fileName = m_cfg.fileName;
+  BinaryMaterialDecorator decorator(decoratorConfig);
+  if (decorator.size() != numSurfaces) {
+    throw std::runtime_error("Verification of '" + m_cfg.fileName
+                             + "' failed: inconsistent number of surfaces");
+  }
+
+  for (const auto& [geoId, sMaterial] : detMaterial.first) {
+    auto binned
+        = dynamic_cast<const Acts::BinnedSurfaceMaterial*>(sMaterial.get());
+    auto homogeneous
+        = dynamic_cast<const Acts::HomogeneousSurfaceMaterial*>(
+            sMaterial.get());
+    if (not binned and not homogeneous) { continue; }
+    auto fail = [&](const std::string& what) {
+      return std::runtime_error("Verification of '" + m_cfg.fileName
+                                + "' failed: " + what + " for surface "
+                                + std::to_string(geoId.value()));
+    };
+
+    auto decoded = decorator.surfaceMaterial(geoId);
+    if (not decoded) { throw fail("missing material"); }
+    size_t bins0 = 1;
+    size_t bins1 = 1;
+    if (binned) {
+      auto decodedBinned
+          = dynamic_cast<const Acts::BinnedSurfaceMaterial*>(decoded.get());
+      if (not decodedBinned) { throw fail("missing binning"); }
+      const auto& bUtility       = binned->binUtility();
+      const auto& decodedUtility = decodedBinned->binUtility();
+      if (bUtility.dimensions() != decodedUtility.dimensions()) {
+        throw fail("inconsistent binning dimensions");
+      }
+      bins0 = bUtility.bins(0);
+      bins1 = bUtility.bins(1);
+      // bin lookup at the center of each bin along its binning value
+      for (size_t ib = 0; ib < bUtility.dimensions(); ++ib) {
+        const auto& bData      = bUtility.binningData()[ib];
+        const auto  boundaries = bData.boundaries();
+        for (size_t i = 0; (i + 1) < boundaries.size(); ++i) {
+          double         center = 0.5 * (boundaries[i] + boundaries[i + 1]);
+          Acts::Vector3D position(center, 0., 0.);
+          if (bData.binvalue == Acts::binY) {
+            position = Acts::Vector3D(0., center, 0.);
+          } else if (bData.binvalue == Acts::binZ) {
+            position = Acts::Vector3D(0., 0., center);
+          } else if (bData.binvalue == Acts::binPhi) {
+            position = Acts::Vector3D(std::cos(center), std::sin(center), 0.);
+          }
+          if (bUtility.transform()) {
+            position = (*bUtility.transform()) * position;
+          }
+          for (size_t jb = 0; jb < bUtility.dimensions(); ++jb) {
+            if (bUtility.bin(position, jb)
+                != decodedUtility.bin(position, jb)) {
+              throw fail("inconsistent bin lookup");
+            }
+          }
+        }
+      }
+    }
+    for (size_t b1 = 0; b1 < bins1; ++b1) {
+      for (size_t b0 = 0; b0 < bins0; ++b0) {
+        const auto& expected = sMaterial->materialProperties(b0, b1);
+        const auto& actual   = decoded->materialProperties(b0, b1);
+        // values are stored with single precision
+        auto differs = [](double lhs, double rhs) {
+          return static_cast<float>(lhs) != static_cast<float>(rhs);
+        };
+        if ((bool(expected) != bool(actual))
+            or (expected
+                and (differs(expected.thickness(), actual.thickness())
+                     or differs(expected.material().X0(),
+                                actual.material().X0())
+                     or differs(expected.material().L0(),
+                                actual.material().L0())
+                     or differs(expected.material().Ar(),
+                                actual.material().Ar())
+                     or differs(expected.material().Z(), actual.material().Z())
+                     or differs(expected.material().massDensity(),
+                                actual.material().massDensity())))) {
+          throw fail("inconsistent material in bin " + std::to_string(b0)
+                     + "," + std::to_string(b1));
+        }
+      }
+    }
+  }
+  ACTS_INFO("Verified material for " << numSurfaces << " surfaces in '"
+                                     << m_cfg.fileName << "'");
+}
+
+void
+FW::BinaryMaterialWriter::write(const Acts::TrackingGeometry& tGeometry)
+{
+  Acts::DetectorMaterialMaps detMatMap;
+  auto                       hVolume = tGeometry.highestTrackingVolume();
+  if (hVolume != nullptr) { collectMaterial(*hVolume, detMatMap.first); }
+  write(detMatMap);
+}
+
+void
+FW::BinaryMaterialWriter::collectMaterial(
+    const Acts::TrackingVolume& tVolume,
+    Acts::SurfaceMaterialMap&   surfaceMaterial) const
+{
+  // If confined layers exist, loop over them and collect the layer material
+  if (tVolume.confinedLayers() != nullptr) {
+    for (auto& lay : tVolume.confinedLayers()->arrayObjects()) {
+      collectMaterial(*lay, surfaceMaterial);
+    }
+  }
+
+  // If any of the boundary surfaces has material collect that
+  if (m_cfg.processBoundaries) {
+    for (auto& bou : tVolume.boundarySurfaces()) {
+      const auto& bSurface = bou->surfaceRepresentation();
+      if (bSurface.surfaceMaterialSharedPtr() != nullptr) {
+        surfaceMaterial[bSurface.geoID()] = bSurface.surfaceMaterialSharedPtr();
+      }
+    }
+  }
+
+  // If the volume has sub volumes, step down
+  if (tVolume.confinedVolumes() != nullptr) {
+    for (auto& tvol : tVolume.confinedVolumes()->arrayObjects()) {
+      collectMaterial(*tvol, surfaceMaterial);
+    }
+  }
+}
+
+void
+FW::BinaryMaterialWriter::collectMaterial(
+    const Acts::Layer&        tLayer,
+    Acts::SurfaceMaterialMap& surfaceMaterial) const
+{
+  // If the representing surface has material, collect it
+  const auto& rSurface = tLayer.surfaceRepresentation();
+  if (rSurface.surfaceMaterialSharedPtr() != nullptr
+      and m_cfg.processRepresenting) {
+    surfaceMaterial[rSurface.geoID()] = rSurface.surfaceMaterialSharedPtr();
+  }
+
+  // Check the approach surfaces
+  if (tLayer.approachDescriptor() != nullptr and m_cfg.processApproaches) {
+    for (auto& aSurface : tLayer.approachDescriptor()->containedSurfaces()) {
+      if (aSurface->surfaceMaterialSharedPtr() != nullptr) {
+        surfaceMaterial[aSurface->geoID()]
+            = aSurface->surfaceMaterialSharedPtr();
+      }
+    }
+  }
+
+  // Check the sensitive surfaces
+  if (tLayer.surfaceArray() != nullptr and m_cfg.processSensitives) {
+    for (auto& sSurface : tLayer.surfaceArray()->surfaces()) {
+      if (sSurface->surfaceMaterialSharedPtr() != nullptr) {
+        surfaceMaterial[sSurface->geoID()]
+            = sSurface->surfaceMaterialSharedPtr();
+      }
+    }
+  }
+}
@@ -0,0 +1,95 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryParticleReader.hpp"
+
+#include <stdexcept>
+
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/EventData/SimParticle.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+
+FW::BinaryParticleReader::BinaryParticleReader(
+    const FW::BinaryParticleReader::Config& cfg,
+    Acts::Logging::Level                    level)
+  : m_cfg(cfg), m_logger(Acts::getDefaultLogger("BinaryParticleReader", level))
+{
+  if (m_cfg.outputParticles.empty()) {
+    throw std::invalid_argument("Missing output collection");
+  }
+  if (m_cfg.inputStem.empty()) {
+    throw std::invalid_argument("Missing input filename stem");
+  }
+  m_file = std::make_unique<ColumnarEventFileReader>(
+      joinPaths(m_cfg.inputDir, m_cfg.inputStem + ".evc"));
+}
+
+FW::BinaryParticleReader::~BinaryParticleReader() = default;
+
+std::string
+FW::BinaryParticleReader::name() const
+{
+  return "BinaryParticleReader";
+}
+
+std::pair<size_t, size_t>
+FW::BinaryParticleReader::availableEvents() const
+{
+  return m_file->availableEvents();
+}
+
+FW::ProcessCode
+FW::BinaryParticleReader::read(const FW::AlgorithmContext& ctx)
+{
+  if (not m_file->hasEvent(ctx.eventNumber)) {
+    ACTS_ERROR("Event " << ctx.eventNumber << " is missing in the input");
+    return ProcessCode::ABORT;
+  }
+  auto event = m_file->read(ctx.eventNumber);
+  auto id    = event.column<uint64_t>("particle_id").begin();
+  auto type  = event.column<int32_t>("particle_type").begin();
+  auto vx    = event.column<float>("vx").begin();
+  auto vy    = event.column<float>("vy").begin();
+  auto vz    = event.column<float>("vz").begin();
+  auto vt    = event.column<float>("vt").begin();
+  auto px    = event.column<float>("px").begin();
+  auto py    = event.column<float>("py").begin();
+  auto pz    = event.column<float>("pz").begin();
+  auto q     = event.column<float>("q").begin();
+
+  SimParticles particles;
+  particles.reserve(event.numRows());
+  for (size_t i = 0; i < event.numRows(); ++i) {
+    Acts::Vector3D particlePos(vx[i] * Acts::UnitConstants::mm,
+                               vy[i] * Acts::UnitConstants::mm,
+                               vz[i] * Acts::UnitConstants::mm);
+    double         particleTime = vt[i] * Acts::UnitConstants::ns;
+    Acts::Vector3D particleMom(px[i] * Acts::UnitConstants::GeV,
+                               py[i] * Acts::UnitConstants::GeV,
+                               pz[i] * Acts::UnitConstants::GeV);
+    //@TODO: get mass and pdg from config?
+    double mass = 0.;
+    // the file is usually ordered by particle id already
+    particles.emplace_hint(particles.end(),
+                           particlePos,
+                           particleMom,
+                           mass,
+                           q[i] * Acts::UnitConstants::e,
+                           type[i],  // this is the pdg id
+                           id[i],
+                           particleTime);
+  }
+
+  // write the truth particles to the EventStore
+  ctx.eventStore.add(m_cfg.outputParticles, std::move(particles));
+
+  return ProcessCode::SUCCESS;
+}
@@ -0,0 +1,107 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryParticleWriter.hpp"
+
+#include <map>
+#include <stdexcept>
+
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+#include "BinaryColumns.hpp"
+
+FW::BinaryParticleWriter::BinaryParticleWriter(
+    const FW::BinaryParticleWriter::Config& cfg,
+    Acts::Logging::Level                    level)
+  : WriterT(cfg.inputEvent, "BinaryParticleWriter", level), m_cfg(cfg)
+{
+  // inputEvent is already checked by base constructor
+  if (m_cfg.outputStem.empty()) {
+    throw std::invalid_argument("Missing ouput filename stem");
+  }
+  m_file = std::make_unique<ColumnarEventFileWriter>(
+      joinPaths(m_cfg.outputDir, m_cfg.outputStem + ".evc"),
+      particleColumns(m_cfg.compress));
+}
+
+FW::BinaryParticleWriter::~BinaryParticleWriter() = default;
+
+FW::ProcessCode
+FW::BinaryParticleWriter::endRun()
+{
+  m_file->close();
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::BinaryParticleWriter::writeT(const FW::AlgorithmContext&         context,
+                                 const std::vector<Data::SimVertex>& vertices)
+{
+  // use pointer instead of reference since it is optional
+  const std::map<Barcode, size_t>* hitsPerParticle = nullptr;
+  if (not m_cfg.inputHitsPerParticle.empty()) {
+    hitsPerParticle = &context.eventStore.get<std::map<Barcode, size_t>>(
+        m_cfg.inputHitsPerParticle);
+  }
+
+  size_t numParticles = 0;
+  for (auto& vertex : vertices) { numParticles += vertex.outgoing.size(); }
+
+  std::vector<uint64_t> particleId;
+  std::vector<int32_t>  particleType, nhits;
+  std::vector<float>    vx, vy, vz, vt, px, py, pz, q;
+  for (auto* column : {&particleType, &nhits}) {
+    column->reserve(numParticles);
+  }
+  for (auto* column : {&vx, &vy, &vz, &vt, &px, &py, &pz, &q}) {
+    column->reserve(numParticles);
+  }
+  particleId.reserve(numParticles);
+
+  for (auto& vertex : vertices) {
+    for (auto& particle : vertex.outgoing) {
+      particleId.push_back(particle.barcode().value());
+      particleType.push_back(particle.pdg());
+      vx.push_back(particle.position().x() / Acts::UnitConstants::mm);
+      vy.push_back(particle.position().y() / Acts::UnitConstants::mm);
+      vz.push_back(particle.position().z() / Acts::UnitConstants::mm);
+      vt.push_back(particle.time() / Acts::UnitConstants::ns);
+      px.push_back(particle.momentum().x() / Acts::UnitConstants::GeV);
+      py.push_back(particle.momentum().y() / Acts::UnitConstants::GeV);
+      pz.push_back(particle.momentum().z() / Acts::UnitConstants::GeV);
+      q.push_back(particle.q() / Acts::UnitConstants::e);
+      // default for every entry if information unvailable
+      int32_t n = -1;
+      if (hitsPerParticle) {
+        auto hppEntry = hitsPerParticle->find(particle.barcode());
+        if (hppEntry != hitsPerParticle->end()) { n = hppEntry->second; }
+      }
+      nhits.push_back(n);
+    }
+  }
+
+  // must follow the column order defined in `particleColumns`
+  ColumnarEventData data;
+  data.add(particleId);
+  data.add(particleType);
+  data.add(vx);
+  data.add(vy);
+  data.add(vz);
+  data.add(vt);
+  data.add(px);
+  data.add(py);
+  data.add(pz);
+  data.add(q);
+  data.add(nhits);
+  m_file->append(context.eventNumber, std::move(data));
+
+  return ProcessCode::SUCCESS;
+}
@@ -0,0 +1,200 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryPileupLibrary.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <Acts/Surfaces/Surface.hpp>
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+
+FW::BinaryPileupLibrary::BinaryPileupLibrary(
+    const FW::BinaryPileupLibrary::Config& cfg)
+  : m_cfg(cfg)
+{
+  if (not m_cfg.trackingGeometry) {
+    throw std::invalid_argument("Missing tracking geometry");
+  }
+  if (m_cfg.inputStem.empty()) {
+    throw std::invalid_argument("Missing input filename stem");
+  }
+  auto path = [&](const std::string& component) {
+    return joinPaths(m_cfg.inputDir,
+                     m_cfg.inputStem + "-" + component + ".evc");
+  };
+  m_vertices  = std::make_unique<ColumnarEventFileReader>(path("vertices"));
+  m_particles = std::make_unique<ColumnarEventFileReader>(path("particles"));
+  m_hits      = std::make_unique<ColumnarEventFileReader>(path("hits"));
+
+  // only events with all components are usable
+  m_events = m_vertices->events();
+  m_events.erase(std::remove_if(m_events.begin(),
+                                m_events.end(),
+                                [this](size_t event) {
+                                  return not m_particles->hasEvent(event)
+                                      or not m_hits->hasEvent(event);
+                                }),
+                 m_events.end());
+  if (m_events.empty()) {
+    throw std::runtime_error("No events in the pile-up library '"
+                             + path("*") + "'");
+  }
+
+  // fill the geo id to surface map once to speed up lookups later on
+  m_cfg.trackingGeometry->visitSurfaces([this](const Acts::Surface* surface) {
+    this->m_surfaces[surface->geoID()] = surface;
+  });
+}
+
+FW::BinaryPileupLibrary::~BinaryPileupLibrary() = default;
+
+FW::Barcode::Value
+FW::BinaryPileupLibrary::append(size_t                        index,
+                                Barcode::Value                primaryOffset,
+                                double                        timeShift,
+                                std::vector<Data::SimVertex>& vertices,
+                                SimHits::sequence_type&       hits) const
+{
+  using Acts::UnitConstants::e;
+  using Acts::UnitConstants::GeV;
+  using Acts::UnitConstants::mm;
+  using Acts::UnitConstants::ns;
+
+  size_t event = m_events.at(index);
+
+  Barcode::Value maxPrimary = primaryOffset;
+  auto           shift      = [&](uint64_t encoded) {
+    Barcode        barcode(encoded);
+    Barcode::Value primary = barcode.vertexPrimary() + primaryOffset;
+    // keep the unmasked value so the caller can detect an overflow
+    maxPrimary = std::max(maxPrimary, primary);
+    return barcode.setVertexPrimary(primary);
+  };
+
+  // vertices
+  auto         storedVertices = m_vertices->read(event);
+  const float* vx             = storedVertices.column<float>("vx").begin();
+  const float* vy             = storedVertices.column<float>("vy").begin();
+  const float* vz             = storedVertices.column<float>("vz").begin();
+  const float* vt             = storedVertices.column<float>("vt").begin();
+  const uint32_t* process = storedVertices.column<uint32_t>("process").begin();
+  size_t          first   = vertices.size();
+  for (size_t i = 0; i < storedVertices.numRows(); ++i) {
+    vertices.emplace_back(Acts::Vector3D(vx[i] * mm, vy[i] * mm, vz[i] * mm),
+                          std::vector<Data::SimParticle>{},
+                          std::vector<Data::SimParticle>{},
+                          process[i],
+                          vt[i] * ns + timeShift);
+  }
+
+  // particles; also needed for the hits, since the hits only store the
+  // particle momentum at the hit position
+  auto            storedParticles = m_particles->read(event);
+  const uint32_t* vertex   = storedParticles.column<uint32_t>("vertex").begin();
+  const int32_t* incoming = storedParticles.column<int32_t>("incoming").begin();
+  const uint64_t* particleId
+      = storedParticles.column<uint64_t>("particle_id").begin();
+  const int32_t* particleType
+      = storedParticles.column<int32_t>("particle_type").begin();
+  const float* x  = storedParticles.column<float>("x").begin();
+  const float* y  = storedParticles.column<float>("y").begin();
+  const float* z  = storedParticles.column<float>("z").begin();
+  const float* t  = storedParticles.column<float>("t").begin();
+  const float* px = storedParticles.column<float>("px").begin();
+  const float* py = storedParticles.column<float>("py").begin();
+  const float* pz = storedParticles.column<float>("pz").begin();
+  const float* m  = storedParticles.column<float>("m").begin();
+  const float* q  = storedParticles.column<float>("q").begin();
+  std::unordered_map<uint64_t, size_t> particleRows;
+  particleRows.reserve(storedParticles.numRows());
+  for (size_t i = 0; i < storedParticles.numRows(); ++i) {
+    if (storedVertices.numRows() <= vertex[i]) {
+      throw std::runtime_error("Invalid vertex for particle "
+                               + std::to_string(particleId[i])
+                               + " in pile-up event "
+                               + std::to_string(event));
+    }
+    Data::SimParticle particle(
+        Acts::Vector3D(x[i] * mm, y[i] * mm, z[i] * mm),
+        Acts::Vector3D(px[i] * GeV, py[i] * GeV, pz[i] * GeV),
+        m[i] * GeV,
+        q[i] * e,
+        particleType[i],
+        shift(particleId[i]),
+        t[i] * ns + timeShift);
+    auto& target = vertices[first + vertex[i]];
+    if (incoming[i]) {
+      target.incoming.push_back(std::move(particle));
+    } else {
+      target.outgoing.push_back(std::move(particle));
+    }
+    particleRows.emplace(particleId[i], i);
+  }
+
+  // hits
+  auto            storedHits = m_hits->read(event);
+  const uint64_t* geometryId
+      = storedHits.column<uint64_t>("geometry_id").begin();
+  const uint64_t* hitParticleId
+      = storedHits.column<uint64_t>("particle_id").begin();
+  const float* hx    = storedHits.column<float>("x").begin();
+  const float* hy    = storedHits.column<float>("y").begin();
+  const float* hz    = storedHits.column<float>("z").begin();
+  const float* ht    = storedHits.column<float>("t").begin();
+  const float* dx    = storedHits.column<float>("dx").begin();
+  const float* dy    = storedHits.column<float>("dy").begin();
+  const float* dz    = storedHits.column<float>("dz").begin();
+  const float* tpx   = storedHits.column<float>("tpx").begin();
+  const float* tpy   = storedHits.column<float>("tpy").begin();
+  const float* tpz   = storedHits.column<float>("tpz").begin();
+  const float* value = storedHits.column<float>("value").begin();
+  for (size_t i = 0; i < storedHits.numRows(); ++i) {
+    auto it = m_surfaces.find(Acts::GeometryID(geometryId[i]));
+    if (it == m_surfaces.end() or not it->second) {
+      throw std::runtime_error("Unknown surface "
+                               + std::to_string(geometryId[i])
+                               + " in pile-up event " + std::to_string(event));
+    }
+    Data::SimHit hit(*(it->second));
+    hit.position  = Acts::Vector3D(hx[i] * mm, hy[i] * mm, hz[i] * mm);
+    hit.time      = ht[i] * ns + timeShift;
+    hit.direction = Acts::Vector3D(dx[i], dy[i], dz[i]);
+    hit.value     = value[i];
+    // the particle state at the hit
+    Acts::Vector3D momentum(tpx[i] * GeV, tpy[i] * GeV, tpz[i] * GeV);
+    auto           row = particleRows.find(hitParticleId[i]);
+    if (row != particleRows.end()) {
+      size_t j     = row->second;
+      hit.particle = Data::SimParticle(hit.position,
+                                       momentum,
+                                       m[j] * GeV,
+                                       q[j] * e,
+                                       particleType[j],
+                                       shift(hitParticleId[i]),
+                                       hit.time);
+    } else {
+      // particles that are not stored have unknown mass and charge
+      hit.particle = Data::SimParticle(hit.position,
+                                       momentum,
+                                       0.,
+                                       0.,
+                                       0,
+                                       shift(hitParticleId[i]),
+                                       hit.time);
+    }
+    hits.push_back(std::move(hit));
+  }
+
+  return maxPrimary;
+}
@@ -0,0 +1,186 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryPileupLibraryWriter.hpp"
+
+#include <stdexcept>
+
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/EventData/SimHit.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+#include "BinaryColumns.hpp"
+
+FW::BinaryPileupLibraryWriter::BinaryPileupLibraryWriter(
+    const FW::BinaryPileupLibraryWriter::Config& cfg,
+    Acts::Logging::Level                         level)
+  : WriterT(cfg.inputEvent, "BinaryPileupLibraryWriter", level), m_cfg(cfg)
+{
+  // inputEvent is already checked by base constructor
+  if (m_cfg.inputHits.empty()) {
+    throw std::invalid_argument("Missing input hits collection");
+  }
+  if (m_cfg.outputStem.empty()) {
+    throw std::invalid_argument("Missing ouput filename stem");
+  }
+  auto path = [&](const std::string& component) {
+    return joinPaths(m_cfg.outputDir,
+                     m_cfg.outputStem + "-" + component + ".evc");
+  };
+  m_vertices = std::make_unique<ColumnarEventFileWriter>(
+      path("vertices"), pileupVertexColumns(m_cfg.compress));
+  m_particles = std::make_unique<ColumnarEventFileWriter>(
+      path("particles"), pileupParticleColumns(m_cfg.compress));
+  m_hits = std::make_unique<ColumnarEventFileWriter>(
+      path("hits"), pileupHitColumns(m_cfg.compress));
+}
+
+FW::BinaryPileupLibraryWriter::~BinaryPileupLibraryWriter() = default;
+
+FW::ProcessCode
+FW::BinaryPileupLibraryWriter::endRun()
+{
+  m_vertices->close();
+  m_particles->close();
+  m_hits->close();
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::BinaryPileupLibraryWriter::writeT(
+    const FW::AlgorithmContext&         context,
+    const std::vector<Data::SimVertex>& vertices)
+{
+  using Acts::UnitConstants::e;
+  using Acts::UnitConstants::GeV;
+  using Acts::UnitConstants::mm;
+  using Acts::UnitConstants::ns;
+
+  const auto& hits = context.eventStore.get<SimHits>(m_cfg.inputHits);
+
+  // vertices
+  {
+    std::vector<float>    vx, vy, vz, vt;
+    std::vector<uint32_t> process;
+    for (auto* column : {&vx, &vy, &vz, &vt}) {
+      column->reserve(vertices.size());
+    }
+    process.reserve(vertices.size());
+    for (const auto& vertex : vertices) {
+      vx.push_back(vertex.position.x() / mm);
+      vy.push_back(vertex.position.y() / mm);
+      vz.push_back(vertex.position.z() / mm);
+      vt.push_back(vertex.time / ns);
+      process.push_back(vertex.processCode);
+    }
+    // must follow the column order defined in `pileupVertexColumns`
+    ColumnarEventData data;
+    data.add(vx);
+    data.add(vy);
+    data.add(vz);
+    data.add(vt);
+    data.add(process);
+    m_vertices->append(context.eventNumber, std::move(data));
+  }
+
+  // particles, incoming before outgoing for each vertex
+  {
+    std::vector<uint32_t> vertex;
+    std::vector<int32_t>  incoming, particleType;
+    std::vector<uint64_t> particleId;
+    std::vector<float>    x, y, z, t, px, py, pz, m, q;
+    auto add = [&](uint32_t iv, bool in, const Data::SimParticle& particle) {
+      vertex.push_back(iv);
+      incoming.push_back(in ? 1 : 0);
+      particleId.push_back(particle.barcode().value());
+      particleType.push_back(particle.pdg());
+      x.push_back(particle.position().x() / mm);
+      y.push_back(particle.position().y() / mm);
+      z.push_back(particle.position().z() / mm);
+      t.push_back(particle.time() / ns);
+      px.push_back(particle.momentum().x() / GeV);
+      py.push_back(particle.momentum().y() / GeV);
+      pz.push_back(particle.momentum().z() / GeV);
+      m.push_back(particle.m() / GeV);
+      q.push_back(particle.q() / e);
+    };
+    for (size_t iv = 0; iv < vertices.size(); ++iv) {
+      for (const auto& particle : vertices[iv].incoming) {
+        add(iv, true, particle);
+      }
+      for (const auto& particle : vertices[iv].outgoing) {
+        add(iv, false, particle);
+      }
+    }
+    // must follow the column order defined in `pileupParticleColumns`
+    ColumnarEventData data;
+    data.add(vertex);
+    data.add(incoming);
+    data.add(particleId);
+    data.add(particleType);
+    data.add(x);
+    data.add(y);
+    data.add(z);
+    data.add(t);
+    data.add(px);
+    data.add(py);
+    data.add(pz);
+    data.add(m);
+    data.add(q);
+    m_particles->append(context.eventNumber, std::move(data));
+  }
+
+  // hits, already in geometry order
+  {
+    std::vector<uint64_t> geometryId, particleId;
+    std::vector<float>    x, y, z, t, dx, dy, dz, tpx, tpy, tpz, value;
+    geometryId.reserve(hits.size());
+    particleId.reserve(hits.size());
+    for (auto* column : {&x, &y, &z, &t, &dx, &dy, &dz}) {
+      column->reserve(hits.size());
+    }
+    for (auto* column : {&tpx, &tpy, &tpz, &value}) {
+      column->reserve(hits.size());
+    }
+    for (const auto& hit : hits) {
+      geometryId.push_back(hit.geometryId.value());
+      particleId.push_back(hit.particle.barcode().value());
+      x.push_back(hit.position.x() / mm);
+      y.push_back(hit.position.y() / mm);
+      z.push_back(hit.position.z() / mm);
+      t.push_back(hit.time / ns);
+      dx.push_back(hit.direction.x());
+      dy.push_back(hit.direction.y());
+      dz.push_back(hit.direction.z());
+      tpx.push_back(hit.particle.momentum().x() / GeV);
+      tpy.push_back(hit.particle.momentum().y() / GeV);
+      tpz.push_back(hit.particle.momentum().z() / GeV);
+      value.push_back(hit.value);
+    }
+    // must follow the column order defined in `pileupHitColumns`
+    ColumnarEventData data;
+    data.add(geometryId);
+    data.add(particleId);
+    data.add(x);
+    data.add(y);
+    data.add(z);
+    data.add(t);
+    data.add(dx);
+    data.add(dy);
+    data.add(dz);
+    data.add(tpx);
+    data.add(tpy);
+    data.add(tpz);
+    data.add(value);
+    m_hits->append(context.eventNumber, std::move(data));
+  }
+
+  return ProcessCode::SUCCESS;
+}
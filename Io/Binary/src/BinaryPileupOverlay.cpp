@@ -0,0 +1,107 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryPileupOverlay.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "ACTFW/EventData/Barcode.hpp"
+#include "ACTFW/EventData/SimHit.hpp"
+#include "ACTFW/EventData/SimVertex.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Io/Binary/BinaryPileupLibrary.hpp"
+
+namespace {
+// the primary vertex identifier is stored in 12 bits
+constexpr FW::Barcode::Value kMaxVertexPrimary = (1u << 12) - 1u;
+}  // namespace
+
+FW::BinaryPileupOverlay::BinaryPileupOverlay(
+    const FW::BinaryPileupOverlay::Config& cfg,
+    Acts::Logging::Level                   level)
+  : FW::BareAlgorithm("BinaryPileupOverlay", level), m_cfg(cfg)
+{
+  if (m_cfg.inputEvent.empty()) {
+    throw std::invalid_argument("Missing input event collection");
+  }
+  if (m_cfg.inputHits.empty()) {
+    throw std::invalid_argument("Missing input hits collection");
+  }
+  if (m_cfg.outputEvent.empty()) {
+    throw std::invalid_argument("Missing output event collection");
+  }
+  if (m_cfg.outputHits.empty()) {
+    throw std::invalid_argument("Missing output hits collection");
+  }
+  if (not m_cfg.library or (m_cfg.library->size() == 0)) {
+    throw std::invalid_argument("Missing or empty pile-up library");
+  }
+  if (not m_cfg.randomNumbers) {
+    throw std::invalid_argument("Missing random numbers service");
+  }
+  if (not m_cfg.multiplicity) {
+    throw std::invalid_argument("Missing pile-up multiplicity generator");
+  }
+  if (m_cfg.timeStddev < 0) {
+    throw std::invalid_argument("Negative pile-up time spread");
+  }
+}
+
+FW::ProcessCode
+FW::BinaryPileupOverlay::execute(const FW::AlgorithmContext& ctx) const
+{
+  std::vector<Data::SimVertex> event;
+  SimHits::sequence_type       hits;
+  if (m_cfg.consumeInput) {
+    event = ctx.eventStore.consume<std::vector<Data::SimVertex>>(
+        m_cfg.inputEvent);
+    hits = ctx.eventStore.consume<SimHits>(m_cfg.inputHits).extract_sequence();
+  } else {
+    const auto& inputHits = ctx.eventStore.get<SimHits>(m_cfg.inputHits);
+    event = ctx.eventStore.get<std::vector<Data::SimVertex>>(m_cfg.inputEvent);
+    hits.assign(inputHits.begin(), inputHits.end());
+  }
+
+  // pile-up primary vertex identifiers start after the hard-scatter ones
+  Barcode::Value offset = 0;
+  for (const auto& vertex : event) {
+    for (const auto& particle : vertex.outgoing) {
+      offset = std::max(offset, particle.barcode().vertexPrimary());
+    }
+  }
+
+  auto rng = m_cfg.randomNumbers->spawnGenerator(ctx);
+  std::uniform_int_distribution<size_t> pickEvent(0,
+                                                  m_cfg.library->size() - 1);
+  std::normal_distribution<double> timeShift(0., m_cfg.timeStddev);
+
+  size_t n = m_cfg.multiplicity(rng);
+  for (size_t i = 0; i < n; ++i) {
+    size_t index = pickEvent(rng);
+    double time  = (0 < m_cfg.timeStddev) ? timeShift(rng) : 0.;
+    offset       = m_cfg.library->append(index, offset, time, event, hits);
+    if (kMaxVertexPrimary < offset) {
+      ACTS_ERROR("Too many primary vertices after " << (i + 1) << " of " << n
+                                                    << " pile-up events");
+      return ProcessCode::ABORT;
+    }
+  }
+  ACTS_DEBUG("Added " << n << " pile-up events, " << event.size()
+                      << " vertices and " << hits.size() << " hits in total");
+
+  // restablish geometry ordering for the combined hits container
+  SimHits combinedHits;
+  combinedHits.adopt_sequence(std::move(hits));
+
+  ctx.eventStore.add(m_cfg.outputEvent, std::move(event));
+  ctx.eventStore.add(m_cfg.outputHits, std::move(combinedHits));
+  return ProcessCode::SUCCESS;
+}
@@ -0,0 +1,283 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryPlanarClusterReader.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
+#include <Acts/Plugins/Identification/IdentifiedDetectorElement.hpp>
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/EventData/Barcode.hpp"
+#include "ACTFW/EventData/DataContainers.hpp"
+#include "ACTFW/EventData/SimHit.hpp"
+#include "ACTFW/EventData/SimIdentifier.hpp"
+#include "ACTFW/EventData/SimParticle.hpp"
+#include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+#include "ACTFW/Utilities/Range.hpp"
+
+FW::BinaryPlanarClusterReader::BinaryPlanarClusterReader(
+    const FW::BinaryPlanarClusterReader::Config& cfg,
+    Acts::Logging::Level                         level)
+  : m_cfg(cfg)
+  , m_logger(Acts::getDefaultLogger("BinaryPlanarClusterReader", level))
+{
+  if (not m_cfg.trackingGeometry) {
+    throw std::invalid_argument("Missing tracking geometry");
+  }
+  if (m_cfg.outputClusters.empty()) {
+    throw std::invalid_argument("Missing cluster output collection");
+  }
+  if (m_cfg.outputHitIds.empty()) {
+    throw std::invalid_argument("Missing hit id output collection");
+  }
+  if (m_cfg.outputHitParticlesMap.empty()) {
+    throw std::invalid_argument("Missing hit-particles map output collection");
+  }
+  if (m_cfg.outputSimulatedHits.empty()) {
+    throw std::invalid_argument("Missing simulated hits output collection");
+  }
+  m_hits = std::make_unique<ColumnarEventFileReader>(
+      joinPaths(m_cfg.inputDir, "hits.evc"));
+  m_cells = std::make_unique<ColumnarEventFileReader>(
+      joinPaths(m_cfg.inputDir, "cells.evc"));
+  m_truth = std::make_unique<ColumnarEventFileReader>(
+      joinPaths(m_cfg.inputDir, "truth.evc"));
+  // fill the geo id to surface map once to speed up lookups later on
+  m_cfg.trackingGeometry->visitSurfaces([this](const Acts::Surface* surface) {
+    this->m_surfaces[surface->geoID()] = surface;
+  });
+}
+
+FW::BinaryPlanarClusterReader::~BinaryPlanarClusterReader() = default;
+
+std::string
+FW::BinaryPlanarClusterReader::name() const
+{
+  return "BinaryPlanarClusterReader";
+}
+
+std::pair<size_t, size_t>
+FW::BinaryPlanarClusterReader::availableEvents() const
+{
+  // all components must be available
+  auto hits  = m_hits->availableEvents();
+  auto cells = m_cells->availableEvents();
+  auto truth = m_truth->availableEvents();
+  return {std::max({hits.first, cells.first, truth.first}),
+          std::min({hits.second, cells.second, truth.second})};
+}
+
+namespace {
+/// Row order for which the given key is non-decreasing.
+///
+/// Rows written by the `BinaryPlanarClusterWriter` are already ordered and
+/// this reduces to the identity without any sorting.
+template <typename Key>
+std::vector<size_t>
+sortedRows(size_t numRows, Key key)
+{
+  std::vector<size_t> rows(numRows);
+  std::iota(rows.begin(), rows.end(), 0u);
+  auto compare = [&](size_t lhs, size_t rhs) { return key(lhs) < key(rhs); };
+  if (not std::is_sorted(rows.begin(), rows.end(), compare)) {
+    std::stable_sort(rows.begin(), rows.end(), compare);
+  }
+  return rows;
+}
+
+/// Rows with the given hit id from the rows ordered by hit id.
+inline FW::Range<std::vector<size_t>::const_iterator>
+selectHitId(const std::vector<size_t>& rows,
+            const uint64_t*            hitIds,
+            uint64_t                   hitId)
+{
+  // row indices and hit ids have the same type; no transparent comparator
+  auto beg = std::lower_bound(
+      rows.begin(), rows.end(), hitId, [=](size_t row, uint64_t id) {
+        return hitIds[row] < id;
+      });
+  auto end = std::upper_bound(
+      beg, rows.end(), hitId, [=](uint64_t id, size_t row) {
+        return id < hitIds[row];
+      });
+  return FW::makeRange(beg, end);
+}
+}  // namespace
+
+FW::ProcessCode
+FW::BinaryPlanarClusterReader::read(const FW::AlgorithmContext& ctx)
+{
+  if (not(m_hits->hasEvent(ctx.eventNumber)
+          and m_cells->hasEvent(ctx.eventNumber)
+          and m_truth->hasEvent(ctx.eventNumber))) {
+    ACTS_ERROR("Event " << ctx.eventNumber << " is missing in the input");
+    return ProcessCode::ABORT;
+  }
+  auto hits   = m_hits->read(ctx.eventNumber);
+  auto cells  = m_cells->read(ctx.eventNumber);
+  auto truths = m_truth->read(ctx.eventNumber);
+
+  // direct access to the stored columns
+  const uint64_t* hitId      = hits.column<uint64_t>("hit_id").begin();
+  const float*    x          = hits.column<float>("x").begin();
+  const float*    y          = hits.column<float>("y").begin();
+  const float*    z          = hits.column<float>("z").begin();
+  const float*    t          = hits.column<float>("t").begin();
+  const uint32_t* volumeId   = hits.column<uint32_t>("volume_id").begin();
+  const uint32_t* layerId    = hits.column<uint32_t>("layer_id").begin();
+  const uint32_t* moduleId   = hits.column<uint32_t>("module_id").begin();
+  const uint64_t* cellHitId  = cells.column<uint64_t>("hit_id").begin();
+  const int32_t*  ch0        = cells.column<int32_t>("ch0").begin();
+  const int32_t*  ch1        = cells.column<int32_t>("ch1").begin();
+  const int32_t*  value      = cells.column<int32_t>("value").begin();
+  const uint64_t* truthHitId = truths.column<uint64_t>("hit_id").begin();
+  const uint64_t* particleId = truths.column<uint64_t>("particle_id").begin();
+  const float*    tx         = truths.column<float>("tx").begin();
+  const float*    ty         = truths.column<float>("ty").begin();
+  const float*    tz         = truths.column<float>("tz").begin();
+  const float*    tt         = truths.column<float>("tt").begin();
+  const float*    tpx        = truths.column<float>("tpx").begin();
+  const float*    tpy        = truths.column<float>("tpy").begin();
+  const float*    tpz        = truths.column<float>("tpz").begin();
+
+  auto geometryId = [=](size_t row) {
+    Acts::GeometryID geoId;
+    geoId.setVolume(volumeId[row]);
+    geoId.setLayer(layerId[row]);
+    geoId.setSensitive(moduleId[row]);
+    return geoId;
+  };
+  // hits must be processed in the same order as the output container
+  auto hitRows = sortedRows(
+      hits.numRows(), [&](size_t row) { return geometryId(row).value(); });
+  // truth and cells are looked up by hit id
+  auto truthRows = sortedRows(truths.numRows(),
+                              [=](size_t row) { return truthHitId[row]; });
+  auto cellRows = sortedRows(cells.numRows(),
+                             [=](size_t row) { return cellHitId[row]; });
+
+  // prepare containers for the hit data using the framework event data types
+  GeometryIdMultimap<Acts::PlanarModuleCluster> clusters;
+  std::vector<uint64_t>                         hitIds;
+  IndexMultimap<Barcode>                        hitParticlesMap;
+  SimHits                                       simHits;
+  clusters.reserve(hits.numRows());
+  hitIds.reserve(hits.numRows());
+  hitParticlesMap.reserve(truths.numRows());
+  simHits.reserve(truths.numRows());
+
+  for (size_t hit : hitRows) {
+
+    // identify hit surface
+    Acts::GeometryID geoId = geometryId(hit);
+    auto             it    = m_surfaces.find(geoId);
+    if (it == m_surfaces.end() or not it->second) {
+      ACTS_FATAL("Could not retrieve the surface for hit " << hitId[hit]);
+      return ProcessCode::ABORT;
+    }
+    const Acts::Surface& surface = *(it->second);
+
+    // find associated truth hits and their particle data.
+    auto truthRange = selectHitId(truthRows, truthHitId, hitId[hit]);
+    std::vector<const FW::Data::SimParticle*> particles;
+    for (size_t truth : truthRange) {
+      FW::Data::SimHit simHit(surface);
+      simHit.position  = Acts::Vector3D(tx[truth] * Acts::UnitConstants::mm,
+                                       ty[truth] * Acts::UnitConstants::mm,
+                                       tz[truth] * Acts::UnitConstants::mm);
+      simHit.time      = tt[truth] * Acts::UnitConstants::ns;
+      simHit.direction = Acts::Vector3D(tpx[truth] * Acts::UnitConstants::GeV,
+                                        tpy[truth] * Acts::UnitConstants::GeV,
+                                        tpz[truth] * Acts::UnitConstants::GeV);
+      // TODO extract hit value/charge from cells
+      simHit.value = 0;
+      // Mass, charge, and PDG identifier are not stored with the truth
+      // information and are set to bogus values as in the csv reader.
+      simHit.particle = FW::Data::SimParticle(simHit.position,
+                                              simHit.direction,
+                                              0,
+                                              0,
+                                              0,
+                                              particleId[truth],
+                                              simHit.time);
+      // hit should only store direction not full momentum
+      simHit.direction.normalize();
+
+      // see `CsvPlanarClusterReader` for the reasoning behind the checks
+      auto capacity = simHits.capacity();
+      auto inserted = simHits.emplace_hint(simHits.end(), std::move(simHit));
+      if (std::next(inserted) != simHits.end()) {
+        ACTS_FATAL("Truth hit sorting broke for input hit id " << hitId[hit]);
+        return ProcessCode::ABORT;
+      }
+      if (capacity != simHits.capacity()) {
+        ACTS_FATAL(
+            "Forbidden truth hits reallocation encountered for input hit id "
+            << hitId[hit]);
+        return ProcessCode::ABORT;
+      }
+      particles.push_back(&(inserted->particle));
+    }
+
+    // find matching pixel cell information
+    std::vector<Acts::DigitizationCell> digitizationCells;
+    for (size_t cell : selectHitId(cellRows, cellHitId, hitId[hit])) {
+      digitizationCells.emplace_back(ch0[cell], ch1[cell], value[cell]);
+    }
+
+    // transform global hit coordinates into local coordinates on the surface
+    Acts::Vector3D pos(x[hit] * Acts::UnitConstants::mm,
+                       y[hit] * Acts::UnitConstants::mm,
+                       z[hit] * Acts::UnitConstants::mm);
+    double         time = t[hit] * Acts::UnitConstants::ns;
+    Acts::Vector3D mom(1, 1, 1);  // fake momentum
+    Acts::Vector2D local(0, 0);
+    surface.globalToLocal(ctx.geoContext, pos, mom, local);
+    // TODO what to use as cluster uncertainty?
+    Acts::ActsSymMatrixD<3> cov = Acts::ActsSymMatrixD<3>::Identity();
+    // create the planar cluster
+    Acts::PlanarModuleCluster cluster(
+        surface.getSharedPtr(),
+        Identifier(Identifier::identifier_type(geoId.value()),
+                   std::move(particles)),
+        std::move(cov),
+        local[0],
+        local[1],
+        time,
+        std::move(digitizationCells));
+
+    // hits are processed in geometry order; new clusters are always appended
+    auto inserted
+        = clusters.emplace_hint(clusters.end(), geoId, std::move(cluster));
+    if (std::next(inserted) != clusters.end()) {
+      ACTS_FATAL("Something went horribly wrong with the hit sorting");
+      return ProcessCode::ABORT;
+    }
+    auto hitIndex = clusters.index_of(inserted);
+    for (size_t truth : truthRange) {
+      hitParticlesMap.emplace_hint(
+          hitParticlesMap.end(), hitIndex, particleId[truth]);
+    }
+
+    // map internal hit/cluster index back to original hit id
+    hitIds.push_back(hitId[hit]);
+  }
+
+  // write the data to the EventStore
+  ctx.eventStore.add(m_cfg.outputClusters, std::move(clusters));
+  ctx.eventStore.add(m_cfg.outputHitIds, std::move(hitIds));
+  ctx.eventStore.add(m_cfg.outputHitParticlesMap, std::move(hitParticlesMap));
+  ctx.eventStore.add(m_cfg.outputSimulatedHits, std::move(simHits));
+
+  return FW::ProcessCode::SUCCESS;
+}
@@ -0,0 +1,151 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/BinaryPlanarClusterWriter.hpp"
+
+#include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
+#include <Acts/Utilities/Units.hpp>
+
+#include "ACTFW/EventData/SimIdentifier.hpp"
+#include "ACTFW/EventData/SimParticle.hpp"
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+#include "ACTFW/Utilities/Paths.hpp"
+#include "BinaryColumns.hpp"
+
+FW::BinaryPlanarClusterWriter::BinaryPlanarClusterWriter(
+    const FW::BinaryPlanarClusterWriter::Config& cfg,
+    Acts::Logging::Level                         level)
+  : WriterT(cfg.inputClusters, "BinaryPlanarClusterWriter", level), m_cfg(cfg)
+{
+  // inputClusters is already checked by base constructor
+  m_hits = std::make_unique<ColumnarEventFileWriter>(
+      joinPaths(m_cfg.outputDir, "hits.evc"), hitColumns(m_cfg.compress));
+  m_cells = std::make_unique<ColumnarEventFileWriter>(
+      joinPaths(m_cfg.outputDir, "cells.evc"), cellColumns(m_cfg.compress));
+  m_truth = std::make_unique<ColumnarEventFileWriter>(
+      joinPaths(m_cfg.outputDir, "truth.evc"), truthColumns(m_cfg.compress));
+}
+
+FW::BinaryPlanarClusterWriter::~BinaryPlanarClusterWriter() = default;
+
+FW::ProcessCode
+FW::BinaryPlanarClusterWriter::endRun()
+{
+  m_hits->close();
+  m_cells->close();
+  m_truth->close();
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::BinaryPlanarClusterWriter::writeT(
+    const AlgorithmContext&                                  context,
+    const FW::GeometryIdMultimap<Acts::PlanarModuleCluster>& clusters)
+{
+  // hits
+  std::vector<uint64_t> hitId;
+  std::vector<float>    x, y, z, t;
+  std::vector<uint32_t> volumeId, layerId, moduleId;
+  // cells
+  std::vector<uint64_t> cellHitId;
+  std::vector<int32_t>  ch0, ch1, timestamp, value;
+  // truth
+  std::vector<uint64_t> truthHitId, particleId;
+  std::vector<float>    tx, ty, tz, tt, tpx, tpy, tpz;
+
+  hitId.reserve(clusters.size());
+  for (auto* column : {&x, &y, &z, &t}) { column->reserve(clusters.size()); }
+  for (auto* column : {&volumeId, &layerId, &moduleId}) {
+    column->reserve(clusters.size());
+  }
+
+  // hit ids are continuous indices in the geometry-ordered collection
+  uint64_t id = 0;
+  for (const auto& entry : clusters) {
+    Acts::GeometryID                 geoId   = entry.first;
+    const Acts::PlanarModuleCluster& cluster = entry.second;
+    // local cluster information
+    const auto&    parameters = cluster.parameters();
+    Acts::Vector2D localPos(parameters[Acts::ParDef::eLOC_0],
+                            parameters[Acts::ParDef::eLOC_1]);
+    Acts::Vector3D globalFakeMom(1, 1, 1);
+    Acts::Vector3D globalPos(0, 0, 0);
+    // transform local into global position information
+    cluster.referenceSurface().localToGlobal(
+        context.geoContext, localPos, globalFakeMom, globalPos);
+
+    // global hit information
+    hitId.push_back(id);
+    x.push_back(globalPos.x() / Acts::UnitConstants::mm);
+    y.push_back(globalPos.y() / Acts::UnitConstants::mm);
+    z.push_back(globalPos.z() / Acts::UnitConstants::mm);
+    t.push_back(parameters[Acts::ParDef::eT] / Acts::UnitConstants::ns);
+    volumeId.push_back(geoId.volume());
+    layerId.push_back(geoId.layer());
+    moduleId.push_back(geoId.sensitive());
+
+    // local cell information
+    for (auto& c : cluster.digitizationCells()) {
+      cellHitId.push_back(id);
+      ch0.push_back(c.channel0);
+      ch1.push_back(c.channel1);
+      // TODO store digitial timestamp once added to the cell definition
+      timestamp.push_back(0);
+      value.push_back(c.data);
+    }
+
+    // hit-particle truth association
+    for (auto& p : cluster.sourceLink().truthParticles()) {
+      truthHitId.push_back(id);
+      particleId.push_back(p->barcode().value());
+      tx.push_back(p->position().x() / Acts::UnitConstants::mm);
+      ty.push_back(p->position().y() / Acts::UnitConstants::mm);
+      tz.push_back(p->position().z() / Acts::UnitConstants::mm);
+      tt.push_back(p->time() / Acts::UnitConstants::ns);
+      tpx.push_back(p->momentum().x() / Acts::UnitConstants::GeV);
+      tpy.push_back(p->momentum().y() / Acts::UnitConstants::GeV);
+      tpz.push_back(p->momentum().z() / Acts::UnitConstants::GeV);
+    }
+
+    id += 1;
+  }
+
+  // column order must follow the definitions in `BinaryColumns.hpp`
+  ColumnarEventData hits;
+  hits.add(hitId);
+  hits.add(x);
+  hits.add(y);
+  hits.add(z);
+  hits.add(t);
+  hits.add(volumeId);
+  hits.add(layerId);
+  hits.add(moduleId);
+  m_hits->append(context.eventNumber, std::move(hits));
+
+  ColumnarEventData cells;
+  cells.add(cellHitId);
+  cells.add(ch0);
+  cells.add(ch1);
+  cells.add(timestamp);
+  cells.add(value);
+  m_cells->append(context.eventNumber, std::move(cells));
+
+  ColumnarEventData truth;
+  truth.add(truthHitId);
+  truth.add(particleId);
+  truth.add(tx);
+  truth.add(ty);
+  truth.add(tz);
+  truth.add(tt);
+  truth.add(tpx);
+  truth.add(tpy);
+  truth.add(tpz);
+  m_truth->append(context.eventNumber, std::move(truth));
+
+  return FW::ProcessCode::SUCCESS;
+}
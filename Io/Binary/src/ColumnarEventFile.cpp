@@ -0,0 +1,361 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Binary/ColumnarEventFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ios>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <zlib.h>
+
+namespace {
+// on-disk layout constants
+constexpr char     kMagic[8]   = {'A', 'C', 'T', 'F', 'W', 'E', 'V', 'C'};
+constexpr uint32_t kVersion    = 1u;
+constexpr size_t   kHeaderSize = 32u;
+constexpr size_t   kAlignment  = 8u;
+
+// header field offsets
+constexpr size_t kOffsetVersion     = 8u;
+constexpr size_t kOffsetNumColumns  = 12u;
+constexpr size_t kOffsetNumEvents   = 16u;
+constexpr size_t kOffsetIndexOffset = 24u;
+
+inline uint64_t
+alignUp(uint64_t offset)
+{
+  return (offset + kAlignment - 1) & ~uint64_t(kAlignment - 1);
+}
+
+template <typename T>
+inline void
+writeValue(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void
+writePadding(std::ostream& os, uint64_t& offset)
+{
+  static const char zeros[kAlignment] = {};
+  uint64_t          aligned           = alignUp(offset);
+  os.write(zeros, aligned - offset);
+  offset = aligned;
+}
+
+template <typename T>
+inline T
+readValue(const uint8_t* ptr)
+{
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+}  // namespace
+
+size_t
+FW::columnElementSize(ColumnType type)
+{
+  switch (type) {
+  case ColumnType::Int32:
+  case ColumnType::UInt32:
+  case ColumnType::Float32:
+    return 4u;
+  case ColumnType::UInt64:
+    return 8u;
+  }
+  throw std::invalid_argument("Unknown column type");
+}
+
+FW::ColumnarEventFileWriter::ColumnarEventFileWriter(
+    const std::string&      path,
+    std::vector<ColumnSpec> columns,
+    int                     compressionLevel)
+  : m_path(path)
+  , m_columns(std::move(columns))
+  , m_compressionLevel(compressionLevel)
+{
+  if (m_columns.empty()) {
+    throw std::invalid_argument("Missing column definitions");
+  }
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (m_columns[i].name == m_columns[j].name) {
+        throw std::invalid_argument("Duplicate column '" + m_columns[i].name
+                                    + "'");
+      }
+    }
+  }
+
+  m_file.open(m_path, std::ios_base::binary | std::ios_base::trunc);
+  if (not m_file.good()) {
+    throw std::ios_base::failure("Could not open '" + m_path + "'");
+  }
+
+  // header; number of events and index offset are updated on close
+  m_file.write(kMagic, sizeof(kMagic));
+  writeValue(m_file, kVersion);
+  writeValue(m_file, static_cast<uint32_t>(m_columns.size()));
+  writeValue(m_file, uint64_t(0));
+  writeValue(m_file, uint64_t(0));
+  m_offset = kHeaderSize;
+  // column definitions
+  for (const auto& column : m_columns) {
+    writeValue(m_file, static_cast<uint8_t>(column.type));
+    writeValue(m_file, static_cast<uint8_t>(column.compress ? 1u : 0u));
+    writeValue(m_file, static_cast<uint16_t>(column.name.size()));
+    m_file.write(column.name.data(), column.name.size());
+    m_offset += 4u + column.name.size();
+    writePadding(m_file, m_offset);
+  }
+}
+
+FW::ColumnarEventFileWriter::~ColumnarEventFileWriter()
+{
+  if (m_file.is_open()) { close(); }
+}
+
+void
+FW::ColumnarEventFileWriter::append(size_t event, ColumnarEventData&& data)
+{
+  if (data.m_types.size() != m_columns.size()) {
+    throw std::invalid_argument("Inconsistent number of columns");
+  }
+  // prepare the stored chunks w/o holding the lock
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    if (data.m_types[i] != m_columns[i].type) {
+      throw std::invalid_argument("Type mismatch for column '"
+                                  + m_columns[i].name + "'");
+    }
+    if (not m_columns[i].compress) { continue; }
+    auto&                raw = data.m_chunks[i];
+    uLongf               len = compressBound(raw.size());
+    std::vector<uint8_t> compressed(len);
+    int ret = compress2(
+        compressed.data(), &len, raw.data(), raw.size(), m_compressionLevel);
+    if (ret != Z_OK) {
+      throw std::runtime_error("Could not compress column '"
+                               + m_columns[i].name + "'");
+    }
+    compressed.resize(len);
+    raw = std::move(compressed);
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (not m_file.is_open()) {
+    throw std::runtime_error("'" + m_path + "' is already closed");
+  }
+  if (not m_events.insert(event).second) {
+    throw std::invalid_argument("Event " + std::to_string(event)
+                                + " was already written");
+  }
+  EventEntry entry;
+  entry.event   = event;
+  entry.numRows = data.numRows();
+  entry.chunks.reserve(m_columns.size());
+  for (const auto& chunk : data.m_chunks) {
+    entry.chunks.push_back({m_offset, chunk.size()});
+    m_file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    m_offset += chunk.size();
+    writePadding(m_file, m_offset);
+  }
+  if (not m_file.good()) {
+    throw std::ios_base::failure("Could not write to '" + m_path + "'");
+  }
+  m_index.push_back(std::move(entry));
+}
+
+void
+FW::ColumnarEventFileWriter::close()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (not m_file.is_open()) { return; }
+
+  // events are appended in processing order but stored in event order
+  std::sort(m_index.begin(),
+            m_index.end(),
+            [](const EventEntry& lhs, const EventEntry& rhs) {
+              return lhs.event < rhs.event;
+            });
+  uint64_t indexOffset = m_offset;
+  for (const auto& entry : m_index) {
+    writeValue(m_file, entry.event);
+    writeValue(m_file, entry.numRows);
+    for (const auto& chunk : entry.chunks) {
+      writeValue(m_file, chunk.offset);
+      writeValue(m_file, chunk.storedSize);
+    }
+  }
+  // finalize the header; a zero index offset marks an unfinished file
+  m_file.seekp(kOffsetNumEvents);
+  writeValue(m_file, static_cast<uint64_t>(m_index.size()));
+  writeValue(m_file, indexOffset);
+  m_file.close();
+}
+
+struct FW::ColumnarEventFileReader::Mapping
+{
+  boost::interprocess::file_mapping  file;
+  boost::interprocess::mapped_region region;
+
+  Mapping(const std::string& path)
+    : file(path.c_str(), boost::interprocess::read_only)
+    , region(file, boost::interprocess::read_only)
+  {
+  }
+};
+
+FW::ColumnarEventFileReader::ColumnarEventFileReader(const std::string& path)
+  : m_path(path)
+{
+  try {
+    m_mapping = std::make_unique<Mapping>(m_path);
+  } catch (const boost::interprocess::interprocess_exception& e) {
+    throw std::runtime_error("Could not map '" + m_path + "': " + e.what());
+  }
+  m_base = static_cast<const uint8_t*>(m_mapping->region.get_address());
+  m_size = m_mapping->region.get_size();
+
+  auto corrupt = [&](const std::string& what) {
+    return std::runtime_error("'" + m_path + "' is corrupt: " + what);
+  };
+
+  // header
+  if ((m_size < kHeaderSize)
+      or (std::memcmp(m_base, kMagic, sizeof(kMagic)) != 0)) {
+    throw corrupt("invalid header");
+  }
+  if (readValue<uint32_t>(m_base + kOffsetVersion) != kVersion) {
+    throw corrupt("unsupported version");
+  }
+  auto numColumns  = readValue<uint32_t>(m_base + kOffsetNumColumns);
+  auto numEvents   = readValue<uint64_t>(m_base + kOffsetNumEvents);
+  auto indexOffset = readValue<uint64_t>(m_base + kOffsetIndexOffset);
+  if (indexOffset == 0u) { throw corrupt("file was not closed properly"); }
+
+  // column definitions
+  uint64_t offset = kHeaderSize;
+  for (uint32_t i = 0; i < numColumns; ++i) {
+    if (m_size < (offset + 4u)) { throw corrupt("truncated columns"); }
+    ColumnSpec column;
+    column.type     = static_cast<ColumnType>(m_base[offset]);
+    column.compress = (m_base[offset + 1] != 0u);
+    auto nameSize   = readValue<uint16_t>(m_base + offset + 2);
+    if (m_size < (offset + 4u + nameSize)) {
+      throw corrupt("truncated columns");
+    }
+    column.name.assign(reinterpret_cast<const char*>(m_base + offset + 4u),
+                       nameSize);
+    // validates the type
+    columnElementSize(column.type);
+    m_columns.push_back(std::move(column));
+    offset = alignUp(offset + 4u + nameSize);
+  }
+
+  // event index; all checks are written to avoid overflows for corrupt
+  // offsets and sizes
+  const size_t entrySize = 2u + 2u * numColumns;
+  if ((m_size < indexOffset)
+      or (((m_size - indexOffset) / (entrySize * sizeof(uint64_t)))
+          < numEvents)) {
+    throw corrupt("truncated index");
+  }
+  const auto* index = reinterpret_cast<const uint64_t*>(m_base + indexOffset);
+  m_index.reserve(numEvents);
+  for (uint64_t i = 0; i < numEvents; ++i) {
+    const uint64_t* entry = index + i * entrySize;
+    m_index.push_back({entry[0], entry[1], entry + 2});
+    for (uint32_t j = 0; j < numColumns; ++j) {
+      uint64_t chunkOffset = entry[2 + 2 * j];
+      uint64_t chunkSize   = entry[3 + 2 * j];
+      if ((m_size < chunkOffset) or ((m_size - chunkOffset) < chunkSize)) {
+        throw corrupt("chunk outside of the file");
+      }
+    }
+  }
+}
+
+FW::ColumnarEventFileReader::~ColumnarEventFileReader() = default;
+
+std::pair<size_t, size_t>
+FW::ColumnarEventFileReader::availableEvents() const
+{
+  if (m_index.empty()) { return {0u, 0u}; }
+  return {m_index.front().event, m_index.back().event + 1};
+}
+
+bool
+FW::ColumnarEventFileReader::hasEvent(size_t event) const
+{
+  auto it = std::lower_bound(
+      m_index.begin(),
+      m_index.end(),
+      event,
+      [](const EventEntry& entry, size_t e) { return entry.event < e; });
+  return (it != m_index.end()) and (it->event == event);
+}
+
+std::vector<size_t>
+FW::ColumnarEventFileReader::events() const
+{
+  std::vector<size_t> numbers;
+  numbers.reserve(m_index.size());
+  for (const auto& entry : m_index) { numbers.push_back(entry.event); }
+  return numbers;
+}
+
+FW::ColumnarEventFileReader::Event
+FW::ColumnarEventFileReader::read(size_t event) const
+{
+  auto it = std::lower_bound(
+      m_index.begin(),
+      m_index.end(),
+      event,
+      [](const EventEntry& entry, size_t e) { return entry.event < e; });
+  if ((it == m_index.end()) or (it->event != event)) {
+    throw std::out_of_range("Event " + std::to_string(event)
+                            + " is not stored in '" + m_path + "'");
+  }
+
+  Event data;
+  data.m_columns = &m_columns;
+  data.m_numRows = it->numRows;
+  data.m_data.reserve(m_columns.size());
+  for (size_t i = 0; i < m_columns.size(); ++i) {
+    const uint8_t* stored     = m_base + it->chunks[2 * i];
+    uint64_t       storedSize = it->chunks[2 * i + 1];
+    uLongf         rawSize = it->numRows * columnElementSize(m_columns[i].type);
+
+    if (not m_columns[i].compress) {
+      if (storedSize != rawSize) {
+        throw std::runtime_error("Inconsistent size for column '"
+                                 + m_columns[i].name + "' in '" + m_path
+                                 + "'");
+      }
+      data.m_data.push_back(stored);
+      continue;
+    }
+    // 64bit words ensure proper alignment for all column types
+    std::vector<uint64_t> buffer((rawSize + 7u) / 8u);
+    auto* raw = reinterpret_cast<Bytef*>(buffer.data());
+    uLongf len = rawSize;
+    if ((uncompress(raw, &len, stored, storedSize) != Z_OK)
+        or (len != rawSize)) {
+      throw std::runtime_error("Could not decompress column '"
+                               + m_columns[i].name + "' in '" + m_path + "'");
+    }
+    data.m_data.push_back(reinterpret_cast<const uint8_t*>(buffer.data()));
+    data.m_buffers.push_back(std::move(buffer));
+  }
+  return data;
+}
@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <utility>
+
 #include "ACTFW/Io/Csv/CsvParticleReader.hpp"
 #include "ACTFW/Io/Csv/CsvPlanarClusterReader.hpp"
 #include "ACTFW/Utilities/OptionsFwd.hpp"
@@ -18,6 +21,16 @@ namespace Options {
   // There are no additional CSV reader options apart from the
   // format-independent, generic input option.
 
+  /// Read the events range of the selected input shard.
+  ///
+  /// The shard is computed once from a single reference, the `hits` files or
+  /// the `particles` files if there are no hits, and is thus identical for all
+  /// CSV readers regardless of the sizes of their own files.
+  ///
+  /// @return the full range if the input is not split into shards
+  std::pair<size_t, size_t>
+  readCsvInputShard(const Variables& vm);
+
   /// Read the CSV particle reader config.
   FW::CsvParticleReader::Config
   readCsvParticleReaderConfig(const Variables& vm);
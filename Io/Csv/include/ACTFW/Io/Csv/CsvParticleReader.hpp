@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -27,6 +28,7 @@ namespace FW {
 ///
 /// and each line in the file corresponds to one particle. The
 /// input filename can be configured and defaults to `particles.csv`.
+/// Compressed `.csv.gz` or `.csv.zst` files are detected automatically.
 class CsvParticleReader : public IReader
 {
 public:
@@ -38,6 +40,11 @@ public:
     std::string inputDir;
     /// Input filename stem.
     std::string inputStem = "particles";
+    /// Only read events within this range, e.g. one input shard.
+    ///
+    /// All readers of one job must use the same range to avoid losing events
+    /// at the range boundaries, see `Options::readCsvInputShard`.
+    std::pair<size_t, size_t> eventsRange = {0u, SIZE_MAX};
   };
 
   CsvParticleReader(const Config&        cfg,
@@ -56,6 +63,7 @@ public:
 
 private:
   Config                              m_cfg;
+  std::string                         m_extension;
   std::pair<size_t, size_t>           m_eventsRange;
   std::unique_ptr<const Acts::Logger> m_logger;
 
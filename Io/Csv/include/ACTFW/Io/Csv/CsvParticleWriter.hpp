@@ -8,12 +8,14 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "ACTFW/EventData/SimParticle.hpp"
 #include "ACTFW/EventData/SimVertex.hpp"
 #include "ACTFW/Framework/WriterT.hpp"
+#include "ACTFW/Utilities/EventManifest.hpp"
 
 namespace FW {
 
@@ -30,7 +32,10 @@ namespace FW {
 ///     event000000002-<stem>.csv
 ///     ...
 ///
-/// and each line in the file corresponds to one particle.
+/// and each line in the file corresponds to one particle. Files are
+/// compressed if the output extension is `.csv.gz` or `.csv.zst`. If
+/// enabled, an `EventManifest` for the written files is updated at the end
+/// of the run.
 class CsvParticleWriter : public WriterT<std::vector<Data::SimVertex>>
 {
 public:
@@ -44,8 +49,15 @@ public:
     std::string outputDir;
     /// Output filename stem.
     std::string outputStem = "particles";
+    /// Output filename extension; `.csv.gz` or `.csv.zst` for compression.
+    std::string outputExtension = ".csv";
     /// Number of decimal digits for floating point precision in output.
     size_t outputPrecision = 6;
+    /// Number of threads used to compress a single file.
+    size_t compressionThreads = 1;
+    /// Write a manifest of all written files at the end of the run. This
+    /// reads every written file again to compute its checksum.
+    bool writeManifest = false;
   };
 
   /// constructor
@@ -54,6 +66,10 @@ public:
   CsvParticleWriter(const Config&        cfg,
                     Acts::Logging::Level level = Acts::Logging::INFO);
 
+  /// Write the event manifest.
+  ProcessCode
+  endRun() final override;
+
 protected:
   /// @brief Write method called by the base class
   /// @param [in] context is the algorithm context for consistency
@@ -64,7 +80,9 @@ protected:
          const std::vector<Data::SimVertex>& vertices) final override;
 
 private:
-  Config m_cfg;  //!< Nested configuration struct
+  Config        m_cfg;  //!< Nested configuration struct
+  std::mutex    m_manifestMutex;
+  EventManifest m_manifest;
 };
 
 }  // namespace FW
@@ -7,6 +7,7 @@
 // file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -36,7 +37,8 @@ namespace FW {
 ///     event000000002-hits.csv
 ///     event000000002-truth.csv
 ///
-/// and each line in the file corresponds to one hit/cluster.
+/// and each line in the file corresponds to one hit/cluster. Compressed
+/// `.csv.gz` or `.csv.zst` files are detected automatically.
 class CsvPlanarClusterReader : public IReader
 {
 public:
@@ -54,6 +56,11 @@ public:
     std::string outputHitParticlesMap;
     /// Output simulated (truth) hits collection.
     std::string outputSimulatedHits;
+    /// Only read events within this range, e.g. one input shard.
+    ///
+    /// All readers of one job must use the same range to avoid losing events
+    /// at the range boundaries, see `Options::readCsvInputShard`.
+    std::pair<size_t, size_t> eventsRange = {0u, SIZE_MAX};
   };
 
   CsvPlanarClusterReader(const Config&        cfg,
@@ -73,6 +80,7 @@ public:
 private:
   Config                                           m_cfg;
   std::map<Acts::GeometryID, const Acts::Surface*> m_surfaces;
+  std::string                                      m_extension;
   std::pair<size_t, size_t>                        m_eventsRange;
   std::unique_ptr<const Acts::Logger>              m_logger;
 
@@ -8,12 +8,14 @@
 
 #pragma once
 
+#include <mutex>
 #include <string>
 
 #include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
 
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/Framework/WriterT.hpp"
+#include "ACTFW/Utilities/EventManifest.hpp"
 
 namespace FW {
 
@@ -32,7 +34,10 @@ namespace FW {
 ///     event000000002-truth.csv
 ///     ...
 ///
-/// and each line in the file corresponds to one hit/cluster.
+/// and each line in the file corresponds to one hit/cluster. Files are
+/// compressed if the output extension is `.csv.gz` or `.csv.zst`. If
+/// enabled, an `EventManifest` for each file type is updated at the end of
+/// the run.
 class CsvPlanarClusterWriter
   : public WriterT<GeometryIdMultimap<Acts::PlanarModuleCluster>>
 {
@@ -43,8 +48,15 @@ public:
     std::string inputClusters;
     /// Where to place output files
     std::string outputDir;
+    /// Output filename extension; `.csv.gz` or `.csv.zst` for compression.
+    std::string outputExtension = ".csv";
     /// Number of decimal digits for floating point precision in output.
     size_t outputPrecision = 6;
+    /// Number of threads used to compress a single file.
+    size_t compressionThreads = 1;
+    /// Write a manifest of all written files at the end of the run. This
+    /// reads every written file again to compute its checksum.
+    bool writeManifest = false;
   };
 
   /// Constructor with
@@ -53,6 +65,10 @@ public:
   CsvPlanarClusterWriter(const Config&        cfg,
                          Acts::Logging::Level level = Acts::Logging::INFO);
 
+  /// Write the event manifests.
+  ProcessCode
+  endRun() final override;
+
 protected:
   /// This implementation holds the actual writing method
   /// and is called by the WriterT<>::write interface
@@ -62,7 +78,11 @@ protected:
       final override;
 
 private:
-  Config m_cfg;
+  Config        m_cfg;
+  std::mutex    m_manifestMutex;
+  EventManifest m_manifestHits;
+  EventManifest m_manifestCells;
+  EventManifest m_manifestTruth;
 };
 
 }  // namespace FW
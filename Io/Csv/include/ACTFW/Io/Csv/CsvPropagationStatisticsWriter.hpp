@@ -0,0 +1,69 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "ACTFW/Framework/WriterT.hpp"
+#include "ACTFW/Propagation/PropagationStatistics.hpp"
+
+namespace FW {
+
+/// Write the per-event propagation statistics as comma-separated-values.
+///
+/// In contrast to the other writers, all events are written into a single
+/// file in the configured output directory, one line per event ordered by
+/// the event number. Each line contains the step, navigation, and field
+/// cache counters together with the propagation time of the event, so they
+/// can be correlated with the timing output of the sequencer.
+///
+/// The file is written at the end of the run.
+class CsvPropagationStatisticsWriter : public WriterT<PropagationStatistics>
+{
+public:
+  struct Config
+  {
+    /// Input per-event statistics collection to write.
+    std::string inputStatistics;
+    /// Where to place the output file.
+    std::string outputDir;
+    /// Output filename.
+    std::string outputFilename = "propagation_statistics.csv";
+    /// Number of decimal digits for floating point precision in output.
+    size_t outputPrecision = 6;
+  };
+
+  /// constructor
+  /// @param cfg is the configuration object
+  /// @parm level is the output logging level
+  CsvPropagationStatisticsWriter(
+      const Config&        cfg,
+      Acts::Logging::Level level = Acts::Logging::INFO);
+
+  /// Write the collected statistics of all events.
+  ProcessCode
+  endRun() final override;
+
+protected:
+  /// @brief Write method called by the base class
+  /// @param [in] context is the algorithm context for consistency
+  /// @param [in] statistics are the propagation statistics of the event
+  ProcessCode
+  writeT(const FW::AlgorithmContext&  context,
+         const PropagationStatistics& statistics) final override;
+
+private:
+  Config                                  m_cfg;  //!< Nested configuration
+  std::mutex                              m_statisticsMutex;
+  std::map<size_t, PropagationStatistics> m_statistics;
+};
+
+}  // namespace FW
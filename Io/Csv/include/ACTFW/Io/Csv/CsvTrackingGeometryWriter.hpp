@@ -39,8 +39,12 @@ public:
     std::shared_ptr<const Acts::TrackingGeometry> trackingGeometry;
     /// Where to place output files.
     std::string outputDir;
+    /// Output filename extension; `.csv.gz` or `.csv.zst` for compression.
+    std::string outputExtension = ".csv";
     /// Number of decimal digits for floating point precision in output.
     std::size_t outputPrecision = 6;
+    /// Number of threads used to compress a single file.
+    std::size_t compressionThreads = 1;
     /// Whether to write the per-event file.
     bool writePerEvent = false;
   };
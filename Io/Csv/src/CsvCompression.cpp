@@ -0,0 +1,249 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "CsvCompression.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <ios>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+#include <zlib.h>
+#ifdef ACTFW_CSV_ZSTD
+#include <zstd.h>
+#endif
+
+#include "ACTFW/Utilities/Paths.hpp"
+
+namespace {
+
+bool
+endsWith(const std::string& str, const std::string& suffix)
+{
+  return (suffix.size() <= str.size())
+      and std::equal(suffix.rbegin(), suffix.rend(), str.rbegin());
+}
+
+// Minimal size of a block to be compressed in a separate thread.
+constexpr size_t kMinBlockSize = 1u << 20;
+
+std::string
+readGzip(const std::string& path)
+{
+  gzFile file = gzopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    throw std::ios_base::failure("Could not open '" + path + "'");
+  }
+  gzbuffer(file, 1u << 17);
+  std::string content;
+  char        buffer[1u << 16];
+  int         len = 0;
+  // concatenated members are read transparently
+  while (0 < (len = gzread(file, buffer, sizeof(buffer)))) {
+    content.append(buffer, len);
+  }
+  int err = Z_OK;
+  if (len < 0) { gzerror(file, &err); }
+  gzclose(file);
+  if (err != Z_OK) {
+    throw std::ios_base::failure("Could not decompress '" + path + "'");
+  }
+  return content;
+}
+
+// Compress a single block into a complete gzip member.
+std::string
+compressGzipMember(const char* data, size_t size)
+{
+  z_stream stream = {};
+  // 16 + MAX_WBITS selects the gzip wrapper
+  if (deflateInit2(&stream,
+                   Z_DEFAULT_COMPRESSION,
+                   Z_DEFLATED,
+                   16 + MAX_WBITS,
+                   8,
+                   Z_DEFAULT_STRATEGY)
+      != Z_OK) {
+    throw std::ios_base::failure("Could not initialize gzip compression");
+  }
+  std::string compressed(deflateBound(&stream, size), '\0');
+  stream.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+  stream.avail_in  = size;
+  stream.next_out  = reinterpret_cast<Bytef*>(&compressed[0]);
+  stream.avail_out = compressed.size();
+  int ret          = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  if (ret != Z_STREAM_END) {
+    throw std::ios_base::failure("Could not compress gzip member");
+  }
+  compressed.resize(stream.total_out);
+  return compressed;
+}
+
+std::string
+compressGzip(const std::string& content, size_t numThreads)
+{
+  size_t numBlocks = std::min(numThreads, content.size() / kMinBlockSize);
+  numBlocks        = std::max<size_t>(1u, numBlocks);
+  if (numBlocks == 1u) {
+    return compressGzipMember(content.data(), content.size());
+  }
+  // independent members are compressed as tasks of the current scheduler,
+  // so writers within the event loop do not start additional threads
+  size_t blockSize = (content.size() + numBlocks - 1) / numBlocks;
+  std::vector<std::string> blocks((content.size() + blockSize - 1) / blockSize);
+  tbb::parallel_for(size_t(0), blocks.size(), [&](size_t i) {
+    size_t offset = i * blockSize;
+    size_t size   = std::min(blockSize, content.size() - offset);
+    blocks[i]     = compressGzipMember(content.data() + offset, size);
+  });
+  std::string compressed;
+  for (const auto& block : blocks) { compressed += block; }
+  return compressed;
+}
+
+#ifdef ACTFW_CSV_ZSTD
+std::string
+readZstd(const std::string& path)
+{
+  std::ifstream file(path, std::ios_base::binary);
+  if (not file.good()) {
+    throw std::ios_base::failure("Could not open '" + path + "'");
+  }
+  std::string compressed((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+
+  ZSTD_DCtx*  ctx = ZSTD_createDCtx();
+  std::string content;
+  std::string buffer(ZSTD_DStreamOutSize(), '\0');
+  ZSTD_inBuffer input = {compressed.data(), compressed.size(), 0};
+  // multiple frames are decompressed transparently
+  while (input.pos < input.size) {
+    ZSTD_outBuffer output = {&buffer[0], buffer.size(), 0};
+    size_t         ret    = ZSTD_decompressStream(ctx, &output, &input);
+    if (ZSTD_isError(ret)) {
+      ZSTD_freeDCtx(ctx);
+      throw std::ios_base::failure("Could not decompress '" + path
+                                   + "': " + ZSTD_getErrorName(ret));
+    }
+    content.append(buffer.data(), output.pos);
+  }
+  ZSTD_freeDCtx(ctx);
+  return content;
+}
+
+std::string
+compressZstd(const std::string& content, size_t numThreads)
+{
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+  if (1u < numThreads) {
+    // fails w/o error if the library was built w/o multi-threading support
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_nbWorkers, numThreads);
+  }
+  std::string compressed(ZSTD_compressBound(content.size()), '\0');
+  size_t      ret = ZSTD_compress2(ctx,
+                              &compressed[0],
+                              compressed.size(),
+                              content.data(),
+                              content.size());
+  ZSTD_freeCCtx(ctx);
+  if (ZSTD_isError(ret)) {
+    throw std::ios_base::failure(std::string("Could not compress zstd data: ")
+                                 + ZSTD_getErrorName(ret));
+  }
+  compressed.resize(ret);
+  return compressed;
+}
+#endif
+
+[[noreturn]] void
+throwZstdUnavailable(const std::string& path)
+{
+  throw std::ios_base::failure("Can not handle '" + path
+                               + "'. Zstd support was not enabled");
+}
+
+}  // namespace
+
+FW::CsvCompression
+FW::csvCompression(const std::string& path)
+{
+  if (endsWith(path, ".gz")) { return CsvCompression::Gzip; }
+  if (endsWith(path, ".zst")) { return CsvCompression::Zstd; }
+  return CsvCompression::None;
+}
+
+std::string
+FW::readCompressedFile(const std::string& path, CsvCompression compression)
+{
+  switch (compression) {
+  case CsvCompression::Gzip:
+    return readGzip(path);
+  case CsvCompression::Zstd:
+#ifdef ACTFW_CSV_ZSTD
+    return readZstd(path);
+#else
+    throwZstdUnavailable(path);
+#endif
+  case CsvCompression::None:
+    break;
+  }
+  std::ifstream file(path, std::ios_base::binary);
+  if (not file.good()) {
+    throw std::ios_base::failure("Could not open '" + path + "'");
+  }
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+void
+FW::writeCompressedFile(const std::string& path,
+                        const std::string& content,
+                        CsvCompression     compression,
+                        size_t             numThreads)
+{
+  std::string compressed;
+  switch (compression) {
+  case CsvCompression::Gzip:
+    compressed = compressGzip(content, numThreads);
+    break;
+  case CsvCompression::Zstd:
+#ifdef ACTFW_CSV_ZSTD
+    compressed = compressZstd(content, numThreads);
+    break;
+#else
+    throwZstdUnavailable(path);
+#endif
+  case CsvCompression::None:
+    break;
+  }
+  const std::string& output
+      = (compression == CsvCompression::None) ? content : compressed;
+  std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+  file.write(output.data(), output.size());
+  if (not file.good()) {
+    throw std::ios_base::failure("Could not write '" + path + "'");
+  }
+}
+
+std::pair<std::string, std::pair<size_t, size_t>>
+FW::detectCsvEventFiles(const std::string& dir, const std::string& stem)
+{
+  const std::vector<std::string> extensions = {".csv", ".csv.gz", ".csv.zst"};
+  std::vector<std::string>       names;
+  for (const auto& extension : extensions) {
+    names.push_back(stem + extension);
+  }
+  // scans the directory only once for all extensions
+  auto found = determineEventFilesRange(dir, names);
+  if (found.first < extensions.size()) {
+    return {extensions[found.first], found.second};
+  }
+  return {".csv", {0u, 0u}};
+}
@@ -0,0 +1,61 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Whole-file compression helpers for csv files
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace FW {
+
+/// Compression scheme for csv files, selected by the file extension.
+enum class CsvCompression {
+  None,
+  Gzip,
+  Zstd,
+};
+
+/// Determine the compression from the file extension, e.g. `.csv.gz`.
+CsvCompression
+csvCompression(const std::string& path);
+
+/// Read and decompress the full file content into memory.
+///
+/// @throws std::ios_base::failure if the file can not be read or decompressed
+std::string
+readCompressedFile(const std::string& path, CsvCompression compression);
+
+/// Compress the content and write it to the file.
+///
+/// @param numThreads Number of gzip blocks compressed as parallel TBB tasks,
+///                   or number of zstd worker threads, for large content
+/// @throws std::ios_base::failure if the file can not be compressed or written
+///
+/// Gzip content is split into independently compressed members that are
+/// concatenated to a single valid file. Zstd content uses the multi-threaded
+/// compression of the zstd library if it is available.
+void
+writeCompressedFile(const std::string& path,
+                    const std::string& content,
+                    CsvCompression     compression,
+                    size_t             numThreads = 1);
+
+/// Detect the extension of per-event csv files, either plain or compressed.
+///
+/// @param dir input directory, current directory if empty
+/// @param stem filename stem, e.g. `hits`
+/// @return first matching extension and the available events range
+/// @returns `.csv` and {0, 0} when no matching files could be found
+std::pair<std::string, std::pair<size_t, size_t>>
+detectCsvEventFiles(const std::string& dir, const std::string& stem);
+
+}  // namespace FW
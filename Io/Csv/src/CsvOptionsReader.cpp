@@ -8,8 +8,35 @@
 
 #include "ACTFW/Io/Csv/CsvOptionsReader.hpp"
 
+#include <cstdint>
+#include <string>
+
 #include <boost/program_options.hpp>
 
+#include "ACTFW/Utilities/Paths.hpp"
+#include "CsvCompression.hpp"
+
+std::pair<size_t, size_t>
+FW::Options::readCsvInputShard(const Variables& vm)
+{
+  if (vm["input-num-shards"].empty()
+      or (vm["input-num-shards"].as<size_t>() <= 1u)) {
+    return {0u, SIZE_MAX};
+  }
+  std::string dir;
+  if (not vm["input-dir"].empty()) { dir = vm["input-dir"].as<std::string>(); }
+  auto shard     = vm["input-shard"].as<size_t>();
+  auto numShards = vm["input-num-shards"].as<size_t>();
+  for (const char* stem : {"hits", "particles"}) {
+    auto detected = detectCsvEventFiles(dir, stem);
+    if (detected.second.first < detected.second.second) {
+      return determineEventFilesShard(
+          dir, stem + detected.first, shard, numShards);
+    }
+  }
+  return {0u, 0u};
+}
+
 FW::CsvParticleReader::Config
 FW::Options::readCsvParticleReaderConfig(const Variables& vm)
 {
@@ -17,6 +44,7 @@ FW::Options::readCsvParticleReaderConfig(const Variables& vm)
   if (not vm["input-dir"].empty()) {
     cfg.inputDir = vm["input-dir"].as<std::string>();
   }
+  cfg.eventsRange = readCsvInputShard(vm);
   return cfg;
 }
 
@@ -27,5 +55,6 @@ FW::Options::readCsvPlanarClusterReaderConfig(const Variables& vm)
   if (not vm["input-dir"].empty()) {
     cfg.inputDir = vm["input-dir"].as<std::string>();
   }
+  cfg.eventsRange = readCsvInputShard(vm);
   return cfg;
 }
@@ -8,6 +8,9 @@
 
 #include "ACTFW/Io/Csv/CsvOptionsWriter.hpp"
 
+#include <stdexcept>
+#include <string>
+
 #include <boost/program_options.hpp>
 
 #include <dfe/dfe_io_dsv.hpp>
@@ -20,9 +23,31 @@ FW::Options::addCsvWriterOptions(FW::Options::Description& desc)
   desc.add_options()("csv-output-precision",
                      value<size_t>()->default_value(6),
                      "Floating number output precision.")(
+      "csv-output-compression",
+      value<std::string>()->default_value("none"),
+      "Compression for output files, one of none, gz, zst.")(
+      "csv-compression-threads",
+      value<size_t>()->default_value(1),
+      "Number of threads used to compress a single file.")(
+      "csv-write-manifest",
+      bool_switch(),
+      "Write manifests of the per-event particle and cluster files.")(
       "csv-tg-perevent", bool_switch(), "Write tracking geometry per event.");
 }
 
+namespace {
+std::string
+readOutputExtension(const FW::Options::Variables& vm)
+{
+  auto compression = vm["csv-output-compression"].as<std::string>();
+  if (compression == "none") { return ".csv"; }
+  if (compression == "gz") { return ".csv.gz"; }
+  if (compression == "zst") { return ".csv.zst"; }
+  throw std::invalid_argument("Unknown csv output compression '"
+                              + compression + "'");
+}
+}  // namespace
+
 FW::CsvParticleWriter::Config
 FW::Options::readCsvParticleWriterConfig(const FW::Options::Variables& vm)
 {
@@ -30,7 +55,10 @@ FW::Options::readCsvParticleWriterConfig(const FW::Options::Variables& vm)
   if (not vm["output-dir"].empty()) {
     cfg.outputDir = vm["output-dir"].as<std::string>();
   }
-  cfg.outputPrecision = vm["csv-output-precision"].as<size_t>();
+  cfg.outputExtension    = readOutputExtension(vm);
+  cfg.outputPrecision    = vm["csv-output-precision"].as<size_t>();
+  cfg.compressionThreads = vm["csv-compression-threads"].as<size_t>();
+  cfg.writeManifest      = vm["csv-write-manifest"].as<bool>();
   return cfg;
 }
 
@@ -41,7 +69,10 @@ FW::Options::readCsvPlanarClusterWriterConfig(const FW::Options::Variables& vm)
   if (not vm["output-dir"].empty()) {
     cfg.outputDir = vm["output-dir"].as<std::string>();
   }
-  cfg.outputPrecision = vm["csv-output-precision"].as<size_t>();
+  cfg.outputExtension    = readOutputExtension(vm);
+  cfg.outputPrecision    = vm["csv-output-precision"].as<size_t>();
+  cfg.compressionThreads = vm["csv-compression-threads"].as<size_t>();
+  cfg.writeManifest      = vm["csv-write-manifest"].as<bool>();
   return cfg;
 }
 
@@ -53,7 +84,9 @@ FW::Options::readCsvTrackingGeometryWriterConfig(
   if (not vm["output-dir"].empty()) {
     cfg.outputDir = vm["output-dir"].as<std::string>();
   }
-  cfg.outputPrecision = vm["csv-output-precision"].as<size_t>();
-  cfg.writePerEvent   = vm.count("csv-tg-perevent");
+  cfg.outputExtension    = readOutputExtension(vm);
+  cfg.outputPrecision    = vm["csv-output-precision"].as<size_t>();
+  cfg.compressionThreads = vm["csv-compression-threads"].as<size_t>();
+  cfg.writePerEvent      = vm.count("csv-tg-perevent");
   return cfg;
 }
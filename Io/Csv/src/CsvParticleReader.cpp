@@ -8,27 +8,27 @@
 
 #include "ACTFW/Io/Csv/CsvParticleReader.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <ios>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <Acts/Utilities/Units.hpp>
-#include <dfe/dfe_io_dsv.hpp>
 
 #include "ACTFW/EventData/SimParticle.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "CsvCompression.hpp"
+#include "CsvRows.hpp"
 #include "TrackMlData.hpp"
 
 FW::CsvParticleReader::CsvParticleReader(
     const FW::CsvParticleReader::Config& cfg,
     Acts::Logging::Level                 level)
-  : m_cfg(cfg)
-  , m_eventsRange(
-        determineEventFilesRange(cfg.inputDir, cfg.inputStem + ".csv"))
-  , m_logger(Acts::getDefaultLogger("CsvParticleReader", level))
+  : m_cfg(cfg), m_logger(Acts::getDefaultLogger("CsvParticleReader", level))
 {
   if (m_cfg.outputParticles.empty()) {
     throw std::invalid_argument("Missing output collection");
@@ -36,6 +36,14 @@ FW::CsvParticleReader::CsvParticleReader(
   if (m_cfg.inputStem.empty()) {
     throw std::invalid_argument("Missing input filename stem");
   }
+  // plain or compressed files are detected automatically
+  std::tie(m_extension, m_eventsRange)
+      = detectCsvEventFiles(m_cfg.inputDir, m_cfg.inputStem);
+  m_eventsRange.first
+      = std::max(m_eventsRange.first, m_cfg.eventsRange.first);
+  m_eventsRange.second
+      = std::min(m_eventsRange.second, m_cfg.eventsRange.second);
+  m_eventsRange.second = std::max(m_eventsRange.first, m_eventsRange.second);
 }
 
 std::string
@@ -56,10 +64,10 @@ FW::CsvParticleReader::read(const FW::AlgorithmContext& ctx)
   SimParticles particles;
 
   auto path = perEventFilepath(
-      m_cfg.inputDir, m_cfg.inputStem + ".csv", ctx.eventNumber);
+      m_cfg.inputDir, m_cfg.inputStem + m_extension, ctx.eventNumber);
   // vt is an optional element
-  dfe::NamedTupleCsvReader<ParticleData> reader(path, {"vt"});
-  ParticleData                           data;
+  CsvRowReader<ParticleData> reader(path, {"vt"});
+  ParticleData               data;
 
   while (reader.read(data)) {
     Acts::Vector3D particlePos(data.vx * Acts::UnitConstants::mm,
@@ -12,10 +12,10 @@
 #include <stdexcept>
 
 #include <Acts/Utilities/Units.hpp>
-#include <dfe/dfe_io_dsv.hpp>
 
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "CsvRows.hpp"
 #include "TrackMlData.hpp"
 
 FW::CsvParticleWriter::CsvParticleWriter(
@@ -40,10 +40,12 @@ FW::CsvParticleWriter::writeT(const FW::AlgorithmContext&         context,
         m_cfg.inputHitsPerParticle);
   }
 
-  auto pathParticles = perEventFilepath(
-      m_cfg.outputDir, m_cfg.outputStem + ".csv", context.eventNumber);
-  dfe::NamedTupleCsvWriter<ParticleData> writer(pathParticles,
-                                                m_cfg.outputPrecision);
+  auto pathParticles
+      = perEventFilepath(m_cfg.outputDir,
+                         m_cfg.outputStem + m_cfg.outputExtension,
+                         context.eventNumber);
+  CsvRowWriter<ParticleData> writer(
+      pathParticles, m_cfg.outputPrecision, m_cfg.compressionThreads);
 
   ParticleData data;
   data.nhits = -1;  // default for every entry if information unvailable
@@ -71,6 +73,26 @@ FW::CsvParticleWriter::writeT(const FW::AlgorithmContext&         context,
       writer.append(data);
     }
   }
+  writer.close();
 
+  if (m_cfg.writeManifest) {
+    // reading back the file for the checksum does not need the lock
+    auto entry = EventManifest::describe(context.eventNumber, pathParticles);
+    std::lock_guard<std::mutex> lock(m_manifestMutex);
+    m_manifest.insert(entry);
+  }
+
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::CsvParticleWriter::endRun()
+{
+  if (m_cfg.writeManifest) {
+    m_manifest.sort();
+    updateEventManifest(m_cfg.outputDir,
+                        m_cfg.outputStem + m_cfg.outputExtension,
+                        m_manifest);
+  }
   return ProcessCode::SUCCESS;
 }
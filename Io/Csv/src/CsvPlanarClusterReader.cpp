@@ -8,10 +8,12 @@
 
 #include "ACTFW/Io/Csv/CsvPlanarClusterReader.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 #include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
 #include <Acts/Plugins/Identification/IdentifiedDetectorElement.hpp>
 #include <Acts/Utilities/Units.hpp>
-#include <dfe/dfe_io_dsv.hpp>
 
 #include "ACTFW/EventData/Barcode.hpp"
 #include "ACTFW/EventData/DataContainers.hpp"
@@ -21,14 +23,14 @@
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
 #include "ACTFW/Utilities/Range.hpp"
+#include "CsvCompression.hpp"
+#include "CsvRows.hpp"
 #include "TrackMlData.hpp"
 
 FW::CsvPlanarClusterReader::CsvPlanarClusterReader(
     const FW::CsvPlanarClusterReader::Config& cfg,
     Acts::Logging::Level                      level)
   : m_cfg(cfg)
-  // TODO check that all files (hits,cells,truth) exists
-  , m_eventsRange(determineEventFilesRange(cfg.inputDir, "hits.csv"))
   , m_logger(Acts::getDefaultLogger("CsvPlanarClusterReader", level))
 {
   if (not m_cfg.trackingGeometry) {
@@ -46,6 +48,15 @@ FW::CsvPlanarClusterReader::CsvPlanarClusterReader(
   if (m_cfg.outputSimulatedHits.empty()) {
     throw std::invalid_argument("Missing simulated hits output collection");
   }
+  // TODO check that all files (hits,cells,truth) exists
+  // plain or compressed files are detected automatically
+  std::tie(m_extension, m_eventsRange)
+      = detectCsvEventFiles(m_cfg.inputDir, "hits");
+  m_eventsRange.first
+      = std::max(m_eventsRange.first, m_cfg.eventsRange.first);
+  m_eventsRange.second
+      = std::min(m_eventsRange.second, m_cfg.eventsRange.second);
+  m_eventsRange.second = std::max(m_eventsRange.first, m_eventsRange.second);
   // fill the geo id to surface map once to speed up lookups later on
   m_cfg.trackingGeometry->visitSurfaces([this](const Acts::Surface* surface) {
     this->m_surfaces[surface->geoID()] = surface;
@@ -119,7 +130,7 @@ readEverything(const std::string&              inputDir,
                size_t                          event)
 {
   std::string path = FW::perEventFilepath(inputDir, filename, event);
-  dfe::NamedTupleCsvReader<Data> reader(path, optional_columns);
+  FW::CsvRowReader<Data> reader(path, optional_columns);
 
   std::vector<Data> everything;
   Data              one;
@@ -129,33 +140,39 @@ readEverything(const std::string&              inputDir,
 }
 
 std::vector<FW::TruthHitData>
-readTruthHitsByHitId(const std::string& inputDir, size_t event)
+readTruthHitsByHitId(const std::string& inputDir,
+                     const std::string& extension,
+                     size_t             event)
 {
   // tt is an optional element
-  auto truths
-      = readEverything<FW::TruthHitData>(inputDir, "truth.csv", {"tt"}, event);
+  auto truths = readEverything<FW::TruthHitData>(
+      inputDir, "truth" + extension, {"tt"}, event);
   // sort for fast hit id look up
   std::sort(truths.begin(), truths.end(), CompareHitId{});
   return truths;
 }
 
 std::vector<FW::SimHitData>
-readSimHitsByGeoId(const std::string& inputDir, size_t event)
+readSimHitsByGeoId(const std::string& inputDir,
+                   const std::string& extension,
+                   size_t             event)
 {
   // t is an optional element
-  auto hits
-      = readEverything<FW::SimHitData>(inputDir, "hits.csv", {"t"}, event);
+  auto hits = readEverything<FW::SimHitData>(
+      inputDir, "hits" + extension, {"t"}, event);
   // sort same way they will be sorted in the output container
   std::sort(hits.begin(), hits.end(), CompareGeometryId{});
   return hits;
 }
 
 std::vector<FW::CellData>
-readCellsByHitId(const std::string& inputDir, size_t event)
+readCellsByHitId(const std::string& inputDir,
+                 const std::string& extension,
+                 size_t             event)
 {
   // timestamp is an optional element
   auto cells = readEverything<FW::CellData>(
-      inputDir, "cells.csv", {"timestamp"}, event);
+      inputDir, "cells" + extension, {"timestamp"}, event);
   // sort for fast hit id look up
   std::sort(cells.begin(), cells.end(), CompareHitId{});
   return cells;
@@ -171,9 +188,10 @@ FW::CsvPlanarClusterReader::read(const FW::AlgorithmContext& ctx)
   // to simplify data handling. to be able to perform this mapping we first
   // read all data into memory before converting to the internal event data
   // types.
-  auto truths = readTruthHitsByHitId(m_cfg.inputDir, ctx.eventNumber);
-  auto hits   = readSimHitsByGeoId(m_cfg.inputDir, ctx.eventNumber);
-  auto cells  = readCellsByHitId(m_cfg.inputDir, ctx.eventNumber);
+  auto truths
+      = readTruthHitsByHitId(m_cfg.inputDir, m_extension, ctx.eventNumber);
+  auto hits  = readSimHitsByGeoId(m_cfg.inputDir, m_extension, ctx.eventNumber);
+  auto cells = readCellsByHitId(m_cfg.inputDir, m_extension, ctx.eventNumber);
 
   // prepare containers for the hit data using the framework event data types
   GeometryIdMultimap<Acts::PlanarModuleCluster> clusters;
@@ -12,7 +12,6 @@
 
 #include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
 #include <Acts/Utilities/Units.hpp>
-#include <dfe/dfe_io_dsv.hpp>
 
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/EventData/SimIdentifier.hpp"
@@ -20,6 +19,7 @@
 #include "ACTFW/EventData/SimVertex.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "CsvRows.hpp"
 #include "TrackMlData.hpp"
 
 FW::CsvPlanarClusterWriter::CsvPlanarClusterWriter(
@@ -36,19 +36,19 @@ FW::CsvPlanarClusterWriter::writeT(
     const FW::GeometryIdMultimap<Acts::PlanarModuleCluster>& clusters)
 {
   // open per-event file for all components
-  std::string pathHits
-      = perEventFilepath(m_cfg.outputDir, "hits.csv", context.eventNumber);
-  std::string pathCells
-      = perEventFilepath(m_cfg.outputDir, "cells.csv", context.eventNumber);
-  std::string pathTruth
-      = perEventFilepath(m_cfg.outputDir, "truth.csv", context.eventNumber);
-
-  dfe::NamedTupleCsvWriter<SimHitData>   writerHits(pathHits,
-                                                  m_cfg.outputPrecision);
-  dfe::NamedTupleCsvWriter<CellData>     writerCells(pathCells,
-                                                 m_cfg.outputPrecision);
-  dfe::NamedTupleCsvWriter<TruthHitData> writerTruth(pathTruth,
-                                                     m_cfg.outputPrecision);
+  std::string pathHits = perEventFilepath(
+      m_cfg.outputDir, "hits" + m_cfg.outputExtension, context.eventNumber);
+  std::string pathCells = perEventFilepath(
+      m_cfg.outputDir, "cells" + m_cfg.outputExtension, context.eventNumber);
+  std::string pathTruth = perEventFilepath(
+      m_cfg.outputDir, "truth" + m_cfg.outputExtension, context.eventNumber);
+
+  CsvRowWriter<SimHitData> writerHits(
+      pathHits, m_cfg.outputPrecision, m_cfg.compressionThreads);
+  CsvRowWriter<CellData> writerCells(
+      pathCells, m_cfg.outputPrecision, m_cfg.compressionThreads);
+  CsvRowWriter<TruthHitData> writerTruth(
+      pathTruth, m_cfg.outputPrecision, m_cfg.compressionThreads);
 
   TruthHitData truth;
   SimHitData   hit;
@@ -108,6 +108,35 @@ FW::CsvPlanarClusterWriter::writeT(
     // increase hit id for next iteration
     hit.hit_id += 1;
   }
+  writerHits.close();
+  writerCells.close();
+  writerTruth.close();
+
+  if (m_cfg.writeManifest) {
+    // reading back the files for the checksums does not need the lock
+    auto entryHits  = EventManifest::describe(context.eventNumber, pathHits);
+    auto entryCells = EventManifest::describe(context.eventNumber, pathCells);
+    auto entryTruth = EventManifest::describe(context.eventNumber, pathTruth);
+    std::lock_guard<std::mutex> lock(m_manifestMutex);
+    m_manifestHits.insert(entryHits);
+    m_manifestCells.insert(entryCells);
+    m_manifestTruth.insert(entryTruth);
+  }
 
   return FW::ProcessCode::SUCCESS;
 }
+
+FW::ProcessCode
+FW::CsvPlanarClusterWriter::endRun()
+{
+  if (m_cfg.writeManifest) {
+    const auto& ext = m_cfg.outputExtension;
+    m_manifestHits.sort();
+    m_manifestCells.sort();
+    m_manifestTruth.sort();
+    updateEventManifest(m_cfg.outputDir, "hits" + ext, m_manifestHits);
+    updateEventManifest(m_cfg.outputDir, "cells" + ext, m_manifestCells);
+    updateEventManifest(m_cfg.outputDir, "truth" + ext, m_manifestTruth);
+  }
+  return FW::ProcessCode::SUCCESS;
+}
@@ -0,0 +1,106 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Csv/CsvPropagationStatisticsWriter.hpp"
+
+#include <stdexcept>
+
+#include <dfe/dfe_namedtuple.hpp>
+
+#include "ACTFW/Utilities/Paths.hpp"
+#include "CsvRows.hpp"
+
+namespace {
+
+struct PropagationStatisticsData
+{
+  uint64_t event_id;
+  uint64_t tracks;
+  uint64_t loop_protected;
+  uint64_t steps;
+  uint64_t steps_actor;
+  uint64_t steps_accuracy;
+  uint64_t steps_aborter;
+  uint64_t steps_user;
+  uint64_t candidates_listed;
+  uint64_t surfaces_reached;
+  uint64_t volumes_crossed;
+  uint64_t field_cache_misses;
+  double   time_s;
+
+  DFE_NAMEDTUPLE(PropagationStatisticsData,
+                 event_id,
+                 tracks,
+                 loop_protected,
+                 steps,
+                 steps_actor,
+                 steps_accuracy,
+                 steps_aborter,
+                 steps_user,
+                 candidates_listed,
+                 surfaces_reached,
+                 volumes_crossed,
+                 field_cache_misses,
+                 time_s);
+};
+
+}  // namespace
+
+FW::CsvPropagationStatisticsWriter::CsvPropagationStatisticsWriter(
+    const FW::CsvPropagationStatisticsWriter::Config& cfg,
+    Acts::Logging::Level                              level)
+  : WriterT(cfg.inputStatistics, "CsvPropagationStatisticsWriter", level)
+  , m_cfg(cfg)
+{
+  // inputStatistics is already checked by base constructor
+  if (m_cfg.outputFilename.empty()) {
+    throw std::invalid_argument("Missing output filename");
+  }
+}
+
+FW::ProcessCode
+FW::CsvPropagationStatisticsWriter::writeT(
+    const FW::AlgorithmContext&      context,
+    const FW::PropagationStatistics& statistics)
+{
+  std::lock_guard<std::mutex> lock(m_statisticsMutex);
+  m_statistics[context.eventNumber] = statistics;
+  return ProcessCode::SUCCESS;
+}
+
+FW::ProcessCode
+FW::CsvPropagationStatisticsWriter::endRun()
+{
+  auto path = joinPaths(m_cfg.outputDir, m_cfg.outputFilename);
+  CsvRowWriter<PropagationStatisticsData> writer(path, m_cfg.outputPrecision);
+
+  PropagationStatisticsData data;
+  for (const auto& entry : m_statistics) {
+    const auto& stats       = entry.second;
+    data.event_id           = entry.first;
+    data.tracks             = stats.tracks;
+    data.loop_protected     = stats.loopProtected;
+    data.steps              = stats.steps;
+    data.steps_actor        = stats.stepsActor;
+    data.steps_accuracy     = stats.stepsAccuracy;
+    data.steps_aborter      = stats.stepsAborter;
+    data.steps_user         = stats.stepsUser;
+    data.candidates_listed  = stats.candidatesListed;
+    data.surfaces_reached   = stats.surfacesReached;
+    data.volumes_crossed    = stats.volumesCrossed;
+    data.field_cache_misses = stats.fieldCacheMisses;
+    data.time_s             = stats.seconds;
+    writer.append(data);
+  }
+  writer.close();
+  ACTS_INFO("Wrote propagation statistics of " << m_statistics.size()
+                                               << " events to '" << path
+                                               << "'");
+
+  return ProcessCode::SUCCESS;
+}
@@ -0,0 +1,295 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Named tuple csv readers/writers for plain and compressed files
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dfe/dfe_io_dsv.hpp>
+
+#include "CsvCompression.hpp"
+
+namespace FW {
+
+/// Write named tuple rows to a plain or compressed csv file.
+///
+/// Plain `.csv` files are written directly using the dfe writer. Compressed
+/// files are formatted in memory and compressed as a whole on `close()`.
+template <typename T>
+class CsvRowWriter
+{
+public:
+  /// @param path Output path; the extension selects the compression
+  /// @param precision Floating point output precision
+  /// @param compressionThreads Number of threads used for compression
+  CsvRowWriter(const std::string& path,
+               int                precision,
+               size_t             compressionThreads = 1);
+  CsvRowWriter(const CsvRowWriter&) = delete;
+  CsvRowWriter&
+  operator=(const CsvRowWriter&)
+      = delete;
+  /// Closes the file if this has not been done explicitely. Errors can only
+  /// be reported by an explicit call to `close()`.
+  ~CsvRowWriter();
+
+  void
+  append(const T& row);
+  /// Compress and write the buffered content for compressed files.
+  ///
+  /// @throws std::ios_base::failure if the file can not be written
+  void
+  close();
+
+private:
+  std::string                                  m_path;
+  CsvCompression                               m_compression;
+  size_t                                       m_compressionThreads;
+  std::unique_ptr<dfe::NamedTupleCsvWriter<T>> m_plain;
+  std::ostringstream                           m_buffer;
+  bool                                         m_closed = false;
+};
+
+/// Read named tuple rows from a plain or compressed csv file.
+///
+/// Plain `.csv` files are read directly using the dfe reader. Compressed
+/// files are decompressed into memory in full before parsing, since the dfe
+/// reader can only read from a file path. The in-memory parser accepts the
+/// output of the dfe writer and runs in the calling task without starting
+/// additional threads.
+template <typename T>
+class CsvRowReader
+{
+public:
+  /// @param path Input path; the extension selects the compression
+  /// @param optionalColumns Columns that can be missing in the file
+  /// @throws std::invalid_argument if required columns are missing
+  CsvRowReader(const std::string&              path,
+               const std::vector<std::string>& optionalColumns = {});
+
+  /// Read the next row. Missing optional columns are not modified.
+  ///
+  /// @return false if there are no more rows
+  /// @throws std::runtime_error on malformed rows
+  bool
+  read(T& row);
+
+private:
+  static constexpr size_t N = std::tuple_size<decltype(T().tuple())>::value;
+
+  template <size_t... I>
+  void
+  parseRow(T& row, std::index_sequence<I...>);
+  template <typename U>
+  void
+  parseField(size_t index, U& value);
+
+  std::string                                  m_path;
+  std::unique_ptr<dfe::NamedTupleCsvReader<T>> m_plain;
+  std::string                                  m_content;
+  size_t                                       m_pos  = 0;
+  size_t                                       m_line = 0;
+  // for each tuple element the column index in the file or -1 if missing
+  std::vector<int>    m_columns;
+  size_t              m_numColumns = 0;
+  std::vector<size_t> m_fields;
+};
+
+}  // namespace FW
+
+template <typename T>
+inline FW::CsvRowWriter<T>::CsvRowWriter(const std::string& path,
+                                         int                precision,
+                                         size_t compressionThreads)
+  : m_path(path)
+  , m_compression(csvCompression(path))
+  , m_compressionThreads(compressionThreads)
+{
+  if (m_compression == CsvCompression::None) {
+    m_plain = std::make_unique<dfe::NamedTupleCsvWriter<T>>(path, precision);
+    return;
+  }
+  m_buffer << std::setprecision(precision);
+  const auto names = T::names();
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (0u < i) { m_buffer << ','; }
+    m_buffer << names[i];
+  }
+  m_buffer << '\n';
+}
+
+template <typename T>
+inline FW::CsvRowWriter<T>::~CsvRowWriter()
+{
+  try {
+    close();
+  } catch (...) {
+    // destructors must not throw
+  }
+}
+
+template <typename T>
+inline void
+FW::CsvRowWriter<T>::append(const T& row)
+{
+  if (m_plain) {
+    m_plain->append(row);
+    return;
+  }
+  size_t i = 0;
+  std::apply(
+      [&](const auto&... values) {
+        ((m_buffer << ((i++ == 0u) ? "" : ",") << values), ...);
+      },
+      row.tuple());
+  m_buffer << '\n';
+}
+
+template <typename T>
+inline void
+FW::CsvRowWriter<T>::close()
+{
+  if (m_closed) { return; }
+  m_closed = true;
+  if (m_plain) {
+    m_plain.reset();
+    return;
+  }
+  writeCompressedFile(
+      m_path, m_buffer.str(), m_compression, m_compressionThreads);
+  m_buffer.str(std::string());
+}
+
+template <typename T>
+inline FW::CsvRowReader<T>::CsvRowReader(
+    const std::string&              path,
+    const std::vector<std::string>& optionalColumns)
+  : m_path(path)
+{
+  CsvCompression compression = csvCompression(path);
+  if (compression == CsvCompression::None) {
+    m_plain
+        = std::make_unique<dfe::NamedTupleCsvReader<T>>(path, optionalColumns);
+    return;
+  }
+  m_content = readCompressedFile(path, compression);
+
+  // split the header into column names
+  size_t eol = std::min(m_content.find('\n'), m_content.size());
+  std::vector<std::string> header;
+  std::string              name;
+  std::istringstream       headerLine(m_content.substr(0, eol));
+  while (std::getline(headerLine, name, ',')) {
+    if (not name.empty() and (name.back() == '\r')) { name.pop_back(); }
+    header.push_back(name);
+  }
+  m_pos        = std::min(eol + 1, m_content.size());
+  m_line       = 1;
+  m_numColumns = header.size();
+
+  // map tuple elements to file columns
+  const auto names = T::names();
+  m_columns.assign(names.size(), -1);
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto it = std::find(header.begin(), header.end(), names[i]);
+    if (it != header.end()) {
+      m_columns[i] = std::distance(header.begin(), it);
+    } else if (std::find(optionalColumns.begin(),
+                         optionalColumns.end(),
+                         names[i])
+               == optionalColumns.end()) {
+      throw std::invalid_argument("Missing header column '" + names[i]
+                                  + "' in '" + path + "'");
+    }
+  }
+}
+
+template <typename T>
+inline bool
+FW::CsvRowReader<T>::read(T& row)
+{
+  if (m_plain) { return m_plain->read(row); }
+
+  // skip empty lines, e.g. a trailing newline
+  while ((m_pos < m_content.size())
+         and ((m_content[m_pos] == '\n') or (m_content[m_pos] == '\r'))) {
+    m_pos += 1;
+    m_line += 1;
+  }
+  if (m_content.size() <= m_pos) { return false; }
+
+  // store field boundaries as [start0, start1, ..., end + 1]
+  size_t eol = std::min(m_content.find('\n', m_pos), m_content.size());
+  m_fields.clear();
+  m_fields.push_back(m_pos);
+  for (size_t i = m_pos; i < eol; ++i) {
+    if (m_content[i] == ',') { m_fields.push_back(i + 1); }
+  }
+  m_fields.push_back(eol + 1);
+  m_line += 1;
+  if (m_fields.size() != (m_numColumns + 1)) {
+    throw std::runtime_error("Inconsistent number of columns in line "
+                             + std::to_string(m_line) + " of '" + m_path
+                             + "'");
+  }
+  parseRow(row, std::make_index_sequence<N>());
+  m_pos = eol + 1;
+  return true;
+}
+
+template <typename T>
+template <size_t... I>
+inline void
+FW::CsvRowReader<T>::parseRow(T& row, std::index_sequence<I...>)
+{
+  auto values = row.tuple();
+  (((0 <= m_columns[I]) ? parseField(m_columns[I], std::get<I>(values))
+                        : void()),
+   ...);
+  row = values;
+}
+
+template <typename T>
+template <typename U>
+inline void
+FW::CsvRowReader<T>::parseField(size_t index, U& value)
+{
+  const char* first = m_content.data() + m_fields[index];
+  const char* last  = m_content.data() + m_fields[index + 1] - 1;
+  if ((first < last) and (last[-1] == '\r')) { last -= 1; }
+
+  bool valid = false;
+  if constexpr (std::is_floating_point<U>::value) {
+    // fields are always followed by a non-numeric separator
+    char* end = nullptr;
+    value     = std::strtod(first, &end);
+    valid     = (first < last) and (end == last);
+  } else {
+    auto ret = std::from_chars(first, last, value);
+    valid    = (ret.ec == std::errc()) and (ret.ptr == last);
+  }
+  if (not valid) {
+    throw std::runtime_error("Invalid value '" + std::string(first, last)
+                             + "' in line " + std::to_string(m_line) + " of '"
+                             + m_path + "'");
+  }
+}
@@ -18,9 +18,9 @@
 #include <Acts/Plugins/Identification/IdentifiedDetectorElement.hpp>
 #include <Acts/Surfaces/Surface.hpp>
 #include <Acts/Utilities/Units.hpp>
-#include <dfe/dfe_io_dsv.hpp>
 
 #include "ACTFW/Utilities/Paths.hpp"
+#include "CsvRows.hpp"
 #include "TrackMlData.hpp"
 
 using namespace FW;
@@ -49,7 +49,7 @@ CsvTrackingGeometryWriter::name() const
 }
 
 namespace {
-using SurfaceWriter = dfe::NamedTupleCsvWriter<SurfaceData>;
+using SurfaceWriter = FW::CsvRowWriter<SurfaceData>;
 
 /// Write a single surface.
 void
@@ -160,18 +160,24 @@ ProcessCode
 CsvTrackingGeometryWriter::write(const AlgorithmContext& ctx)
 {
   if (not m_cfg.writePerEvent) { return ProcessCode::SUCCESS; }
-  SurfaceWriter writer(
-      perEventFilepath(m_cfg.outputDir, "detectors.csv", ctx.eventNumber),
-      m_cfg.outputPrecision);
+  SurfaceWriter writer(perEventFilepath(m_cfg.outputDir,
+                                        "detectors" + m_cfg.outputExtension,
+                                        ctx.eventNumber),
+                       m_cfg.outputPrecision,
+                       m_cfg.compressionThreads);
   writeVolume(writer, *m_world, ctx.geoContext);
+  writer.close();
   return ProcessCode::SUCCESS;
 }
 
 ProcessCode
 CsvTrackingGeometryWriter::endRun()
 {
-  SurfaceWriter writer(joinPaths(m_cfg.outputDir, "detectors.csv"),
-                       m_cfg.outputPrecision);
+  SurfaceWriter writer(
+      joinPaths(m_cfg.outputDir, "detectors" + m_cfg.outputExtension),
+      m_cfg.outputPrecision,
+      m_cfg.compressionThreads);
   writeVolume(writer, *m_world, Acts::GeometryContext());
+  writer.close();
   return ProcessCode::SUCCESS;
 }
@@ -0,0 +1,23 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+namespace FW {
+
+/// Enable ROOT's implicit multi-threading for the whole application.
+///
+/// @param numThreads Size of the ROOT thread pool, non-positive for automatic
+///
+/// Readers and writers never enable it themselves. It must be enabled once,
+/// before any ROOT input or output is created, if ROOT should decompress or
+/// compress the data of different branches or columns in parallel.
+void
+enableRootImplicitMT(int numThreads = -1);
+
+}  // namespace FW
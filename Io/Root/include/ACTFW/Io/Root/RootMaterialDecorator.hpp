@@ -134,6 +134,13 @@ public:
     }
   }
 
+  /// Access the read surface material, e.g. for format conversion
+  const Acts::SurfaceMaterialMap&
+  surfaceMaterialMap() const
+  {
+    return m_surfaceMaterialMap;
+  }
+
 private:
   /// The config class
   Config m_cfg;
@@ -8,7 +8,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 #include <vector>
 
 #include <Acts/Propagator/MaterialInteractor.hpp>
@@ -19,15 +19,19 @@
 #include "ACTFW/Framework/IService.hpp"
 #include "ACTFW/Framework/ProcessCode.hpp"
 
-class TChain;
-
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeInput;
+
 /// @class RootMaterialTrackReader
 ///
 /// @brief Reads in MaterialTrack information from a root file
 /// and fills it into a format to be understood by the MaterialMapping
 /// algorithm
+///
+/// Safe to use from multiple reader threads - each thread reads from its own
+/// chain without locking.
 class RootMaterialTrackReader : public IReader
 {
 public:
@@ -42,6 +46,8 @@ public:
 
     unsigned int batchSize = 1;  ///!< The number of tracks per event
 
+    long long cacheSize = 10 * 1024 * 1024;  ///< per-thread tree cache size
+
     /// The default logger
     std::shared_ptr<const Acts::Logger> logger;
 
@@ -90,36 +96,44 @@ private:
   /// The config class
   Config m_cfg;
 
-  /// mutex used to protect multi-threaded reads
-  std::mutex m_read_mutex;
-
   /// The number of events
   size_t m_events = 0;
 
-  /// The input tree name
-  TChain* m_inputChain = nullptr;
-
-  float m_v_x;    ///< start global x
-  float m_v_y;    ///< start global y
-  float m_v_z;    ///< start global z
-  float m_v_px;   ///< start global momentum x
-  float m_v_py;   ///< start global momentum y
-  float m_v_pz;   ///< start global momentum z
-  float m_v_phi;  ///< start phi direction
-  float m_v_eta;  ///< start eta direction
-  float m_tX0;    ///< thickness in X0/L0
-  float m_tL0;    ///< thickness in X0/L0
-
-  std::vector<float>* m_step_x = new std::vector<float>;  ///< step x position
-  std::vector<float>* m_step_y = new std::vector<float>;  ///< step y position
-  std::vector<float>* m_step_z = new std::vector<float>;  ///< step z position
-  std::vector<float>* m_step_length = new std::vector<float>;  ///< step length
-  std::vector<float>* m_step_X0 = new std::vector<float>;  ///< step material x0
-  std::vector<float>* m_step_L0 = new std::vector<float>;  ///< step material l0
-  std::vector<float>* m_step_A  = new std::vector<float>;  ///< step material A
-  std::vector<float>* m_step_Z  = new std::vector<float>;  ///< step material Z
-  std::vector<float>* m_step_rho
-      = new std::vector<float>;  ///< step material rho
+  /// Branch buffers; one instance per reading thread
+  struct Buffers
+  {
+    float v_x;    ///< start global x
+    float v_y;    ///< start global y
+    float v_z;    ///< start global z
+    float v_px;   ///< start global momentum x
+    float v_py;   ///< start global momentum y
+    float v_pz;   ///< start global momentum z
+    float v_phi;  ///< start phi direction
+    float v_eta;  ///< start eta direction
+    float tX0;    ///< thickness in X0/L0
+    float tL0;    ///< thickness in X0/L0
+
+    std::vector<float>* step_x = new std::vector<float>;  ///< step x position
+    std::vector<float>* step_y = new std::vector<float>;  ///< step y position
+    std::vector<float>* step_z = new std::vector<float>;  ///< step z position
+    std::vector<float>* step_length = new std::vector<float>;  ///< step length
+    std::vector<float>* step_X0 = new std::vector<float>;  ///< step material x0
+    std::vector<float>* step_L0 = new std::vector<float>;  ///< step material l0
+    std::vector<float>* step_A  = new std::vector<float>;  ///< step material A
+    std::vector<float>* step_Z  = new std::vector<float>;  ///< step material Z
+    std::vector<float>* step_rho
+        = new std::vector<float>;  ///< step material rho
+
+    Buffers() = default;
+    Buffers(const Buffers&) = delete;
+    Buffers&
+    operator=(const Buffers&)
+        = delete;
+    ~Buffers();
+  };
+
+  /// The per-thread input chains
+  std::unique_ptr<RootTreeInput<Buffers>> m_input;
 };
 
 }  // namespace FW
@@ -8,7 +8,9 @@
 
 #pragma once
 
-#include <mutex>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 #include <Acts/Propagator/MaterialInteractor.hpp>
 #include <Acts/Utilities/Logger.hpp>
@@ -32,6 +34,9 @@ using RecordedMaterialTrack
 
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeOutput;
+
 /// @class RootMaterialTrackWriter
 ///
 /// @brief Writes out MaterialTrack collections from a root file
@@ -39,6 +44,9 @@ namespace FW {
 /// This service is the root implementation of the IWriterT.
 /// It writes out a MaterialTrack which is usually generated from
 /// Geant4 material mapping
+///
+/// Safe to use from multiple writer threads - uses a std::mutex lock.
+/// With Config::ntupleOutput an RNTuple is written instead of the TTree.
 class RootMaterialTrackWriter
   : public WriterT<std::vector<Acts::RecordedMaterialTrack>>
 {
@@ -51,6 +59,8 @@ public:
     std::string fileMode = "RECREATE";         ///< file access mode
     std::string treeName = "material-tracks";  ///< name of the output tree
     TFile*      rootFile = nullptr;            ///< common root file
+    /// fill an RNTuple instead of a TTree; needs own file
+    bool ntupleOutput = false;
 
     /// Re-calculate total values from individual steps (for cross-checks)
     bool recalculateTotals = false;
@@ -85,57 +95,52 @@ protected:
       final override;
 
 private:
-  /// The config class
-  Config m_cfg;
-  /// mutex used to protect multi-threaded writes
-  std::mutex m_writeMutex;
-  /// The output file name
-  TFile* m_outputFile;
-  /// The output tree name
-  TTree* m_outputTree;
-
-  float m_v_x;    ///< start global x
-  float m_v_y;    ///< start global y
-  float m_v_z;    ///< start global z
-  float m_v_px;   ///< start global momentum x
-  float m_v_py;   ///< start global momentum y
-  float m_v_pz;   ///< start global momentum z
-  float m_v_phi;  ///< start phi direction
-  float m_v_eta;  ///< start eta direction
-  float m_tX0;    ///< thickness in X0/L0
-  float m_tL0;    ///< thickness in X0/L0
-
-  std::vector<float> m_step_sx;      ///< step x (start) position (optional)
-  std::vector<float> m_step_sy;      ///< step y (start) position (optional)
-  std::vector<float> m_step_sz;      ///< step z (start) position (optional)
-  std::vector<float> m_step_x;       ///< step x position
-  std::vector<float> m_step_y;       ///< step y position
-  std::vector<float> m_step_z;       ///< step z position
-  std::vector<float> m_step_ex;      ///< step x (end) position (optional)
-  std::vector<float> m_step_ey;      ///< step y (end) position (optional)
-  std::vector<float> m_step_ez;      ///< step z (end) position (optional)
-  std::vector<float> m_step_length;  ///< step length
-  std::vector<float> m_step_X0;      ///< step material x0
-  std::vector<float> m_step_L0;      ///< step material l0
-  std::vector<float> m_step_A;       ///< step material A
-  std::vector<float> m_step_Z;       ///< step material Z
-  std::vector<float> m_step_rho;     ///< step material rho
-
-  std::vector<std::uint64_t>
-      m_sur_id;  ///< ID of the suface associated with the step
-  std::vector<int32_t>
-                     m_sur_type;  ///< Type of the suface associated with the step
-  std::vector<float> m_sur_x;     ///< x position of the center of the suface
-                                  ///< associated with the step
-  std::vector<float> m_sur_y;     ///< y position of the center of the suface
-                                  ///< associated with the step
-  std::vector<float> m_sur_z;     ///< z position of the center of the suface
-                                  ///< associated with the step
-
-  std::vector<float>
-      m_sur_range_min;  ///< Min range of the suface associated with the step
-  std::vector<float>
-      m_sur_range_max;  ///< Max range of the suface associated with the step
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    float v_x;    ///< start global x
+    float v_y;    ///< start global y
+    float v_z;    ///< start global z
+    float v_px;   ///< start global momentum x
+    float v_py;   ///< start global momentum y
+    float v_pz;   ///< start global momentum z
+    float v_phi;  ///< start phi direction
+    float v_eta;  ///< start eta direction
+    float tX0;    ///< thickness in X0/L0
+    float tL0;    ///< thickness in X0/L0
+
+    std::vector<float> step_sx;      ///< step x (start) position (optional)
+    std::vector<float> step_sy;      ///< step y (start) position (optional)
+    std::vector<float> step_sz;      ///< step z (start) position (optional)
+    std::vector<float> step_x;       ///< step x position
+    std::vector<float> step_y;       ///< step y position
+    std::vector<float> step_z;       ///< step z position
+    std::vector<float> step_ex;      ///< step x (end) position (optional)
+    std::vector<float> step_ey;      ///< step y (end) position (optional)
+    std::vector<float> step_ez;      ///< step z (end) position (optional)
+    std::vector<float> step_length;  ///< step length
+    std::vector<float> step_X0;      ///< step material x0
+    std::vector<float> step_L0;      ///< step material l0
+    std::vector<float> step_A;       ///< step material A
+    std::vector<float> step_Z;       ///< step material Z
+    std::vector<float> step_rho;     ///< step material rho
+
+    /// ID of the suface associated with the step
+    std::vector<std::uint64_t> sur_id;
+    /// Type of the suface associated with the step
+    std::vector<int32_t> sur_type;
+    /// Position of the center of the suface associated with the step
+    std::vector<float> sur_x;
+    std::vector<float> sur_y;
+    std::vector<float> sur_z;
+    /// Min range of the suface associated with the step
+    std::vector<float> sur_range_min;
+    /// Max range of the suface associated with the step
+    std::vector<float> sur_range_max;
+  };
+
+  Config                                   m_cfg;     ///< the configuration
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< the output tree
 };
 
 }  // namespace FW
@@ -8,7 +8,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 
 #include "ACTFW/EventData/SimParticle.hpp"
 #include "ACTFW/EventData/SimVertex.hpp"
@@ -19,17 +19,20 @@ class TTree;
 
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeOutput;
+
 /// Write out a particles associated to process vertices into a TTree
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
-///
 /// Each entry in the TTree corresponds to one particle for optimum writing
 /// speed. The event number is part of the written data.
 ///
 /// A common file can be provided for to the writer to attach his TTree,
 /// this is done by setting the Config::rootFile pointer to an existing file
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
+/// With Config::parallelOutput each writer thread fills a separate tree that
+/// is merged into the output file in the background. Otherwise, a single tree
+/// is filled and protected by a std::mutex lock.
 class RootParticleWriter final : public WriterT<std::vector<Data::SimVertex>>
 {
 public:
@@ -40,6 +43,8 @@ public:
     std::string fileMode = "RECREATE";   ///< file access mode
     std::string treeName = "particles";  ///< name of the output tree
     TFile*      rootFile = nullptr;      ///< common root file
+    /// fill per-thread trees merged in the background; needs own file
+    bool parallelOutput = false;
   };
 
   /// Constructor
@@ -66,30 +71,33 @@ protected:
          const std::vector<Data::SimVertex>& vertices) final override;
 
 private:
-  Config     m_cfg;         ///< The config class
-  std::mutex m_writeMutex;  ///< Mutex used to protect multi-threaded writes
-  TFile*     m_outputFile{nullptr};  ///< The output file
-  TTree*     m_outputTree{nullptr};  ///< The output tree
-  int        m_eventNr{0};           ///< the event number of
-  float      m_vx{0.};               ///< Vertex position x
-  float      m_vy{0.};               ///< Vertex position y
-  float      m_vz{0.};               ///< Vertex position z
-  float      m_vt{0.};               ///< Vertex time t
-  float      m_px{0.};               ///< Momentum position x
-  float      m_py{0.};               ///< Momentum position y
-  float      m_pz{0.};               ///< Momentum position z
-  float      m_pT{0.};               ///< Momentum position transverse component
-  float      m_eta{0.};              ///< Momentum direction eta
-  float      m_phi{0.};              ///< Momentum direction phi
-  float      m_mass{0.};             ///< Particle mass
-  int        m_charge{0};            ///< Particle charge
-  int        m_pdgCode{0};           ///< Particle pdg code
-  uint64_t   m_barcode{0};           ///< Particle barcode
-  uint32_t   m_vertexPrimary{0};     ///< Barcode primary vertex id
-  uint32_t   m_vertexSecondary{0};   ///< Barcode secondary vertex id
-  uint32_t   m_particle{0};          ///< Barcode particle id
-  uint32_t   m_parentParticle{0};    ///< Barcode parent particle id
-  uint32_t   m_process{0};           ///< Barcode process id
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    int      eventNr{0};          ///< the event number of
+    float    vx{0.};              ///< Vertex position x
+    float    vy{0.};              ///< Vertex position y
+    float    vz{0.};              ///< Vertex position z
+    float    vt{0.};              ///< Vertex time t
+    float    px{0.};              ///< Momentum position x
+    float    py{0.};              ///< Momentum position y
+    float    pz{0.};              ///< Momentum position z
+    float    pT{0.};              ///< Momentum position transverse component
+    float    eta{0.};             ///< Momentum direction eta
+    float    phi{0.};             ///< Momentum direction phi
+    float    mass{0.};            ///< Particle mass
+    int      charge{0};           ///< Particle charge
+    int      pdgCode{0};          ///< Particle pdg code
+    uint64_t barcode{0};          ///< Particle barcode
+    uint32_t vertexPrimary{0};    ///< Barcode primary vertex id
+    uint32_t vertexSecondary{0};  ///< Barcode secondary vertex id
+    uint32_t particle{0};         ///< Barcode particle id
+    uint32_t parentParticle{0};   ///< Barcode parent particle id
+    uint32_t process{0};          ///< Barcode process id
+  };
+
+  Config                                   m_cfg;     ///< The config class
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< The output tree(s)
 };
 
 }  // namespace FW
@@ -8,7 +8,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 
 #include <Acts/Plugins/Digitization/PlanarModuleCluster.hpp>
 
@@ -20,6 +20,9 @@ class TTree;
 
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeOutput;
+
 /// @class RootPlanarClusterWriter
 ///
 /// Write out a planar cluster collection into a root file
@@ -30,7 +33,9 @@ namespace FW {
 /// A common file can be provided for to the writer to attach his TTree,
 /// this is done by setting the Config::rootFile pointer to an existing file
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
+/// With Config::parallelOutput each writer thread fills a separate tree that
+/// is merged into the output file in the background. Otherwise, a single tree
+/// is filled and protected by a std::mutex lock.
 class RootPlanarClusterWriter
   : public WriterT<GeometryIdMultimap<Acts::PlanarModuleCluster>>
 {
@@ -42,6 +47,8 @@ public:
     std::string fileMode   = "RECREATE";  ///< file access mode
     std::string treeName   = "clusters";  ///< name of the output tree
     TFile*      rootFile   = nullptr;     ///< common root file
+    /// fill per-thread trees merged in the background; needs own file
+    bool parallelOutput = false;
   };
 
   /// Constructor with
@@ -69,37 +76,40 @@ protected:
       final override;
 
 private:
-  Config             m_cfg;         ///< the configuration object
-  std::mutex         m_writeMutex;  ///< protect multi-threaded writes
-  TFile*             m_outputFile;  ///< the output file
-  TTree*             m_outputTree;  ///< the output tree
-  int                m_eventNr;     ///< the event number of
-  int                m_volumeID;    ///< volume identifier
-  int                m_layerID;     ///< layer identifier
-  int                m_surfaceID;   ///< surface identifier
-  float              m_x;           ///< global x
-  float              m_y;           ///< global y
-  float              m_z;           ///< global z
-  float              m_t;           ///< global t
-  float              m_lx;          ///< local lx
-  float              m_ly;          ///< local ly
-  float              m_cov_lx;      ///< local covariance lx
-  float              m_cov_ly;      ///< local covariance ly
-  std::vector<int>   m_cell_IDx;    ///< cell ID in lx
-  std::vector<int>   m_cell_IDy;    ///< cell ID in ly
-  std::vector<float> m_cell_lx;     ///< local cell position x
-  std::vector<float> m_cell_ly;     ///< local cell position y
-  std::vector<float> m_cell_data;   ///< local cell position y
-
-  // (optional) the truth position
-  std::vector<float> m_t_gx;  ///< truth position global x
-  std::vector<float> m_t_gy;  ///< truth position global y
-  std::vector<float> m_t_gz;  ///< truth position global z
-  std::vector<float> m_t_gt;  ///< truth time t
-  std::vector<float> m_t_lx;  ///< truth position local x
-  std::vector<float> m_t_ly;  ///< truth position local y
-  std::vector<unsigned long>
-      m_t_barcode;  ///< associated truth particle barcode
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    int                eventNr;    ///< the event number of
+    int                volumeID;   ///< volume identifier
+    int                layerID;    ///< layer identifier
+    int                surfaceID;  ///< surface identifier
+    float              x;          ///< global x
+    float              y;          ///< global y
+    float              z;          ///< global z
+    float              t;          ///< global t
+    float              lx;         ///< local lx
+    float              ly;         ///< local ly
+    float              cov_lx;     ///< local covariance lx
+    float              cov_ly;     ///< local covariance ly
+    std::vector<int>   cell_IDx;   ///< cell ID in lx
+    std::vector<int>   cell_IDy;   ///< cell ID in ly
+    std::vector<float> cell_lx;    ///< local cell position x
+    std::vector<float> cell_ly;    ///< local cell position y
+    std::vector<float> cell_data;  ///< local cell position y
+
+    // (optional) the truth position
+    std::vector<float>         t_gx;       ///< truth position global x
+    std::vector<float>         t_gy;       ///< truth position global y
+    std::vector<float>         t_gz;       ///< truth position global z
+    std::vector<float>         t_gt;       ///< truth time t
+    std::vector<float>         t_lx;       ///< truth position local x
+    std::vector<float>         t_ly;       ///< truth position local y
+    /// associated truth particle barcode
+    std::vector<unsigned long> t_barcode;
+  };
+
+  Config                                   m_cfg;     ///< the configuration
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< the output tree(s)
 };
 
 }  // namespace FW
@@ -8,9 +8,10 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 
 #include <ACTFW/Framework/WriterT.hpp>
+#include <ACTFW/Propagation/SampledSteppingLogger.hpp>
 
 #include "Acts/Propagator/detail/SteppingLogger.hpp"
 
@@ -19,9 +20,12 @@ class TTree;
 
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeOutput;
+
 using PropagationSteps = std::vector<Acts::detail::Step>;
 
-/// @class RootPropagationStepsWriter
+/// @class RootPropagationStepsWriterT
 ///
 /// Write out the steps of test propgations for stepping validation,
 /// each step sequence is one entry in the  in the root file for optimised
@@ -31,8 +35,16 @@ using PropagationSteps = std::vector<Acts::detail::Step>;
 /// A common file can be provided for to the writer to attach his TTree,
 /// this is done by setting the Config::rootFile pointer to an existing file
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
-class RootPropagationStepsWriter : public WriterT<std::vector<PropagationSteps>>
+/// With Config::parallelOutput each writer thread fills a separate tree that
+/// is merged into the output file in the background. Otherwise, a single tree
+/// is filled and protected by a std::mutex lock.
+///
+/// With Config::ntupleOutput an RNTuple is written instead of the TTree.
+///
+/// @tparam step_t Step type, either `Acts::detail::Step` or `CompactStep`
+template <typename step_t>
+class RootPropagationStepsWriterT
+  : public WriterT<std::vector<std::vector<step_t>>>
 {
 public:
   struct Config
@@ -43,16 +55,20 @@ public:
     std::string fileMode = "RECREATE";  ///< file access mode
     std::string treeName = "propagation_steps";  ///< name of the output tree
     TFile*      rootFile = nullptr;              ///< common root file
+    /// fill per-thread trees merged in the background; needs own file
+    bool parallelOutput = false;
+    /// fill an RNTuple instead of a TTree; needs own file
+    bool ntupleOutput = false;
   };
 
   /// Constructor with
   /// @param cfg configuration struct
   /// @param output logging level
-  RootPropagationStepsWriter(const Config&        cfg,
-                             Acts::Logging::Level level = Acts::Logging::INFO);
+  RootPropagationStepsWriterT(const Config&        cfg,
+                              Acts::Logging::Level level = Acts::Logging::INFO);
 
   /// Virtual destructor
-  ~RootPropagationStepsWriter() override;
+  ~RootPropagationStepsWriterT() override;
 
   /// End-of-run hook
   ProcessCode
@@ -65,31 +81,42 @@ protected:
   /// @param context The Algorithm context with per event information
   /// @param steps is the data to be written out
   ProcessCode
-  writeT(const AlgorithmContext&              context,
-         const std::vector<PropagationSteps>& steps) final override;
+  writeT(const AlgorithmContext&                 context,
+         const std::vector<std::vector<step_t>>& steps) final override;
+
+  using WriterT<std::vector<std::vector<step_t>>>::logger;
 
 private:
-  Config             m_cfg;          ///< the configuration object
-  std::mutex         m_writeMutex;   ///< protect multi-threaded writes
-  TFile*             m_outputFile;   ///< the output file name
-  TTree*             m_outputTree;   ///< the output tree
-  int                m_eventNr;      ///< the event number of
-  std::vector<int>   m_volumeID;     ///< volume identifier
-  std::vector<int>   m_boundaryID;   ///< boundary identifier
-  std::vector<int>   m_layerID;      ///< layer identifier if
-  std::vector<int>   m_approachID;   ///< surface identifier
-  std::vector<int>   m_sensitiveID;  ///< surface identifier
-  std::vector<float> m_x;            ///< global x
-  std::vector<float> m_y;            ///< global y
-  std::vector<float> m_z;            ///< global z
-  std::vector<float> m_dx;           ///< global direction x
-  std::vector<float> m_dy;           ///< global direction y
-  std::vector<float> m_dz;           ///< global direction z
-  std::vector<int>   m_step_type;    ///< step type
-  std::vector<float> m_step_acc;     ///< accuracy
-  std::vector<float> m_step_act;     ///< actor check
-  std::vector<float> m_step_abt;     ///< aborter
-  std::vector<float> m_step_usr;     ///< user
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    int                eventNr;      ///< the event number of
+    std::vector<int>   volumeID;     ///< volume identifier
+    std::vector<int>   boundaryID;   ///< boundary identifier
+    std::vector<int>   layerID;      ///< layer identifier if
+    std::vector<int>   approachID;   ///< surface identifier
+    std::vector<int>   sensitiveID;  ///< surface identifier
+    std::vector<float> x;            ///< global x
+    std::vector<float> y;            ///< global y
+    std::vector<float> z;            ///< global z
+    std::vector<float> dx;           ///< global direction x
+    std::vector<float> dy;           ///< global direction y
+    std::vector<float> dz;           ///< global direction z
+    std::vector<int>   step_type;    ///< step type
+    std::vector<float> step_acc;     ///< accuracy
+    std::vector<float> step_act;     ///< actor check
+    std::vector<float> step_abt;     ///< aborter
+    std::vector<float> step_usr;     ///< user
+  };
+
+  Config                                   m_cfg;     ///< the configuration
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< the output tree(s)
 };
 
+/// Writer for full steps as recorded by default.
+using RootPropagationStepsWriter
+    = RootPropagationStepsWriterT<Acts::detail::Step>;
+/// Writer for compact steps; writes the same tree content.
+using RootCompactStepsWriter = RootPropagationStepsWriterT<CompactStep>;
+
 }  // namespace FW
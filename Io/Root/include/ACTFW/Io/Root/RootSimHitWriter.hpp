@@ -8,7 +8,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/EventData/SimHit.hpp"
@@ -19,6 +19,9 @@ class TTree;
 
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeOutput;
+
 /// @class RootSimHitWriter
 ///
 /// Write out a planar cluster collection into a root file
@@ -29,7 +32,9 @@ namespace FW {
 /// A common file can be provided for to the writer to attach his TTree,
 /// this is done by setting the Config::rootFile pointer to an existing file
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
+/// With Config::parallelOutput each writer thread fills a separate tree that
+/// is merged into the output file in the background. Otherwise, a single tree
+/// is filled and protected by a std::mutex lock.
 class RootSimHitWriter : public WriterT<SimHits>
 {
 public:
@@ -40,6 +45,8 @@ public:
     std::string fileMode = "RECREATE";  ///< file access mode
     std::string treeName = "hits";      ///< name of the output tree
     TFile*      rootFile = nullptr;     ///< common root file
+    /// fill per-thread trees merged in the background; needs own file
+    bool parallelOutput = false;
   };
 
   /// Constructor with
@@ -65,21 +72,24 @@ protected:
   writeT(const AlgorithmContext& context, const SimHits& hits) final override;
 
 private:
-  Config     m_cfg;         ///< the configuration object
-  std::mutex m_writeMutex;  ///< protect multi-threaded writes
-  TFile*     m_outputFile;  ///< the output file
-  TTree*     m_outputTree;  ///< the output tree to be written to
-  int        m_eventNr;     ///< the event number of
-  int        m_volumeID;    ///< volume identifier
-  int        m_layerID;     ///< layer identifier
-  int        m_surfaceID;   ///< surface identifier
-  float      m_x;           ///< global x
-  float      m_y;           ///< global y
-  float      m_z;           ///< global z
-  float      m_dx;          ///< global direction x
-  float      m_dy;          ///< global direction y
-  float      m_dz;          ///< global direction z
-  float      m_value;       ///< value of the hit
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    int   eventNr;    ///< the event number of
+    int   volumeID;   ///< volume identifier
+    int   layerID;    ///< layer identifier
+    int   surfaceID;  ///< surface identifier
+    float x;          ///< global x
+    float y;          ///< global y
+    float z;          ///< global z
+    float dx;         ///< global direction x
+    float dy;         ///< global direction y
+    float dz;         ///< global direction z
+    float value;      ///< value of the hit
+  };
+
+  Config                                   m_cfg;     ///< the configuration
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< the output tree(s)
 };
 
 }  // namespace FW
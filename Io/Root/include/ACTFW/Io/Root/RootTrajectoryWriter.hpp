@@ -8,7 +8,11 @@
 
 #pragma once
 
-#include <mutex>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "ACTFW/EventData/Barcode.hpp"
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/EventData/SimParticle.hpp"
@@ -27,6 +31,10 @@ class TTree;
 
 namespace FW {
 
+class RootBranchBooker;
+template <typename buffers_t>
+class RootTreeOutput;
+
 using Identifier = Data::SimSourceLink;
 using Measurement
     = Acts::Measurement<Identifier, Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_1>;
@@ -36,8 +44,6 @@ using Measurement
 /// Write out a trajectory (i.e. a vector of
 /// trackState at the moment) into a TTree
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
-///
 /// Each entry in the TTree corresponds to one trajectory for optimum
 /// writing speed. The event number is part of the written data.
 ///
@@ -45,7 +51,15 @@ using Measurement
 /// this is done by setting the Config::rootFile pointer to an existing
 /// file
 ///
-/// Safe to use from multiple writer threads - uses a std::mutex lock.
+/// The branches are organized in groups that can be disabled individually.
+/// The computations needed only for disabled groups are skipped as well.
+///
+/// The entries of an event are computed in local buffers first. Only copying
+/// them into the output buffers and filling is protected by a std::mutex lock.
+/// With Config::parallelOutput each writer thread fills a separate tree that
+/// is merged into the output file in the background instead.
+///
+/// With Config::ntupleOutput an RNTuple is written instead of the TTree.
 class RootTrajectoryWriter final : public WriterT<TrajectoryContainer>
 {
 public:
@@ -59,6 +73,17 @@ public:
     std::string outputTreename = "tracks";       ///< name of the output tree
     std::string fileMode       = "RECREATE";     ///< file access mode
     TFile*      rootFile       = nullptr;        ///< common root file
+    /// fill per-thread trees merged in the background; needs own file
+    bool parallelOutput = false;
+    /// fill an RNTuple instead of a TTree; needs own file
+    bool ntupleOutput = false;
+    // branch groups; event and trajectory number are always written
+    bool writeSummary   = true;  ///< state counts and fitted parameters
+    bool writeTruth     = true;  ///< truth particle and truth hits
+    bool writeHits      = true;  ///< measurements and hit residuals
+    bool writePredicted = true;  ///< predicted parameters
+    bool writeFiltered  = true;  ///< filtered parameters and chi2
+    bool writeSmoothed  = true;  ///< smoothed parameters
   };
 
   /// Constructor
@@ -84,182 +109,117 @@ protected:
          const TrajectoryContainer& trajectories) final override;
 
 private:
-  Config     m_cfg;         ///< The config class
-  std::mutex m_writeMutex;  ///< Mutex used to protect multi-threaded writes
-  TFile*     m_outputFile{nullptr};  ///< The output file
-  TTree*     m_outputTree{nullptr};  ///< The output tree
-  int        m_eventNr{0};           ///< the event number
-  int        m_trajNr{0};            ///< the trajectory number
-
-  unsigned long m_t_barcode{0};   ///< Truth particle barcode
-  int           m_t_charge{0};    ///< Truth particle charge
-  float         m_t_time{0};      ///< Truth particle time
-  float         m_t_vx{-99.};     ///< Truth particle vertex x
-  float         m_t_vy{-99.};     ///< Truth particle vertex y
-  float         m_t_vz{-99.};     ///< Truth particle vertex z
-  float         m_t_px{-99.};     ///< Truth particle initial momentum px
-  float         m_t_py{-99.};     ///< Truth particle initial momentum py
-  float         m_t_pz{-99.};     ///< Truth particle initial momentum pz
-  float         m_t_theta{-99.};  ///< Truth particle initial momentum theta
-  float         m_t_phi{-99.};    ///< Truth particle initial momentum phi
-  float         m_t_pT{-99.};     ///< Truth particle initial momentum pT
-  float         m_t_eta{-99.};    ///< Truth particle initial momentum eta
-
-  std::vector<float> m_t_x;  ///< Global truth hit position x
-  std::vector<float> m_t_y;  ///< Global truth hit position y
-  std::vector<float> m_t_z;  ///< Global truth hit position z
-  std::vector<float> m_t_r;  ///< Global truth hit position r
-  std::vector<float>
-      m_t_dx;  ///< Truth particle direction x at global hit position
-  std::vector<float>
-      m_t_dy;  ///< Truth particle direction y at global hit position
-  std::vector<float>
-      m_t_dz;  ///< Truth particle direction z at global hit position
-
-  std::vector<float> m_t_eLOC0;   ///< truth parameter eLOC_0
-  std::vector<float> m_t_eLOC1;   ///< truth parameter eLOC_1
-  std::vector<float> m_t_ePHI;    ///< truth parameter ePHI
-  std::vector<float> m_t_eTHETA;  ///< truth parameter eTHETA
-  std::vector<float> m_t_eQOP;    ///< truth parameter eQOP
-  std::vector<float> m_t_eT;      ///< truth parameter eT
+  using ParameterVectors = std::array<std::vector<float>, Acts::BoundParsDim>;
 
-  int              m_nStates{0};        ///< number of all states
-  int              m_nMeasurements{0};  ///< number of states with measurements
-  std::vector<int> m_volumeID;          ///< volume identifier
-  std::vector<int> m_layerID;           ///< layer identifier
-  std::vector<int> m_moduleID;          ///< surface identifier
-  std::vector<float> m_lx_hit;          ///< uncalibrated measurement local x
-  std::vector<float> m_ly_hit;          ///< uncalibrated measurement local y
-  std::vector<float> m_x_hit;           ///< uncalibrated measurement global x
-  std::vector<float> m_y_hit;           ///< uncalibrated measurement global y
-  std::vector<float> m_z_hit;           ///< uncalibrated measurement global z
-  std::vector<float> m_res_x_hit;       ///< hit residual x
-  std::vector<float> m_res_y_hit;       ///< hit residual y
-  std::vector<float> m_err_x_hit;       ///< hit err x
-  std::vector<float> m_err_y_hit;       ///< hit err y
-  std::vector<float> m_pull_x_hit;      ///< hit pull x
-  std::vector<float> m_pull_y_hit;      ///< hit pull y
-  std::vector<int>   m_dim_hit;         ///< dimension of measurement
-
-  bool  m_hasFittedParams;       ///< if the track has fitted parameter
-  float m_eLOC0_fit{-99.};       ///< fitted parameter eLOC_0
-  float m_eLOC1_fit{-99.};       ///< fitted parameter eLOC_1
-  float m_ePHI_fit{-99.};        ///< fitted parameter ePHI
-  float m_eTHETA_fit{-99.};      ///< fitted parameter eTHETA
-  float m_eQOP_fit{-99.};        ///< fitted parameter eQOP
-  float m_eT_fit{-99.};          ///< fitted parameter eT
-  float m_err_eLOC0_fit{-99.};   ///< fitted parameter eLOC_-99.err
-  float m_err_eLOC1_fit{-99.};   ///< fitted parameter eLOC_1 err
-  float m_err_ePHI_fit{-99.};    ///< fitted parameter ePHI err
-  float m_err_eTHETA_fit{-99.};  ///< fitted parameter eTHETA err
-  float m_err_eQOP_fit{-99.};    ///< fitted parameter eQOP err
-  float m_err_eT_fit{-99.};      ///< fitted parameter eT err
-
-  int m_nPredicted{0};       ///< number of states with predicted parameter
-  std::vector<bool>  m_prt;  ///< predicted status
-  std::vector<float> m_eLOC0_prt;       ///< predicted parameter eLOC0
-  std::vector<float> m_eLOC1_prt;       ///< predicted parameter eLOC1
-  std::vector<float> m_ePHI_prt;        ///< predicted parameter ePHI
-  std::vector<float> m_eTHETA_prt;      ///< predicted parameter eTHETA
-  std::vector<float> m_eQOP_prt;        ///< predicted parameter eQOP
-  std::vector<float> m_eT_prt;          ///< predicted parameter eT
-  std::vector<float> m_res_eLOC0_prt;   ///< predicted parameter eLOC0 residual
-  std::vector<float> m_res_eLOC1_prt;   ///< predicted parameter eLOC1 residual
-  std::vector<float> m_res_ePHI_prt;    ///< predicted parameter ePHI residual
-  std::vector<float> m_res_eTHETA_prt;  ///< predicted parameter eTHETA residual
-  std::vector<float> m_res_eQOP_prt;    ///< predicted parameter eQOP residual
-  std::vector<float> m_res_eT_prt;      ///< predicted parameter eT residual
-  std::vector<float> m_err_eLOC0_prt;   ///< predicted parameter eLOC0 error
-  std::vector<float> m_err_eLOC1_prt;   ///< predicted parameter eLOC1 error
-  std::vector<float> m_err_ePHI_prt;    ///< predicted parameter ePHI error
-  std::vector<float> m_err_eTHETA_prt;  ///< predicted parameter eTHETA error
-  std::vector<float> m_err_eQOP_prt;    ///< predicted parameter eQOP error
-  std::vector<float> m_err_eT_prt;      ///< predicted parameter eT error
-  std::vector<float> m_pull_eLOC0_prt;  ///< predicted parameter eLOC0 pull
-  std::vector<float> m_pull_eLOC1_prt;  ///< predicted parameter eLOC1 pull
-  std::vector<float> m_pull_ePHI_prt;   ///< predicted parameter ePHI pull
-  std::vector<float> m_pull_eTHETA_prt;  ///< predicted parameter eTHETA pull
-  std::vector<float> m_pull_eQOP_prt;    ///< predicted parameter eQOP pull
-  std::vector<float> m_pull_eT_prt;      ///< predicted parameter eT pull
-  std::vector<float> m_x_prt;            ///< predicted global x
-  std::vector<float> m_y_prt;            ///< predicted global y
-  std::vector<float> m_z_prt;            ///< predicted global z
-  std::vector<float> m_px_prt;           ///< predicted momentum px
-  std::vector<float> m_py_prt;           ///< predicted momentum py
-  std::vector<float> m_pz_prt;           ///< predicted momentum pz
-  std::vector<float> m_eta_prt;          ///< predicted momentum eta
-  std::vector<float> m_pT_prt;           ///< predicted momentum pT
+  /// Branches for one type of track parameters at the measurement states.
+  struct StateParameters
+  {
+    int                num{0};  ///< number of states with parameters
+    std::vector<bool>  status;  ///< whether the state has parameters
+    ParameterVectors   par;     ///< parameters
+    ParameterVectors   res;     ///< parameter residuals w.r.t. truth
+    ParameterVectors   err;     ///< parameter errors
+    ParameterVectors   pull;    ///< parameter pulls w.r.t. truth
+    std::vector<float> x;       ///< global x
+    std::vector<float> y;       ///< global y
+    std::vector<float> z;       ///< global z
+    std::vector<float> px;      ///< momentum px
+    std::vector<float> py;      ///< momentum py
+    std::vector<float> pz;      ///< momentum pz
+    std::vector<float> eta;     ///< momentum eta
+    std::vector<float> pT;      ///< momentum pT
+
+    /// Book the branches, e.g. `predicted`, `nPredicted`, and `eLOC0_prt`.
+    void
+    book(RootBranchBooker&  tree,
+         const std::string& name,
+         const std::string& suffix);
+    /// Add the parameters of one state.
+    void
+    fill(const Acts::BoundParameters& parameters,
+         const Acts::BoundVector&     truth);
+    /// Add default values for a state without parameters.
+    void
+    fillMissing();
+    void
+    clear();
+  };
 
-  int m_nFiltered{0};              ///< number of states with filtered parameter
-  std::vector<bool>  m_flt;        ///< filtered status
-  std::vector<float> m_eLOC0_flt;  ///< filtered parameter eLOC0
-  std::vector<float> m_eLOC1_flt;  ///< filtered parameter eLOC1
-  std::vector<float> m_ePHI_flt;   ///< filtered parameter ePHI
-  std::vector<float> m_eTHETA_flt;       ///< filtered parameter eTHETA
-  std::vector<float> m_eQOP_flt;         ///< filtered parameter eQOP
-  std::vector<float> m_eT_flt;           ///< filtered parameter eT
-  std::vector<float> m_res_eLOC0_flt;    ///< filtered parameter eLOC0 residual
-  std::vector<float> m_res_eLOC1_flt;    ///< filtered parameter eLOC1 residual
-  std::vector<float> m_res_ePHI_flt;     ///< filtered parameter ePHI residual
-  std::vector<float> m_res_eTHETA_flt;   ///< filtered parameter eTHETA residual
-  std::vector<float> m_res_eQOP_flt;     ///< filtered parameter eQOP residual
-  std::vector<float> m_res_eT_flt;       ///< filtered parameter eT residual
-  std::vector<float> m_err_eLOC0_flt;    ///< filtered parameter eLOC0 error
-  std::vector<float> m_err_eLOC1_flt;    ///< filtered parameter eLOC1 error
-  std::vector<float> m_err_ePHI_flt;     ///< filtered parameter ePHI error
-  std::vector<float> m_err_eTHETA_flt;   ///< filtered parameter eTHETA error
-  std::vector<float> m_err_eQOP_flt;     ///< filtered parameter eQOP error
-  std::vector<float> m_err_eT_flt;       ///< filtered parameter eT error
-  std::vector<float> m_pull_eLOC0_flt;   ///< filtered parameter eLOC0 pull
-  std::vector<float> m_pull_eLOC1_flt;   ///< filtered parameter eLOC1 pull
-  std::vector<float> m_pull_ePHI_flt;    ///< filtered parameter ePHI pull
-  std::vector<float> m_pull_eTHETA_flt;  ///< filtered parameter eTHETA pull
-  std::vector<float> m_pull_eQOP_flt;    ///< filtered parameter eQOP pull
-  std::vector<float> m_pull_eT_flt;      ///< filtered parameter eT pull
-  std::vector<float> m_x_flt;            ///< filtered global x
-  std::vector<float> m_y_flt;            ///< filtered global y
-  std::vector<float> m_z_flt;            ///< filtered global z
-  std::vector<float> m_px_flt;           ///< filtered momentum px
-  std::vector<float> m_py_flt;           ///< filtered momentum py
-  std::vector<float> m_pz_flt;           ///< filtered momentum pz
-  std::vector<float> m_eta_flt;          ///< filtered momentum eta
-  std::vector<float> m_pT_flt;           ///< filtered momentum pT
-  std::vector<float> m_chi2;             ///< chisq from filtering
+  /// Branch buffers; one instance per output tree
+  struct Buffers
+  {
+    int eventNr{0};  ///< the event number
+    int trajNr{0};   ///< the trajectory number
+
+    unsigned long t_barcode{0};   ///< Truth particle barcode
+    int           t_charge{0};    ///< Truth particle charge
+    float         t_time{0};      ///< Truth particle time
+    float         t_vx{-99.};     ///< Truth particle vertex x
+    float         t_vy{-99.};     ///< Truth particle vertex y
+    float         t_vz{-99.};     ///< Truth particle vertex z
+    float         t_px{-99.};     ///< Truth particle initial momentum px
+    float         t_py{-99.};     ///< Truth particle initial momentum py
+    float         t_pz{-99.};     ///< Truth particle initial momentum pz
+    float         t_theta{-99.};  ///< Truth particle initial momentum theta
+    float         t_phi{-99.};    ///< Truth particle initial momentum phi
+    float         t_pT{-99.};     ///< Truth particle initial momentum pT
+    float         t_eta{-99.};    ///< Truth particle initial momentum eta
+
+    std::vector<float> t_x;    ///< Global truth hit position x
+    std::vector<float> t_y;    ///< Global truth hit position y
+    std::vector<float> t_z;    ///< Global truth hit position z
+    std::vector<float> t_r;    ///< Global truth hit position r
+    std::vector<float> t_dx;   ///< Truth particle direction x at the hit
+    std::vector<float> t_dy;   ///< Truth particle direction y at the hit
+    std::vector<float> t_dz;   ///< Truth particle direction z at the hit
+    ParameterVectors   t_par;  ///< Truth parameters at the hit
+
+    int nStates{0};        ///< number of all states
+    int nMeasurements{0};  ///< number of states with measurements
+
+    std::vector<int>   volumeID;    ///< volume identifier
+    std::vector<int>   layerID;     ///< layer identifier
+    std::vector<int>   moduleID;    ///< surface identifier
+    std::vector<float> lx_hit;      ///< uncalibrated measurement local x
+    std::vector<float> ly_hit;      ///< uncalibrated measurement local y
+    std::vector<float> x_hit;       ///< uncalibrated measurement global x
+    std::vector<float> y_hit;       ///< uncalibrated measurement global y
+    std::vector<float> z_hit;       ///< uncalibrated measurement global z
+    std::vector<float> res_x_hit;   ///< hit residual x
+    std::vector<float> res_y_hit;   ///< hit residual y
+    std::vector<float> err_x_hit;   ///< hit err x
+    std::vector<float> err_y_hit;   ///< hit err y
+    std::vector<float> pull_x_hit;  ///< hit pull x
+    std::vector<float> pull_y_hit;  ///< hit pull y
+    std::vector<int>   dim_hit;     ///< dimension of measurement
+
+    bool hasFittedParams{false};  ///< if the track has fitted parameter
+    std::array<float, Acts::BoundParsDim> fit;      ///< fitted parameters
+    std::array<float, Acts::BoundParsDim> err_fit;  ///< fitted parameter errors
+
+    StateParameters    prt;   ///< predicted parameters
+    StateParameters    flt;   ///< filtered parameters
+    StateParameters    smt;   ///< smoothed parameters
+    std::vector<float> chi2;  ///< chisq from filtering
+
+    /// Reset all values to prepare for the next trajectory.
+    void
+    clear();
+  };
 
-  int m_nSmoothed{0};              ///< number of states with smoothed parameter
-  std::vector<bool>  m_smt;        ///< smoothed status
-  std::vector<float> m_eLOC0_smt;  ///< smoothed parameter eLOC0
-  std::vector<float> m_eLOC1_smt;  ///< smoothed parameter eLOC1
-  std::vector<float> m_ePHI_smt;   ///< smoothed parameter ePHI
-  std::vector<float> m_eTHETA_smt;       ///< smoothed parameter eTHETA
-  std::vector<float> m_eQOP_smt;         ///< smoothed parameter eQOP
-  std::vector<float> m_eT_smt;           ///< smoothed parameter eT
-  std::vector<float> m_res_eLOC0_smt;    ///< smoothed parameter eLOC0 residual
-  std::vector<float> m_res_eLOC1_smt;    ///< smoothed parameter eLOC1 residual
-  std::vector<float> m_res_ePHI_smt;     ///< smoothed parameter ePHI residual
-  std::vector<float> m_res_eTHETA_smt;   ///< smoothed parameter eTHETA residual
-  std::vector<float> m_res_eQOP_smt;     ///< smoothed parameter eQOP residual
-  std::vector<float> m_res_eT_smt;       ///< smoothed parameter eT residual
-  std::vector<float> m_err_eLOC0_smt;    ///< smoothed parameter eLOC0 error
-  std::vector<float> m_err_eLOC1_smt;    ///< smoothed parameter eLOC1 error
-  std::vector<float> m_err_ePHI_smt;     ///< smoothed parameter ePHI error
-  std::vector<float> m_err_eTHETA_smt;   ///< smoothed parameter eTHETA error
-  std::vector<float> m_err_eQOP_smt;     ///< smoothed parameter eQOP error
-  std::vector<float> m_err_eT_smt;       ///< smoothed parameter eT error
-  std::vector<float> m_pull_eLOC0_smt;   ///< smoothed parameter eLOC0 pull
-  std::vector<float> m_pull_eLOC1_smt;   ///< smoothed parameter eLOC1 pull
-  std::vector<float> m_pull_ePHI_smt;    ///< smoothed parameter ePHI pull
-  std::vector<float> m_pull_eTHETA_smt;  ///< smoothed parameter eTHETA pull
-  std::vector<float> m_pull_eQOP_smt;    ///< smoothed parameter eQOP pull
-  std::vector<float> m_pull_eT_smt;      ///< smoothed parameter eT pull
-  std::vector<float> m_x_smt;            ///< smoothed global x
-  std::vector<float> m_y_smt;            ///< smoothed global y
-  std::vector<float> m_z_smt;            ///< smoothed global z
-  std::vector<float> m_px_smt;           ///< smoothed momentum px
-  std::vector<float> m_py_smt;           ///< smoothed momentum py
-  std::vector<float> m_pz_smt;           ///< smoothed momentum pz
-  std::vector<float> m_eta_smt;          ///< smoothed momentum eta
-  std::vector<float> m_pT_smt;           ///< smoothed momentum pT
+  /// Fill the branch buffers for a single trajectory.
+  ///
+  /// Only reads the configuration and can be called without the output lock.
+  ///
+  /// @return false if the trajectory should not be written
+  bool
+  fillTrajectory(const AlgorithmContext& ctx,
+                 const SimParticles&     particles,
+                 const TruthFitTrack&    traj,
+                 Buffers&                b) const;
+
+  Config                                   m_cfg;     ///< the configuration
+  std::unique_ptr<RootTreeOutput<Buffers>> m_output;  ///< the output tree(s)
 };
 
 }  // namespace FW
@@ -8,7 +8,7 @@
 
 #pragma once
 
-#include <mutex>
+#include <memory>
 #include <vector>
 
 #include <Acts/Propagator/MaterialInteractor.hpp>
@@ -19,14 +19,18 @@
 #include "ACTFW/Framework/IService.hpp"
 #include "ACTFW/Framework/ProcessCode.hpp"
 
-class TChain;
-
 namespace FW {
 
+template <typename buffers_t>
+class RootTreeInput;
+
 /// @class RootVertexAndTracksReader
 ///
 /// @brief Reads in vertex and tracks information from a root file
 /// and fills it into a format to be understood by the vertexing algorithms
+///
+/// Safe to use from multiple reader threads - each thread reads from its own
+/// chain without locking.
 class RootVertexAndTracksReader : public IReader
 {
 public:
@@ -39,6 +43,8 @@ public:
 
     unsigned int batchSize = 1;  ///!< Batch
 
+    long long cacheSize = 10 * 1024 * 1024;  ///< per-thread tree cache size
+
     /// The default logger
     std::shared_ptr<const Acts::Logger> logger;
 
@@ -87,29 +93,37 @@ private:
   /// The config class
   Config m_cfg;
 
-  /// mutex used to protect multi-threaded reads
-  std::mutex m_read_mutex;
-
   /// The number of events
   size_t m_events = 0;
 
-  /// The input tree name
-  TChain* m_inputChain = nullptr;
-
-  int m_eventNr = 0;
-
-  std::vector<double>*              m_ptrVx    = new std::vector<double>;
-  std::vector<double>*              m_ptrVy    = new std::vector<double>;
-  std::vector<double>*              m_ptrVz    = new std::vector<double>;
-  std::vector<double>*              m_ptrD0    = new std::vector<double>;
-  std::vector<double>*              m_ptrZ0    = new std::vector<double>;
-  std::vector<double>*              m_ptrPhi   = new std::vector<double>;
-  std::vector<double>*              m_ptrTheta = new std::vector<double>;
-  std::vector<double>*              m_ptrQP    = new std::vector<double>;
-  std::vector<double>*              m_ptrTime  = new std::vector<double>;
-  std::vector<int>*                 m_ptrVtxID = new std::vector<int>;
-  std::vector<std::vector<double>>* m_ptrTrkCov
-      = new std::vector<std::vector<double>>;
+  /// Branch buffers; one instance per reading thread
+  struct Buffers
+  {
+    int eventNr = 0;
+
+    std::vector<double>*              ptrVx    = new std::vector<double>;
+    std::vector<double>*              ptrVy    = new std::vector<double>;
+    std::vector<double>*              ptrVz    = new std::vector<double>;
+    std::vector<double>*              ptrD0    = new std::vector<double>;
+    std::vector<double>*              ptrZ0    = new std::vector<double>;
+    std::vector<double>*              ptrPhi   = new std::vector<double>;
+    std::vector<double>*              ptrTheta = new std::vector<double>;
+    std::vector<double>*              ptrQP    = new std::vector<double>;
+    std::vector<double>*              ptrTime  = new std::vector<double>;
+    std::vector<int>*                 ptrVtxID = new std::vector<int>;
+    std::vector<std::vector<double>>* ptrTrkCov
+        = new std::vector<std::vector<double>>;
+
+    Buffers() = default;
+    Buffers(const Buffers&) = delete;
+    Buffers&
+    operator=(const Buffers&)
+        = delete;
+    ~Buffers();
+  };
+
+  /// The per-thread input chains
+  std::unique_ptr<RootTreeInput<Buffers>> m_input;
 };
 
 }  // namespace FW
@@ -0,0 +1,19 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Io/Root/RootImplicitMT.hpp"
+
+#include <TROOT.h>
+
+void
+FW::enableRootImplicitMT(int numThreads)
+{
+  if (ROOT::IsImplicitMTEnabled()) { return; }
+  // zero lets ROOT choose the pool size
+  ROOT::EnableImplicitMT((0 < numThreads) ? numThreads : 0);
+}
@@ -13,58 +13,63 @@
 #include <iostream>
 
 #include "ACTFW/Framework/WhiteBoard.hpp"
+#include "RootTreeInput.hpp"
 
 FW::RootMaterialTrackReader::RootMaterialTrackReader(
     const FW::RootMaterialTrackReader::Config& cfg)
-  : FW::IReader(), m_cfg(cfg), m_events(0), m_inputChain(nullptr)
+  : FW::IReader(), m_cfg(cfg), m_events(0)
 {
-  m_inputChain = new TChain(m_cfg.treeName.c_str());
+  RootTreeInput<Buffers>::Config inputCfg;
+  inputCfg.treeName  = m_cfg.treeName;
+  inputCfg.fileList  = m_cfg.fileList;
+  inputCfg.cacheSize = m_cfg.cacheSize;
 
   // Set the branches
-  m_inputChain->SetBranchAddress("v_x", &m_v_x);
-  m_inputChain->SetBranchAddress("v_y", &m_v_y);
-  m_inputChain->SetBranchAddress("v_z", &m_v_z);
-  m_inputChain->SetBranchAddress("v_px", &m_v_px);
-  m_inputChain->SetBranchAddress("v_py", &m_v_py);
-  m_inputChain->SetBranchAddress("v_pz", &m_v_pz);
-  m_inputChain->SetBranchAddress("v_phi", &m_v_phi);
-  m_inputChain->SetBranchAddress("v_eta", &m_v_eta);
-  m_inputChain->SetBranchAddress("t_X0", &m_tX0);
-  m_inputChain->SetBranchAddress("t_L0", &m_tL0);
-  m_inputChain->SetBranchAddress("mat_x", &m_step_x);
-  m_inputChain->SetBranchAddress("mat_y", &m_step_y);
-  m_inputChain->SetBranchAddress("mat_z", &m_step_z);
-  m_inputChain->SetBranchAddress("mat_step_length", &m_step_length);
-  m_inputChain->SetBranchAddress("mat_X0", &m_step_X0);
-  m_inputChain->SetBranchAddress("mat_L0", &m_step_L0);
-  m_inputChain->SetBranchAddress("mat_A", &m_step_A);
-  m_inputChain->SetBranchAddress("mat_Z", &m_step_Z);
-  m_inputChain->SetBranchAddress("mat_rho", &m_step_rho);
-
-  // loop over the input files
+  auto book = [](TChain& chain, Buffers& b) {
+    chain.SetBranchAddress("v_x", &b.v_x);
+    chain.SetBranchAddress("v_y", &b.v_y);
+    chain.SetBranchAddress("v_z", &b.v_z);
+    chain.SetBranchAddress("v_px", &b.v_px);
+    chain.SetBranchAddress("v_py", &b.v_py);
+    chain.SetBranchAddress("v_pz", &b.v_pz);
+    chain.SetBranchAddress("v_phi", &b.v_phi);
+    chain.SetBranchAddress("v_eta", &b.v_eta);
+    chain.SetBranchAddress("t_X0", &b.tX0);
+    chain.SetBranchAddress("t_L0", &b.tL0);
+    chain.SetBranchAddress("mat_x", &b.step_x);
+    chain.SetBranchAddress("mat_y", &b.step_y);
+    chain.SetBranchAddress("mat_z", &b.step_z);
+    chain.SetBranchAddress("mat_step_length", &b.step_length);
+    chain.SetBranchAddress("mat_X0", &b.step_X0);
+    chain.SetBranchAddress("mat_L0", &b.step_L0);
+    chain.SetBranchAddress("mat_A", &b.step_A);
+    chain.SetBranchAddress("mat_Z", &b.step_Z);
+    chain.SetBranchAddress("mat_rho", &b.step_rho);
+  };
+
+  // each reading thread adds the input files to its own chain
   for (auto inputFile : m_cfg.fileList) {
-    // add file to the input chain
-    m_inputChain->Add(inputFile.c_str());
     ACTS_DEBUG("Adding File " << inputFile << " to tree '" << m_cfg.treeName
                               << "'.");
   }
-
-  m_events = m_inputChain->GetEntries();
+  m_input  = std::make_unique<RootTreeInput<Buffers>>(inputCfg, book);
+  m_events = m_input->numEntries();
   ACTS_DEBUG("The full chain has " << m_events << " entries.");
 }
 
-FW::RootMaterialTrackReader::~RootMaterialTrackReader()
-{
+FW::RootMaterialTrackReader::~RootMaterialTrackReader() = default;
 
-  delete m_step_x;
-  delete m_step_y;
-  delete m_step_z;
-  delete m_step_length;
-  delete m_step_X0;
-  delete m_step_L0;
-  delete m_step_A;
-  delete m_step_Z;
-  delete m_step_rho;
+FW::RootMaterialTrackReader::Buffers::~Buffers()
+{
+  delete step_x;
+  delete step_y;
+  delete step_z;
+  delete step_length;
+  delete step_X0;
+  delete step_L0;
+  delete step_A;
+  delete step_Z;
+  delete step_rho;
 }
 
 std::string
@@ -85,28 +90,26 @@ FW::RootMaterialTrackReader::read(const FW::AlgorithmContext& context)
 
   ACTS_DEBUG("Trying to read recorded material from tracks.");
   // read in the material track
-  if (m_inputChain && context.eventNumber < m_events) {
-    // lock the mutex
-    std::lock_guard<std::mutex> lock(m_read_mutex);
-    // now read
-
+  if (context.eventNumber < m_events) {
     // The collection to be written
     std::vector<Acts::RecordedMaterialTrack> mtrackCollection;
 
     for (size_t ib = 0; ib < m_cfg.batchSize; ++ib) {
 
       // Read the correct entry: batch size * event_number + ib
-      m_inputChain->GetEntry(m_cfg.batchSize * context.eventNumber + ib);
+      // into the buffers of this thread; no lock is needed
+      const Buffers& b
+          = m_input->read(m_cfg.batchSize * context.eventNumber + ib);
       ACTS_VERBOSE("Reading entry: " << m_cfg.batchSize * context.eventNumber
                        + ib);
 
       Acts::RecordedMaterialTrack rmTrack;
       // Fill the position and momentum
-      rmTrack.first.first  = Acts::Vector3D(m_v_x, m_v_y, m_v_z);
-      rmTrack.first.second = Acts::Vector3D(m_v_px, m_v_py, m_v_pz);
+      rmTrack.first.first  = Acts::Vector3D(b.v_x, b.v_y, b.v_z);
+      rmTrack.first.second = Acts::Vector3D(b.v_px, b.v_py, b.v_pz);
 
       // Fill the individual steps
-      size_t msteps = m_step_length->size();
+      size_t msteps = b.step_length->size();
       ACTS_VERBOSE("Reading " << msteps << " material steps.");
       rmTrack.second.materialInteractions.reserve(msteps);
       rmTrack.second.materialInX0 = 0.;
@@ -114,9 +117,9 @@ FW::RootMaterialTrackReader::read(const FW::AlgorithmContext& context)
 
       for (size_t is = 0; is < msteps; ++is) {
 
-        double mX0 = (*m_step_X0)[is];
-        double mL0 = (*m_step_L0)[is];
-        double s   = (*m_step_length)[is];
+        double mX0 = (*b.step_X0)[is];
+        double mL0 = (*b.step_L0)[is];
+        double s   = (*b.step_length)[is];
 
         rmTrack.second.materialInX0 += s / mX0;
         rmTrack.second.materialInL0 += s / mL0;
@@ -124,9 +127,9 @@ FW::RootMaterialTrackReader::read(const FW::AlgorithmContext& context)
         /// Fill the position & the material
         Acts::MaterialInteraction mInteraction;
         mInteraction.position
-            = Acts::Vector3D((*m_step_x)[is], (*m_step_y)[is], (*m_step_z)[is]);
+            = Acts::Vector3D((*b.step_x)[is], (*b.step_y)[is], (*b.step_z)[is]);
         mInteraction.materialProperties = Acts::MaterialProperties(
-            mX0, mL0, (*m_step_A)[is], (*m_step_Z)[is], (*m_step_rho)[is], s);
+            mX0, mL0, (*b.step_A)[is], (*b.step_Z)[is], (*b.step_rho)[is], s);
         rmTrack.second.materialInteractions.push_back(std::move(mInteraction));
       }
       mtrackCollection.push_back(std::move(rmTrack));
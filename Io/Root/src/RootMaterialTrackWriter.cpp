@@ -8,8 +8,6 @@
 
 #include "ACTFW/Io/Root/RootMaterialTrackWriter.hpp"
 
-#include <ios>
-#include <iostream>
 #include <stdexcept>
 
 #include <Acts/Geometry/GeometryID.hpp>
@@ -19,6 +17,8 @@
 #include <TFile.h>
 #include <TTree.h>
 
+#include "RootTreeOutput.hpp"
+
 using Acts::VectorHelpers::eta;
 using Acts::VectorHelpers::perp;
 using Acts::VectorHelpers::phi;
@@ -28,7 +28,6 @@ FW::RootMaterialTrackWriter::RootMaterialTrackWriter(
     Acts::Logging::Level                       level)
   : WriterT(cfg.collection, "RootMaterialTrackWriter", level)
   , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.collection.empty()) {
@@ -38,69 +37,66 @@ FW::RootMaterialTrackWriter::RootMaterialTrackWriter(
   }
 
   // Setup ROOT I/O
-  if (m_outputFile == nullptr) {
-    m_outputFile = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
-    if (m_outputFile == nullptr) {
-      throw std::ios_base::failure("Could not open '" + m_cfg.filePath);
-    }
-  }
-  m_outputFile->cd();
-  m_outputTree
-      = new TTree(m_cfg.treeName.c_str(), "TTree from RootMaterialTrackWriter");
-  if (m_outputTree == nullptr) throw std::bad_alloc();
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = m_cfg.filePath;
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.treeName;
+  outputCfg.treeTitle = "TTree from RootMaterialTrackWriter";
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.ntuple    = m_cfg.ntupleOutput;
 
   // Set the branches
-  m_outputTree->Branch("v_x", &m_v_x);
-  m_outputTree->Branch("v_y", &m_v_y);
-  m_outputTree->Branch("v_z", &m_v_z);
-  m_outputTree->Branch("v_px", &m_v_px);
-  m_outputTree->Branch("v_py", &m_v_py);
-  m_outputTree->Branch("v_pz", &m_v_pz);
-  m_outputTree->Branch("v_phi", &m_v_phi);
-  m_outputTree->Branch("v_eta", &m_v_eta);
-  m_outputTree->Branch("t_X0", &m_tX0);
-  m_outputTree->Branch("t_L0", &m_tL0);
-  m_outputTree->Branch("mat_x", &m_step_x);
-  m_outputTree->Branch("mat_y", &m_step_y);
-  m_outputTree->Branch("mat_z", &m_step_z);
-  m_outputTree->Branch("mat_step_length", &m_step_length);
-  m_outputTree->Branch("mat_X0", &m_step_X0);
-  m_outputTree->Branch("mat_L0", &m_step_L0);
-  m_outputTree->Branch("mat_A", &m_step_A);
-  m_outputTree->Branch("mat_Z", &m_step_Z);
-  m_outputTree->Branch("mat_rho", &m_step_rho);
+  auto book = [this](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("v_x", &b.v_x);
+    tree.Branch("v_y", &b.v_y);
+    tree.Branch("v_z", &b.v_z);
+    tree.Branch("v_px", &b.v_px);
+    tree.Branch("v_py", &b.v_py);
+    tree.Branch("v_pz", &b.v_pz);
+    tree.Branch("v_phi", &b.v_phi);
+    tree.Branch("v_eta", &b.v_eta);
+    tree.Branch("t_X0", &b.tX0);
+    tree.Branch("t_L0", &b.tL0);
+    tree.Branch("mat_x", &b.step_x);
+    tree.Branch("mat_y", &b.step_y);
+    tree.Branch("mat_z", &b.step_z);
+    tree.Branch("mat_step_length", &b.step_length);
+    tree.Branch("mat_X0", &b.step_X0);
+    tree.Branch("mat_L0", &b.step_L0);
+    tree.Branch("mat_A", &b.step_A);
+    tree.Branch("mat_Z", &b.step_Z);
+    tree.Branch("mat_rho", &b.step_rho);
 
-  if (m_cfg.prePostStep) {
-    m_outputTree->Branch("mat_sx", &m_step_sx);
-    m_outputTree->Branch("mat_sy", &m_step_sy);
-    m_outputTree->Branch("mat_sz", &m_step_sz);
-    m_outputTree->Branch("mat_ex", &m_step_ex);
-    m_outputTree->Branch("mat_ey", &m_step_ey);
-    m_outputTree->Branch("mat_ez", &m_step_ez);
-  }
-  if (m_cfg.storesurface) {
-    m_outputTree->Branch("sur_id", &m_sur_id);
-    m_outputTree->Branch("sur_type", &m_sur_type);
-    m_outputTree->Branch("sur_x", &m_sur_x);
-    m_outputTree->Branch("sur_y", &m_sur_y);
-    m_outputTree->Branch("sur_z", &m_sur_z);
-    m_outputTree->Branch("sur_range_min", &m_sur_range_min);
-    m_outputTree->Branch("sur_range_max", &m_sur_range_max);
-  }
+    if (m_cfg.prePostStep) {
+      tree.Branch("mat_sx", &b.step_sx);
+      tree.Branch("mat_sy", &b.step_sy);
+      tree.Branch("mat_sz", &b.step_sz);
+      tree.Branch("mat_ex", &b.step_ex);
+      tree.Branch("mat_ey", &b.step_ey);
+      tree.Branch("mat_ez", &b.step_ez);
+    }
+    if (m_cfg.storesurface) {
+      tree.Branch("sur_id", &b.sur_id);
+      tree.Branch("sur_type", &b.sur_type);
+      tree.Branch("sur_x", &b.sur_x);
+      tree.Branch("sur_y", &b.sur_y);
+      tree.Branch("sur_z", &b.sur_z);
+      tree.Branch("sur_range_min", &b.sur_range_min);
+      tree.Branch("sur_range_max", &b.sur_range_max);
+    }
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
-FW::RootMaterialTrackWriter::~RootMaterialTrackWriter()
-{
-  m_outputFile->Close();
-}
+// the output closes the file if it's ours
+FW::RootMaterialTrackWriter::~RootMaterialTrackWriter() = default;
 
 FW::ProcessCode
 FW::RootMaterialTrackWriter::endRun()
 {
   // write the tree and close the file
   ACTS_INFO("Writing ROOT output File : " << m_cfg.filePath);
-  m_outputFile->cd();
-  m_outputTree->Write();
+  m_output->write();
   return FW::ProcessCode::SUCCESS;
 }
 
@@ -110,99 +106,100 @@ FW::RootMaterialTrackWriter::writeT(
     const std::vector<Acts::RecordedMaterialTrack>& materialTracks)
 {
   // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
 
   // Loop over the material tracks and write them out
   for (auto& mtrack : materialTracks) {
 
     // Clearing the vector first
-    m_step_sx.clear();
-    m_step_sy.clear();
-    m_step_sz.clear();
-    m_step_x.clear();
-    m_step_y.clear();
-    m_step_z.clear();
-    m_step_ex.clear();
-    m_step_ey.clear();
-    m_step_ez.clear();
-    m_step_length.clear();
-    m_step_X0.clear();
-    m_step_L0.clear();
-    m_step_A.clear();
-    m_step_Z.clear();
-    m_step_rho.clear();
+    b.step_sx.clear();
+    b.step_sy.clear();
+    b.step_sz.clear();
+    b.step_x.clear();
+    b.step_y.clear();
+    b.step_z.clear();
+    b.step_ex.clear();
+    b.step_ey.clear();
+    b.step_ez.clear();
+    b.step_length.clear();
+    b.step_X0.clear();
+    b.step_L0.clear();
+    b.step_A.clear();
+    b.step_Z.clear();
+    b.step_rho.clear();
 
-    m_sur_id.clear();
-    m_sur_type.clear();
-    m_sur_x.clear();
-    m_sur_y.clear();
-    m_sur_z.clear();
-    m_sur_range_min.clear();
-    m_sur_range_max.clear();
+    b.sur_id.clear();
+    b.sur_type.clear();
+    b.sur_x.clear();
+    b.sur_y.clear();
+    b.sur_z.clear();
+    b.sur_range_min.clear();
+    b.sur_range_max.clear();
 
     // Reserve the vector then
     size_t mints = mtrack.second.materialInteractions.size();
-    m_step_sx.reserve(mints);
-    m_step_sy.reserve(mints);
-    m_step_sz.reserve(mints);
-    m_step_x.reserve(mints);
-    m_step_y.reserve(mints);
-    m_step_ez.reserve(mints);
-    m_step_ex.reserve(mints);
-    m_step_ey.reserve(mints);
-    m_step_ez.reserve(mints);
-    m_step_length.reserve(mints);
-    m_step_X0.reserve(mints);
-    m_step_L0.reserve(mints);
-    m_step_A.reserve(mints);
-    m_step_Z.reserve(mints);
-    m_step_rho.reserve(mints);
+    b.step_sx.reserve(mints);
+    b.step_sy.reserve(mints);
+    b.step_sz.reserve(mints);
+    b.step_x.reserve(mints);
+    b.step_y.reserve(mints);
+    b.step_z.reserve(mints);
+    b.step_ex.reserve(mints);
+    b.step_ey.reserve(mints);
+    b.step_ez.reserve(mints);
+    b.step_length.reserve(mints);
+    b.step_X0.reserve(mints);
+    b.step_L0.reserve(mints);
+    b.step_A.reserve(mints);
+    b.step_Z.reserve(mints);
+    b.step_rho.reserve(mints);
 
-    m_sur_id.reserve(mints);
-    m_sur_type.reserve(mints);
-    m_sur_x.reserve(mints);
-    m_sur_y.reserve(mints);
-    m_sur_z.reserve(mints);
-    m_sur_range_min.reserve(mints);
-    m_sur_range_max.reserve(mints);
+    b.sur_id.reserve(mints);
+    b.sur_type.reserve(mints);
+    b.sur_x.reserve(mints);
+    b.sur_y.reserve(mints);
+    b.sur_z.reserve(mints);
+    b.sur_range_min.reserve(mints);
+    b.sur_range_max.reserve(mints);
 
     // reset the global counter
     if (m_cfg.recalculateTotals) {
-      m_tX0 = 0.;
-      m_tL0 = 0.;
+      b.tX0 = 0.;
+      b.tL0 = 0.;
     } else {
-      m_tX0 = mtrack.second.materialInX0;
-      m_tL0 = mtrack.second.materialInL0;
+      b.tX0 = mtrack.second.materialInX0;
+      b.tL0 = mtrack.second.materialInL0;
     }
 
     // set the track information at vertex
-    m_v_x   = mtrack.first.first.x();
-    m_v_y   = mtrack.first.first.y();
-    m_v_z   = mtrack.first.first.z();
-    m_v_px  = mtrack.first.second.x();
-    m_v_py  = mtrack.first.second.y();
-    m_v_pz  = mtrack.first.second.z();
-    m_v_phi = phi(mtrack.first.second);
-    m_v_eta = eta(mtrack.first.second);
+    b.v_x   = mtrack.first.first.x();
+    b.v_y   = mtrack.first.first.y();
+    b.v_z   = mtrack.first.first.z();
+    b.v_px  = mtrack.first.second.x();
+    b.v_py  = mtrack.first.second.y();
+    b.v_pz  = mtrack.first.second.z();
+    b.v_phi = phi(mtrack.first.second);
+    b.v_eta = eta(mtrack.first.second);
 
     // an now loop over the material
     for (auto& mint : mtrack.second.materialInteractions) {
       // The material step position information
-      m_step_x.push_back(mint.position.x());
-      m_step_y.push_back(mint.position.y());
-      m_step_z.push_back(mint.position.z());
+      b.step_x.push_back(mint.position.x());
+      b.step_y.push_back(mint.position.y());
+      b.step_z.push_back(mint.position.z());
 
       if (m_cfg.prePostStep) {
         Acts::Vector3D prePos
             = mint.position - 0.5 * mint.pathCorrection * mint.direction;
         Acts::Vector3D posPos
             = mint.position + 0.5 * mint.pathCorrection * mint.direction;
-        m_step_sx.push_back(prePos.x());
-        m_step_sy.push_back(prePos.y());
-        m_step_sz.push_back(prePos.z());
-        m_step_ex.push_back(posPos.x());
-        m_step_ey.push_back(posPos.y());
-        m_step_ez.push_back(posPos.z());
+        b.step_sx.push_back(prePos.x());
+        b.step_sy.push_back(prePos.y());
+        b.step_sz.push_back(prePos.z());
+        b.step_ex.push_back(posPos.x());
+        b.step_ey.push_back(posPos.y());
+        b.step_ez.push_back(posPos.z());
       }
 
       if (m_cfg.storesurface) {
@@ -212,11 +209,11 @@ FW::RootMaterialTrackWriter::writeT(
           Acts::Intersection intersection = surface->intersectionEstimate(
               ctx.geoContext, mint.position, mint.direction, true);
           layerID = surface->geoID();
-          m_sur_id.push_back(layerID.value());
-          m_sur_type.push_back(surface->type());
-          m_sur_x.push_back(intersection.position.x());
-          m_sur_y.push_back(intersection.position.y());
-          m_sur_z.push_back(intersection.position.z());
+          b.sur_id.push_back(layerID.value());
+          b.sur_type.push_back(surface->type());
+          b.sur_x.push_back(intersection.position.x());
+          b.sur_y.push_back(intersection.position.y());
+          b.sur_z.push_back(intersection.position.z());
 
           const Acts::SurfaceBounds& surfaceBounds = surface->bounds();
 
@@ -226,14 +223,14 @@ FW::RootMaterialTrackWriter::writeT(
               = dynamic_cast<const Acts::CylinderBounds*>(&surfaceBounds);
 
           if (radialBounds) {
-            m_sur_range_min.push_back(radialBounds->rMin());
-            m_sur_range_max.push_back(radialBounds->rMax());
+            b.sur_range_min.push_back(radialBounds->rMin());
+            b.sur_range_max.push_back(radialBounds->rMax());
           } else if (cylinderBounds) {
-            m_sur_range_min.push_back(-1 * cylinderBounds->halflengthZ());
-            m_sur_range_max.push_back(cylinderBounds->halflengthZ());
+            b.sur_range_min.push_back(-1 * cylinderBounds->halflengthZ());
+            b.sur_range_max.push_back(cylinderBounds->halflengthZ());
           } else {
-            m_sur_range_min.push_back(0);
-            m_sur_range_max.push_back(0);
+            b.sur_range_min.push_back(0);
+            b.sur_range_max.push_back(0);
           }
         } else {
           layerID.setVolume(0);
@@ -241,33 +238,33 @@ FW::RootMaterialTrackWriter::writeT(
           layerID.setLayer(0);
           layerID.setApproach(0);
           layerID.setSensitive(0);
-          m_sur_id.push_back(layerID.value());
-          m_sur_type.push_back(-1);
+          b.sur_id.push_back(layerID.value());
+          b.sur_type.push_back(-1);
 
-          m_sur_x.push_back(0);
-          m_sur_y.push_back(0);
-          m_sur_z.push_back(0);
-          m_sur_range_min.push_back(0);
-          m_sur_range_max.push_back(0);
+          b.sur_x.push_back(0);
+          b.sur_y.push_back(0);
+          b.sur_z.push_back(0);
+          b.sur_range_min.push_back(0);
+          b.sur_range_max.push_back(0);
         }
       }
 
       // the material information
       const auto& mprops = mint.materialProperties;
-      m_step_length.push_back(mprops.thickness());
-      m_step_X0.push_back(mprops.material().X0());
-      m_step_L0.push_back(mprops.material().L0());
-      m_step_A.push_back(mprops.material().Ar());
-      m_step_Z.push_back(mprops.material().Z());
-      m_step_rho.push_back(mprops.material().massDensity());
+      b.step_length.push_back(mprops.thickness());
+      b.step_X0.push_back(mprops.material().X0());
+      b.step_L0.push_back(mprops.material().L0());
+      b.step_A.push_back(mprops.material().Ar());
+      b.step_Z.push_back(mprops.material().Z());
+      b.step_rho.push_back(mprops.material().massDensity());
       // re-calculate if defined to do so
       if (m_cfg.recalculateTotals) {
-        m_tX0 += mprops.thicknessInX0();
-        m_tL0 += mprops.thicknessInL0();
+        b.tX0 += mprops.thicknessInX0();
+        b.tL0 += mprops.thicknessInL0();
       }
     }
     // write to
-    m_outputTree->Fill();
+    output.fill();
   }
 
   // return success
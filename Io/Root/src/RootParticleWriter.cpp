@@ -16,6 +16,8 @@
 #include <TFile.h>
 #include <TTree.h>
 
+#include "RootTreeOutput.hpp"
+
 using Acts::VectorHelpers::eta;
 using Acts::VectorHelpers::perp;
 using Acts::VectorHelpers::phi;
@@ -23,9 +25,7 @@ using Acts::VectorHelpers::phi;
 FW::RootParticleWriter::RootParticleWriter(
     const FW::RootParticleWriter::Config& cfg,
     Acts::Logging::Level                  level)
-  : WriterT(cfg.collection, "RootParticleWriter", level)
-  , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
+  : WriterT(cfg.collection, "RootParticleWriter", level), m_cfg(cfg)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.collection.empty()) {
@@ -35,55 +35,49 @@ FW::RootParticleWriter::RootParticleWriter(
   }
 
   // Setup ROOT I/O
-  if (m_outputFile == nullptr) {
-    m_outputFile = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
-    if (m_outputFile == nullptr) {
-      throw std::ios_base::failure("Could not open '" + m_cfg.filePath);
-    }
-  }
-  m_outputFile->cd();
-  m_outputTree = new TTree(m_cfg.treeName.c_str(), m_cfg.treeName.c_str());
-  if (m_outputTree == nullptr)
-    throw std::bad_alloc();
-  else {
-    // I/O parameters
-    m_outputTree->Branch("event_nr", &m_eventNr);
-    m_outputTree->Branch("eta", &m_eta);
-    m_outputTree->Branch("phi", &m_phi);
-    m_outputTree->Branch("vx", &m_vx);
-    m_outputTree->Branch("vy", &m_vy);
-    m_outputTree->Branch("vz", &m_vz);
-    m_outputTree->Branch("vt", &m_vt);
-    m_outputTree->Branch("px", &m_px);
-    m_outputTree->Branch("py", &m_py);
-    m_outputTree->Branch("pz", &m_pz);
-    m_outputTree->Branch("pt", &m_pT);
-    m_outputTree->Branch("charge", &m_charge);
-    m_outputTree->Branch("mass", &m_mass);
-    m_outputTree->Branch("pdg", &m_pdgCode);
-    m_outputTree->Branch("barcode", &m_barcode, "barcode/l");
-    m_outputTree->Branch("vertex_primary", &m_vertexPrimary);
-    m_outputTree->Branch("vertex_secondary", &m_vertexSecondary);
-    m_outputTree->Branch("particle", &m_particle);
-    m_outputTree->Branch("parent_particle", &m_parentParticle);
-    m_outputTree->Branch("process", &m_process);
-  }
-}
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = m_cfg.filePath;
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.treeName;
+  outputCfg.treeTitle = m_cfg.treeName;
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.parallel  = m_cfg.parallelOutput;
 
-FW::RootParticleWriter::~RootParticleWriter()
-{
-  if (m_outputFile) { m_outputFile->Close(); }
+  // I/O parameters
+  auto book = [](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("event_nr", &b.eventNr);
+    tree.Branch("eta", &b.eta);
+    tree.Branch("phi", &b.phi);
+    tree.Branch("vx", &b.vx);
+    tree.Branch("vy", &b.vy);
+    tree.Branch("vz", &b.vz);
+    tree.Branch("vt", &b.vt);
+    tree.Branch("px", &b.px);
+    tree.Branch("py", &b.py);
+    tree.Branch("pz", &b.pz);
+    tree.Branch("pt", &b.pT);
+    tree.Branch("charge", &b.charge);
+    tree.Branch("mass", &b.mass);
+    tree.Branch("pdg", &b.pdgCode);
+    tree.Branch("barcode", &b.barcode, "barcode/l");
+    tree.Branch("vertex_primary", &b.vertexPrimary);
+    tree.Branch("vertex_secondary", &b.vertexSecondary);
+    tree.Branch("particle", &b.particle);
+    tree.Branch("parent_particle", &b.parentParticle);
+    tree.Branch("process", &b.process);
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
+// the output closes the file if it's ours
+FW::RootParticleWriter::~RootParticleWriter() = default;
+
 FW::ProcessCode
 FW::RootParticleWriter::endRun()
 {
-  if (m_outputFile) {
-    m_outputFile->cd();
-    m_outputTree->Write();
-    ACTS_INFO("Wrote particles to tree '" << m_cfg.treeName << "' in '"
-                                          << m_cfg.filePath << "'");
-  }
+  m_output->write();
+  ACTS_INFO("Wrote particles to tree '" << m_cfg.treeName << "' in '"
+                                        << m_cfg.filePath << "'");
   return ProcessCode::SUCCESS;
 }
 
@@ -91,41 +85,39 @@ FW::ProcessCode
 FW::RootParticleWriter::writeT(const AlgorithmContext&             context,
                                const std::vector<Data::SimVertex>& vertices)
 {
-
-  if (m_outputFile == nullptr) return ProcessCode::SUCCESS;
-
   // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
 
   // Get the event number
-  m_eventNr = context.eventNumber;
+  b.eventNr = context.eventNumber;
 
   // loop over the process vertices
   for (auto& vertex : vertices) {
     for (auto& particle : vertex.outgoing) {
       // collect the information
-      m_vx      = particle.position().x();
-      m_vy      = particle.position().y();
-      m_vz      = particle.position().z();
-      m_vt      = particle.time() / Acts::UnitConstants::ns;
-      m_eta     = eta(particle.momentum());
-      m_phi     = phi(particle.momentum());
-      m_px      = particle.momentum().x();
-      m_py      = particle.momentum().y();
-      m_pz      = particle.momentum().z();
-      m_pT      = perp(particle.momentum());
-      m_charge  = particle.q();
-      m_mass    = particle.m();
-      m_pdgCode = particle.pdg();
+      b.vx      = particle.position().x();
+      b.vy      = particle.position().y();
+      b.vz      = particle.position().z();
+      b.vt      = particle.time() / Acts::UnitConstants::ns;
+      b.eta     = eta(particle.momentum());
+      b.phi     = phi(particle.momentum());
+      b.px      = particle.momentum().x();
+      b.py      = particle.momentum().y();
+      b.pz      = particle.momentum().z();
+      b.pT      = perp(particle.momentum());
+      b.charge  = particle.q();
+      b.mass    = particle.m();
+      b.pdgCode = particle.pdg();
       // store encoded barcode
-      m_barcode = particle.barcode().value();
+      b.barcode = particle.barcode().value();
       // store decoded barcode components
-      m_vertexPrimary   = particle.barcode().vertexPrimary();
-      m_vertexSecondary = particle.barcode().vertexSecondary();
-      m_particle        = particle.barcode().particle();
-      m_parentParticle  = particle.barcode().parentParticle();
-      m_process         = particle.barcode().process();
-      m_outputTree->Fill();
+      b.vertexPrimary   = particle.barcode().vertexPrimary();
+      b.vertexSecondary = particle.barcode().vertexSecondary();
+      b.particle        = particle.barcode().particle();
+      b.parentParticle  = particle.barcode().parentParticle();
+      b.process         = particle.barcode().process();
+      output.fill();
     }
   }
 
@@ -8,7 +8,6 @@
 
 #include "ACTFW/Io/Root/RootPlanarClusterWriter.hpp"
 
-#include <ios>
 #include <stdexcept>
 
 #include <Acts/Plugins/Digitization/DigitizationModule.hpp>
@@ -25,13 +24,13 @@
 #include "ACTFW/EventData/SimVertex.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "RootTreeOutput.hpp"
 
 FW::RootPlanarClusterWriter::RootPlanarClusterWriter(
     const FW::RootPlanarClusterWriter::Config& cfg,
     Acts::Logging::Level                       level)
   : WriterT(cfg.collection, "RootPlanarClusterWriter", level)
   , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.collection.empty()) {
@@ -41,56 +40,52 @@ FW::RootPlanarClusterWriter::RootPlanarClusterWriter(
   }
 
   // Setup ROOT I/O
-  if (m_outputFile == nullptr) {
-    m_outputFile = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
-    if (m_outputFile == nullptr) {
-      throw std::ios_base::failure("Could not open '" + m_cfg.filePath);
-    }
-  }
-  m_outputFile->cd();
-  m_outputTree
-      = new TTree(m_cfg.treeName.c_str(), "TTree from RootPlanarClusterWriter");
-  if (m_outputTree == nullptr) throw std::bad_alloc();
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = m_cfg.filePath;
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.treeName;
+  outputCfg.treeTitle = "TTree from RootPlanarClusterWriter";
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.parallel  = m_cfg.parallelOutput;
 
   // Set the branches
-  m_outputTree->Branch("event_nr", &m_eventNr);
-  m_outputTree->Branch("volume_id", &m_volumeID);
-  m_outputTree->Branch("layer_id", &m_layerID);
-  m_outputTree->Branch("surface_id", &m_surfaceID);
-  m_outputTree->Branch("g_x", &m_x);
-  m_outputTree->Branch("g_y", &m_y);
-  m_outputTree->Branch("g_z", &m_z);
-  m_outputTree->Branch("g_t", &m_t);
-  m_outputTree->Branch("l_x", &m_lx);
-  m_outputTree->Branch("l_y", &m_ly);
-  m_outputTree->Branch("cov_l_x", &m_cov_lx);
-  m_outputTree->Branch("cov_l_y", &m_cov_ly);
-  m_outputTree->Branch("cell_ID_x", &m_cell_IDx);
-  m_outputTree->Branch("cell_ID_y", &m_cell_IDy);
-  m_outputTree->Branch("cell_l_x", &m_cell_lx);
-  m_outputTree->Branch("cell_l_y", &m_cell_ly);
-  m_outputTree->Branch("cell_data", &m_cell_data);
-  m_outputTree->Branch("truth_g_x", &m_t_gx);
-  m_outputTree->Branch("truth_g_y", &m_t_gy);
-  m_outputTree->Branch("truth_g_z", &m_t_gz);
-  m_outputTree->Branch("truth_g_t", &m_t_gt);
-  m_outputTree->Branch("truth_l_x", &m_t_lx);
-  m_outputTree->Branch("truth_l_y", &m_t_ly);
-  m_outputTree->Branch("truth_barcode", &m_t_barcode, "truth_barcode/l");
+  auto book = [](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("event_nr", &b.eventNr);
+    tree.Branch("volume_id", &b.volumeID);
+    tree.Branch("layer_id", &b.layerID);
+    tree.Branch("surface_id", &b.surfaceID);
+    tree.Branch("g_x", &b.x);
+    tree.Branch("g_y", &b.y);
+    tree.Branch("g_z", &b.z);
+    tree.Branch("g_t", &b.t);
+    tree.Branch("l_x", &b.lx);
+    tree.Branch("l_y", &b.ly);
+    tree.Branch("cov_l_x", &b.cov_lx);
+    tree.Branch("cov_l_y", &b.cov_ly);
+    tree.Branch("cell_ID_x", &b.cell_IDx);
+    tree.Branch("cell_ID_y", &b.cell_IDy);
+    tree.Branch("cell_l_x", &b.cell_lx);
+    tree.Branch("cell_l_y", &b.cell_ly);
+    tree.Branch("cell_data", &b.cell_data);
+    tree.Branch("truth_g_x", &b.t_gx);
+    tree.Branch("truth_g_y", &b.t_gy);
+    tree.Branch("truth_g_z", &b.t_gz);
+    tree.Branch("truth_g_t", &b.t_gt);
+    tree.Branch("truth_l_x", &b.t_lx);
+    tree.Branch("truth_l_y", &b.t_ly);
+    tree.Branch("truth_barcode", &b.t_barcode, "truth_barcode/l");
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
-FW::RootPlanarClusterWriter::~RootPlanarClusterWriter()
-{
-  /// Close the file if it's yours
-  if (m_cfg.rootFile == nullptr) { m_outputFile->Close(); }
-}
+// the output closes the file if it's ours
+FW::RootPlanarClusterWriter::~RootPlanarClusterWriter() = default;
 
 FW::ProcessCode
 FW::RootPlanarClusterWriter::endRun()
 {
   // Write the tree
-  m_outputFile->cd();
-  m_outputTree->Write();
+  m_output->write();
   ACTS_INFO("Wrote particles to tree '" << m_cfg.treeName << "' in '"
                                         << m_cfg.filePath << "'");
   return ProcessCode::SUCCESS;
@@ -102,9 +97,10 @@ FW::RootPlanarClusterWriter::writeT(
     const FW::GeometryIdMultimap<Acts::PlanarModuleCluster>& clusters)
 {
   // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
   // Get the event number
-  m_eventNr = context.eventNumber;
+  b.eventNr = context.eventNumber;
 
   // Loop over the planar clusters in this event
   for (const auto& entry : clusters) {
@@ -123,26 +119,26 @@ FW::RootPlanarClusterWriter::writeT(
     // transform local into global position information
     clusterSurface.localToGlobal(context.geoContext, local, mom, pos);
     // identification
-    m_volumeID  = geoId.volume();
-    m_layerID   = geoId.layer();
-    m_surfaceID = geoId.sensitive();
-    m_x         = pos.x();
-    m_y         = pos.y();
-    m_z         = pos.z();
-    m_t         = parameters[2] / Acts::UnitConstants::ns;
-    m_lx        = local.x();
-    m_ly        = local.y();
-    m_cov_lx    = 0.;  // @todo fill in
-    m_cov_ly    = 0.;  // @todo fill in
+    b.volumeID  = geoId.volume();
+    b.layerID   = geoId.layer();
+    b.surfaceID = geoId.sensitive();
+    b.x         = pos.x();
+    b.y         = pos.y();
+    b.z         = pos.z();
+    b.t         = parameters[2] / Acts::UnitConstants::ns;
+    b.lx        = local.x();
+    b.ly        = local.y();
+    b.cov_lx    = 0.;  // @todo fill in
+    b.cov_ly    = 0.;  // @todo fill in
     // get the cells and run through them
     const auto& cells    = cluster.digitizationCells();
     auto detectorElement = dynamic_cast<const Acts::IdentifiedDetectorElement*>(
         clusterSurface.associatedDetectorElement());
     for (auto& cell : cells) {
       // cell identification
-      m_cell_IDx.push_back(cell.channel0);
-      m_cell_IDy.push_back(cell.channel1);
-      m_cell_data.push_back(cell.data);
+      b.cell_IDx.push_back(cell.channel0);
+      b.cell_IDy.push_back(cell.channel1);
+      b.cell_data.push_back(cell.data);
       // for more we need the digitization module
       if (detectorElement && detectorElement->digitizationModule()) {
         auto digitationModule = detectorElement->digitizationModule();
@@ -150,8 +146,8 @@ FW::RootPlanarClusterWriter::writeT(
             = digitationModule->segmentation();
         // get the cell positions
         auto cellLocalPosition = segmentation.cellPosition(cell);
-        m_cell_lx.push_back(cellLocalPosition.x());
-        m_cell_ly.push_back(cellLocalPosition.y());
+        b.cell_lx.push_back(cellLocalPosition.x());
+        b.cell_ly.push_back(cellLocalPosition.y());
       }
     }
     // get the truth parameters
@@ -168,29 +164,29 @@ FW::RootPlanarClusterWriter::writeT(
       clusterSurface.globalToLocal(
           context.geoContext, sPosition, sMomentum, lPosition);
       // fill the variables
-      m_t_gx.push_back(sPosition.x());
-      m_t_gy.push_back(sPosition.y());
-      m_t_gz.push_back(sPosition.z());
-      m_t_gt.push_back(sParticle->time());
-      m_t_lx.push_back(lPosition.x());
-      m_t_ly.push_back(lPosition.y());
-      m_t_barcode.push_back(sParticle->barcode().value());
+      b.t_gx.push_back(sPosition.x());
+      b.t_gy.push_back(sPosition.y());
+      b.t_gz.push_back(sPosition.z());
+      b.t_gt.push_back(sParticle->time());
+      b.t_lx.push_back(lPosition.x());
+      b.t_ly.push_back(lPosition.y());
+      b.t_barcode.push_back(sParticle->barcode().value());
     }
     // fill the tree
-    m_outputTree->Fill();
+    output.fill();
     // now reset
-    m_cell_IDx.clear();
-    m_cell_IDy.clear();
-    m_cell_lx.clear();
-    m_cell_ly.clear();
-    m_cell_data.clear();
-    m_t_gx.clear();
-    m_t_gy.clear();
-    m_t_gz.clear();
-    m_t_gt.clear();
-    m_t_lx.clear();
-    m_t_ly.clear();
-    m_t_barcode.clear();
+    b.cell_IDx.clear();
+    b.cell_IDy.clear();
+    b.cell_lx.clear();
+    b.cell_ly.clear();
+    b.cell_data.clear();
+    b.t_gx.clear();
+    b.t_gy.clear();
+    b.t_gz.clear();
+    b.t_gt.clear();
+    b.t_lx.clear();
+    b.t_ly.clear();
+    b.t_barcode.clear();
   }
   return FW::ProcessCode::SUCCESS;
 }
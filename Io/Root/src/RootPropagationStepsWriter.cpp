@@ -8,7 +8,6 @@
 
 #include "ACTFW/Io/Root/RootPropagationStepsWriter.hpp"
 
-#include <ios>
 #include <stdexcept>
 
 #include <Acts/Geometry/GeometryID.hpp>
@@ -19,14 +18,68 @@
 #include <TTree.h>
 
 #include "ACTFW/Framework/WhiteBoard.hpp"
+#include "ACTFW/Propagation/PropagationStatistics.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "RootTreeOutput.hpp"
 
-FW::RootPropagationStepsWriter::RootPropagationStepsWriter(
-    const FW::RootPropagationStepsWriter::Config& cfg,
-    Acts::Logging::Level                          level)
-  : WriterT(cfg.collection, "RootPropagationStepsWriter", level)
+namespace {
+
+/// Identification, kinematics, and step size constraints of a step.
+struct StepInfo
+{
+  Acts::GeometryID        geoID;
+  Acts::GeometryID::Value volumeID = 0;
+  Acts::Vector3D          position;
+  Acts::Vector3D          direction;
+  double                  accuracy;
+  double                  actor;
+  double                  aborter;
+  double                  user;
+};
+
+StepInfo
+stepInfo(const Acts::detail::Step& step)
+{
+  StepInfo info;
+  // get the identification from the surface first
+  if (step.surface) { info.geoID = step.surface->geoID(); }
+  info.volumeID  = info.geoID.volume();
+  // a current volume overwrites the surface tagged one
+  if (step.volume) { info.volumeID = step.volume->geoID().volume(); }
+  info.position  = step.position;
+  info.direction = step.momentum.normalized();
+  info.accuracy  = step.stepSize.value(Acts::ConstrainedStep::accuracy);
+  info.actor     = step.stepSize.value(Acts::ConstrainedStep::actor);
+  info.aborter   = step.stepSize.value(Acts::ConstrainedStep::aborter);
+  info.user      = step.stepSize.value(Acts::ConstrainedStep::user);
+  return info;
+}
+
+StepInfo
+stepInfo(const FW::CompactStep& step)
+{
+  StepInfo info;
+  info.geoID     = step.geoId;
+  info.volumeID  = (step.volumeId != 0) ? step.volumeId : step.geoId.volume();
+  info.position  = step.position.cast<double>();
+  info.direction = step.direction.cast<double>();
+  info.accuracy  = step.accuracy;
+  info.actor     = step.actor;
+  info.aborter   = step.aborter;
+  info.user      = step.user;
+  return info;
+}
+
+}  // namespace
+
+template <typename step_t>
+FW::RootPropagationStepsWriterT<step_t>::RootPropagationStepsWriterT(
+    const Config&        cfg,
+    Acts::Logging::Level level)
+  : WriterT<std::vector<std::vector<step_t>>>(cfg.collection,
+                                              "RootPropagationStepsWriter",
+                                              level)
   , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.collection.empty()) {
@@ -36,65 +89,66 @@ FW::RootPropagationStepsWriter::RootPropagationStepsWriter(
   }
 
   // Setup ROOT I/O
-  if (m_outputFile == nullptr) {
-    m_outputFile = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
-    if (m_outputFile == nullptr) {
-      throw std::ios_base::failure("Could not open '" + m_cfg.filePath);
-    }
-  }
-  m_outputFile->cd();
-
-  m_outputTree = new TTree(m_cfg.treeName.c_str(),
-                           "TTree from RootPropagationStepsWriter");
-  if (m_outputTree == nullptr) throw std::bad_alloc();
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = m_cfg.filePath;
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.treeName;
+  outputCfg.treeTitle = "TTree from RootPropagationStepsWriter";
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.parallel  = m_cfg.parallelOutput;
+  outputCfg.ntuple    = m_cfg.ntupleOutput;
 
   // Set the branches
-  m_outputTree->Branch("event_nr", &m_eventNr);
-  m_outputTree->Branch("volume_id", &m_volumeID);
-  m_outputTree->Branch("boundary_id", &m_boundaryID);
-  m_outputTree->Branch("layer_id", &m_layerID);
-  m_outputTree->Branch("approach_id", &m_approachID);
-  m_outputTree->Branch("sensitive_id", &m_sensitiveID);
-  m_outputTree->Branch("g_x", &m_x);
-  m_outputTree->Branch("g_y", &m_y);
-  m_outputTree->Branch("g_z", &m_z);
-  m_outputTree->Branch("d_x", &m_dx);
-  m_outputTree->Branch("d_y", &m_dy);
-  m_outputTree->Branch("d_z", &m_dz);
-  m_outputTree->Branch("type", &m_step_type);
-  m_outputTree->Branch("step_acc", &m_step_acc);
-  m_outputTree->Branch("step_act", &m_step_act);
-  m_outputTree->Branch("step_abt", &m_step_abt);
-  m_outputTree->Branch("step_usr", &m_step_usr);
+  auto book = [](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("event_nr", &b.eventNr);
+    tree.Branch("volume_id", &b.volumeID);
+    tree.Branch("boundary_id", &b.boundaryID);
+    tree.Branch("layer_id", &b.layerID);
+    tree.Branch("approach_id", &b.approachID);
+    tree.Branch("sensitive_id", &b.sensitiveID);
+    tree.Branch("g_x", &b.x);
+    tree.Branch("g_y", &b.y);
+    tree.Branch("g_z", &b.z);
+    tree.Branch("d_x", &b.dx);
+    tree.Branch("d_y", &b.dy);
+    tree.Branch("d_z", &b.dz);
+    tree.Branch("type", &b.step_type);
+    tree.Branch("step_acc", &b.step_acc);
+    tree.Branch("step_act", &b.step_act);
+    tree.Branch("step_abt", &b.step_abt);
+    tree.Branch("step_usr", &b.step_usr);
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
-FW::RootPropagationStepsWriter::~RootPropagationStepsWriter()
-{
-  /// Close the file if it's yours
-  if (m_cfg.rootFile == nullptr) { m_outputFile->Close(); }
-}
+// the output closes the file if it's ours
+template <typename step_t>
+FW::RootPropagationStepsWriterT<step_t>::~RootPropagationStepsWriterT()
+    = default;
 
+template <typename step_t>
 FW::ProcessCode
-FW::RootPropagationStepsWriter::endRun()
+FW::RootPropagationStepsWriterT<step_t>::endRun()
 {
   // Write the tree
-  m_outputFile->cd();
-  m_outputTree->Write();
+  m_output->write();
   ACTS_VERBOSE("Wrote particles to tree '" << m_cfg.treeName << "' in '"
                                            << m_cfg.filePath << "'");
   return ProcessCode::SUCCESS;
 }
 
+template <typename step_t>
 FW::ProcessCode
-FW::RootPropagationStepsWriter::writeT(
-    const AlgorithmContext&              context,
-    const std::vector<PropagationSteps>& stepCollection)
+FW::RootPropagationStepsWriterT<step_t>::writeT(
+    const AlgorithmContext&                 context,
+    const std::vector<std::vector<step_t>>& stepCollection)
 {
   // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
 
   // we get the event number
-  m_eventNr = context.eventNumber;
+  b.eventNr = context.eventNumber;
 
   using ag = Acts::GeometryID;
 
@@ -102,85 +156,55 @@ FW::RootPropagationStepsWriter::writeT(
   for (auto& steps : stepCollection) {
 
     // clear the vectors for each collection
-    m_volumeID.clear();
-    m_boundaryID.clear();
-    m_layerID.clear();
-    m_approachID.clear();
-    m_sensitiveID.clear();
-    m_x.clear();
-    m_y.clear();
-    m_z.clear();
-    m_dx.clear();
-    m_dy.clear();
-    m_dz.clear();
-    m_step_type.clear();
-    m_step_acc.clear();
-    m_step_act.clear();
-    m_step_abt.clear();
-    m_step_usr.clear();
+    b.volumeID.clear();
+    b.boundaryID.clear();
+    b.layerID.clear();
+    b.approachID.clear();
+    b.sensitiveID.clear();
+    b.x.clear();
+    b.y.clear();
+    b.z.clear();
+    b.dx.clear();
+    b.dy.clear();
+    b.dz.clear();
+    b.step_type.clear();
+    b.step_acc.clear();
+    b.step_act.clear();
+    b.step_abt.clear();
+    b.step_usr.clear();
 
     // loop over single steps
     for (auto& step : steps) {
+      auto info = stepInfo(step);
       // the identification of the step
-      Acts::GeometryID::Value volumeID    = 0;
-      Acts::GeometryID::Value boundaryID  = 0;
-      Acts::GeometryID::Value layerID     = 0;
-      Acts::GeometryID::Value approachID  = 0;
-      Acts::GeometryID::Value sensitiveID = 0;
-      // get the identification from the surface first
-      if (step.surface) {
-        auto geoID  = step.surface->geoID();
-        volumeID    = geoID.volume();
-        boundaryID  = geoID.boundary();
-        layerID     = geoID.layer();
-        approachID  = geoID.approach();
-        sensitiveID = geoID.sensitive();
-      }
-      // a current volume overwrites the surface tagged one
-      if (step.volume) { volumeID = step.volume->geoID().volume(); }
-      // now fill
-      m_sensitiveID.push_back(sensitiveID);
-      m_approachID.push_back(approachID);
-      m_layerID.push_back(layerID);
-      m_boundaryID.push_back(boundaryID);
-      m_volumeID.push_back(volumeID);
+      b.sensitiveID.push_back(info.geoID.sensitive());
+      b.approachID.push_back(info.geoID.approach());
+      b.layerID.push_back(info.geoID.layer());
+      b.boundaryID.push_back(info.geoID.boundary());
+      b.volumeID.push_back(info.volumeID);
 
       // kinematic information
-      m_x.push_back(step.position.x());
-      m_y.push_back(step.position.y());
-      m_z.push_back(step.position.z());
-      auto direction = step.momentum.normalized();
-      m_dx.push_back(direction.x());
-      m_dy.push_back(direction.y());
-      m_dz.push_back(direction.z());
-
-      double accuracy = step.stepSize.value(Acts::ConstrainedStep::accuracy);
-      double actor    = step.stepSize.value(Acts::ConstrainedStep::actor);
-      double aborter  = step.stepSize.value(Acts::ConstrainedStep::aborter);
-      double user     = step.stepSize.value(Acts::ConstrainedStep::user);
-      double act2     = actor * actor;
-      double acc2     = accuracy * accuracy;
-      double abo2     = aborter * aborter;
-      double usr2     = user * user;
+      b.x.push_back(info.position.x());
+      b.y.push_back(info.position.y());
+      b.z.push_back(info.position.z());
+      b.dx.push_back(info.direction.x());
+      b.dy.push_back(info.direction.y());
+      b.dz.push_back(info.direction.z());
 
       // todo - fold with direction
-      if (act2 < acc2 && act2 < abo2 && act2 < usr2) {
-        m_step_type.push_back(0);
-      } else if (acc2 < abo2 && acc2 < usr2) {
-        m_step_type.push_back(1);
-      } else if (abo2 < usr2) {
-        m_step_type.push_back(2);
-      } else {
-        m_step_type.push_back(3);
-      }
+      b.step_type.push_back(static_cast<int>(
+          stepType(info.accuracy, info.actor, info.aborter, info.user)));
 
       // step size information
-      m_step_acc.push_back(accuracy);
-      m_step_act.push_back(actor);
-      m_step_abt.push_back(aborter);
-      m_step_usr.push_back(user);
+      b.step_acc.push_back(info.accuracy);
+      b.step_act.push_back(info.actor);
+      b.step_abt.push_back(info.aborter);
+      b.step_usr.push_back(info.user);
     }
-    m_outputTree->Fill();
+    output.fill();
   }
   return FW::ProcessCode::SUCCESS;
 }
+
+template class FW::RootPropagationStepsWriterT<Acts::detail::Step>;
+template class FW::RootPropagationStepsWriterT<FW::CompactStep>;
@@ -8,7 +8,6 @@
 
 #include "ACTFW/Io/Root/RootSimHitWriter.hpp"
 
-#include <ios>
 #include <stdexcept>
 
 #include <Acts/Plugins/Digitization/DigitizationModule.hpp>
@@ -20,12 +19,12 @@
 #include "ACTFW/EventData/DataContainers.hpp"
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/Utilities/Paths.hpp"
+#include "RootTreeOutput.hpp"
 
 FW::RootSimHitWriter::RootSimHitWriter(const FW::RootSimHitWriter::Config& cfg,
                                        Acts::Logging::Level level)
   : WriterT(cfg.collection, "RootSimHitWriter", level)
   , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.collection.empty()) {
@@ -35,43 +34,38 @@ FW::RootSimHitWriter::RootSimHitWriter(const FW::RootSimHitWriter::Config& cfg,
   }
 
   // Setup ROOT I/O
-  if (m_cfg.rootFile == nullptr) {
-    m_outputFile = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
-    if (!m_outputFile) {
-      throw std::ios_base::failure("Could not open '" + m_cfg.filePath);
-    }
-  }
-
-  m_outputFile->cd();
-  m_outputTree
-      = new TTree(m_cfg.treeName.c_str(), "TTree from RootSimHitWriter");
-  if (m_outputTree == nullptr) throw std::bad_alloc();
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = m_cfg.filePath;
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.treeName;
+  outputCfg.treeTitle = "TTree from RootSimHitWriter";
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.parallel  = m_cfg.parallelOutput;
 
   // Set the branches
-  m_outputTree->Branch("volume_id", &m_volumeID);
-  m_outputTree->Branch("layer_id", &m_layerID);
-  m_outputTree->Branch("surface_id", &m_surfaceID);
-  m_outputTree->Branch("g_x", &m_x);
-  m_outputTree->Branch("g_y", &m_y);
-  m_outputTree->Branch("g_z", &m_z);
-  m_outputTree->Branch("d_x", &m_dx);
-  m_outputTree->Branch("d_y", &m_dy);
-  m_outputTree->Branch("d_z", &m_dz);
-  m_outputTree->Branch("value", &m_value);
+  auto book = [](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("volume_id", &b.volumeID);
+    tree.Branch("layer_id", &b.layerID);
+    tree.Branch("surface_id", &b.surfaceID);
+    tree.Branch("g_x", &b.x);
+    tree.Branch("g_y", &b.y);
+    tree.Branch("g_z", &b.z);
+    tree.Branch("d_x", &b.dx);
+    tree.Branch("d_y", &b.dy);
+    tree.Branch("d_z", &b.dz);
+    tree.Branch("value", &b.value);
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
-FW::RootSimHitWriter::~RootSimHitWriter()
-{
-  /// Close the file if it's yours
-  if (m_cfg.rootFile == nullptr) { m_outputFile->Close(); }
-}
+// the output closes the file if it's ours
+FW::RootSimHitWriter::~RootSimHitWriter() = default;
 
 FW::ProcessCode
 FW::RootSimHitWriter::endRun()
 {
   // Write the tree
-  m_outputFile->cd();
-  m_outputTree->Write();
+  m_output->write();
   ACTS_VERBOSE("Wrote particles to tree '" << m_cfg.treeName << "' in '"
                                            << m_cfg.filePath << "'");
   return ProcessCode::SUCCESS;
@@ -82,26 +76,27 @@ FW::RootSimHitWriter::writeT(const AlgorithmContext& context,
                              const FW::SimHits&      hits)
 {
   // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
 
   // Get the event number
-  m_eventNr = context.eventNumber;
+  b.eventNr = context.eventNumber;
 
   // Loop over the planar fatras hits in this event
   for (const auto& hit : hits) {
     // extract geometry identification
-    m_volumeID  = hit.geoId().volume();
-    m_layerID   = hit.geoId().layer();
-    m_surfaceID = hit.geoId().sensitive();
-    m_x         = hit.position.x();
-    m_y         = hit.position.y();
-    m_z         = hit.position.z();
-    m_dx        = hit.direction.x();
-    m_dy        = hit.direction.y();
-    m_dz        = hit.direction.z();
-    m_value     = hit.value;
+    b.volumeID  = hit.geoId().volume();
+    b.layerID   = hit.geoId().layer();
+    b.surfaceID = hit.geoId().sensitive();
+    b.x         = hit.position.x();
+    b.y         = hit.position.y();
+    b.z         = hit.position.z();
+    b.dx        = hit.direction.x();
+    b.dy        = hit.direction.y();
+    b.dz        = hit.direction.z();
+    b.value     = hit.value;
     // Fill the tree
-    m_outputTree->Fill();
+    output.fill();
   }
   return FW::ProcessCode::SUCCESS;
 }
@@ -8,26 +8,33 @@
 
 #include "ACTFW/Io/Root/RootTrajectoryWriter.hpp"
 
-#include <ios>
+#include <cctype>
+#include <cmath>
 #include <stdexcept>
+#include <utility>
 
 #include <Acts/Utilities/Helpers.hpp>
 #include <TFile.h>
 #include <TTree.h>
 
 #include "ACTFW/Utilities/Paths.hpp"
+#include "RootTreeOutput.hpp"
 
 using Acts::VectorHelpers::eta;
 using Acts::VectorHelpers::perp;
 using Acts::VectorHelpers::phi;
 using Acts::VectorHelpers::theta;
 
+namespace {
+const std::array<std::string, Acts::BoundParsDim> kParameterNames
+    = {"eLOC0", "eLOC1", "ePHI", "eTHETA", "eQOP", "eT"};
+}  // namespace
+
 FW::RootTrajectoryWriter::RootTrajectoryWriter(
     const FW::RootTrajectoryWriter::Config& cfg,
     Acts::Logging::Level                    level)
   : WriterT(cfg.inputTrajectories, "RootTrajectoryWriter", level)
   , m_cfg(cfg)
-  , m_outputFile(cfg.rootFile)
 {
   // An input collection name and tree name must be specified
   if (m_cfg.inputTrajectories.empty()) {
@@ -41,205 +48,101 @@ FW::RootTrajectoryWriter::RootTrajectoryWriter(
   }
 
   // Setup ROOT I/O
-  if (m_outputFile == nullptr) {
-    auto path    = joinPaths(m_cfg.outputDir, m_cfg.outputFilename);
-    m_outputFile = TFile::Open(path.c_str(), m_cfg.fileMode.c_str());
-    if (m_outputFile == nullptr) {
-      throw std::ios_base::failure("Could not open '" + path);
+  RootTreeOutput<Buffers>::Config outputCfg;
+  outputCfg.filePath  = joinPaths(m_cfg.outputDir, m_cfg.outputFilename);
+  outputCfg.fileMode  = m_cfg.fileMode;
+  outputCfg.treeName  = m_cfg.outputTreename;
+  outputCfg.treeTitle = m_cfg.outputTreename;
+  outputCfg.rootFile  = m_cfg.rootFile;
+  outputCfg.parallel  = m_cfg.parallelOutput;
+  outputCfg.ntuple    = m_cfg.ntupleOutput;
+
+  // I/O parameters
+  auto book = [this](RootBranchBooker& tree, Buffers& b) {
+    tree.Branch("event_nr", &b.eventNr);
+    tree.Branch("traj_nr", &b.trajNr);
+
+    if (m_cfg.writeTruth) {
+      tree.Branch("t_barcode", &b.t_barcode, "t_barcode/l");
+      tree.Branch("t_charge", &b.t_charge);
+      tree.Branch("t_time", &b.t_time);
+      tree.Branch("t_vx", &b.t_vx);
+      tree.Branch("t_vy", &b.t_vy);
+      tree.Branch("t_vz", &b.t_vz);
+      tree.Branch("t_px", &b.t_px);
+      tree.Branch("t_py", &b.t_py);
+      tree.Branch("t_pz", &b.t_pz);
+      tree.Branch("t_theta", &b.t_theta);
+      tree.Branch("t_phi", &b.t_phi);
+      tree.Branch("t_eta", &b.t_eta);
+      tree.Branch("t_pT", &b.t_pT);
+
+      tree.Branch("t_x", &b.t_x);
+      tree.Branch("t_y", &b.t_y);
+      tree.Branch("t_z", &b.t_z);
+      tree.Branch("t_r", &b.t_r);
+      tree.Branch("t_dx", &b.t_dx);
+      tree.Branch("t_dy", &b.t_dy);
+      tree.Branch("t_dz", &b.t_dz);
+      for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+        tree.Branch(("t_" + kParameterNames[parID]).c_str(), &b.t_par[parID]);
+      }
     }
-  }
-  m_outputFile->cd();
-  m_outputTree
-      = new TTree(m_cfg.outputTreename.c_str(), m_cfg.outputTreename.c_str());
-  if (m_outputTree == nullptr)
-    throw std::bad_alloc();
-  else {
-    // I/O parameters
-    m_outputTree->Branch("event_nr", &m_eventNr);
-    m_outputTree->Branch("traj_nr", &m_trajNr);
-    m_outputTree->Branch("t_barcode", &m_t_barcode, "t_barcode/l");
-    m_outputTree->Branch("t_charge", &m_t_charge);
-    m_outputTree->Branch("t_time", &m_t_time);
-    m_outputTree->Branch("t_vx", &m_t_vx);
-    m_outputTree->Branch("t_vy", &m_t_vy);
-    m_outputTree->Branch("t_vz", &m_t_vz);
-    m_outputTree->Branch("t_px", &m_t_px);
-    m_outputTree->Branch("t_py", &m_t_py);
-    m_outputTree->Branch("t_pz", &m_t_pz);
-    m_outputTree->Branch("t_theta", &m_t_theta);
-    m_outputTree->Branch("t_phi", &m_t_phi);
-    m_outputTree->Branch("t_eta", &m_t_eta);
-    m_outputTree->Branch("t_pT", &m_t_pT);
-
-    m_outputTree->Branch("t_x", &m_t_x);
-    m_outputTree->Branch("t_y", &m_t_y);
-    m_outputTree->Branch("t_z", &m_t_z);
-    m_outputTree->Branch("t_r", &m_t_r);
-    m_outputTree->Branch("t_dx", &m_t_dx);
-    m_outputTree->Branch("t_dy", &m_t_dy);
-    m_outputTree->Branch("t_dz", &m_t_dz);
-    m_outputTree->Branch("t_eLOC0", &m_t_eLOC0);
-    m_outputTree->Branch("t_eLOC1", &m_t_eLOC1);
-    m_outputTree->Branch("t_ePHI", &m_t_ePHI);
-    m_outputTree->Branch("t_eTHETA", &m_t_eTHETA);
-    m_outputTree->Branch("t_eQOP", &m_t_eQOP);
-    m_outputTree->Branch("t_eT", &m_t_eT);
-
-    m_outputTree->Branch("nStates", &m_nStates);
-    m_outputTree->Branch("nMeasurements", &m_nMeasurements);
-    m_outputTree->Branch("volume_id", &m_volumeID);
-    m_outputTree->Branch("layer_id", &m_layerID);
-    m_outputTree->Branch("module_id", &m_moduleID);
-    m_outputTree->Branch("l_x_hit", &m_lx_hit);
-    m_outputTree->Branch("l_y_hit", &m_ly_hit);
-    m_outputTree->Branch("g_x_hit", &m_x_hit);
-    m_outputTree->Branch("g_y_hit", &m_y_hit);
-    m_outputTree->Branch("g_z_hit", &m_z_hit);
-    m_outputTree->Branch("res_x_hit", &m_res_x_hit);
-    m_outputTree->Branch("res_y_hit", &m_res_y_hit);
-    m_outputTree->Branch("err_x_hit", &m_err_x_hit);
-    m_outputTree->Branch("err_y_hit", &m_err_y_hit);
-    m_outputTree->Branch("pull_x_hit", &m_pull_x_hit);
-    m_outputTree->Branch("pull_y_hit", &m_pull_y_hit);
-    m_outputTree->Branch("dim_hit", &m_dim_hit);
-
-    m_outputTree->Branch("hasFittedParams", &m_hasFittedParams);
-    m_outputTree->Branch("eLOC0_fit", &m_eLOC0_fit);
-    m_outputTree->Branch("eLOC1_fit", &m_eLOC1_fit);
-    m_outputTree->Branch("ePHI_fit", &m_ePHI_fit);
-    m_outputTree->Branch("eTHETA_fit", &m_eTHETA_fit);
-    m_outputTree->Branch("eQOP_fit", &m_eQOP_fit);
-    m_outputTree->Branch("eT_fit", &m_eT_fit);
-    m_outputTree->Branch("err_eLOC0_fit", &m_err_eLOC0_fit);
-    m_outputTree->Branch("err_eLOC1_fit", &m_err_eLOC1_fit);
-    m_outputTree->Branch("err_ePHI_fit", &m_err_ePHI_fit);
-    m_outputTree->Branch("err_eTHETA_fit", &m_err_eTHETA_fit);
-    m_outputTree->Branch("err_eQOP_fit", &m_err_eQOP_fit);
-    m_outputTree->Branch("err_eT_fit", &m_err_eT_fit);
-
-    m_outputTree->Branch("nPredicted", &m_nPredicted);
-    m_outputTree->Branch("predicted", &m_prt);
-    m_outputTree->Branch("eLOC0_prt", &m_eLOC0_prt);
-    m_outputTree->Branch("eLOC1_prt", &m_eLOC1_prt);
-    m_outputTree->Branch("ePHI_prt", &m_ePHI_prt);
-    m_outputTree->Branch("eTHETA_prt", &m_eTHETA_prt);
-    m_outputTree->Branch("eQOP_prt", &m_eQOP_prt);
-    m_outputTree->Branch("eT_prt", &m_eT_prt);
-    m_outputTree->Branch("res_eLOC0_prt", &m_res_eLOC0_prt);
-    m_outputTree->Branch("res_eLOC1_prt", &m_res_eLOC1_prt);
-    m_outputTree->Branch("res_ePHI_prt", &m_res_ePHI_prt);
-    m_outputTree->Branch("res_eTHETA_prt", &m_res_eTHETA_prt);
-    m_outputTree->Branch("res_eQOP_prt", &m_res_eQOP_prt);
-    m_outputTree->Branch("res_eT_prt", &m_res_eT_prt);
-    m_outputTree->Branch("err_eLOC0_prt", &m_err_eLOC0_prt);
-    m_outputTree->Branch("err_eLOC1_prt", &m_err_eLOC1_prt);
-    m_outputTree->Branch("err_ePHI_prt", &m_err_ePHI_prt);
-    m_outputTree->Branch("err_eTHETA_prt", &m_err_eTHETA_prt);
-    m_outputTree->Branch("err_eQOP_prt", &m_err_eQOP_prt);
-    m_outputTree->Branch("err_eT_prt", &m_err_eT_prt);
-    m_outputTree->Branch("pull_eLOC0_prt", &m_pull_eLOC0_prt);
-    m_outputTree->Branch("pull_eLOC1_prt", &m_pull_eLOC1_prt);
-    m_outputTree->Branch("pull_ePHI_prt", &m_pull_ePHI_prt);
-    m_outputTree->Branch("pull_eTHETA_prt", &m_pull_eTHETA_prt);
-    m_outputTree->Branch("pull_eQOP_prt", &m_pull_eQOP_prt);
-    m_outputTree->Branch("pull_eT_prt", &m_pull_eT_prt);
-    m_outputTree->Branch("g_x_prt", &m_x_prt);
-    m_outputTree->Branch("g_y_prt", &m_y_prt);
-    m_outputTree->Branch("g_z_prt", &m_z_prt);
-    m_outputTree->Branch("px_prt", &m_px_prt);
-    m_outputTree->Branch("py_prt", &m_py_prt);
-    m_outputTree->Branch("pz_prt", &m_pz_prt);
-    m_outputTree->Branch("eta_prt", &m_eta_prt);
-    m_outputTree->Branch("pT_prt", &m_pT_prt);
-
-    m_outputTree->Branch("nFiltered", &m_nFiltered);
-    m_outputTree->Branch("filtered", &m_flt);
-    m_outputTree->Branch("eLOC0_flt", &m_eLOC0_flt);
-    m_outputTree->Branch("eLOC1_flt", &m_eLOC1_flt);
-    m_outputTree->Branch("ePHI_flt", &m_ePHI_flt);
-    m_outputTree->Branch("eTHETA_flt", &m_eTHETA_flt);
-    m_outputTree->Branch("eQOP_flt", &m_eQOP_flt);
-    m_outputTree->Branch("eT_flt", &m_eT_flt);
-    m_outputTree->Branch("res_eLOC0_flt", &m_res_eLOC0_flt);
-    m_outputTree->Branch("res_eLOC1_flt", &m_res_eLOC1_flt);
-    m_outputTree->Branch("res_ePHI_flt", &m_res_ePHI_flt);
-    m_outputTree->Branch("res_eTHETA_flt", &m_res_eTHETA_flt);
-    m_outputTree->Branch("res_eQOP_flt", &m_res_eQOP_flt);
-    m_outputTree->Branch("res_eT_flt", &m_res_eT_flt);
-    m_outputTree->Branch("err_eLOC0_flt", &m_err_eLOC0_flt);
-    m_outputTree->Branch("err_eLOC1_flt", &m_err_eLOC1_flt);
-    m_outputTree->Branch("err_ePHI_flt", &m_err_ePHI_flt);
-    m_outputTree->Branch("err_eTHETA_flt", &m_err_eTHETA_flt);
-    m_outputTree->Branch("err_eQOP_flt", &m_err_eQOP_flt);
-    m_outputTree->Branch("err_eT_flt", &m_err_eT_flt);
-    m_outputTree->Branch("pull_eLOC0_flt", &m_pull_eLOC0_flt);
-    m_outputTree->Branch("pull_eLOC1_flt", &m_pull_eLOC1_flt);
-    m_outputTree->Branch("pull_ePHI_flt", &m_pull_ePHI_flt);
-    m_outputTree->Branch("pull_eTHETA_flt", &m_pull_eTHETA_flt);
-    m_outputTree->Branch("pull_eQOP_flt", &m_pull_eQOP_flt);
-    m_outputTree->Branch("pull_eT_flt", &m_pull_eT_flt);
-    m_outputTree->Branch("g_x_flt", &m_x_flt);
-    m_outputTree->Branch("g_y_flt", &m_y_flt);
-    m_outputTree->Branch("g_z_flt", &m_z_flt);
-    m_outputTree->Branch("px_flt", &m_px_flt);
-    m_outputTree->Branch("py_flt", &m_py_flt);
-    m_outputTree->Branch("pz_flt", &m_pz_flt);
-    m_outputTree->Branch("eta_flt", &m_eta_flt);
-    m_outputTree->Branch("pT_flt", &m_pT_flt);
-    m_outputTree->Branch("chi2", &m_chi2);
-
-    m_outputTree->Branch("nSmoothed", &m_nSmoothed);
-    m_outputTree->Branch("smoothed", &m_smt);
-    m_outputTree->Branch("eLOC0_smt", &m_eLOC0_smt);
-    m_outputTree->Branch("eLOC1_smt", &m_eLOC1_smt);
-    m_outputTree->Branch("ePHI_smt", &m_ePHI_smt);
-    m_outputTree->Branch("eTHETA_smt", &m_eTHETA_smt);
-    m_outputTree->Branch("eQOP_smt", &m_eQOP_smt);
-    m_outputTree->Branch("eT_smt", &m_eT_smt);
-    m_outputTree->Branch("res_eLOC0_smt", &m_res_eLOC0_smt);
-    m_outputTree->Branch("res_eLOC1_smt", &m_res_eLOC1_smt);
-    m_outputTree->Branch("res_ePHI_smt", &m_res_ePHI_smt);
-    m_outputTree->Branch("res_eTHETA_smt", &m_res_eTHETA_smt);
-    m_outputTree->Branch("res_eQOP_smt", &m_res_eQOP_smt);
-    m_outputTree->Branch("res_eT_smt", &m_res_eT_smt);
-    m_outputTree->Branch("err_eLOC0_smt", &m_err_eLOC0_smt);
-    m_outputTree->Branch("err_eLOC1_smt", &m_err_eLOC1_smt);
-    m_outputTree->Branch("err_ePHI_smt", &m_err_ePHI_smt);
-    m_outputTree->Branch("err_eTHETA_smt", &m_err_eTHETA_smt);
-    m_outputTree->Branch("err_eQOP_smt", &m_err_eQOP_smt);
-    m_outputTree->Branch("err_eT_smt", &m_err_eT_smt);
-    m_outputTree->Branch("pull_eLOC0_smt", &m_pull_eLOC0_smt);
-    m_outputTree->Branch("pull_eLOC1_smt", &m_pull_eLOC1_smt);
-    m_outputTree->Branch("pull_ePHI_smt", &m_pull_ePHI_smt);
-    m_outputTree->Branch("pull_eTHETA_smt", &m_pull_eTHETA_smt);
-    m_outputTree->Branch("pull_eQOP_smt", &m_pull_eQOP_smt);
-    m_outputTree->Branch("pull_eT_smt", &m_pull_eT_smt);
-    m_outputTree->Branch("g_x_smt", &m_x_smt);
-    m_outputTree->Branch("g_y_smt", &m_y_smt);
-    m_outputTree->Branch("g_z_smt", &m_z_smt);
-    m_outputTree->Branch("px_smt", &m_px_smt);
-    m_outputTree->Branch("py_smt", &m_py_smt);
-    m_outputTree->Branch("pz_smt", &m_pz_smt);
-    m_outputTree->Branch("eta_smt", &m_eta_smt);
-    m_outputTree->Branch("pT_smt", &m_pT_smt);
-  }
-}
 
-FW::RootTrajectoryWriter::~RootTrajectoryWriter()
-{
-  if (m_outputFile) { m_outputFile->Close(); }
+    if (m_cfg.writeSummary) {
+      tree.Branch("nStates", &b.nStates);
+      tree.Branch("nMeasurements", &b.nMeasurements);
+    }
+    if (m_cfg.writeHits) {
+      tree.Branch("volume_id", &b.volumeID);
+      tree.Branch("layer_id", &b.layerID);
+      tree.Branch("module_id", &b.moduleID);
+      tree.Branch("l_x_hit", &b.lx_hit);
+      tree.Branch("l_y_hit", &b.ly_hit);
+      tree.Branch("g_x_hit", &b.x_hit);
+      tree.Branch("g_y_hit", &b.y_hit);
+      tree.Branch("g_z_hit", &b.z_hit);
+      tree.Branch("res_x_hit", &b.res_x_hit);
+      tree.Branch("res_y_hit", &b.res_y_hit);
+      tree.Branch("err_x_hit", &b.err_x_hit);
+      tree.Branch("err_y_hit", &b.err_y_hit);
+      tree.Branch("pull_x_hit", &b.pull_x_hit);
+      tree.Branch("pull_y_hit", &b.pull_y_hit);
+      tree.Branch("dim_hit", &b.dim_hit);
+    }
+
+    if (m_cfg.writeSummary) {
+      tree.Branch("hasFittedParams", &b.hasFittedParams);
+      for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+        const auto& name = kParameterNames[parID];
+        tree.Branch((name + "_fit").c_str(), &b.fit[parID]);
+      }
+      for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+        const auto& name = kParameterNames[parID];
+        tree.Branch(("err_" + name + "_fit").c_str(), &b.err_fit[parID]);
+      }
+    }
+
+    if (m_cfg.writePredicted) { b.prt.book(tree, "predicted", "prt"); }
+    if (m_cfg.writeFiltered) {
+      b.flt.book(tree, "filtered", "flt");
+      tree.Branch("chi2", &b.chi2);
+    }
+    if (m_cfg.writeSmoothed) { b.smt.book(tree, "smoothed", "smt"); }
+  };
+  m_output = std::make_unique<RootTreeOutput<Buffers>>(outputCfg, book);
 }
 
+// the output closes the file if it's ours
+FW::RootTrajectoryWriter::~RootTrajectoryWriter() = default;
+
 FW::ProcessCode
 FW::RootTrajectoryWriter::endRun()
 {
-  if (m_outputFile) {
-    m_outputFile->cd();
-    m_outputTree->Write();
-    ACTS_INFO("Write trajectories to tree '"
-              << m_cfg.outputTreename << "' in '"
-              << joinPaths(m_cfg.outputDir, m_cfg.outputFilename) << "'");
-  }
+  m_output->write();
+  ACTS_INFO("Write trajectories to tree '"
+            << m_cfg.outputTreename << "' in '"
+            << joinPaths(m_cfg.outputDir, m_cfg.outputFilename) << "'");
   return ProcessCode::SUCCESS;
 }
 
@@ -247,113 +150,136 @@ FW::ProcessCode
 FW::RootTrajectoryWriter::writeT(const AlgorithmContext&    ctx,
                                  const TrajectoryContainer& trajectories)
 {
-
-  if (m_outputFile == nullptr) return ProcessCode::SUCCESS;
-
-  auto& gctx = ctx.geoContext;
-
   // read truth particles from input collection
   const auto& particles
       = ctx.eventStore.get<SimParticles>(m_cfg.inputParticles);
 
-  // Exclusive access to the tree while writing
-  std::lock_guard<std::mutex> lock(m_writeMutex);
-
-  // Get the event number
-  m_eventNr = ctx.eventNumber;
-
-  // Loop over the trajectories
+  // Prepare all entries in local buffers without holding the output lock
+  std::vector<Buffers> rows;
+  rows.reserve(trajectories.size());
   int iTraj = 0;
   for (const auto& traj : trajectories) {
-    /// Collect the information
-    m_trajNr = iTraj;
+    rows.emplace_back();
+    // No entry for the track without measurements in the tree
+    if (not fillTrajectory(ctx, particles, traj, rows.back())) {
+      rows.pop_back();
+      continue;
+    }
+    rows.back().eventNr = ctx.eventNumber;
+    rows.back().trajNr  = iTraj;
+    iTraj++;
+  }  // all trajectories
 
-    // Collect number of trackstates with measurements
-    m_nMeasurements = traj.numMeasurements();
+  // Exclusive access to the tree only while filling
+  auto  output = m_output->acquire();
+  auto& b      = output.buffers();
+  for (auto& row : rows) {
+    // moving keeps the buffer objects and thus the branch addresses in place
+    b = std::move(row);
+    // fill the variables for one track to tree
+    output.fill();
+  }
 
-    // No entry for the track without measurements in the tree
-    if (m_nMeasurements == 0) { continue; }
+  return ProcessCode::SUCCESS;
+}
+
+bool
+FW::RootTrajectoryWriter::fillTrajectory(const AlgorithmContext& ctx,
+                                         const SimParticles&     particles,
+                                         const TruthFitTrack&    traj,
+                                         Buffers&                b) const
+{
+  auto& gctx = ctx.geoContext;
+
+  // only compute what is needed for the enabled branches
+  const bool writeParameters
+      = m_cfg.writePredicted or m_cfg.writeFiltered or m_cfg.writeSmoothed;
+  // the parameter residuals and pulls are computed w.r.t. the truth
+  const bool needTruth = m_cfg.writeTruth or writeParameters;
+  // the hit residuals are computed w.r.t. the predicted parameters
+  const bool needPredicted = m_cfg.writePredicted or m_cfg.writeHits;
+  const bool visitStates   = needTruth or m_cfg.writeHits;
 
-    // Collect number of all trackstates
-    m_nStates = traj.numStates();
+  b.clear();
 
-    // Get the majority truth particle to this track
+  // Collect number of trackstates with measurements
+  b.nMeasurements = traj.numMeasurements();
+
+  // No entry for the track without measurements in the tree
+  if (b.nMeasurements == 0) { return false; }
+
+  // Collect number of all trackstates
+  b.nStates = traj.numStates();
+
+  // Get the majority truth particle to this track
+  if (needTruth) {
     std::vector<ParticleHitCount> particleHitCount
         = traj.identifyMajorityParticle();
     if (not particleHitCount.empty()) {
       // Get the barcode of the majority truth particle
-      m_t_barcode = particleHitCount.front().particleId.value();
+      b.t_barcode = particleHitCount.front().particleId.value();
       // Find the truth particle via the barcode
-      auto ip = particles.find(m_t_barcode);
+      auto ip = particles.find(b.t_barcode);
       if (ip != particles.end()) {
         const auto& particle = *ip;
-        ACTS_DEBUG("Find the truth particle with barcode = " << m_t_barcode);
+        ACTS_DEBUG("Find the truth particle with barcode = " << b.t_barcode);
         // Get the truth particle info at vertex
         Acts::Vector3D truthPos = particle.position();
         Acts::Vector3D truthMom = particle.momentum();
-        m_t_charge              = particle.q();
-        m_t_time                = particle.time();
-        m_t_vx                  = truthPos.x();
-        m_t_vy                  = truthPos.y();
-        m_t_vz                  = truthPos.z();
-        m_t_px                  = truthMom.x();
-        m_t_py                  = truthMom.y();
-        m_t_pz                  = truthMom.z();
-        m_t_theta               = theta(truthMom);
-        m_t_phi                 = phi(truthMom);
-        m_t_pT                  = perp(truthMom);
-        m_t_eta                 = eta(truthMom);
+        b.t_charge              = particle.q();
+        b.t_time                = particle.time();
+        b.t_vx                  = truthPos.x();
+        b.t_vy                  = truthPos.y();
+        b.t_vz                  = truthPos.z();
+        b.t_px                  = truthMom.x();
+        b.t_py                  = truthMom.y();
+        b.t_pz                  = truthMom.z();
+        b.t_theta               = theta(truthMom);
+        b.t_phi                 = phi(truthMom);
+        b.t_pT                  = perp(truthMom);
+        b.t_eta                 = eta(truthMom);
       } else {
-        ACTS_WARNING("Truth particle with barcode = " << m_t_barcode
+        ACTS_WARNING("Truth particle with barcode = " << b.t_barcode
                                                       << " not found!");
       }
     }
+  }
 
-    // Get the fitted track parameter
-    m_hasFittedParams = false;
-    if (traj.hasTrackParameters()) {
-      m_hasFittedParams      = true;
-      const auto& boundParam = traj.trackParameters();
-      const auto& parameter  = boundParam.parameters();
-      const auto& covariance = *boundParam.covariance();
-      m_eLOC0_fit            = parameter[Acts::ParDef::eLOC_0];
-      m_eLOC1_fit            = parameter[Acts::ParDef::eLOC_1];
-      m_ePHI_fit             = parameter[Acts::ParDef::ePHI];
-      m_eTHETA_fit           = parameter[Acts::ParDef::eTHETA];
-      m_eQOP_fit             = parameter[Acts::ParDef::eQOP];
-      m_eT_fit               = parameter[Acts::ParDef::eT];
-      m_err_eLOC0_fit
-          = sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0));
-      m_err_eLOC1_fit
-          = sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1));
-      m_err_ePHI_fit = sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI));
-      m_err_eTHETA_fit
-          = sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA));
-      m_err_eQOP_fit = sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP));
-      m_err_eT_fit   = sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT));
+  // Get the fitted track parameter
+  if (m_cfg.writeSummary and traj.hasTrackParameters()) {
+    b.hasFittedParams      = true;
+    const auto& boundParam = traj.trackParameters();
+    const auto& parameter  = boundParam.parameters();
+    const auto& covariance = *boundParam.covariance();
+    for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+      b.fit[parID]     = parameter[parID];
+      b.err_fit[parID] = std::sqrt(covariance(parID, parID));
     }
+  }
 
-    // Get the fitted trajectory
-    const auto& [trackTip, mj] = traj.trajectory();
-
-    // Get the trackStates on the trajectory
-    m_nPredicted = 0;
-    m_nFiltered  = 0;
-    m_nSmoothed  = 0;
-    mj.visitBackwards(trackTip, [&](const auto& state) {
-      // we only fill the track states with non-outlier measurement
-      auto typeFlags = state.typeFlags();
-      if (not typeFlags.test(Acts::TrackStateFlag::MeasurementFlag)) {
-        return true;
-      }
+  if (not visitStates) { return true; }
+
+  // Get the fitted trajectory
+  const auto& [trackTip, mj] = traj.trajectory();
+
+  // Get the trackStates on the trajectory
+  mj.visitBackwards(trackTip, [&](const auto& state) {
+    // we only fill the track states with non-outlier measurement
+    auto typeFlags = state.typeFlags();
+    if (not typeFlags.test(Acts::TrackStateFlag::MeasurementFlag)) {
+      return true;
+    }
 
+    auto meas = std::get<Measurement>(*state.uncalibrated());
+    // get measurement covariance
+    auto cov = meas.covariance();
+
+    if (m_cfg.writeHits) {
       // get the geometry ID
       auto geoID = state.referenceSurface().geoID();
-      m_volumeID.push_back(geoID.volume());
-      m_layerID.push_back(geoID.layer());
-      m_moduleID.push_back(geoID.sensitive());
-
-      auto meas = std::get<Measurement>(*state.uncalibrated());
+      b.volumeID.push_back(geoID.volume());
+      b.layerID.push_back(geoID.layer());
+      b.moduleID.push_back(geoID.sensitive());
 
       // get local position
       Acts::Vector2D local(meas.parameters()[Acts::ParDef::eLOC_0],
@@ -361,20 +287,19 @@ FW::RootTrajectoryWriter::writeT(const AlgorithmContext&    ctx,
       // get global position
       Acts::Vector3D global(0, 0, 0);
       Acts::Vector3D mom(1, 1, 1);
-      meas.referenceSurface().localToGlobal(ctx.geoContext, local, mom, global);
-
-      // get measurement covariance
-      auto  cov  = meas.covariance();
-      float resX = sqrt(cov(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0));
-      float resY = sqrt(cov(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1));
+      meas.referenceSurface().localToGlobal(gctx, local, mom, global);
 
       // push the measurement info
-      m_lx_hit.push_back(local.x());
-      m_ly_hit.push_back(local.y());
-      m_x_hit.push_back(global.x());
-      m_y_hit.push_back(global.y());
-      m_z_hit.push_back(global.z());
+      b.lx_hit.push_back(local.x());
+      b.ly_hit.push_back(local.y());
+      b.x_hit.push_back(global.x());
+      b.y_hit.push_back(global.y());
+      b.z_hit.push_back(global.z());
+    }
 
+    // get the truth track parameter at this track State
+    Acts::BoundVector truth = Acts::BoundVector::Zero();
+    if (needTruth) {
       // get the truth hit corresponding to this trackState
       auto truthHit = state.uncalibrated().truthHit();
       // get local truth position
@@ -382,541 +307,259 @@ FW::RootTrajectoryWriter::writeT(const AlgorithmContext&    ctx,
       truthHit.surface->globalToLocal(
           gctx, truthHit.position, truthHit.direction, truthlocal);
 
-      // push the truth hit info
-      m_t_x.push_back(truthHit.position.x());
-      m_t_y.push_back(truthHit.position.y());
-      m_t_z.push_back(truthHit.position.z());
-      m_t_r.push_back(perp(truthHit.position));
-      m_t_dx.push_back(truthHit.direction.x());
-      m_t_dy.push_back(truthHit.direction.y());
-      m_t_dz.push_back(truthHit.direction.z());
-
-      // get the truth track parameter at this track State
-      float truthLOC0 = 0, truthLOC1 = 0, truthPHI = 0, truthTHETA = 0,
-            truthQOP = 0, truthTIME = 0;
-      truthLOC0  = truthlocal.x();
-      truthLOC1  = truthlocal.y();
-      truthPHI   = phi(truthHit.particle.momentum());
-      truthTHETA = theta(truthHit.particle.momentum());
-      truthQOP   = m_t_charge / truthHit.particle.momentum().norm();
-      truthTIME  = truthHit.particle.time();
-
-      // push the truth track parameter at this track State
-      m_t_eLOC0.push_back(truthLOC0);
-      m_t_eLOC1.push_back(truthLOC1);
-      m_t_ePHI.push_back(truthPHI);
-      m_t_eTHETA.push_back(truthTHETA);
-      m_t_eQOP.push_back(truthQOP);
-      m_t_eT.push_back(truthTIME);
-
-      // get the predicted parameter
-      bool predicted = false;
+      truth[Acts::ParDef::eLOC_0] = truthlocal.x();
+      truth[Acts::ParDef::eLOC_1] = truthlocal.y();
+      truth[Acts::ParDef::ePHI]   = phi(truthHit.particle.momentum());
+      truth[Acts::ParDef::eTHETA] = theta(truthHit.particle.momentum());
+      truth[Acts::ParDef::eQOP]
+          = b.t_charge / truthHit.particle.momentum().norm();
+      truth[Acts::ParDef::eT] = truthHit.particle.time();
+
+      if (m_cfg.writeTruth) {
+        // push the truth hit info
+        b.t_x.push_back(truthHit.position.x());
+        b.t_y.push_back(truthHit.position.y());
+        b.t_z.push_back(truthHit.position.z());
+        b.t_r.push_back(perp(truthHit.position));
+        b.t_dx.push_back(truthHit.direction.x());
+        b.t_dy.push_back(truthHit.direction.y());
+        b.t_dz.push_back(truthHit.direction.z());
+        // push the truth track parameter at this track State
+        for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+          b.t_par[parID].push_back(truth[parID]);
+        }
+      }
+    }
+
+    // get the predicted parameter
+    if (needPredicted) {
       if (state.hasPredicted()) {
-        predicted = true;
-        m_nPredicted++;
         Acts::BoundParameters parameter(
             gctx,
             state.predictedCovariance(),
             state.predicted(),
             state.referenceSurface().getSharedPtr());
-        auto covariance = state.predictedCovariance();
-        // local hit residual info
-        auto H        = meas.projector();
-        auto resCov   = cov + H * covariance * H.transpose();
-        auto residual = meas.residual(parameter);
-        m_res_x_hit.push_back(residual(Acts::ParDef::eLOC_0));
-        m_res_y_hit.push_back(residual(Acts::ParDef::eLOC_1));
-        m_err_x_hit.push_back(
-            sqrt(resCov(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_err_y_hit.push_back(
-            sqrt(resCov(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_pull_x_hit.push_back(
-            residual(Acts::ParDef::eLOC_0)
-            / sqrt(resCov(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_pull_y_hit.push_back(
-            residual(Acts::ParDef::eLOC_1)
-            / sqrt(resCov(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_dim_hit.push_back(state.calibratedSize());
-
-        // predicted parameter
-        m_eLOC0_prt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]);
-        m_eLOC1_prt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]);
-        m_ePHI_prt.push_back(parameter.parameters()[Acts::ParDef::ePHI]);
-        m_eTHETA_prt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]);
-        m_eQOP_prt.push_back(parameter.parameters()[Acts::ParDef::eQOP]);
-        m_eT_prt.push_back(parameter.parameters()[Acts::ParDef::eT]);
-
-        // predicted residual
-        m_res_eLOC0_prt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]
-                                  - truthLOC0);
-        m_res_eLOC1_prt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]
-                                  - truthLOC1);
-        m_res_ePHI_prt.push_back(parameter.parameters()[Acts::ParDef::ePHI]
-                                 - truthPHI);
-        m_res_eTHETA_prt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]
-                                   - truthTHETA);
-        m_res_eQOP_prt.push_back(parameter.parameters()[Acts::ParDef::eQOP]
-                                 - truthQOP);
-        m_res_eT_prt.push_back(parameter.parameters()[Acts::ParDef::eT]
-                               - truthTIME);
-
-        // predicted parameter error
-        m_err_eLOC0_prt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_err_eLOC1_prt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_err_ePHI_prt.push_back(
-            sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_err_eTHETA_prt.push_back(
-            sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_err_eQOP_prt.push_back(
-            sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_err_eT_prt.push_back(
-            sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // predicted parameter pull
-        m_pull_eLOC0_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_0] - truthLOC0)
-            / sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_pull_eLOC1_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_1] - truthLOC1)
-            / sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_pull_ePHI_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::ePHI] - truthPHI)
-            / sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_pull_eTHETA_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::eTHETA] - truthTHETA)
-            / sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_pull_eQOP_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::eQOP] - truthQOP)
-            / sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_pull_eT_prt.push_back(
-            (parameter.parameters()[Acts::ParDef::eT] - truthTIME)
-            / sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // further predicted parameter info
-        m_x_prt.push_back(parameter.position().x());
-        m_y_prt.push_back(parameter.position().y());
-        m_z_prt.push_back(parameter.position().z());
-        m_px_prt.push_back(parameter.momentum().x());
-        m_py_prt.push_back(parameter.momentum().y());
-        m_pz_prt.push_back(parameter.momentum().z());
-        m_pT_prt.push_back(parameter.pT());
-        m_eta_prt.push_back(eta(parameter.position()));
+        if (m_cfg.writeHits) {
+          // local hit residual info
+          auto H        = meas.projector();
+          auto resCov   = cov + H * state.predictedCovariance() * H.transpose();
+          auto residual = meas.residual(parameter);
+
+          float errX
+              = std::sqrt(resCov(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0));
+          float errY
+              = std::sqrt(resCov(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1));
+          b.res_x_hit.push_back(residual(Acts::ParDef::eLOC_0));
+          b.res_y_hit.push_back(residual(Acts::ParDef::eLOC_1));
+          b.err_x_hit.push_back(errX);
+          b.err_y_hit.push_back(errY);
+          b.pull_x_hit.push_back(residual(Acts::ParDef::eLOC_0) / errX);
+          b.pull_y_hit.push_back(residual(Acts::ParDef::eLOC_1) / errY);
+          b.dim_hit.push_back(state.calibratedSize());
+        }
+        if (m_cfg.writePredicted) { b.prt.fill(parameter, truth); }
       } else {
         // push default values if no predicted parameter
-        m_res_x_hit.push_back(-99.);
-        m_res_y_hit.push_back(-99.);
-        m_err_x_hit.push_back(-99.);
-        m_err_y_hit.push_back(-99.);
-        m_pull_x_hit.push_back(-99.);
-        m_pull_y_hit.push_back(-99.);
-        m_dim_hit.push_back(-99.);
-        m_eLOC0_prt.push_back(-99.);
-        m_eLOC1_prt.push_back(-99.);
-        m_ePHI_prt.push_back(-99.);
-        m_eTHETA_prt.push_back(-99.);
-        m_eQOP_prt.push_back(-99.);
-        m_eT_prt.push_back(-99.);
-        m_res_eLOC0_prt.push_back(-99.);
-        m_res_eLOC1_prt.push_back(-99.);
-        m_res_ePHI_prt.push_back(-99.);
-        m_res_eTHETA_prt.push_back(-99.);
-        m_res_eQOP_prt.push_back(-99.);
-        m_res_eT_prt.push_back(-99.);
-        m_err_eLOC0_prt.push_back(-99);
-        m_err_eLOC1_prt.push_back(-99);
-        m_err_ePHI_prt.push_back(-99);
-        m_err_eTHETA_prt.push_back(-99);
-        m_err_eQOP_prt.push_back(-99);
-        m_err_eT_prt.push_back(-99);
-        m_pull_eLOC0_prt.push_back(-99.);
-        m_pull_eLOC1_prt.push_back(-99.);
-        m_pull_ePHI_prt.push_back(-99.);
-        m_pull_eTHETA_prt.push_back(-99.);
-        m_pull_eQOP_prt.push_back(-99.);
-        m_pull_eT_prt.push_back(-99.);
-        m_x_prt.push_back(-99.);
-        m_y_prt.push_back(-99.);
-        m_z_prt.push_back(-99.);
-        m_px_prt.push_back(-99.);
-        m_py_prt.push_back(-99.);
-        m_pz_prt.push_back(-99.);
-        m_pT_prt.push_back(-99.);
-        m_eta_prt.push_back(-99.);
+        if (m_cfg.writeHits) {
+          b.res_x_hit.push_back(-99.);
+          b.res_y_hit.push_back(-99.);
+          b.err_x_hit.push_back(-99.);
+          b.err_y_hit.push_back(-99.);
+          b.pull_x_hit.push_back(-99.);
+          b.pull_y_hit.push_back(-99.);
+          b.dim_hit.push_back(-99.);
+        }
+        if (m_cfg.writePredicted) { b.prt.fillMissing(); }
       }
+    }
 
-      // get the filtered parameter
-      bool filtered = false;
+    // get the filtered parameter
+    if (m_cfg.writeFiltered) {
       if (state.hasFiltered()) {
-        filtered = true;
-        m_nFiltered++;
         Acts::BoundParameters parameter(
             gctx,
             state.filteredCovariance(),
             state.filtered(),
             state.referenceSurface().getSharedPtr());
-        auto covariance = state.filteredCovariance();
-        // filtered parameter
-        m_eLOC0_flt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]);
-        m_eLOC1_flt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]);
-        m_ePHI_flt.push_back(parameter.parameters()[Acts::ParDef::ePHI]);
-        m_eTHETA_flt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]);
-        m_eQOP_flt.push_back(parameter.parameters()[Acts::ParDef::eQOP]);
-        m_eT_flt.push_back(parameter.parameters()[Acts::ParDef::eT]);
-
-        // filtered residual
-        m_res_eLOC0_flt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]
-                                  - truthLOC0);
-        m_res_eLOC1_flt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]
-                                  - truthLOC1);
-        m_res_ePHI_flt.push_back(parameter.parameters()[Acts::ParDef::ePHI]
-                                 - truthPHI);
-        m_res_eTHETA_flt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]
-                                   - truthTHETA);
-        m_res_eQOP_flt.push_back(parameter.parameters()[Acts::ParDef::eQOP]
-                                 - truthQOP);
-        m_res_eT_flt.push_back(parameter.parameters()[Acts::ParDef::eT]
-                               - truthTIME);
-
-        // filtered parameter error
-        m_err_eLOC0_flt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_err_eLOC1_flt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_err_ePHI_flt.push_back(
-            sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_err_eTHETA_flt.push_back(
-            sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_err_eQOP_flt.push_back(
-            sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_err_eT_flt.push_back(
-            sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // filtered parameter pull
-        m_pull_eLOC0_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_0] - truthLOC0)
-            / sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_pull_eLOC1_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_1] - truthLOC1)
-            / sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_pull_ePHI_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::ePHI] - truthPHI)
-            / sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_pull_eTHETA_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::eTHETA] - truthTHETA)
-            / sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_pull_eQOP_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::eQOP] - truthQOP)
-            / sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_pull_eT_flt.push_back(
-            (parameter.parameters()[Acts::ParDef::eT] - truthTIME)
-            / sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // more filtered parameter info
-        m_x_flt.push_back(parameter.position().x());
-        m_y_flt.push_back(parameter.position().y());
-        m_z_flt.push_back(parameter.position().z());
-        m_px_flt.push_back(parameter.momentum().x());
-        m_py_flt.push_back(parameter.momentum().y());
-        m_pz_flt.push_back(parameter.momentum().z());
-        m_pT_flt.push_back(parameter.pT());
-        m_eta_flt.push_back(eta(parameter.position()));
-        m_chi2.push_back(state.chi2());
+        b.flt.fill(parameter, truth);
+        b.chi2.push_back(state.chi2());
       } else {
-        // push default values if no filtered parameter
-        m_eLOC0_flt.push_back(-99.);
-        m_eLOC1_flt.push_back(-99.);
-        m_ePHI_flt.push_back(-99.);
-        m_eTHETA_flt.push_back(-99.);
-        m_eQOP_flt.push_back(-99.);
-        m_eT_flt.push_back(-99.);
-        m_res_eLOC0_flt.push_back(-99.);
-        m_res_eLOC1_flt.push_back(-99.);
-        m_res_ePHI_flt.push_back(-99.);
-        m_res_eTHETA_flt.push_back(-99.);
-        m_res_eQOP_flt.push_back(-99.);
-        m_res_eT_flt.push_back(-99.);
-        m_err_eLOC0_flt.push_back(-99);
-        m_err_eLOC1_flt.push_back(-99);
-        m_err_ePHI_flt.push_back(-99);
-        m_err_eTHETA_flt.push_back(-99);
-        m_err_eQOP_flt.push_back(-99);
-        m_err_eT_flt.push_back(-99);
-        m_pull_eLOC0_flt.push_back(-99.);
-        m_pull_eLOC1_flt.push_back(-99.);
-        m_pull_ePHI_flt.push_back(-99.);
-        m_pull_eTHETA_flt.push_back(-99.);
-        m_pull_eQOP_flt.push_back(-99.);
-        m_pull_eT_flt.push_back(-99.);
-        m_x_flt.push_back(-99.);
-        m_y_flt.push_back(-99.);
-        m_z_flt.push_back(-99.);
-        m_py_flt.push_back(-99.);
-        m_pz_flt.push_back(-99.);
-        m_pT_flt.push_back(-99.);
-        m_eta_flt.push_back(-99.);
-        m_chi2.push_back(-99.0);
+        b.flt.fillMissing();
+        b.chi2.push_back(-99.0);
       }
+    }
 
-      // get the smoothed parameter
-      bool smoothed = false;
+    // get the smoothed parameter
+    if (m_cfg.writeSmoothed) {
       if (state.hasSmoothed()) {
-        smoothed = true;
-        m_nSmoothed++;
         Acts::BoundParameters parameter(
             gctx,
             state.smoothedCovariance(),
             state.smoothed(),
             state.referenceSurface().getSharedPtr());
-        auto covariance = state.smoothedCovariance();
-
-        // smoothed parameter
-        m_eLOC0_smt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]);
-        m_eLOC1_smt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]);
-        m_ePHI_smt.push_back(parameter.parameters()[Acts::ParDef::ePHI]);
-        m_eTHETA_smt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]);
-        m_eQOP_smt.push_back(parameter.parameters()[Acts::ParDef::eQOP]);
-        m_eT_smt.push_back(parameter.parameters()[Acts::ParDef::eT]);
-
-        // smoothed residual
-        m_res_eLOC0_smt.push_back(parameter.parameters()[Acts::ParDef::eLOC_0]
-                                  - truthLOC0);
-        m_res_eLOC1_smt.push_back(parameter.parameters()[Acts::ParDef::eLOC_1]
-                                  - truthLOC1);
-        m_res_ePHI_smt.push_back(parameter.parameters()[Acts::ParDef::ePHI]
-                                 - truthPHI);
-        m_res_eTHETA_smt.push_back(parameter.parameters()[Acts::ParDef::eTHETA]
-                                   - truthTHETA);
-        m_res_eQOP_smt.push_back(parameter.parameters()[Acts::ParDef::eQOP]
-                                 - truthQOP);
-        m_res_eT_smt.push_back(parameter.parameters()[Acts::ParDef::eT]
-                               - truthTIME);
-
-        // smoothed parameter error
-        m_err_eLOC0_smt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_err_eLOC1_smt.push_back(
-            sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_err_ePHI_smt.push_back(
-            sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_err_eTHETA_smt.push_back(
-            sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_err_eQOP_smt.push_back(
-            sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_err_eT_smt.push_back(
-            sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // smoothed parameter pull
-        m_pull_eLOC0_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_0] - truthLOC0)
-            / sqrt(covariance(Acts::ParDef::eLOC_0, Acts::ParDef::eLOC_0)));
-        m_pull_eLOC1_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::eLOC_1] - truthLOC1)
-            / sqrt(covariance(Acts::ParDef::eLOC_1, Acts::ParDef::eLOC_1)));
-        m_pull_ePHI_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::ePHI] - truthPHI)
-            / sqrt(covariance(Acts::ParDef::ePHI, Acts::ParDef::ePHI)));
-        m_pull_eTHETA_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::eTHETA] - truthTHETA)
-            / sqrt(covariance(Acts::ParDef::eTHETA, Acts::ParDef::eTHETA)));
-        m_pull_eQOP_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::eQOP] - truthQOP)
-            / sqrt(covariance(Acts::ParDef::eQOP, Acts::ParDef::eQOP)));
-        m_pull_eT_smt.push_back(
-            (parameter.parameters()[Acts::ParDef::eT] - truthTIME)
-            / sqrt(covariance(Acts::ParDef::eT, Acts::ParDef::eT)));
-
-        // further smoothed parameter info
-        m_x_smt.push_back(parameter.position().x());
-        m_y_smt.push_back(parameter.position().y());
-        m_z_smt.push_back(parameter.position().z());
-        m_px_smt.push_back(parameter.momentum().x());
-        m_py_smt.push_back(parameter.momentum().y());
-        m_pz_smt.push_back(parameter.momentum().z());
-        m_pT_smt.push_back(parameter.pT());
-        m_eta_smt.push_back(eta(parameter.position()));
+        b.smt.fill(parameter, truth);
       } else {
-        // push default values if no smoothed parameter
-        m_eLOC0_smt.push_back(-99.);
-        m_eLOC1_smt.push_back(-99.);
-        m_ePHI_smt.push_back(-99.);
-        m_eTHETA_smt.push_back(-99.);
-        m_eQOP_smt.push_back(-99.);
-        m_eT_smt.push_back(-99.);
-        m_res_eLOC0_smt.push_back(-99.);
-        m_res_eLOC1_smt.push_back(-99.);
-        m_res_ePHI_smt.push_back(-99.);
-        m_res_eTHETA_smt.push_back(-99.);
-        m_res_eQOP_smt.push_back(-99.);
-        m_res_eT_smt.push_back(-99.);
-        m_err_eLOC0_smt.push_back(-99);
-        m_err_eLOC1_smt.push_back(-99);
-        m_err_ePHI_smt.push_back(-99);
-        m_err_eTHETA_smt.push_back(-99);
-        m_err_eQOP_smt.push_back(-99);
-        m_err_eT_smt.push_back(-99);
-        m_pull_eLOC0_smt.push_back(-99.);
-        m_pull_eLOC1_smt.push_back(-99.);
-        m_pull_ePHI_smt.push_back(-99.);
-        m_pull_eTHETA_smt.push_back(-99.);
-        m_pull_eQOP_smt.push_back(-99.);
-        m_pull_eT_smt.push_back(-99.);
-        m_x_smt.push_back(-99.);
-        m_y_smt.push_back(-99.);
-        m_z_smt.push_back(-99.);
-        m_px_smt.push_back(-99.);
-        m_py_smt.push_back(-99.);
-        m_pz_smt.push_back(-99.);
-        m_pT_smt.push_back(-99.);
-        m_eta_smt.push_back(-99.);
+        b.smt.fillMissing();
       }
+    }
+    return true;
+  });  // all states
 
-      m_prt.push_back(predicted);
-      m_flt.push_back(filtered);
-      m_smt.push_back(smoothed);
-      return true;
-    });  // all states
+  return true;
+}
 
-    // fill the variables for one track to tree
-    m_outputTree->Fill();
-
-    // now reset
-    m_t_x.clear();
-    m_t_y.clear();
-    m_t_z.clear();
-    m_t_r.clear();
-    m_t_dx.clear();
-    m_t_dy.clear();
-    m_t_dz.clear();
-    m_t_eLOC0.clear();
-    m_t_eLOC1.clear();
-    m_t_ePHI.clear();
-    m_t_eTHETA.clear();
-    m_t_eQOP.clear();
-    m_t_eT.clear();
-
-    m_volumeID.clear();
-    m_layerID.clear();
-    m_moduleID.clear();
-    m_lx_hit.clear();
-    m_ly_hit.clear();
-    m_x_hit.clear();
-    m_y_hit.clear();
-    m_z_hit.clear();
-    m_res_x_hit.clear();
-    m_res_y_hit.clear();
-    m_err_x_hit.clear();
-    m_err_y_hit.clear();
-    m_pull_x_hit.clear();
-    m_pull_y_hit.clear();
-    m_dim_hit.clear();
-
-    m_prt.clear();
-    m_eLOC0_prt.clear();
-    m_eLOC1_prt.clear();
-    m_ePHI_prt.clear();
-    m_eTHETA_prt.clear();
-    m_eQOP_prt.clear();
-    m_eT_prt.clear();
-    m_res_eLOC0_prt.clear();
-    m_res_eLOC1_prt.clear();
-    m_res_ePHI_prt.clear();
-    m_res_eTHETA_prt.clear();
-    m_res_eQOP_prt.clear();
-    m_res_eT_prt.clear();
-    m_err_eLOC0_prt.clear();
-    m_err_eLOC1_prt.clear();
-    m_err_ePHI_prt.clear();
-    m_err_eTHETA_prt.clear();
-    m_err_eQOP_prt.clear();
-    m_err_eT_prt.clear();
-    m_pull_eLOC0_prt.clear();
-    m_pull_eLOC1_prt.clear();
-    m_pull_ePHI_prt.clear();
-    m_pull_eTHETA_prt.clear();
-    m_pull_eQOP_prt.clear();
-    m_pull_eT_prt.clear();
-    m_x_prt.clear();
-    m_y_prt.clear();
-    m_z_prt.clear();
-    m_px_prt.clear();
-    m_py_prt.clear();
-    m_pz_prt.clear();
-    m_eta_prt.clear();
-    m_pT_prt.clear();
-
-    m_flt.clear();
-    m_eLOC0_flt.clear();
-    m_eLOC1_flt.clear();
-    m_ePHI_flt.clear();
-    m_eTHETA_flt.clear();
-    m_eQOP_flt.clear();
-    m_eT_flt.clear();
-    m_res_eLOC0_flt.clear();
-    m_res_eLOC1_flt.clear();
-    m_res_ePHI_flt.clear();
-    m_res_eTHETA_flt.clear();
-    m_res_eQOP_flt.clear();
-    m_res_eT_flt.clear();
-    m_err_eLOC0_flt.clear();
-    m_err_eLOC1_flt.clear();
-    m_err_ePHI_flt.clear();
-    m_err_eTHETA_flt.clear();
-    m_err_eQOP_flt.clear();
-    m_err_eT_flt.clear();
-    m_pull_eLOC0_flt.clear();
-    m_pull_eLOC1_flt.clear();
-    m_pull_ePHI_flt.clear();
-    m_pull_eTHETA_flt.clear();
-    m_pull_eQOP_flt.clear();
-    m_pull_eT_flt.clear();
-    m_x_flt.clear();
-    m_y_flt.clear();
-    m_z_flt.clear();
-    m_px_flt.clear();
-    m_py_flt.clear();
-    m_pz_flt.clear();
-    m_eta_flt.clear();
-    m_pT_flt.clear();
-    m_chi2.clear();
-
-    m_smt.clear();
-    m_eLOC0_smt.clear();
-    m_eLOC1_smt.clear();
-    m_ePHI_smt.clear();
-    m_eTHETA_smt.clear();
-    m_eQOP_smt.clear();
-    m_eT_smt.clear();
-    m_res_eLOC0_smt.clear();
-    m_res_eLOC1_smt.clear();
-    m_res_ePHI_smt.clear();
-    m_res_eTHETA_smt.clear();
-    m_res_eQOP_smt.clear();
-    m_res_eT_smt.clear();
-    m_err_eLOC0_smt.clear();
-    m_err_eLOC1_smt.clear();
-    m_err_ePHI_smt.clear();
-    m_err_eTHETA_smt.clear();
-    m_err_eQOP_smt.clear();
-    m_err_eT_smt.clear();
-    m_pull_eLOC0_smt.clear();
-    m_pull_eLOC1_smt.clear();
-    m_pull_ePHI_smt.clear();
-    m_pull_eTHETA_smt.clear();
-    m_pull_eQOP_smt.clear();
-    m_pull_eT_smt.clear();
-    m_x_smt.clear();
-    m_y_smt.clear();
-    m_z_smt.clear();
-    m_px_smt.clear();
-    m_py_smt.clear();
-    m_pz_smt.clear();
-    m_eta_smt.clear();
-    m_pT_smt.clear();
+void
+FW::RootTrajectoryWriter::StateParameters::book(RootBranchBooker&  tree,
+                                                const std::string& name,
+                                                const std::string& suffix)
+{
+  // e.g. nPredicted for the predicted parameters
+  std::string count = name;
+  count[0]          = std::toupper(count[0]);
+  tree.Branch(("n" + count).c_str(), &num);
+  tree.Branch(name.c_str(), &status);
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    const auto& parName = kParameterNames[parID];
+    tree.Branch((parName + "_" + suffix).c_str(), &par[parID]);
+  }
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    const auto& parName = kParameterNames[parID];
+    tree.Branch(("res_" + parName + "_" + suffix).c_str(), &res[parID]);
+  }
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    const auto& parName = kParameterNames[parID];
+    tree.Branch(("err_" + parName + "_" + suffix).c_str(), &err[parID]);
+  }
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    const auto& parName = kParameterNames[parID];
+    tree.Branch(("pull_" + parName + "_" + suffix).c_str(), &pull[parID]);
+  }
+  tree.Branch(("g_x_" + suffix).c_str(), &x);
+  tree.Branch(("g_y_" + suffix).c_str(), &y);
+  tree.Branch(("g_z_" + suffix).c_str(), &z);
+  tree.Branch(("px_" + suffix).c_str(), &px);
+  tree.Branch(("py_" + suffix).c_str(), &py);
+  tree.Branch(("pz_" + suffix).c_str(), &pz);
+  tree.Branch(("eta_" + suffix).c_str(), &eta);
+  tree.Branch(("pT_" + suffix).c_str(), &pT);
+}
 
-    iTraj++;
-  }  // all trajectories
+void
+FW::RootTrajectoryWriter::StateParameters::fill(
+    const Acts::BoundParameters& parameters,
+    const Acts::BoundVector&     truth)
+{
+  const auto& values     = parameters.parameters();
+  const auto& covariance = *parameters.covariance();
+  num++;
+  status.push_back(true);
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    float error = std::sqrt(covariance(parID, parID));
+    par[parID].push_back(values[parID]);
+    res[parID].push_back(values[parID] - truth[parID]);
+    err[parID].push_back(error);
+    pull[parID].push_back((values[parID] - truth[parID]) / error);
+  }
+  x.push_back(parameters.position().x());
+  y.push_back(parameters.position().y());
+  z.push_back(parameters.position().z());
+  px.push_back(parameters.momentum().x());
+  py.push_back(parameters.momentum().y());
+  pz.push_back(parameters.momentum().z());
+  pT.push_back(parameters.pT());
+  eta.push_back(Acts::VectorHelpers::eta(parameters.position()));
+}
 
-  return ProcessCode::SUCCESS;
+void
+FW::RootTrajectoryWriter::StateParameters::fillMissing()
+{
+  status.push_back(false);
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    par[parID].push_back(-99.);
+    res[parID].push_back(-99.);
+    err[parID].push_back(-99.);
+    pull[parID].push_back(-99.);
+  }
+  x.push_back(-99.);
+  y.push_back(-99.);
+  z.push_back(-99.);
+  px.push_back(-99.);
+  py.push_back(-99.);
+  pz.push_back(-99.);
+  pT.push_back(-99.);
+  eta.push_back(-99.);
+}
+
+void
+FW::RootTrajectoryWriter::StateParameters::clear()
+{
+  num = 0;
+  status.clear();
+  for (unsigned int parID = 0; parID < Acts::BoundParsDim; parID++) {
+    par[parID].clear();
+    res[parID].clear();
+    err[parID].clear();
+    pull[parID].clear();
+  }
+  x.clear();
+  y.clear();
+  z.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  eta.clear();
+  pT.clear();
+}
+
+void
+FW::RootTrajectoryWriter::Buffers::clear()
+{
+  t_barcode = 0;
+  t_charge  = 0;
+  t_time    = 0;
+  t_vx      = -99.;
+  t_vy      = -99.;
+  t_vz      = -99.;
+  t_px      = -99.;
+  t_py      = -99.;
+  t_pz      = -99.;
+  t_theta   = -99.;
+  t_phi     = -99.;
+  t_pT      = -99.;
+  t_eta     = -99.;
+  t_x.clear();
+  t_y.clear();
+  t_z.clear();
+  t_r.clear();
+  t_dx.clear();
+  t_dy.clear();
+  t_dz.clear();
+  for (auto& values : t_par) { values.clear(); }
+
+  nStates       = 0;
+  nMeasurements = 0;
+  volumeID.clear();
+  layerID.clear();
+  moduleID.clear();
+  lx_hit.clear();
+  ly_hit.clear();
+  x_hit.clear();
+  y_hit.clear();
+  z_hit.clear();
+  res_x_hit.clear();
+  res_y_hit.clear();
+  err_x_hit.clear();
+  err_y_hit.clear();
+  pull_x_hit.clear();
+  pull_y_hit.clear();
+  dim_hit.clear();
+
+  hasFittedParams = false;
+  fit.fill(-99.);
+  err_fit.fill(-99.);
+
+  prt.clear();
+  flt.clear();
+  smt.clear();
+  chi2.clear();
 }
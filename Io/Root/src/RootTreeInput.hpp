@@ -0,0 +1,127 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Input chain that can be read from multiple threads
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <TChain.h>
+
+namespace FW {
+
+/// Input chain that can be read from multiple threads without locking.
+///
+/// Each reading thread gets its own `TChain` over the same files together
+/// with its own branch buffers. Entries are thus read, decompressed, and
+/// converted concurrently. Only the lookup of the per-thread chain is
+/// serialized. Each chain uses a `TTreeCache` to prefetch the baskets of all
+/// branches with a few large reads. Baskets of different branches are only
+/// decompressed in parallel if the application enabled ROOT's implicit
+/// multi-threading, see `enableRootImplicitMT`.
+///
+/// @tparam buffers_t Branch buffers; one instance per chain
+template <typename buffers_t>
+class RootTreeInput
+{
+public:
+  /// Set the branch addresses of a new chain to the given buffers.
+  using BookFunction = std::function<void(TChain&, buffers_t&)>;
+
+  struct Config
+  {
+    std::string              treeName;  ///< name of the input tree
+    std::vector<std::string> fileList;  ///< input files
+    /// Size of the per-thread tree cache in bytes; zero to disable.
+    long long cacheSize = 10 * 1024 * 1024;
+  };
+
+  RootTreeInput(const Config& cfg, BookFunction book);
+
+  /// Total number of entries in all input files.
+  size_t
+  numEntries() const
+  {
+    return m_numEntries;
+  }
+
+  /// Read an entry into the buffers of the calling thread.
+  ///
+  /// @return Buffers that stay valid until the next call from this thread
+  const buffers_t&
+  read(size_t entry);
+
+private:
+  struct Slot
+  {
+    buffers_t               buffers;
+    std::unique_ptr<TChain> chain;
+  };
+
+  std::unique_ptr<TChain>
+  makeChain() const;
+
+  Config       m_cfg;
+  BookFunction m_book;
+  size_t       m_numEntries = 0;
+  std::mutex   m_slotsMutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<Slot>> m_slots;
+};
+
+}  // namespace FW
+
+template <typename buffers_t>
+inline FW::RootTreeInput<buffers_t>::RootTreeInput(const Config& cfg,
+                                                   BookFunction  book)
+  : m_cfg(cfg), m_book(std::move(book))
+{
+  m_numEntries = makeChain()->GetEntries();
+}
+
+template <typename buffers_t>
+inline std::unique_ptr<TChain>
+FW::RootTreeInput<buffers_t>::makeChain() const
+{
+  auto chain = std::make_unique<TChain>(m_cfg.treeName.c_str());
+  for (const auto& inputFile : m_cfg.fileList) {
+    chain->Add(inputFile.c_str());
+  }
+  return chain;
+}
+
+template <typename buffers_t>
+inline const buffers_t&
+FW::RootTreeInput<buffers_t>::read(size_t entry)
+{
+  Slot* slot = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_slotsMutex);
+    auto&                       owned = m_slots[std::this_thread::get_id()];
+    if (not owned) {
+      owned        = std::make_unique<Slot>();
+      owned->chain = makeChain();
+      m_book(*owned->chain, owned->buffers);
+      if (0 < m_cfg.cacheSize) {
+        owned->chain->SetCacheSize(m_cfg.cacheSize);
+        owned->chain->AddBranchToCache("*", true);
+      }
+    }
+    slot = owned.get();
+  }
+  slot->chain->GetEntry(entry);
+  return slot->buffers;
+}
@@ -0,0 +1,372 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Output tree or ntuple that can be filled from multiple threads
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <ios>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ROOT/TBufferMerger.hxx>
+#include <TFile.h>
+#include <TTree.h>
+#ifdef ACTFW_ROOT_NTUPLE
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#endif
+
+namespace FW {
+
+/// Book branches either in a `TTree` or as fields of an `RNTuple` model.
+///
+/// The interface mirrors `TTree::Branch` so the same booking code can be used
+/// for both output formats. For the ntuple, the buffer addresses are recorded
+/// and bound to the entry that is filled.
+class RootBranchBooker
+{
+public:
+  explicit RootBranchBooker(TTree& tree) : m_tree(&tree) {}
+#ifdef ACTFW_ROOT_NTUPLE
+  explicit RootBranchBooker(ROOT::Experimental::RNTupleModel& model)
+    : m_model(&model)
+  {
+  }
+#endif
+
+  template <typename T>
+  void
+  Branch(const char* name, T* address)
+  {
+    if (m_tree) {
+      m_tree->Branch(name, address);
+      return;
+    }
+#ifdef ACTFW_ROOT_NTUPLE
+    // nested containers are mapped to native collection fields
+    m_model->MakeField<T>(name);
+    m_addresses.emplace_back(name, static_cast<void*>(address));
+#endif
+  }
+  /// The leaf list is only used for trees; ntuple fields use the C++ type.
+  template <typename T>
+  void
+  Branch(const char* name, T* address, const char* leaflist)
+  {
+    if (m_tree) {
+      m_tree->Branch(name, address, leaflist);
+      return;
+    }
+    Branch(name, address);
+  }
+
+  /// Field names and the addresses of their buffers.
+  const std::vector<std::pair<std::string, void*>>&
+  addresses() const
+  {
+    return m_addresses;
+  }
+
+private:
+  TTree* m_tree = nullptr;
+#ifdef ACTFW_ROOT_NTUPLE
+  ROOT::Experimental::RNTupleModel* m_model = nullptr;
+#endif
+  std::vector<std::pair<std::string, void*>> m_addresses;
+};
+
+/// Output tree or ntuple that can be filled from multiple threads.
+///
+/// In the default shared mode, all threads fill a single tree in a single
+/// file and access is serialized using a mutex.
+///
+/// In the ntuple mode, a single `RNTuple` is filled instead of the tree and
+/// access is serialized as well. Nested vectors are stored as native
+/// collections. Pages are only compressed in parallel if the application has
+/// enabled ROOT's implicit multi-threading, i.e. with the `root-implicit-mt`
+/// option or `enableRootImplicitMT`; otherwise they are compressed in the
+/// filling thread while holding the lock. Requires a build with
+/// `ACTFW_ROOT_NTUPLE`.
+///
+/// In the parallel mode, each thread fills its own tree in a separate
+/// in-memory file provided by a `TBufferMerger`. Every `flushEvents` events
+/// the in-memory file is handed to the merger, which appends it to the output
+/// file in the background. Serialization and compression of the baskets thus
+/// run concurrently in the filling threads and only the merge is serialized.
+/// Entries from different threads are interleaved in blocks, i.e. the entry
+/// order in the output tree is not the event order.
+///
+/// @tparam buffers_t Branch buffers; one instance per tree or ntuple
+template <typename buffers_t>
+class RootTreeOutput
+{
+private:
+  struct Slot
+  {
+    std::shared_ptr<ROOT::Experimental::TBufferMergerFile> file;
+    TTree*                                                  tree = nullptr;
+    buffers_t                                               buffers;
+    size_t                                                  numEvents = 0;
+  };
+
+public:
+  /// Setup the branches of a new tree or ntuple using the given buffers.
+  using BookFunction = std::function<void(RootBranchBooker&, buffers_t&)>;
+
+  struct Config
+  {
+    std::string filePath;               ///< path of the output file
+    std::string fileMode = "RECREATE";  ///< file access mode
+    std::string treeName;               ///< name of the output tree
+    std::string treeTitle;              ///< title of the output tree
+    TFile*      rootFile = nullptr;     ///< common root file
+    bool        parallel = false;       ///< fill per-thread trees
+    bool        ntuple   = false;       ///< fill an ntuple instead of a tree
+    /// Number of events after which a per-thread tree is sent to the merger.
+    size_t flushEvents = 100;
+  };
+
+  /// @throws std::invalid_argument for parallel or ntuple output to a common
+  ///         file, parallel ntuple output, or unsupported ntuple output
+  /// @throws std::ios_base::failure if the output file can not be opened
+  RootTreeOutput(const Config& cfg, BookFunction book);
+  RootTreeOutput(const RootTreeOutput&) = delete;
+  RootTreeOutput&
+  operator=(const RootTreeOutput&)
+      = delete;
+  /// Writes pending entries and closes the file if it's ours.
+  ~RootTreeOutput();
+
+  /// Exclusive access to the output and its buffers while filling one event.
+  class Handle
+  {
+  public:
+    Handle(const Handle&) = delete;
+    Handle&
+    operator=(const Handle&)
+        = delete;
+    /// Hands the filled entries to the merger if necessary.
+    ~Handle();
+
+    /// Fill the current buffer content as a new entry.
+    void
+    fill();
+    buffers_t&
+    buffers()
+    {
+      return m_slot.buffers;
+    }
+
+  private:
+    friend class RootTreeOutput;
+
+    Handle(RootTreeOutput& output, std::unique_lock<std::mutex> lock);
+
+    RootTreeOutput&              m_output;
+    std::unique_lock<std::mutex> m_lock;
+    Slot&                        m_slot;
+  };
+
+  /// Acquire the tree and buffers to be filled by the calling thread.
+  ///
+  /// Blocks in the shared mode until no other thread is filling.
+  Handle
+  acquire();
+
+  /// Write the tree(s) or the ntuple to the output file.
+  ///
+  /// Must be called at most once after all entries have been filled.
+  void
+  write();
+
+private:
+  Slot&
+  threadSlot();
+
+  Config       m_cfg;
+  BookFunction m_book;
+  // shared mode
+  std::mutex m_sharedMutex;
+  TFile*     m_file = nullptr;
+  Slot       m_shared;
+#ifdef ACTFW_ROOT_NTUPLE
+  // ntuple mode
+  std::unique_ptr<ROOT::Experimental::RNTupleWriter> m_ntuple;
+  std::unique_ptr<ROOT::Experimental::REntry>        m_entry;
+#endif
+  // parallel mode
+  std::unique_ptr<ROOT::Experimental::TBufferMerger>          m_merger;
+  std::mutex                                                  m_slotsMutex;
+  std::unordered_map<std::thread::id, std::unique_ptr<Slot>> m_slots;
+  bool m_written = false;
+};
+
+}  // namespace FW
+
+template <typename buffers_t>
+inline FW::RootTreeOutput<buffers_t>::RootTreeOutput(const Config& cfg,
+                                                     BookFunction  book)
+  : m_cfg(cfg), m_book(std::move(book))
+{
+  if (m_cfg.ntuple) {
+    if (m_cfg.parallel or (m_cfg.rootFile != nullptr)) {
+      throw std::invalid_argument(
+          "Ntuple output requires a separate file and shared filling");
+    }
+#ifdef ACTFW_ROOT_NTUPLE
+    using namespace ROOT::Experimental;
+    auto             model = RNTupleModel::Create();
+    RootBranchBooker booker(*model);
+    m_book(booker, m_shared.buffers);
+    RNTupleWriteOptions options;
+    options.SetUseBufferedWrite(true);
+    // throws on failure to open the file
+    m_ntuple = RNTupleWriter::Recreate(
+        std::move(model), m_cfg.treeName, m_cfg.filePath, options);
+    m_entry = m_ntuple->CreateEntry();
+    for (const auto& field : booker.addresses()) {
+      m_entry->CaptureValueUnsafe(field.first, field.second);
+    }
+    return;
+#else
+    throw std::invalid_argument("Ntuple output is not supported by this build");
+#endif
+  }
+  if (m_cfg.parallel) {
+    if (m_cfg.rootFile != nullptr) {
+      throw std::invalid_argument(
+          "Parallel output is not supported for a common root file");
+    }
+    // throws on failure to open the file
+    m_merger = std::make_unique<ROOT::Experimental::TBufferMerger>(
+        m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
+    return;
+  }
+
+  m_file = m_cfg.rootFile;
+  if (m_file == nullptr) {
+    m_file = TFile::Open(m_cfg.filePath.c_str(), m_cfg.fileMode.c_str());
+    if (m_file == nullptr) {
+      throw std::ios_base::failure("Could not open '" + m_cfg.filePath + "'");
+    }
+  }
+  m_file->cd();
+  m_shared.tree = new TTree(m_cfg.treeName.c_str(), m_cfg.treeTitle.c_str());
+  RootBranchBooker booker(*m_shared.tree);
+  m_book(booker, m_shared.buffers);
+}
+
+template <typename buffers_t>
+inline FW::RootTreeOutput<buffers_t>::~RootTreeOutput()
+{
+  if (m_merger and not m_written) { write(); }
+  // the merger closes its output file when it is destroyed
+  if (m_file and (m_cfg.rootFile == nullptr)) { m_file->Close(); }
+}
+
+template <typename buffers_t>
+inline FW::RootTreeOutput<buffers_t>::Handle::Handle(
+    RootTreeOutput&              output,
+    std::unique_lock<std::mutex> lock)
+  : m_output(output)
+  , m_lock(std::move(lock))
+  , m_slot(output.m_merger ? output.threadSlot() : output.m_shared)
+{
+}
+
+template <typename buffers_t>
+inline FW::RootTreeOutput<buffers_t>::Handle::~Handle()
+{
+  if (not m_output.m_merger) { return; }
+  if (m_output.m_cfg.flushEvents <= ++m_slot.numEvents) {
+    // serializes and compresses in this thread; merging happens elsewhere
+    m_slot.file->Write();
+    m_slot.numEvents = 0;
+  }
+}
+
+template <typename buffers_t>
+inline void
+FW::RootTreeOutput<buffers_t>::Handle::fill()
+{
+#ifdef ACTFW_ROOT_NTUPLE
+  if (m_output.m_ntuple) {
+    m_output.m_ntuple->Fill(*m_output.m_entry);
+    return;
+  }
+#endif
+  m_slot.tree->Fill();
+}
+
+template <typename buffers_t>
+inline typename FW::RootTreeOutput<buffers_t>::Handle
+FW::RootTreeOutput<buffers_t>::acquire()
+{
+  if (m_merger) { return Handle(*this, std::unique_lock<std::mutex>()); }
+  return Handle(*this, std::unique_lock<std::mutex>(m_sharedMutex));
+}
+
+template <typename buffers_t>
+inline void
+FW::RootTreeOutput<buffers_t>::write()
+{
+  m_written = true;
+#ifdef ACTFW_ROOT_NTUPLE
+  if (m_ntuple) {
+    // the page list and footer are written when the writer is destroyed
+    m_entry.reset();
+    m_ntuple.reset();
+    return;
+  }
+#endif
+  if (not m_merger) {
+    m_file->cd();
+    m_shared.tree->Write();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_slotsMutex);
+  for (auto& slot : m_slots) {
+    if (0u < slot.second->numEvents) { slot.second->file->Write(); }
+  }
+  // the files own the trees. all files must be released before the merger
+  // can finish writing the output.
+  m_slots.clear();
+  m_merger.reset();
+}
+
+template <typename buffers_t>
+inline typename FW::RootTreeOutput<buffers_t>::Slot&
+FW::RootTreeOutput<buffers_t>::threadSlot()
+{
+  std::lock_guard<std::mutex> lock(m_slotsMutex);
+
+  auto& slot = m_slots[std::this_thread::get_id()];
+  if (not slot) {
+    slot       = std::make_unique<Slot>();
+    slot->file = m_merger->GetFile();
+    // the tree is attached to and owned by the current directory
+    slot->file->cd();
+    slot->tree = new TTree(m_cfg.treeName.c_str(), m_cfg.treeTitle.c_str());
+    // avoid the global list of cleanups which requires a global lock
+    slot->tree->ResetBit(kMustCleanup);
+    RootBranchBooker booker(*slot->tree);
+    m_book(booker, slot->buffers);
+  }
+  return *slot;
+}
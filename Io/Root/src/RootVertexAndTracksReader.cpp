@@ -16,52 +16,58 @@
 
 #include "ACTFW/Framework/WhiteBoard.hpp"
 #include "ACTFW/TruthTracking/VertexAndTracks.hpp"
+#include "RootTreeInput.hpp"
 
 FW::RootVertexAndTracksReader::RootVertexAndTracksReader(
     const FW::RootVertexAndTracksReader::Config& cfg)
-  : FW::IReader(), m_cfg(cfg), m_events(0), m_inputChain(nullptr)
+  : FW::IReader(), m_cfg(cfg), m_events(0)
 {
-  m_inputChain = new TChain(m_cfg.treeName.c_str());
-
-  m_inputChain->SetBranchAddress("event_nr", &m_eventNr);
-  m_inputChain->SetBranchAddress("vx", &m_ptrVx);
-  m_inputChain->SetBranchAddress("vy", &m_ptrVy);
-  m_inputChain->SetBranchAddress("vz", &m_ptrVz);
-
-  m_inputChain->SetBranchAddress("d0", &m_ptrD0);
-  m_inputChain->SetBranchAddress("z0", &m_ptrZ0);
-  m_inputChain->SetBranchAddress("phi", &m_ptrPhi);
-  m_inputChain->SetBranchAddress("theta", &m_ptrTheta);
-  m_inputChain->SetBranchAddress("qp", &m_ptrQP);
-  m_inputChain->SetBranchAddress("time", &m_ptrTime);
-  m_inputChain->SetBranchAddress("vtxID", &m_ptrVtxID);
-  m_inputChain->SetBranchAddress("trkCov", &m_ptrTrkCov);
-
-  // loop over the input files
+  RootTreeInput<Buffers>::Config inputCfg;
+  inputCfg.treeName  = m_cfg.treeName;
+  inputCfg.fileList  = m_cfg.fileList;
+  inputCfg.cacheSize = m_cfg.cacheSize;
+
+  auto book = [](TChain& chain, Buffers& b) {
+    chain.SetBranchAddress("event_nr", &b.eventNr);
+    chain.SetBranchAddress("vx", &b.ptrVx);
+    chain.SetBranchAddress("vy", &b.ptrVy);
+    chain.SetBranchAddress("vz", &b.ptrVz);
+
+    chain.SetBranchAddress("d0", &b.ptrD0);
+    chain.SetBranchAddress("z0", &b.ptrZ0);
+    chain.SetBranchAddress("phi", &b.ptrPhi);
+    chain.SetBranchAddress("theta", &b.ptrTheta);
+    chain.SetBranchAddress("qp", &b.ptrQP);
+    chain.SetBranchAddress("time", &b.ptrTime);
+    chain.SetBranchAddress("vtxID", &b.ptrVtxID);
+    chain.SetBranchAddress("trkCov", &b.ptrTrkCov);
+  };
+
+  // each reading thread adds the input files to its own chain
   for (auto inputFile : m_cfg.fileList) {
-    // add file to the input chain
-    m_inputChain->Add(inputFile.c_str());
     ACTS_DEBUG("Adding File " << inputFile << " to tree '" << m_cfg.treeName
                               << "'.");
   }
-
-  m_events = m_inputChain->GetEntries();
+  m_input  = std::make_unique<RootTreeInput<Buffers>>(inputCfg, book);
+  m_events = m_input->numEntries();
   ACTS_DEBUG("The full chain has " << m_events << " entries.");
 }
 
-FW::RootVertexAndTracksReader::~RootVertexAndTracksReader()
+FW::RootVertexAndTracksReader::~RootVertexAndTracksReader() = default;
+
+FW::RootVertexAndTracksReader::Buffers::~Buffers()
 {
-  delete m_ptrVx;
-  delete m_ptrVy;
-  delete m_ptrVz;
-  delete m_ptrD0;
-  delete m_ptrZ0;
-  delete m_ptrPhi;
-  delete m_ptrTheta;
-  delete m_ptrQP;
-  delete m_ptrTime;
-  delete m_ptrVtxID;
-  delete m_ptrTrkCov;
+  delete ptrVx;
+  delete ptrVy;
+  delete ptrVz;
+  delete ptrD0;
+  delete ptrZ0;
+  delete ptrPhi;
+  delete ptrTheta;
+  delete ptrQP;
+  delete ptrTime;
+  delete ptrVtxID;
+  delete ptrTrkCov;
 }
 
 std::string
@@ -82,43 +88,42 @@ FW::RootVertexAndTracksReader::read(const FW::AlgorithmContext& context)
 
   ACTS_DEBUG("Trying to read vertex and tracks.");
 
-  if (m_inputChain && context.eventNumber < m_events) {
-    // Lock the mutex
-    std::lock_guard<std::mutex> lock(m_read_mutex);
-
+  if (context.eventNumber < m_events) {
     // The collection to be written
     std::vector<FW::VertexAndTracks> mCollection;
 
     for (size_t ib = 0; ib < m_cfg.batchSize; ++ib) {
 
       // Read the correct entry: batch size * event_number + ib
-      m_inputChain->GetEntry(m_cfg.batchSize * context.eventNumber + ib);
+      // into the buffers of this thread; no lock is needed
+      const Buffers& b
+          = m_input->read(m_cfg.batchSize * context.eventNumber + ib);
       ACTS_VERBOSE("Reading entry: " << m_cfg.batchSize * context.eventNumber
                        + ib);
 
       // Loop over all vertices
-      for (int idx = 0; idx < m_ptrVx->size(); ++idx) {
+      for (int idx = 0; idx < b.ptrVx->size(); ++idx) {
         FW::VertexAndTracks vtxAndTracks;
         vtxAndTracks.vertex.position
-            = Acts::Vector3D((*m_ptrVx)[idx], (*m_ptrVy)[idx], (*m_ptrVz)[idx]);
+            = Acts::Vector3D((*b.ptrVx)[idx], (*b.ptrVy)[idx], (*b.ptrVz)[idx]);
 
         std::vector<Acts::BoundParameters> tracks;
         // Loop over all tracks in current event
-        for (int trkId = 0; trkId < m_ptrD0->size(); ++trkId) {
+        for (int trkId = 0; trkId < b.ptrD0->size(); ++trkId) {
           // Take only tracks that belong to current vertex
-          if ((*m_ptrVtxID)[trkId] == idx) {
+          if ((*b.ptrVtxID)[trkId] == idx) {
             // Get track parameter
             Acts::BoundVector newTrackParams;
-            newTrackParams << (*m_ptrD0)[trkId], (*m_ptrZ0)[trkId],
-                (*m_ptrPhi)[trkId], (*m_ptrTheta)[trkId], (*m_ptrQP)[trkId],
-                (*m_ptrTime)[trkId];
+            newTrackParams << (*b.ptrD0)[trkId], (*b.ptrZ0)[trkId],
+                (*b.ptrPhi)[trkId], (*b.ptrTheta)[trkId], (*b.ptrQP)[trkId],
+                (*b.ptrTime)[trkId];
 
             // Get track covariance vector
-            std::vector<double> trkCovVec = (*m_ptrTrkCov)[trkId];
+            const std::vector<double>& trkCovVec = (*b.ptrTrkCov)[trkId];
 
             // Construct track covariance
             Acts::BoundSymMatrix covMat
-                = Eigen::Map<Acts::BoundSymMatrix>(trkCovVec.data());
+                = Eigen::Map<const Acts::BoundSymMatrix>(trkCovVec.data());
 
             // Create track parameters and add to track list
             std::shared_ptr<Acts::PerigeeSurface> perigeeSurface
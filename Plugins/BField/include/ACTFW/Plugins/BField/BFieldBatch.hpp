@@ -0,0 +1,77 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Evaluate magnetic fields for many positions at once
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "Acts/Utilities/Definitions.hpp"
+
+namespace FW {
+
+namespace BField {
+
+  namespace detail {
+    template <typename field_t, typename = void>
+    struct HasFieldBatch : std::false_type
+    {
+    };
+    template <typename field_t>
+    struct HasFieldBatch<
+        field_t,
+        std::void_t<decltype(std::declval<const field_t&>().getFieldBatch(
+            std::declval<const Acts::Vector3D*>(),
+            std::declval<Acts::Vector3D*>(),
+            std::declval<size_t>(),
+            std::declval<typename field_t::Cache&>()))>> : std::true_type
+    {
+    };
+  }  // namespace detail
+
+  /// Retrieve the magnetic field values for many positions.
+  ///
+  /// Uses the batch lookup of the field if available, e.g. for the
+  /// `CompactBFieldMap` and the `ScalableBField`, and otherwise the cached
+  /// single position lookup for each position.
+  ///
+  /// The core `InterpolatedBFieldMap` always uses the single lookups. It only
+  /// returns copies of its mapper and keeps the corner values of its cached
+  /// cell private, so a batched interpolation here would have to copy the
+  /// full grid for every call. Interpolated xyz maps that should be evaluated
+  /// in batches must be converted into a `CompactBFieldMap` once instead,
+  /// e.g. with the `bf-compact` option.
+  ///
+  /// @param bField Magnetic field service
+  /// @param positions Global positions
+  /// @param fields Output magnetic field vectors, one per position
+  /// @param size Number of positions
+  /// @param cache Field cache that is reused for all positions
+  template <typename field_t>
+  void
+  getFieldBatch(const field_t&           bField,
+                const Acts::Vector3D*    positions,
+                Acts::Vector3D*          fields,
+                size_t                   size,
+                typename field_t::Cache& cache)
+  {
+    if constexpr (detail::HasFieldBatch<field_t>::value) {
+      bField.getFieldBatch(positions, fields, size, cache);
+    } else {
+      for (size_t i = 0; i < size; ++i) {
+        fields[i] = bField.getField(positions[i], cache);
+      }
+    }
+  }
+
+}  // namespace BField
+}  // namespace FW
@@ -0,0 +1,91 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file
+/// @brief Binary cache for interpolated magnetic field maps
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "Acts/MagneticField/InterpolatedBFieldMap.hpp"
+#include "Acts/Utilities/detail/Axis.hpp"
+#include "Acts/Utilities/detail/Grid.hpp"
+
+namespace FW {
+
+namespace BField {
+
+  /// Identify a field map cache by its source and conversion parameters.
+  ///
+  /// The key includes a hash of the full source file content. Any change of
+  /// the source file or the conversion parameters yields a different key.
+  ///
+  /// @param fieldMapFile Source field map file
+  /// @param treeName Tree name for root sources; empty for text sources
+  /// @param lengthUnit Length scalor used for the grid points
+  /// @param BFieldUnit Field scalor used for the field values
+  /// @param firstOctant Whether the map is mirrored from the first octant
+  /// @throws std::ios_base::failure if the source file can not be read
+  uint64_t
+  fieldMapCacheKey(const std::string& fieldMapFile,
+                   const std::string& treeName,
+                   double             lengthUnit,
+                   double             BFieldUnit,
+                   bool               firstOctant);
+
+  /// Cache file path in the given directory for a source file and key.
+  std::string
+  fieldMapCachePath(const std::string& cacheDir,
+                    const std::string& fieldMapFile,
+                    uint64_t           key);
+
+  /// Load an rz field mapper from the cache or build and cache it.
+  ///
+  /// The cache stores the final grid with all axes and values. It is
+  /// memory-mapped on load and copied into the grid without any parsing.
+  /// Missing, corrupt, or outdated caches are silently rebuilt. Failures to
+  /// write the cache are reported but not fatal.
+  ///
+  /// @param cacheFile Cache file path; empty to always build
+  /// @param key Expected cache key
+  /// @param build Build the mapper from the source file
+  Acts::InterpolatedBFieldMapper<
+      Acts::detail::Grid<Acts::Vector2D,
+                         Acts::detail::EquidistantAxis,
+                         Acts::detail::EquidistantAxis>>
+  cachedFieldMapperRZ(
+      const std::string& cacheFile,
+      uint64_t           key,
+      const std::function<Acts::InterpolatedBFieldMapper<
+          Acts::detail::Grid<Acts::Vector2D,
+                             Acts::detail::EquidistantAxis,
+                             Acts::detail::EquidistantAxis>>()>& build);
+
+  /// Load an xyz field mapper from the cache or build and cache it.
+  ///
+  /// @see cachedFieldMapperRZ
+  Acts::InterpolatedBFieldMapper<
+      Acts::detail::Grid<Acts::Vector3D,
+                         Acts::detail::EquidistantAxis,
+                         Acts::detail::EquidistantAxis,
+                         Acts::detail::EquidistantAxis>>
+  cachedFieldMapperXYZ(
+      const std::string& cacheFile,
+      uint64_t           key,
+      const std::function<Acts::InterpolatedBFieldMapper<
+          Acts::detail::Grid<Acts::Vector3D,
+                             Acts::detail::EquidistantAxis,
+                             Acts::detail::EquidistantAxis,
+                             Acts::detail::EquidistantAxis>>()>& build);
+
+}  // namespace BField
+
+}  // namespace FW
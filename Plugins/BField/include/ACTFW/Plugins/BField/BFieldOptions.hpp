@@ -32,6 +32,7 @@ class ConstantBField;
 namespace FW {
 namespace BField {
   class ScalableBField;
+  class CompactBFieldMap;
 }
 }  // namespace FW
 
@@ -59,7 +60,8 @@ namespace Options {
       = std::variant<std::shared_ptr<InterpolatedBFieldMap2D>,
                      std::shared_ptr<InterpolatedBFieldMap3D>,
                      std::shared_ptr<Acts::ConstantBField>,
-                     std::shared_ptr<FW::BField::ScalableBField>>;
+                     std::shared_ptr<FW::BField::ScalableBField>,
+                     std::shared_ptr<FW::BField::CompactBFieldMap>>;
 
   // common bfield options, with a bf prefix
   void
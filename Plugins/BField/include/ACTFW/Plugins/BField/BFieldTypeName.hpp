@@ -0,0 +1,45 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "ACTFW/Plugins/BField/BFieldOptions.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
+#include "ACTFW/Plugins/BField/ScalableBField.hpp"
+#include "Acts/MagneticField/ConstantBField.hpp"
+
+namespace FW {
+
+namespace BField {
+
+  /// Short name of a magnetic field type, e.g. for benchmark output.
+  template <typename field_t>
+  std::string
+  fieldTypeName()
+  {
+    if constexpr (std::is_same_v<field_t, InterpolatedBFieldMap2D>) {
+      return "interpolated_rz";
+    } else if constexpr (std::is_same_v<field_t, InterpolatedBFieldMap3D>) {
+      return "interpolated_xyz";
+    } else if constexpr (std::is_same_v<field_t, CompactBFieldMap>) {
+      return "compact_xyz";
+    } else if constexpr (std::is_same_v<field_t, Acts::ConstantBField>) {
+      return "constant";
+    } else if constexpr (std::is_same_v<field_t, ScalableBField>) {
+      return "scalable";
+    } else {
+      return "unknown";
+    }
+  }
+
+}  // namespace BField
+
+}  // namespace FW
@@ -0,0 +1,268 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "Acts/MagneticField/MagneticFieldContext.hpp"
+#include "Acts/Utilities/Definitions.hpp"
+
+namespace FW {
+
+namespace BField {
+
+  /// @ingroup MagneticField
+  ///
+  /// @brief interpolated xyz field map with single precision storage
+  ///
+  /// The field values on the grid points are stored as floats in a single
+  /// contiguous array, using half the memory of the double precision grid.
+  /// The trilinear interpolation is still done in double precision.
+  ///
+  /// Optionally only the first octant is stored and the field for all other
+  /// octants is looked up at the mirrored position, i.e. at (|x|,|y|,|z|).
+  /// This is the same symmetry that is used to create a full map from a
+  /// first octant map, but without storing the mirrored grid points.
+  class CompactBFieldMap final
+  {
+  public:
+    /// @brief the map has no per-context state
+    struct Cache
+    {
+      /// @brief constructor with context
+      Cache(const Acts::MagneticFieldContext& /*mcfg*/) {}
+    };
+
+    /// @brief construct from an xyz field mapper
+    ///
+    /// The field values are converted from the grid of the mapper which can
+    /// be released afterwards.
+    ///
+    /// @param [in] mapper xyz field mapper with equidistant axes
+    /// @param [in] firstOctant look up all octants in the first octant
+    /// @throws std::invalid_argument if any axis has less than two points
+    template <typename mapper_t>
+    explicit CompactBFieldMap(const mapper_t& mapper, bool firstOctant = false)
+      : m_firstOctant(firstOctant)
+    {
+      const auto& grid   = mapper.getGrid();
+      auto        minima = mapper.getMin();
+      auto        maxima = mapper.getMax();
+      auto        nBins  = mapper.getNBins();
+      // the value of each bin is the field at its lower bin edge
+      for (size_t i = 0; i < 3; ++i) {
+        if (nBins.at(i) < 2) {
+          throw std::invalid_argument("Field map axis with less than 2 points");
+        }
+        double width  = (maxima.at(i) - minima.at(i)) / nBins.at(i);
+        m_min[i]      = minima.at(i);
+        m_max[i]      = minima.at(i) + (nBins.at(i) - 1) * width;
+        m_invWidth[i] = 1. / width;
+        m_nPoints[i]  = nBins.at(i);
+      }
+      m_stride = {m_nPoints[1] * m_nPoints[2], m_nPoints[2], 1u};
+      m_values.reserve(3 * m_nPoints[0] * m_nPoints[1] * m_nPoints[2]);
+      for (size_t i = 0; i < m_nPoints[0]; ++i) {
+        for (size_t j = 0; j < m_nPoints[1]; ++j) {
+          for (size_t k = 0; k < m_nPoints[2]; ++k) {
+            // local bin 0 is the underflow bin
+            const auto& value = grid.at({{i + 1, j + 1, k + 1}});
+            m_values.push_back(value[0]);
+            m_values.push_back(value[1]);
+            m_values.push_back(value[2]);
+          }
+        }
+      }
+    }
+
+    /// @brief retrieve magnetic field value
+    ///
+    /// @param [in] position global position
+    /// @return magnetic field vector
+    ///
+    /// @pre The given @c position must lie within the range of the field map;
+    ///      positions outside are clamped to the boundary of the map.
+    Acts::Vector3D
+    getField(const Acts::Vector3D& position) const
+    {
+      double local[3];
+      size_t base = 0;
+      for (size_t i = 0; i < 3; ++i) {
+        size_t cell;
+        local[i] = locate(position[i], i, cell);
+        base += cell * m_stride[i];
+      }
+      return interpolate(base, local[0], local[1], local[2]);
+    }
+
+    /// @brief retrieve magnetic field value
+    ///
+    /// @param [in] position global position
+    /// @param [in] cache Cache object (is ignored)
+    /// @return magnetic field vector
+    Acts::Vector3D
+    getField(const Acts::Vector3D& position, Cache& /*cache*/) const
+    {
+      return getField(position);
+    }
+
+    /// @brief retrieve magnetic field values for many positions
+    ///
+    /// The grid cells are located for a block of positions at once in loops
+    /// without dependencies, which the compiler vectorizes, before the cell
+    /// corners are interpolated. Results are identical to @c getField.
+    ///
+    /// @param [in] positions global positions
+    /// @param [out] fields magnetic field vectors, one per position
+    /// @param [in] size number of positions
+    /// @param [in] cache Cache object (is ignored)
+    void
+    getFieldBatch(const Acts::Vector3D* positions,
+                  Acts::Vector3D*       fields,
+                  size_t                size,
+                  Cache& /*cache*/) const
+    {
+      constexpr size_t kBlock = 64;
+
+      size_t base[kBlock];
+      double local[3][kBlock];
+      for (size_t first = 0; first < size; first += kBlock) {
+        size_t num = std::min(kBlock, size - first);
+        std::fill(base, base + num, 0u);
+        for (size_t i = 0; i < 3; ++i) {
+          for (size_t j = 0; j < num; ++j) {
+            size_t cell;
+            local[i][j] = locate(positions[first + j][i], i, cell);
+            base[j] += cell * m_stride[i];
+          }
+        }
+        for (size_t j = 0; j < num; ++j) {
+          fields[first + j]
+              = interpolate(base[j], local[0][j], local[1][j], local[2][j]);
+        }
+      }
+    }
+
+    /// @brief retrieve magnetic field value & its gradient
+    ///
+    /// @param [in]  position   global position
+    /// @param [out] derivative gradient of magnetic field vector as (3x3)
+    /// matrix
+    /// @return magnetic field vector
+    ///
+    /// @note currently the derivative is not calculated
+    /// @todo return derivative
+    Acts::Vector3D
+    getFieldGradient(const Acts::Vector3D& position,
+                     Acts::ActsMatrixD<3, 3>& /*derivative*/) const
+    {
+      return getField(position);
+    }
+
+    /// @brief retrieve magnetic field value & its gradient
+    ///
+    /// @param [in]  position   global position
+    /// @param [out] derivative gradient of magnetic field vector as (3x3)
+    /// matrix
+    /// @param [in] cache Cache object (is ignored)
+    /// @return magnetic field vector
+    ///
+    /// @note currently the derivative is not calculated
+    /// @todo return derivative
+    Acts::Vector3D
+    getFieldGradient(const Acts::Vector3D& position,
+                     Acts::ActsMatrixD<3, 3>& /*derivative*/,
+                     Cache& /*cache*/) const
+    {
+      return getField(position);
+    }
+
+    /// @brief check whether given 3D position is inside look-up domain
+    ///
+    /// @param [in] position global 3D position
+    /// @return @c true if position is inside the defined look-up grid,
+    ///         otherwise @c false
+    bool
+    isInside(const Acts::Vector3D& position) const
+    {
+      for (size_t i = 0; i < 3; ++i) {
+        double u = m_firstOctant ? std::abs(position[i]) : position[i];
+        if (not((m_min[i] <= u) and (u <= m_max[i]))) { return false; }
+      }
+      return true;
+    }
+
+    /// @brief number of stored grid points
+    size_t
+    size() const
+    {
+      return m_values.size() / 3;
+    }
+
+    /// @brief memory used by the stored field values in bytes
+    size_t
+    memoryUsage() const
+    {
+      return m_values.size() * sizeof(float);
+    }
+
+  private:
+    /// @brief grid cell and position inside the cell along one axis
+    double
+    locate(double x, size_t axis, size_t& cell) const
+    {
+      if (m_firstOctant) { x = std::abs(x); }
+      double u = std::clamp((x - m_min[axis]) * m_invWidth[axis],
+                            0.,
+                            static_cast<double>(m_nPoints[axis] - 1));
+      cell = std::min(static_cast<size_t>(u), m_nPoints[axis] - 2);
+      return u - cell;
+    }
+
+    /// @brief trilinear interpolation between the eight cell corners
+    Acts::Vector3D
+    interpolate(size_t base, double lx, double ly, double lz) const
+    {
+      const float* v000 = m_values.data() + 3 * base;
+      const float* v001 = v000 + 3 * m_stride[2];
+      const float* v010 = v000 + 3 * m_stride[1];
+      const float* v011 = v010 + 3 * m_stride[2];
+      const float* v100 = v000 + 3 * m_stride[0];
+      const float* v101 = v100 + 3 * m_stride[2];
+      const float* v110 = v100 + 3 * m_stride[1];
+      const float* v111 = v110 + 3 * m_stride[2];
+      Acts::Vector3D field;
+      for (size_t i = 0; i < 3; ++i) {
+        double c00 = v000[i] + lz * (v001[i] - double(v000[i]));
+        double c01 = v010[i] + lz * (v011[i] - double(v010[i]));
+        double c10 = v100[i] + lz * (v101[i] - double(v100[i]));
+        double c11 = v110[i] + lz * (v111[i] - double(v110[i]));
+        double c0  = c00 + ly * (c01 - c00);
+        double c1  = c10 + ly * (c11 - c10);
+        field[i]   = c0 + lx * (c1 - c0);
+      }
+      return field;
+    }
+
+    bool                  m_firstOctant;
+    std::array<double, 3> m_min;
+    std::array<double, 3> m_max;
+    std::array<double, 3> m_invWidth;
+    std::array<size_t, 3> m_nPoints;
+    std::array<size_t, 3> m_stride;
+    /// field values as x,y,z triplets with the z axis running fastest
+    std::vector<float> m_values;
+  };
+
+}  // namespace BField
+}  // namespace FW
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "Acts/MagneticField/MagneticFieldContext.hpp"
 #include "Acts/Utilities/Definitions.hpp"
 
@@ -83,6 +85,23 @@ namespace BField {
       return m_BField * cache.scalor;
     }
 
+    /// @brief retrieve magnetic field values for many positions
+    ///
+    /// @param [in] positions global positions (are ignored)
+    /// @param [out] fields magnetic field vectors, one per position
+    /// @param [in] size number of positions
+    /// @param [in] cache Cache object
+    ///
+    /// @note The scaled field is computed once and broadcast to all outputs.
+    void
+    getFieldBatch(const Acts::Vector3D* /*positions*/,
+                  Acts::Vector3D* fields,
+                  size_t          size,
+                  Cache&          cache) const
+    {
+      std::fill(fields, fields + size, Acts::Vector3D(m_BField * cache.scalor));
+    }
+
     /// @brief retrieve magnetic field value & its gradient
     ///
     /// @param [in]  position   global position
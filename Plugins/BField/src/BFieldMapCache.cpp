@@ -0,0 +1,342 @@
+// This file is part of the Acts project.
+//
+// Copyright (C) 2019 CERN for the benefit of the Acts project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "ACTFW/Plugins/BField/BFieldMapCache.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "ACTFW/Utilities/Paths.hpp"
+
+namespace {
+
+using Grid2D = Acts::detail::Grid<Acts::Vector2D,
+                                  Acts::detail::EquidistantAxis,
+                                  Acts::detail::EquidistantAxis>;
+using Grid3D = Acts::detail::Grid<Acts::Vector3D,
+                                  Acts::detail::EquidistantAxis,
+                                  Acts::detail::EquidistantAxis,
+                                  Acts::detail::EquidistantAxis>;
+
+// on-disk layout
+//
+//     header | axes[dim] | values[numValues][dim]
+//
+// with a fixed-size header
+//
+//     magic[8] | version u32 | dim u32 | key u64 | numValues u64
+//
+// and each axis stored as min f64 | max f64 | nBins u64. Values are stored
+// for all global bins of the grid including under- and overflow bins. All
+// numbers are stored in native byte order.
+constexpr char     kMagic[8]    = {'A', 'C', 'T', 'F', 'W', 'B', 'F', 'C'};
+constexpr uint32_t kVersion     = 1u;
+constexpr size_t   kHeaderSize  = 32u;
+constexpr size_t   kAxisSize    = 24u;
+constexpr uint64_t kFnvOffset   = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime    = 1099511628211ull;
+constexpr size_t   kHashChunk   = 1u << 20;
+constexpr size_t   kHashWord    = sizeof(uint64_t);
+constexpr size_t   kOffsetDim   = 12u;
+constexpr size_t   kOffsetKey   = 16u;
+constexpr size_t   kOffsetCount = 24u;
+
+/// FNV-1a style hash; consumes 64bit words to keep up with the disk.
+struct Hasher
+{
+  uint64_t value = kFnvOffset;
+
+  void
+  add(const char* data, size_t size)
+  {
+    size_t i = 0;
+    for (; (i + kHashWord) <= size; i += kHashWord) {
+      uint64_t word;
+      std::memcpy(&word, data + i, kHashWord);
+      value = (value ^ word) * kFnvPrime;
+    }
+    for (; i < size; ++i) {
+      value = (value ^ static_cast<unsigned char>(data[i])) * kFnvPrime;
+    }
+  }
+  template <typename T>
+  void
+  add(const T& x)
+  {
+    add(reinterpret_cast<const char*>(&x), sizeof(T));
+  }
+};
+
+template <typename T>
+inline void
+writeValue(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+inline T
+readValue(const uint8_t* ptr)
+{
+  T value;
+  std::memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+// same transformations as used by the core field mapper helpers
+Acts::Vector2D
+transformPosRZ(const Acts::Vector3D& pos)
+{
+  return Acts::Vector2D(std::hypot(pos.x(), pos.y()), pos.z());
+}
+
+Acts::Vector3D
+transformBFieldRZ(const Acts::Vector2D& field, const Acts::Vector3D& pos)
+{
+  double r_sin_theta_2 = pos.x() * pos.x() + pos.y() * pos.y();
+  double cos_phi, sin_phi;
+  if (r_sin_theta_2 > std::numeric_limits<double>::min()) {
+    double inv_r_sin_theta = 1. / std::sqrt(r_sin_theta_2);
+    cos_phi                = pos.x() * inv_r_sin_theta;
+    sin_phi                = pos.y() * inv_r_sin_theta;
+  } else {
+    cos_phi = 1.;
+    sin_phi = 0.;
+  }
+  return Acts::Vector3D(field.x() * cos_phi, field.x() * sin_phi, field.y());
+}
+
+Acts::Vector3D
+transformPosXYZ(const Acts::Vector3D& pos)
+{
+  return pos;
+}
+
+Acts::Vector3D
+transformBFieldXYZ(const Acts::Vector3D& field, const Acts::Vector3D&)
+{
+  return field;
+}
+
+/// Write the mapper grid; a temporary file is renamed so concurrent jobs
+/// never see partially written caches.
+template <typename grid_t>
+void
+writeCache(const std::string&                           path,
+           uint64_t                                     key,
+           const Acts::InterpolatedBFieldMapper<grid_t>& mapper)
+{
+  constexpr size_t kDim = grid_t::DIM;
+
+  const grid_t& grid   = mapper.getGrid();
+  auto          minima = mapper.getMin();
+  auto          maxima = mapper.getMax();
+  auto          nBins  = mapper.getNBins();
+
+  std::string tmp = path + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream os(tmp, std::ios_base::binary | std::ios_base::trunc);
+    if (not os.good()) {
+      throw std::ios_base::failure("Could not open '" + tmp + "'");
+    }
+    os.write(kMagic, sizeof(kMagic));
+    writeValue(os, kVersion);
+    writeValue(os, static_cast<uint32_t>(kDim));
+    writeValue(os, key);
+    writeValue(os, static_cast<uint64_t>(grid.size()));
+    for (size_t i = 0; i < kDim; ++i) {
+      writeValue(os, static_cast<double>(minima.at(i)));
+      writeValue(os, static_cast<double>(maxima.at(i)));
+      writeValue(os, static_cast<uint64_t>(nBins.at(i)));
+    }
+    for (size_t bin = 0; bin < grid.size(); ++bin) {
+      const auto& value = grid.at(bin);
+      for (size_t i = 0; i < kDim; ++i) { writeValue(os, double(value[i])); }
+    }
+    if (not os.good()) {
+      throw std::ios_base::failure("Could not write to '" + tmp + "'");
+    }
+  }
+  boost::filesystem::rename(tmp, path);
+}
+
+template <typename grid_t, size_t... kAxes>
+grid_t
+makeGrid(const double*   minima,
+         const double*   maxima,
+         const uint64_t* nBins,
+         std::index_sequence<kAxes...>)
+{
+  return grid_t(std::make_tuple(Acts::detail::EquidistantAxis(
+      minima[kAxes], maxima[kAxes], nBins[kAxes])...));
+}
+
+/// Read the mapper grid; empty if the cache is missing or does not match.
+template <typename grid_t>
+std::optional<grid_t>
+readCache(const std::string& path, uint64_t key)
+{
+  namespace bip = boost::interprocess;
+
+  constexpr size_t kDim = grid_t::DIM;
+
+  if (not boost::filesystem::exists(path)) { return std::nullopt; }
+  try {
+    bip::file_mapping  file(path.c_str(), bip::read_only);
+    bip::mapped_region region(file, bip::read_only);
+    const auto* base = static_cast<const uint8_t*>(region.get_address());
+    size_t      size = region.get_size();
+
+    if ((size < (kHeaderSize + kDim * kAxisSize))
+        or (std::memcmp(base, kMagic, sizeof(kMagic)) != 0)
+        or (readValue<uint32_t>(base + sizeof(kMagic)) != kVersion)
+        or (readValue<uint32_t>(base + kOffsetDim) != kDim)
+        or (readValue<uint64_t>(base + kOffsetKey) != key)) {
+      return std::nullopt;
+    }
+    auto numValues = readValue<uint64_t>(base + kOffsetCount);
+    if (size
+        != (kHeaderSize + kDim * kAxisSize
+            + numValues * kDim * sizeof(double))) {
+      return std::nullopt;
+    }
+
+    double   minima[kDim];
+    double   maxima[kDim];
+    uint64_t nBins[kDim];
+    for (size_t i = 0; i < kDim; ++i) {
+      const uint8_t* axis = base + kHeaderSize + i * kAxisSize;
+      minima[i]           = readValue<double>(axis);
+      maxima[i]           = readValue<double>(axis + 8u);
+      nBins[i]            = readValue<uint64_t>(axis + 16u);
+    }
+    auto grid = makeGrid<grid_t>(
+        minima, maxima, nBins, std::make_index_sequence<kDim>());
+    if (grid.size() != numValues) { return std::nullopt; }
+
+    const uint8_t* values = base + kHeaderSize + kDim * kAxisSize;
+    for (size_t bin = 0; bin < numValues; ++bin) {
+      auto& value = grid.at(bin);
+      for (size_t i = 0; i < kDim; ++i) {
+        value[i] = readValue<double>(values);
+        values += sizeof(double);
+      }
+    }
+    return grid;
+  } catch (const bip::interprocess_exception&) {
+    return std::nullopt;
+  }
+}
+
+template <typename grid_t, typename transform_pos_t, typename transform_field_t>
+Acts::InterpolatedBFieldMapper<grid_t>
+cachedFieldMapper(
+    const std::string&                                            cacheFile,
+    uint64_t                                                      key,
+    const std::function<Acts::InterpolatedBFieldMapper<grid_t>()>& build,
+    transform_pos_t                                               transformPos,
+    transform_field_t transformBField)
+{
+  if (cacheFile.empty()) { return build(); }
+
+  auto grid = readCache<grid_t>(cacheFile, key);
+  if (grid) {
+    std::cout << "- magnetic field map loaded from cache: " << cacheFile
+              << std::endl;
+    return Acts::InterpolatedBFieldMapper<grid_t>(
+        transformPos, transformBField, std::move(*grid));
+  }
+
+  auto mapper = build();
+  try {
+    writeCache(cacheFile, key, mapper);
+    std::cout << "- magnetic field map cached in: " << cacheFile << std::endl;
+  } catch (const std::exception& e) {
+    std::cout << "- magnetic field map could not be cached: " << e.what()
+              << std::endl;
+  }
+  return mapper;
+}
+
+}  // namespace
+
+uint64_t
+FW::BField::fieldMapCacheKey(const std::string& fieldMapFile,
+                             const std::string& treeName,
+                             double             lengthUnit,
+                             double             BFieldUnit,
+                             bool               firstOctant)
+{
+  std::ifstream is(fieldMapFile, std::ios_base::binary);
+  if (not is.good()) {
+    throw std::ios_base::failure("Could not open '" + fieldMapFile + "'");
+  }
+
+  Hasher            hasher;
+  std::vector<char> chunk(kHashChunk);
+  while (is) {
+    is.read(chunk.data(), chunk.size());
+    hasher.add(chunk.data(), is.gcount());
+  }
+  if (is.bad()) {
+    throw std::ios_base::failure("Could not read '" + fieldMapFile + "'");
+  }
+  hasher.add(treeName.data(), treeName.size());
+  hasher.add(lengthUnit);
+  hasher.add(BFieldUnit);
+  hasher.add(firstOctant);
+  hasher.add(kVersion);
+  return hasher.value;
+}
+
+std::string
+FW::BField::fieldMapCachePath(const std::string& cacheDir,
+                              const std::string& fieldMapFile,
+                              uint64_t           key)
+{
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(key));
+
+  std::string stem = boost::filesystem::path(fieldMapFile).stem().string();
+  return joinPaths(cacheDir, stem + "-" + hex + ".bfc");
+}
+
+Acts::InterpolatedBFieldMapper<Grid2D>
+FW::BField::cachedFieldMapperRZ(
+    const std::string&                                            cacheFile,
+    uint64_t                                                      key,
+    const std::function<Acts::InterpolatedBFieldMapper<Grid2D>()>& build)
+{
+  return cachedFieldMapper<Grid2D>(
+      cacheFile, key, build, transformPosRZ, transformBFieldRZ);
+}
+
+Acts::InterpolatedBFieldMapper<Grid3D>
+FW::BField::cachedFieldMapperXYZ(
+    const std::string&                                            cacheFile,
+    uint64_t                                                      key,
+    const std::function<Acts::InterpolatedBFieldMapper<Grid3D>()>& build)
+{
+  return cachedFieldMapper<Grid3D>(
+      cacheFile, key, build, transformPosXYZ, transformBFieldXYZ);
+}
@@ -13,7 +13,9 @@
 #include <iostream>
 #include <tuple>
 #include <utility>
+#include "ACTFW/Plugins/BField/BFieldMapCache.hpp"
 #include "ACTFW/Plugins/BField/BFieldUtils.hpp"
+#include "ACTFW/Plugins/BField/CompactBFieldMap.hpp"
 #include "ACTFW/Plugins/BField/ScalableBField.hpp"
 #include "ACTFW/Utilities/Options.hpp"
 #include "Acts/MagneticField/ConstantBField.hpp"
@@ -89,6 +91,16 @@ namespace Options {
         "field will be created automatically. The values can be set with this "
         "options. Please hand over the coordinates in cartesian coordinates: "
         "{Bx,By,Bz} in Tesla.")(
+        "bf-compact",
+        po::value<bool>()->default_value(false),
+        "Store the field values of an 'xyz' field map in single precision. "
+        "Together with 'bf-foctant' only the given octant is stored and the "
+        "other octants are looked up at the mirrored positions.")(
+        "bf-cache-dir",
+        po::value<std::string>()->default_value(""),
+        "Directory to cache the interpolated field map grid in a binary file. "
+        "Later runs with the same map and scalors load the cached grid "
+        "directly. Omit to disable caching.")(
         "bf-context-scalable",
         po::value<bool>()->default_value(false),
         "This is for testing the event dependent magnetic field scaling.");
@@ -145,29 +157,64 @@ namespace Options {
     else if (bfieldmaptype != constant)
       std::cout << "- BField map is given in 'xyz' coordiantes." << std::endl;
 
-    if (bfieldmaptype != constant && vm["bf-foctant"].template as<bool>()) {
+    // A compact map mirrors the first octant at lookup instead
+    bool compact
+        = bfieldmaptype != constant && vm["bf-compact"].template as<bool>();
+    if (compact && vm["bf-rz"].template as<bool>()) {
+      std::cout << "- Compact storage is only available for 'xyz' maps and "
+                   "will be ignored."
+                << std::endl;
+      compact = false;
+    }
+    bool firstOctant = vm["bf-foctant"].template as<bool>();
+    if (bfieldmaptype != constant && firstOctant && compact) {
+      std::cout << "- Only the first octant is given, bField map will be "
+                   "looked up symmetrically for all other octants"
+                << std::endl;
+    } else if (bfieldmaptype != constant && firstOctant) {
       std::cout
           << "- Only the first octant/quadrant is given, bField map will be "
              "symmetrically created for all other octants/quadrants"
           << std::endl;
     }
+    bool mirrorGrid = firstOctant && !compact;
 
     // Declare the mapper
     double lengthUnit = lscalor * Acts::units::_mm;
     double BFieldUnit = bscalor * Acts::units::_T;
 
+    // Binary cache of the final grid, keyed by source content and scalors
+    std::string cacheFile;
+    uint64_t    cacheKey = 0;
+    if (bfieldmaptype != constant
+        && !vm["bf-cache-dir"].template as<std::string>().empty()) {
+      cacheKey  = FW::BField::fieldMapCacheKey(
+          bfieldmap,
+          (bfieldmaptype == root) ? vm["bf-name"].template as<std::string>()
+                                  : std::string(),
+          lengthUnit,
+          BFieldUnit,
+          mirrorGrid);
+      cacheFile = FW::BField::fieldMapCachePath(
+          vm["bf-cache-dir"].template as<std::string>(), bfieldmap, cacheKey);
+    }
+
     // set the mapper - foort
     if (bfieldmaptype == root) {
       if (vm["bf-rz"].template as<bool>()) {
-        auto mapper2D = FW::BField::root::fieldMapperRZ(
-            [](std::array<size_t, 2> binsRZ, std::array<size_t, 2> nBinsRZ) {
-              return (binsRZ.at(1) * nBinsRZ.at(0) + binsRZ.at(0));
-            },
-            vm["bf-map"].template as<std::string>(),
-            vm["bf-name"].template as<std::string>(),
-            lengthUnit,
-            BFieldUnit,
-            vm["bf-foctant"].template as<bool>());
+        auto mapper2D = FW::BField::cachedFieldMapperRZ(
+            cacheFile, cacheKey, [&] {
+              return FW::BField::root::fieldMapperRZ(
+                  [](std::array<size_t, 2> binsRZ,
+                     std::array<size_t, 2> nBinsRZ) {
+                    return (binsRZ.at(1) * nBinsRZ.at(0) + binsRZ.at(0));
+                  },
+                  vm["bf-map"].template as<std::string>(),
+                  vm["bf-name"].template as<std::string>(),
+                  lengthUnit,
+                  BFieldUnit,
+                  mirrorGrid);
+            });
 
         // create field mapping
         InterpolatedBFieldMap2D::Config config2D(std::move(mapper2D));
@@ -176,16 +223,29 @@ namespace Options {
         return std::make_shared<InterpolatedBFieldMap2D>(std::move(config2D));
 
       } else {
-        auto mapper3D = FW::BField::root::fieldMapperXYZ(
-            [](std::array<size_t, 3> binsXYZ, std::array<size_t, 3> nBinsXYZ) {
-              return (binsXYZ.at(0) * (nBinsXYZ.at(1) * nBinsXYZ.at(2))
-                      + binsXYZ.at(1) * nBinsXYZ.at(2) + binsXYZ.at(2));
-            },
-            vm["bf-map"].template as<std::string>(),
-            vm["bf-name"].template as<std::string>(),
-            lengthUnit,
-            BFieldUnit,
-            vm["bf-foctant"].template as<bool>());
+        auto mapper3D = FW::BField::cachedFieldMapperXYZ(
+            cacheFile, cacheKey, [&] {
+              return FW::BField::root::fieldMapperXYZ(
+                  [](std::array<size_t, 3> binsXYZ,
+                     std::array<size_t, 3> nBinsXYZ) {
+                    return (binsXYZ.at(0) * (nBinsXYZ.at(1) * nBinsXYZ.at(2))
+                            + binsXYZ.at(1) * nBinsXYZ.at(2) + binsXYZ.at(2));
+                  },
+                  vm["bf-map"].template as<std::string>(),
+                  vm["bf-name"].template as<std::string>(),
+                  lengthUnit,
+                  BFieldUnit,
+                  mirrorGrid);
+            });
+
+        if (compact) {
+          auto map = std::make_shared<FW::BField::CompactBFieldMap>(
+              mapper3D, firstOctant);
+          std::cout << "- compact field map with " << map->size()
+                    << " grid points uses " << map->memoryUsage()
+                    << " bytes" << std::endl;
+          return map;
+        }
 
         // create field mapping
         InterpolatedBFieldMap3D::Config config3D(std::move(mapper3D));
@@ -195,15 +255,19 @@ namespace Options {
       }
     } else if (bfieldmaptype == text) {
       if (vm["bf-rz"].template as<bool>()) {
-        auto mapper2D = FW::BField::txt::fieldMapperRZ(
-            [](std::array<size_t, 2> binsRZ, std::array<size_t, 2> nBinsRZ) {
-              return (binsRZ.at(1) * nBinsRZ.at(0) + binsRZ.at(0));
-            },
-            vm["bf-map"].template as<std::string>(),
-            lengthUnit,
-            BFieldUnit,
-            vm["bf-gridpoints"].template as<size_t>(),
-            vm["bf-foctant"].template as<bool>());
+        auto mapper2D = FW::BField::cachedFieldMapperRZ(
+            cacheFile, cacheKey, [&] {
+              return FW::BField::txt::fieldMapperRZ(
+                  [](std::array<size_t, 2> binsRZ,
+                     std::array<size_t, 2> nBinsRZ) {
+                    return (binsRZ.at(1) * nBinsRZ.at(0) + binsRZ.at(0));
+                  },
+                  vm["bf-map"].template as<std::string>(),
+                  lengthUnit,
+                  BFieldUnit,
+                  vm["bf-gridpoints"].template as<size_t>(),
+                  mirrorGrid);
+            });
 
         // create field mapping
         InterpolatedBFieldMap2D::Config config2D(std::move(mapper2D));
@@ -212,16 +276,29 @@ namespace Options {
         return std::make_shared<InterpolatedBFieldMap2D>(std::move(config2D));
 
       } else {
-        auto mapper3D = FW::BField::txt::fieldMapperXYZ(
-            [](std::array<size_t, 3> binsXYZ, std::array<size_t, 3> nBinsXYZ) {
-              return (binsXYZ.at(0) * (nBinsXYZ.at(1) * nBinsXYZ.at(2))
-                      + binsXYZ.at(1) * nBinsXYZ.at(2) + binsXYZ.at(2));
-            },
-            vm["bf-map"].template as<std::string>(),
-            lengthUnit,
-            BFieldUnit,
-            vm["bf-gridpoints"].template as<size_t>(),
-            vm["bf-foctant"].template as<bool>());
+        auto mapper3D = FW::BField::cachedFieldMapperXYZ(
+            cacheFile, cacheKey, [&] {
+              return FW::BField::txt::fieldMapperXYZ(
+                  [](std::array<size_t, 3> binsXYZ,
+                     std::array<size_t, 3> nBinsXYZ) {
+                    return (binsXYZ.at(0) * (nBinsXYZ.at(1) * nBinsXYZ.at(2))
+                            + binsXYZ.at(1) * nBinsXYZ.at(2) + binsXYZ.at(2));
+                  },
+                  vm["bf-map"].template as<std::string>(),
+                  lengthUnit,
+                  BFieldUnit,
+                  vm["bf-gridpoints"].template as<size_t>(),
+                  mirrorGrid);
+            });
+
+        if (compact) {
+          auto map = std::make_shared<FW::BField::CompactBFieldMap>(
+              mapper3D, firstOctant);
+          std::cout << "- compact field map with " << map->size()
+                    << " grid points uses " << map->memoryUsage()
+                    << " bytes" << std::endl;
+          return map;
+        }
 
         // create field mapping
         InterpolatedBFieldMap3D::Config config3D(std::move(mapper3D));
@@ -0,0 +1,25 @@
+# Find the zstd include directory and library.
+#
+# This module defines the `Zstd` imported target that encodes all
+# necessary information in its target properties.
+
+list(APPEND CMAKE_PREFIX_PATH $ENV{Zstd_DIR})
+
+find_library(
+  Zstd_LIBRARY
+  NAMES zstd libzstd.so
+  DOC "The zstd library")
+find_path(
+  Zstd_INCLUDE_DIR
+  NAMES zstd.h
+  DOC "The zstd include directory")
+
+find_package_handle_standard_args(
+  Zstd
+  REQUIRED_VARS Zstd_LIBRARY Zstd_INCLUDE_DIR)
+
+add_library(Zstd SHARED IMPORTED)
+set_property(TARGET Zstd PROPERTY IMPORTED_LOCATION ${Zstd_LIBRARY})
+set_property(TARGET Zstd PROPERTY INTERFACE_INCLUDE_DIRECTORIES ${Zstd_INCLUDE_DIR})
+
+mark_as_advanced(Zstd_FOUND Zstd_INCLUDE_DIR Zstd_LIBRARY)